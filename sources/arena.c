@@ -0,0 +1,113 @@
+#include "compile.h"
+
+#include <assert.h>
+#include <string.h>
+
+/* Chunks are linked newest first, so resetting to a mark frees from the head
+ * of the list until the marked chunk is reached.  Each chunk is twice the size
+ * of the one before it, up to ARENA_MAX_CHUNK_SIZE, so a compilation needs few
+ * chunks however much it allocates.  An allocation bigger than that gets a
+ * chunk of its own size.
+ */
+
+#define ARENA_FIRST_CHUNK_SIZE (64 * 1024)
+#define ARENA_MAX_CHUNK_SIZE (4 * 1024 * 1024)
+
+struct ArenaChunk {
+    struct ArenaChunk *previous;
+    size_t size;
+    char data[];
+};
+
+void arena_init(struct Arena *arena)
+{
+    *arena = (struct Arena) {0};
+}
+
+void arena_free(struct Arena *arena)
+{
+    arena_reset(arena, (struct ArenaMark) {0});
+}
+
+void *arena_grow(struct Arena *arena, size_t size)
+{
+    size_t chunk_size = ARENA_FIRST_CHUNK_SIZE;
+
+    if (arena->chunk != NULL && arena->chunk->size < ARENA_MAX_CHUNK_SIZE)
+        chunk_size = arena->chunk->size * 2;
+    else if (arena->chunk != NULL)
+        chunk_size = ARENA_MAX_CHUNK_SIZE;
+
+    // keep the limit aligned, so aligning next never passes it
+    if (size + ARENA_ALIGNMENT > chunk_size)
+        chunk_size = (size + 2 * ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    struct ArenaChunk *chunk = malloc(sizeof *chunk + chunk_size);
+    if (chunk == NULL)
+        return NULL;
+
+    *chunk = (struct ArenaChunk) { .previous = arena->chunk, .size = chunk_size };
+
+    char *next = (char *)(((uintptr_t)chunk->data + ARENA_ALIGNMENT - 1) & ~(uintptr_t)(ARENA_ALIGNMENT - 1));
+    char *limit = (char *)((uintptr_t)(chunk->data + chunk_size) & ~(uintptr_t)(ARENA_ALIGNMENT - 1));
+
+    arena->chunk = chunk;
+    arena->next = next + size;
+    arena->limit = limit;
+
+    assert(arena->next <= arena->limit);
+
+    return next;
+}
+
+void arena_reset(struct Arena *arena, struct ArenaMark mark)
+{
+    while (arena->chunk != mark.chunk) {
+        struct ArenaChunk *previous = arena->chunk->previous;
+        free(arena->chunk);
+        arena->chunk = previous;
+    }
+
+    if (arena->chunk == NULL) {
+        *arena = (struct Arena) {0};
+        return;
+    }
+
+    arena->next = mark.next;
+    arena->limit = (char *)((uintptr_t)(arena->chunk->data + arena->chunk->size) & ~(uintptr_t)(ARENA_ALIGNMENT - 1));
+}
+
+void *arena_resize(struct Arena *arena, void *old, size_t old_size, size_t new_size)
+{
+    assert(new_size >= old_size);
+
+    if (old != NULL && (char *)old + old_size == arena->next
+            && (size_t)(arena->limit - (char *)old) >= new_size) {
+        arena->next = (char *)old + new_size;
+        return old;
+    }
+
+    void *resized = arena_alloc(arena, new_size);
+
+    if (resized != NULL && old != NULL)
+        memcpy(resized, old, old_size);
+
+    return resized;
+}
+
+const char *arena_copy_text(struct Arena *arena, const char *data, size_t length)
+{
+    char *text = arena->next;
+
+    // text needs no alignment, so it is packed in right after the last thing
+    if (arena->next == NULL || (size_t)(arena->limit - arena->next) < length) {
+        if ((text = arena_grow(arena, length)) == NULL)
+            return NULL;
+    } else {
+        arena->next += length;
+    }
+
+    memcpy(text, data, length);
+
+    return text;
+}
@@ -0,0 +1,390 @@
+#include "compile.h"
+
+#include <assert.h>
+#include <string.h>
+
+/* The arrays grow by doubling inside the arena.  Whichever array grew last
+ * is usually the newest allocation, so arena_resize can often extend it in
+ * place; otherwise the old copy is left behind in the arena, which at worst
+ * wastes as much as the final arrays take.
+ */
+
+#define AST_MIN_CAPACITY 64
+
+const char *const node_kind_strings[TEMAX] = {
+    [ETADDITION] = "addition",
+    [ETADDITIONASSIGN] = "addition assign",
+    [ETASSIGN] = "assign",
+    [ETASYNCFUNCTION] = "async function",
+    [ETASYNCGENFUNCTION] = "async gen function",
+    [ETAWAIT] = "await",
+    [ETBITAND] = "bit and",
+    [ETBITANDASSIGN] = "bit and assign",
+    [ETBITNOT] = "bit not",
+    [ETBITOR] = "bit or",
+    [ETBITORASSIGN] = "bit or assign",
+    [ETBITXOR] = "bit xor",
+    [ETBITXORASSIGN] = "bit xor assign",
+    [ETCLASS] = "class",
+    [ETCOMMA] = "comma",
+    [ETTERNARY] = "ternary",
+    [ETDECREMENT] = "decrement",
+    [ETDELETE] = "delete",
+    [ETDESTRUCTUREASSIGN] = "destructure assign",
+    [ETDIVISION] = "division",
+    [ETDIVISIONASSIGN] = "division assign",
+    [ETEQUAL] = "equal",
+    [ETEXPONENT] = "exponent",
+    [ETEXPONENTASSIGN] = "exponent assign",
+    [ETFUNCTION] = "function",
+    [ETGENFUNCTION] = "gen function",
+    [ETGREATER] = "greater",
+    [ETGREATEREQUAL] = "greater equal",
+    [ETGROUP] = "group",
+    [ETIMPORTMETA] = "import meta",
+    [ETIMPORT] = "import",
+    [ETIN] = "in",
+    [ETINCREMENT] = "increment",
+    [ETINEQUAL] = "inequal",
+    [ETINSTANCEOF] = "instanceof",
+    [ETLEFTSHIFT] = "left shift",
+    [ETLEFTSHIFTASSIGN] = "left shift assign",
+    [ETLESS] = "less",
+    [ETLESSEQUAL] = "less equal",
+    [ETLOGICAND] = "logic and",
+    [ETLOGICOR] = "logic or",
+    [ETLOGICORASSIGN] = "logic or assign",
+    [ETMULTIPLY] = "multiply",
+    [ETMULTIPLYASSIGN] = "multiply assign",
+    [ETNEW] = "new",
+    [ETNEWTARGET] = "new target",
+    [ETNULL] = "null",
+    [ETNULLCOALESCEASSIGN] = "null coalesce assign",
+    [ETNULLCOALESCE] = "null coalesce",
+    [ETNUMERICLITERAL] = "numeric literal",
+    [ETOBJECTINIT] = "object init",
+    [ETOPTIONALCHAIN] = "optional chain",
+    [ETPROPERTYACCESS] = "property access",
+    [ETREMAINDER] = "remainder",
+    [ETREMAINDERASSIGN] = "remainder assign",
+    [ETRIGHTSHIFT] = "right shift",
+    [ETRIGHTSHIFTASSIGN] = "right shift assign",
+    [ETSPREAD] = "spread",
+    [ETSTRICTEQUAL] = "strict equal",
+    [ETSTRICTINEQUAL] = "strict inequal",
+    [ETSTRINGLITERAL] = "string literal",
+    [ETSUBTRACT] = "subtract",
+    [ETSUBTRACTASSIGN] = "subtract assign",
+    [ETSUPER] = "super",
+    [ETTHIS] = "this",
+    [ETTYPEOF] = "typeof",
+    [ETUNARYNEGATE] = "unary negate",
+    [ETUNARYPLUS] = "unary plus",
+    [ETUNSIGNEDRIGHTSHIFT] = "unsigned right shift",
+    [ETUNSIGNEDRIGHTSHIFTASSIGN] = "unsigned right shift assign",
+    [ETVOID] = "void",
+    [ETYIELD] = "yield",
+    [ETGENYIELD] = "gen yield",
+    [ETIDENTIFIER] = "identifier",
+    [ETBOOLEANLITERAL] = "boolean literal",
+    [ETLOGICANDASSIGN] = "logic and assign",
+    [ETCALL] = "call",
+    [ETINDEX] = "index",
+    [ETARRAYINIT] = "array init",
+    [ETPROPERTYINIT] = "property init",
+    [ETARROWFUNCTION] = "arrow function",
+    [ETLOGICNOT] = "logic not",
+    [ETGETTER] = "getter",
+    [ETSETTER] = "setter",
+    [SDPROGRAM] = "program",
+    [SDASYNCFUNCTION] = "async function",
+    [SDASYNCGENFUNCTION] = "async gen function",
+    [SDBLOCK] = "block",
+    [SDBREAK] = "break",
+    [SDCLASS] = "class",
+    [SDCONST] = "const",
+    [SDCONTINUE] = "continue",
+    [SDDEBUGGER] = "debugger",
+    [SDDOWHILE] = "do while",
+    [SDEMPTY] = "empty",
+    [SDEXPORT] = "export",
+    [SDEXPRSTATEMENT] = "expr statement",
+    [SDFOR] = "for",
+    [SDFORAWAITOF] = "for await of",
+    [SDFORIN] = "for in",
+    [SDFOROF] = "for of",
+    [SDFUNCTION] = "function",
+    [SDGENFUNCTION] = "gen function",
+    [SDIFELSE] = "if else",
+    [SDIMPORT] = "import",
+    [SDLABEL] = "label",
+    [SDLET] = "let",
+    [SDRETURN] = "return",
+    [SDSWITCH] = "switch",
+    [SDTHROW] = "throw",
+    [SDTRYCATCH] = "try catch",
+    [SDVAR] = "var",
+    [SDWHILE] = "while",
+    [SDINTERFACE] = "interface",
+    [SDTYPEALIAS] = "type alias",
+    [TEREFERENCE] = "type reference",
+    [TEINSTANCE] = "type instance",
+    [TEARRAY] = "array type",
+    [TEUNION] = "union type",
+    [TEOBJECT] = "object type",
+    [TEMEMBER] = "member",
+    [TEOPTIONALMEMBER] = "optional member",
+    [TEFUNCTION] = "function type",
+    [TEVOID] = "void type",
+    [TEANNOTATION] = "annotation",
+    [TEOPTIONAL] = "optional",
+};
+
+const uint8_t node_layouts[TEMAX] = {
+    [ETADDITION] = NLBINARY,
+    [ETADDITIONASSIGN] = NLBINARY,
+    [ETASSIGN] = NLBINARY,
+    [ETASYNCFUNCTION] = NLFUNCTION,
+    [ETASYNCGENFUNCTION] = NLFUNCTION,
+    [ETAWAIT] = NLUNARY,
+    [ETBITAND] = NLBINARY,
+    [ETBITANDASSIGN] = NLBINARY,
+    [ETBITNOT] = NLUNARY,
+    [ETBITOR] = NLBINARY,
+    [ETBITORASSIGN] = NLBINARY,
+    [ETBITXOR] = NLBINARY,
+    [ETBITXORASSIGN] = NLBINARY,
+    [ETCOMMA] = NLBINARY,
+    [ETTERNARY] = NLTERNARY,
+    [ETDECREMENT] = NLUNARY,
+    [ETDELETE] = NLUNARY,
+    [ETDESTRUCTUREASSIGN] = NLBINARY,
+    [ETDIVISION] = NLBINARY,
+    [ETDIVISIONASSIGN] = NLBINARY,
+    [ETEQUAL] = NLBINARY,
+    [ETEXPONENT] = NLBINARY,
+    [ETEXPONENTASSIGN] = NLBINARY,
+    [ETFUNCTION] = NLFUNCTION,
+    [ETGENFUNCTION] = NLFUNCTION,
+    [ETGREATER] = NLBINARY,
+    [ETGREATEREQUAL] = NLBINARY,
+    [ETGROUP] = NLUNARY,
+    [ETIN] = NLBINARY,
+    [ETINCREMENT] = NLUNARY,
+    [ETINEQUAL] = NLBINARY,
+    [ETINSTANCEOF] = NLBINARY,
+    [ETLEFTSHIFT] = NLBINARY,
+    [ETLEFTSHIFTASSIGN] = NLBINARY,
+    [ETLESS] = NLBINARY,
+    [ETLESSEQUAL] = NLBINARY,
+    [ETLOGICAND] = NLBINARY,
+    [ETLOGICOR] = NLBINARY,
+    [ETLOGICORASSIGN] = NLBINARY,
+    [ETMULTIPLY] = NLBINARY,
+    [ETMULTIPLYASSIGN] = NLBINARY,
+    [ETNEW] = NLCALL,
+    [ETNULLCOALESCEASSIGN] = NLBINARY,
+    [ETNULLCOALESCE] = NLBINARY,
+    [ETOBJECTINIT] = NLLIST,
+    [ETOPTIONALCHAIN] = NLUNARY,
+    [ETPROPERTYACCESS] = NLMEMBER,
+    [ETREMAINDER] = NLBINARY,
+    [ETREMAINDERASSIGN] = NLBINARY,
+    [ETRIGHTSHIFT] = NLBINARY,
+    [ETRIGHTSHIFTASSIGN] = NLBINARY,
+    [ETSPREAD] = NLUNARY,
+    [ETSTRICTEQUAL] = NLBINARY,
+    [ETSTRICTINEQUAL] = NLBINARY,
+    [ETSUBTRACT] = NLBINARY,
+    [ETSUBTRACTASSIGN] = NLBINARY,
+    [ETTYPEOF] = NLUNARY,
+    [ETUNARYNEGATE] = NLUNARY,
+    [ETUNARYPLUS] = NLUNARY,
+    [ETUNSIGNEDRIGHTSHIFT] = NLBINARY,
+    [ETUNSIGNEDRIGHTSHIFTASSIGN] = NLBINARY,
+    [ETVOID] = NLUNARY,
+    [ETYIELD] = NLUNARY,
+    [ETGENYIELD] = NLUNARY,
+    [ETLOGICANDASSIGN] = NLBINARY,
+    [ETCALL] = NLCALL,
+    [ETINDEX] = NLBINARY,
+    [ETARRAYINIT] = NLLIST,
+    [ETPROPERTYINIT] = NLBINARY,
+    [ETARROWFUNCTION] = NLFUNCTION,
+    [ETLOGICNOT] = NLUNARY,
+    [ETGETTER] = NLBINARY,
+    [ETSETTER] = NLBINARY,
+    [SDPROGRAM] = NLLIST,
+    [SDASYNCFUNCTION] = NLFUNCTION,
+    [SDASYNCGENFUNCTION] = NLFUNCTION,
+    [SDBLOCK] = NLLIST,
+    [SDCONST] = NLDECLARATION,
+    [SDEXPRSTATEMENT] = NLUNARY,
+    [SDFUNCTION] = NLFUNCTION,
+    [SDGENFUNCTION] = NLFUNCTION,
+    [SDLET] = NLDECLARATION,
+    [SDRETURN] = NLUNARY,
+    [SDVAR] = NLDECLARATION,
+    [SDINTERFACE] = NLDECLARATION,
+    [SDTYPEALIAS] = NLDECLARATION,
+    [TEINSTANCE] = NLCALL,
+    [TEARRAY] = NLUNARY,
+    [TEUNION] = NLLIST,
+    [TEOBJECT] = NLLIST,
+    [TEMEMBER] = NLNAMED,
+    [TEOPTIONALMEMBER] = NLNAMED,
+    [TEFUNCTION] = NLCALL,
+    [TEANNOTATION] = NLBINARY,
+    [TEOPTIONAL] = NLBINARY,
+    // everything else is a leaf, or not built yet
+};
+
+static int grow(struct Arena *arena, void **array, size_t *capacity, size_t needed, size_t size)
+{
+    if (needed <= *capacity)
+        return EXIT_SUCCESS;
+
+    size_t wanted = *capacity < AST_MIN_CAPACITY ? AST_MIN_CAPACITY : *capacity;
+    while (wanted < needed)
+        wanted *= 2;
+
+    void *resized = arena_resize(arena, *array, *capacity * size, wanted * size);
+    if (resized == NULL)
+        return EXIT_FAILURE;
+
+    *array = resized;
+    *capacity = wanted;
+
+    return EXIT_SUCCESS;
+}
+
+int ast_init(struct Ast *ast, struct Arena *arena, size_t expected_nodes)
+{
+    *ast = (struct Ast) { .arena = arena };
+
+    return ast_reserve(ast, expected_nodes);
+}
+
+int ast_reserve(struct Ast *ast, size_t capacity)
+{
+    return grow(ast->arena, (void **)&ast->nodes, &ast->capacity, capacity, sizeof *ast->nodes);
+}
+
+int ast_push_list(struct Ast *ast, const uint32_t *items, size_t count, uint32_t *start)
+{
+    if (grow(ast->arena, (void **)&ast->extra, &ast->extra_capacity, ast->extra_count + count, sizeof *ast->extra) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    *start = ast->extra_count;
+    if (count > 0)
+        memcpy(&ast->extra[ast->extra_count], items, count * sizeof *items);
+    ast->extra_count += count;
+
+    return EXIT_SUCCESS;
+}
+
+int ast_push_number(struct Ast *ast, double value, uint32_t *index)
+{
+    if (grow(ast->arena, (void **)&ast->numbers, &ast->number_capacity, ast->number_count + 1, sizeof *ast->numbers) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    *index = ast->number_count;
+    ast->numbers[ast->number_count++] = value;
+
+    return EXIT_SUCCESS;
+}
+
+int ast_push_function(struct Ast *ast, struct Function function, uint32_t *index)
+{
+    if (grow(ast->arena, (void **)&ast->functions, &ast->function_capacity, ast->function_count + 1, sizeof *ast->functions) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    *index = ast->function_count;
+    ast->functions[ast->function_count++] = function;
+
+    return EXIT_SUCCESS;
+}
+
+int ast_append(struct Ast *ast, const struct Ast *part)
+{
+    assert(ast->count > 0 && part->count > 0);
+
+    // part's node 0 is a placeholder, so its node i becomes node i + shift
+    uint32_t shift = ast->count - 1, nodes = ast->count, extra = ast->extra_count;
+    uint32_t numbers = ast->number_count, functions = ast->function_count;
+
+    if (ast_reserve(ast, ast->count + part->count - 1) != EXIT_SUCCESS
+            || grow(ast->arena, (void **)&ast->extra, &ast->extra_capacity, ast->extra_count + part->extra_count, sizeof *ast->extra) != EXIT_SUCCESS
+            || grow(ast->arena, (void **)&ast->numbers, &ast->number_capacity, ast->number_count + part->number_count, sizeof *ast->numbers) != EXIT_SUCCESS
+            || grow(ast->arena, (void **)&ast->functions, &ast->function_capacity, ast->function_count + part->function_count, sizeof *ast->functions) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    memcpy(&ast->nodes[nodes], &part->nodes[1], (part->count - 1) * sizeof *ast->nodes);
+    memcpy(&ast->extra[extra], part->extra, part->extra_count * sizeof *ast->extra);
+    memcpy(&ast->numbers[numbers], part->numbers, part->number_count * sizeof *ast->numbers);
+    memcpy(&ast->functions[functions], part->functions, part->function_count * sizeof *ast->functions);
+    ast->count += part->count - 1;
+    ast->extra_count += part->extra_count;
+    ast->number_count += part->number_count;
+    ast->function_count += part->function_count;
+
+#define MOVE(node) ((node) = (node) == NODE_NONE ? NODE_NONE : (node) + shift)
+
+    // every list in extra belongs to one node or function, which moves it
+    for (size_t i = nodes; i < ast->count; i++) {
+        struct Node *n = &ast->nodes[i];
+
+        switch (node_layouts[n->kind]) {
+        case NLLEAF:
+            if (n->kind == ETNUMERICLITERAL)
+                n->lhs += numbers;
+            break;
+        case NLUNARY:
+        case NLMEMBER:
+            MOVE(n->lhs);
+            break;
+        case NLBINARY:
+            MOVE(n->lhs);
+            MOVE(n->rhs);
+            break;
+        case NLTERNARY:
+            MOVE(n->lhs);
+            n->rhs += extra;
+            MOVE(ast->extra[n->rhs]);
+            MOVE(ast->extra[n->rhs + 1]);
+            break;
+        case NLCALL:
+            MOVE(n->lhs);
+            n->rhs += extra;
+            for (uint32_t j = 0; j < ast->extra[n->rhs]; j++)
+                MOVE(ast->extra[n->rhs + 1 + j]);
+            break;
+        case NLLIST:
+            n->lhs += extra;
+            for (uint32_t j = 0; j < n->rhs; j++)
+                MOVE(ast->extra[n->lhs + j]);
+            break;
+        case NLFUNCTION:
+            n->lhs += functions;
+            break;
+        case NLDECLARATION:
+        case NLNAMED:
+            MOVE(n->rhs);
+            break;
+        }
+    }
+
+    for (size_t i = functions; i < ast->function_count; i++) {
+        struct Function *f = &ast->functions[i];
+
+        f->parameters += extra;
+        for (uint32_t j = 0; j < ast->extra[f->parameters]; j++)
+            MOVE(ast->extra[f->parameters + 1 + j]);
+        MOVE(f->body);
+        MOVE(f->result);
+    }
+
+#undef MOVE
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,367 @@
+#define _DEFAULT_SOURCE // mkdir and getpid
+
+#include "compile.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* An entry is a header followed by the arrays of a TokenBuffer and an Ast,
+ * each starting on a CACHE_ALIGNMENT boundary, written exactly as they are in
+ * memory, then a copy of the source and the symbols' text.  Loading maps the
+ * file and points the buffers straight into it, so a hit costs hashing the
+ * source, comparing it with the copy, checking the header and interning the
+ * file's symbols again, and nothing proportional to its tokens or nodes.  The
+ * copy is what makes a hit certain: two files whose keys collide still differ
+ * there.
+ * The mapping is private and writable: parse_function_body fills in function
+ * records in place, and the kernel copies only the pages it touches.
+ *
+ * Entries are native-endian and only ever read by the build that wrote them,
+ * which the key and the version in the header make sure of.  A new entry is
+ * written to a temporary file and renamed into place, so a concurrent build
+ * never maps half an entry.
+ */
+
+#define CACHE_MAGIC "jscache"
+#define CACHE_FORMAT 2
+#define CACHE_ALIGNMENT 16
+
+struct CacheHeader {
+    char magic[8];
+    char version[16];
+    uint32_t format;
+    uint32_t symbol_count;      // including SYMBOL_NONE
+    uint64_t key;
+    uint64_t source_length;
+    uint64_t token_count;
+    uint64_t node_count;
+    uint64_t extra_count;
+    uint64_t number_count;
+    uint64_t function_count;
+    uint64_t text_length;       // of all the symbols' text
+};
+
+// a symbol's text, as an offset into the entry's text section
+struct CacheSymbol {
+    uint32_t offset;
+    uint32_t length;
+};
+
+enum CacheSection {
+    CSNUMBERS = 0,
+    CSNODES,
+    CSFUNCTIONS,
+    CSSTARTS,
+    CSLENGTHS,
+    CSSYMBOLS,
+    CSEXTRA,
+    CSSYMBOLTABLE,
+    CSTYPES,
+    CSSOURCE,
+    CSTEXT,
+    CSMAX,
+};
+
+/* The mixing is the round function of xxHash64, over four independent lanes
+ * of eight bytes so the multiplies overlap.
+ */
+
+static const uint64_t P1 = 0x9e3779b185ebca87ull;
+static const uint64_t P2 = 0xc2b2ae3d27d4eb4full;
+static const uint64_t P3 = 0x165667b19e3779f9ull;
+
+static inline uint64_t rotate(uint64_t x, int bits)
+{
+    return (x << bits) | (x >> (64 - bits));
+}
+
+static inline uint64_t mix(uint64_t lane, uint64_t word)
+{
+    return rotate(lane + word * P2, 31) * P1;
+}
+
+static uint64_t hash_bytes(const char *data, size_t length, uint64_t seed)
+{
+    uint64_t lanes[4] = { seed + P1 + P2, seed + P2, seed, seed - P1 };
+    uint64_t word, h;
+    size_t i = 0;
+
+    for (; length - i >= 32; i += 32) {
+        for (int lane = 0; lane < 4; lane++) {
+            memcpy(&word, &data[i + lane * 8], 8);
+            lanes[lane] = mix(lanes[lane], word);
+        }
+    }
+
+    h = rotate(lanes[0], 1) + rotate(lanes[1], 7) + rotate(lanes[2], 12) + rotate(lanes[3], 18) + length;
+
+    for (; length - i >= 8; i += 8) {
+        memcpy(&word, &data[i], 8);
+        h = rotate(h ^ mix(0, word), 27) * P1 + P3;
+    }
+
+    if (i < length) {
+        word = 0;
+        memcpy(&word, &data[i], length - i);
+        h = rotate(h ^ mix(0, word), 27) * P1 + P3;
+    }
+
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+uint64_t cache_key(const char *data, size_t length)
+{
+    uint64_t seed = hash_bytes(COMPILER_VERSION, strlen(COMPILER_VERSION), CACHE_FORMAT);
+    return hash_bytes(data, length, seed);
+}
+
+static size_t align(size_t offset)
+{
+    return (offset + CACHE_ALIGNMENT - 1) & ~(size_t)(CACHE_ALIGNMENT - 1);
+}
+
+/**Writes where each section starts, and returns the length of the entry, or
+ * SIZE_MAX if the counts are too big for any entry to hold.  The sections
+ * follow one another, so an entry of the returned length holds them all.
+ */
+static size_t layout(const struct CacheHeader *header, size_t offsets[CSMAX])
+{
+    const uint64_t counts[CSMAX] = {
+        [CSNUMBERS] = header->number_count,
+        [CSNODES] = header->node_count,
+        [CSFUNCTIONS] = header->function_count,
+        [CSSTARTS] = header->token_count,
+        [CSLENGTHS] = header->token_count,
+        [CSSYMBOLS] = header->token_count,
+        [CSEXTRA] = header->extra_count,
+        [CSSYMBOLTABLE] = header->symbol_count,
+        [CSTYPES] = header->token_count,
+        [CSSOURCE] = header->source_length,
+        [CSTEXT] = header->text_length,
+    };
+    static const size_t widths[CSMAX] = {
+        [CSNUMBERS] = sizeof(double),
+        [CSNODES] = sizeof(struct Node),
+        [CSFUNCTIONS] = sizeof(struct Function),
+        [CSSTARTS] = sizeof(uint32_t),
+        [CSLENGTHS] = sizeof(uint32_t),
+        [CSSYMBOLS] = sizeof(uint32_t),
+        [CSEXTRA] = sizeof(uint32_t),
+        [CSSYMBOLTABLE] = sizeof(struct CacheSymbol),
+        [CSTYPES] = sizeof(uint8_t),
+        [CSSOURCE] = sizeof(char),
+        [CSTEXT] = sizeof(char),
+    };
+    size_t offset = sizeof *header;
+
+    for (int i = 0; i < CSMAX; i++) {
+        // a count read from a damaged entry mustn't wrap the sum around
+        if (counts[i] > (SIZE_MAX - CACHE_ALIGNMENT - offset) / widths[i])
+            return SIZE_MAX;
+
+        offsets[i] = offset = align(offset);
+        offset += counts[i] * widths[i];
+    }
+
+    return offset;
+}
+
+static void entry_path(char *path, size_t size, const char *directory, uint64_t key)
+{
+    snprintf(path, size, "%s/%016llx.ast", directory, (unsigned long long)key);
+}
+
+int cache_load(const char *directory, uint64_t key, const struct SourceFile *source, struct Interner *interner,
+               struct TokenBuffer *tokens, struct Ast *ast, struct Arena *arena, struct CacheEntry *entry)
+{
+    char path[4096];
+    struct stat st;
+    int fd;
+
+    entry_path(path, sizeof path, directory, key);
+
+    if ((fd = open(path, O_RDONLY)) < 0)
+        return EXIT_FAILURE;
+
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct CacheHeader)) {
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    size_t length = st.st_size;
+    char *data = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return EXIT_FAILURE;
+
+    struct CacheHeader header;
+    size_t offsets[CSMAX];
+    memcpy(&header, data, sizeof header);
+
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof CACHE_MAGIC) != 0 || header.format != CACHE_FORMAT
+            || strncmp(header.version, COMPILER_VERSION, sizeof header.version) != 0
+            || header.key != key || header.source_length != source->length
+            || header.symbol_count == 0 || layout(&header, offsets) != length
+            || memcmp(&data[offsets[CSSOURCE]], source->data, source->length) != 0) {
+        munmap(data, length);
+        return EXIT_FAILURE;
+    }
+
+    const struct CacheSymbol *symbols = (const struct CacheSymbol *)&data[offsets[CSSYMBOLTABLE]];
+    const char *text = &data[offsets[CSTEXT]];
+
+    // every symbol's text must lie within the text section
+    for (uint32_t i = 1; i < header.symbol_count; i++) {
+        if ((uint64_t)symbols[i].offset + symbols[i].length > header.text_length) {
+            munmap(data, length);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // symbols are handed out in order, so interning them again numbers them the same
+    for (uint32_t i = 1; i < header.symbol_count; i++) {
+        const char *name = &text[symbols[i].offset];
+        if (intern(interner, name, symbols[i].length, intern_hash(name, symbols[i].length)) != i) {
+            munmap(data, length);
+            return EXIT_FAILURE;
+        }
+    }
+
+    *tokens = (struct TokenBuffer) {
+        .source = source->data,
+        .types = (uint8_t *)&data[offsets[CSTYPES]],
+        .starts = (uint32_t *)&data[offsets[CSSTARTS]],
+        .lengths = (uint32_t *)&data[offsets[CSLENGTHS]],
+        .symbols = (uint32_t *)&data[offsets[CSSYMBOLS]],
+        .count = header.token_count,
+        .capacity = header.token_count,
+    };
+
+    // every array is full, so the first push copies it out into the arena
+    *ast = (struct Ast) {
+        .arena = arena,
+        .nodes = (struct Node *)&data[offsets[CSNODES]],
+        .count = header.node_count,
+        .capacity = header.node_count,
+        .extra = (uint32_t *)&data[offsets[CSEXTRA]],
+        .extra_count = header.extra_count,
+        .extra_capacity = header.extra_count,
+        .numbers = (double *)&data[offsets[CSNUMBERS]],
+        .number_count = header.number_count,
+        .number_capacity = header.number_count,
+        .functions = (struct Function *)&data[offsets[CSFUNCTIONS]],
+        .function_count = header.function_count,
+        .function_capacity = header.function_count,
+    };
+
+    *entry = (struct CacheEntry) { .mapping = data, .mapping_length = length };
+
+    return EXIT_SUCCESS;
+}
+
+void cache_entry_free(struct CacheEntry *entry)
+{
+    if (entry->mapping != NULL)
+        munmap(entry->mapping, entry->mapping_length);
+
+    *entry = (struct CacheEntry) {0};
+}
+
+static int write_section(FILE *f, size_t offset, const void *data, size_t size)
+{
+    static const char zeros[CACHE_ALIGNMENT];
+    long at = ftell(f);
+
+    if (at < 0 || (size_t)at > offset || fwrite(zeros, 1, offset - at, f) != offset - at)
+        return EXIT_FAILURE;
+
+    return size == 0 || fwrite(data, 1, size, f) == size ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int cache_store(const char *directory, uint64_t key, const struct SourceFile *source, const struct Interner *interner,
+                const struct TokenBuffer *tokens, const struct Ast *ast)
+{
+    struct CacheHeader header = {
+        .magic = CACHE_MAGIC,
+        .format = CACHE_FORMAT,
+        .symbol_count = interner->count,
+        .key = key,
+        .source_length = source->length,
+        .token_count = tokens->count,
+        .node_count = ast->count,
+        .extra_count = ast->extra_count,
+        .number_count = ast->number_count,
+        .function_count = ast->function_count,
+    };
+    struct CacheSymbol *symbols = calloc(interner->count, sizeof *symbols);
+    size_t offsets[CSMAX];
+    char path[4096], temporary[4096 + 32];
+    int result = EXIT_FAILURE;
+
+    if (symbols == NULL)
+        return EXIT_FAILURE;
+
+    strncpy(header.version, COMPILER_VERSION, sizeof header.version);
+
+    for (uint32_t i = 1; i < interner->count; i++) {
+        symbols[i] = (struct CacheSymbol) { .offset = header.text_length, .length = interner->strings[i].length };
+        header.text_length += interner->strings[i].length;
+    }
+
+    layout(&header, offsets);
+
+    // the directory may well exist already; if it can't be made, fopen fails
+    mkdir(directory, 0777);
+    entry_path(path, sizeof path, directory, key);
+    snprintf(temporary, sizeof temporary, "%s.%ld", path, (long)getpid());
+
+    FILE *f = fopen(temporary, "wb");
+    if (f == NULL) {
+        free(symbols);
+        return EXIT_FAILURE;
+    }
+
+    if (fwrite(&header, sizeof header, 1, f) == 1
+            && write_section(f, offsets[CSNUMBERS], ast->numbers, ast->number_count * sizeof *ast->numbers) == EXIT_SUCCESS
+            && write_section(f, offsets[CSNODES], ast->nodes, ast->count * sizeof *ast->nodes) == EXIT_SUCCESS
+            && write_section(f, offsets[CSFUNCTIONS], ast->functions, ast->function_count * sizeof *ast->functions) == EXIT_SUCCESS
+            && write_section(f, offsets[CSSTARTS], tokens->starts, tokens->count * sizeof *tokens->starts) == EXIT_SUCCESS
+            && write_section(f, offsets[CSLENGTHS], tokens->lengths, tokens->count * sizeof *tokens->lengths) == EXIT_SUCCESS
+            && write_section(f, offsets[CSSYMBOLS], tokens->symbols, tokens->count * sizeof *tokens->symbols) == EXIT_SUCCESS
+            && write_section(f, offsets[CSEXTRA], ast->extra, ast->extra_count * sizeof *ast->extra) == EXIT_SUCCESS
+            && write_section(f, offsets[CSSYMBOLTABLE], symbols, interner->count * sizeof *symbols) == EXIT_SUCCESS
+            && write_section(f, offsets[CSTYPES], tokens->types, tokens->count * sizeof *tokens->types) == EXIT_SUCCESS
+            && write_section(f, offsets[CSSOURCE], source->data, source->length) == EXIT_SUCCESS
+            && write_section(f, offsets[CSTEXT], NULL, 0) == EXIT_SUCCESS)
+        result = EXIT_SUCCESS;
+
+    for (uint32_t i = 1; result == EXIT_SUCCESS && i < interner->count; i++) {
+        struct StringView name = interner->strings[i];
+        if (fwrite(name.data, 1, name.length, f) != name.length)
+            result = EXIT_FAILURE;
+    }
+
+    if (fclose(f) != 0)
+        result = EXIT_FAILURE;
+
+    if (result == EXIT_SUCCESS && rename(temporary, path) != 0)
+        result = EXIT_FAILURE;
+
+    if (result != EXIT_SUCCESS)
+        remove(temporary);
+
+    free(symbols);
+
+    return result;
+}
@@ -0,0 +1,2719 @@
+#include "compile.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Names live in two namespaces, values and types, each an array indexed by
+ * symbol holding the innermost binding of that name.  Bindings are pushed on
+ * one stack and remember the binding they hide, so leaving a scope pops back
+ * to a mark in time proportional to what it declared.  On entering a list of
+ * statements, its interfaces, type aliases and function declarations are
+ * bound first so they can be used before they're declared; variables are
+ * bound as they're reached.  Names that resolve to nothing are taken to be
+ * declared somewhere the checker can't see yet (there are no declaration
+ * files), and are typed any.
+ *
+ * An interface is the type instance of its declaration, which only expands
+ * to the object type of its members when it's compared, so interfaces can
+ * refer to themselves and each other.
+ *
+ * Expressions are evaluated bottom up on an explicit stack, like the parser
+ * builds them, so nesting depth only costs stack entries.  The type of each
+ * expression node is kept in node_types, which also holds the object type
+ * of each interface declaration.
+ *
+ * The bodies of functions reached at the top level are left as tasks until
+ * the top level is done, and then checked as though after it, whether by one
+ * thread or several.  By then every name they can see from outside is bound
+ * and every type they can see from outside is in the table, so checking one
+ * body doesn't affect another.  Each worker gets copies of the bindings and
+ * the type table to add to, and its own diagnostics; the tree, node_types
+ * (whose entries each body writes only for its own nodes) and the interner
+ * are shared.  So that workers never add symbols, bodies are all parsed and
+ * string literals interned before they start.  Diagnostics are merged in
+ * order of token, so the result is the same however the work was shared
+ * out, and so are the types in messages, which never depend on IDs.
+ *
+ * Tasks are handed out as runs of about equal size, and a worker that runs
+ * out steals the back half of another's run.
+ *
+ * Given a CheckState, each use of a top-level name (or of a top-level
+ * interface's members, through expand) is noted against the part of the
+ * statement being checked.  Top-level interfaces are identified by their
+ * name rather than their node, so the types made from them stay the same
+ * when the file is reparsed, and a statement that's skipped can keep its.
+ * A part is skipped where a full check would have checked it, after
+ * replaying its uses against the names bound so far.
+ */
+
+#define CHECK_INITIAL_CAPACITY 256
+#define RELATION_INITIAL_SLOTS 1024
+
+// below this many tokens of function bodies per thread, threads cost more
+// than they save
+#define PARALLEL_MIN_TOKENS (16 * 1024)
+
+// what a binding made inside a function or block has for its statement
+#define NO_DECLARATION UINT32_MAX
+
+// set in the declaration of an instance of a top-level interface, which is
+// its name's symbol; other interfaces are their node
+#define DECLARATION_TOPLEVEL 0x80000000u
+
+// comparisons nested deeper than this are assumed to hold, as expanding
+// recursive types can otherwise go on for ever
+#define RELATION_MAX_DEPTH 100
+
+enum BindingFlags {
+    BFTYPE = 1,         // in the type namespace
+    BFCONSTANT = 2,
+    BFRESOLVING = 4,    // a type alias whose type is being worked out
+    BFTOPLEVEL = 8,
+};
+
+struct Binding {
+    uint32_t symbol;
+    uint32_t type;      // TYPE_NONE while a type alias is unresolved
+    uint32_t node;      // the declaration
+    uint32_t statement; // the top-level statement it's in, or NO_DECLARATION
+    uint32_t shadowed;  // the binding this one hides plus one, or 0
+    uint8_t flags;
+};
+
+enum Relation {
+    RKASSIGNABLE = 0,
+    RKCOMPARABLE,       // either could be the other, as for ===
+};
+
+struct RelationSlot {
+    uint32_t source;    // TYPE_NONE for an empty slot
+    uint32_t target;
+    uint32_t epoch;     // the part it was found in, see Checker.epoch
+    uint8_t relation;
+    bool result;
+};
+
+/* A comparison in progress.  lowest is the depth of the outermost comparison
+ * in progress that this one was assumed to hold for, so if it turns out to
+ * hold, it's only certain once that one does too.
+ */
+struct RelationFrame {
+    uint32_t source;
+    uint32_t target;
+    uint8_t relation;
+    size_t lowest;
+    size_t pending;     // the pending count when it started
+};
+
+struct Visit {
+    uint32_t node;
+    bool expanded;
+};
+
+struct Task {
+    uint32_t function;
+    uint32_t type;      // its signature
+    uint32_t statement; // the top-level statement it was left by
+    uint32_t part;      // 1 + which of the statement's bodies it is
+    uint8_t kind;
+    bool kept;          // skipped, see CheckState
+};
+
+enum StatementProgress {
+    SPWAITING = 0,
+    SPCHECKED,
+    SPKEPT,
+};
+
+/* This run's view of a top-level statement, when there's a CheckState.
+ */
+struct StatementRecord {
+    uint64_t text;
+    uint32_t node;
+    uint32_t first;     // its first token
+    uint32_t previous;  // the last run's statement it matches, or NO_DECLARATION
+    uint32_t type, shape;
+    uint32_t bodies;    // how many bodies it's left so far
+    uint8_t progress;
+};
+
+struct Use {
+    uint32_t statement;
+    struct CheckedUse use;
+};
+
+struct Checker {
+    const struct TokenBuffer *tokens;
+    struct Ast *ast;
+    struct Interner *interner;
+    struct TypeTable *types;
+    struct Diagnostics *diagnostics;
+    size_t error_token;
+    bool failed;
+
+    struct Binding *bindings;
+    size_t binding_count, binding_capacity;
+    uint32_t *names[2];         // values and types: binding index plus one
+    uint32_t *shapes;           // top-level interfaces' members, by name
+    size_t name_capacity;
+
+    uint32_t *node_types;
+    size_t node_capacity;
+    struct Visit *visits;
+    size_t visit_count, visit_capacity;
+    uint32_t *list;             // a stack of type IDs being gathered
+    size_t list_count, list_capacity;
+    struct TypeMember *members;
+    size_t member_count, member_capacity;
+
+    struct RelationSlot *relations;
+    size_t relation_count, relation_slot_count;
+    struct RelationFrame *frames;
+    size_t frame_count, frame_capacity;
+    struct RelationSlot *pending;   // comparisons that held, on assumptions
+    size_t pending_count, pending_capacity;
+
+    uint32_t result;            // the current function's return type, or
+                                // TYPE_NONE if it isn't annotated
+    char *text;                 // where messages are formatted
+    size_t text_length, text_capacity;
+
+    struct Task *tasks;         // bodies left until the top level is done
+    size_t task_count, task_capacity;
+    uint32_t depth;             // how many blocks and functions in
+    bool shared;                // whether other threads are reading too
+
+    const struct CheckState *previous;  // NULL if not keeping a CheckState
+    struct StatementRecord *statements;
+    uint32_t statement, part;   // what uses are noted against
+    struct Use *uses;
+    size_t use_count, use_capacity;
+    size_t checked, kept;
+    uint32_t epoch;             // which part the relation cache is for, as a
+                                // part must note the uses of what it compares
+
+    uint32_t undefined_symbol, array_symbol;
+    uint32_t builtin_symbols[TKNONPRIMITIVE + 1];
+};
+
+static const char *const primitive_names[TKPRIMITIVEMAX] = {
+    [TKANY] = "any",
+    [TKUNKNOWN] = "unknown",
+    [TKNEVER] = "never",
+    [TKVOID] = "void",
+    [TKUNDEFINED] = "undefined",
+    [TKNULL] = "null",
+    [TKBOOLEAN] = "boolean",
+    [TKTRUE] = "true",
+    [TKFALSE] = "false",
+    [TKNUMBER] = "number",
+    [TKSTRING] = "string",
+    [TKBIGINT] = "bigint",
+    [TKSYMBOL] = "symbol",
+    [TKNONPRIMITIVE] = "object",
+};
+
+static uint32_t check_expression(struct Checker *checker, uint32_t root);
+static void add_diagnostic(struct Checker *checker, uint32_t token, const char *text, size_t length);
+static void note_use(struct Checker *checker, uint32_t symbol, uint8_t space);
+static bool keep_statement(struct Checker *checker, uint32_t statement);
+static void check_statement(struct Checker *checker, uint32_t node);
+static uint32_t resolve_type(struct Checker *checker, uint32_t node);
+static bool related(struct Checker *checker, uint32_t source, uint32_t target, uint8_t relation);
+
+static int reserve(struct Checker *checker, void **array, size_t *capacity, size_t needed, size_t size)
+{
+    if (needed <= *capacity)
+        return EXIT_SUCCESS;
+
+    size_t wanted = *capacity ? *capacity : CHECK_INITIAL_CAPACITY;
+    while (wanted < needed)
+        wanted *= 2;
+
+    void *resized = realloc(*array, wanted * size);
+    if (resized == NULL) {
+        checker->failed = true;
+        return EXIT_FAILURE;
+    }
+
+    *array = resized;
+    *capacity = wanted;
+
+    return EXIT_SUCCESS;
+}
+
+static struct Type type_of(const struct Checker *checker, uint32_t type)
+{
+    return checker->types->types[type];
+}
+
+/**The text of a symbol, which for a string literal type is its contents.
+ */
+static struct StringView symbol_text(const struct Checker *checker, uint32_t symbol)
+{
+    return symbol_string(checker->interner, symbol);
+}
+
+static uint32_t intern_text(struct Checker *checker, const char *data, size_t length)
+{
+    uint32_t hash = intern_hash(data, length);
+    uint32_t symbol = checker->shared ? intern_find(checker->interner, data, length, hash)
+                                      : intern(checker->interner, data, length, hash);
+
+    if (symbol == SYMBOL_NONE)
+        checker->failed = true;
+
+    return symbol;
+}
+
+/**The symbol for the property or member named at token.  A keyword, as in
+ * a.default, was given no symbol by the lexer, so its text is looked up.
+ */
+static uint32_t name_symbol(struct Checker *checker, uint32_t token, uint32_t symbol)
+{
+    if (symbol != SYMBOL_NONE || token >= checker->tokens->count)
+        return symbol;
+
+    struct StringView text = token_view(checker->tokens, token);
+
+    return intern_text(checker, text.data, text.length);
+}
+
+/* Messages */
+
+static void append(struct Checker *checker, const char *data, size_t length)
+{
+    if (reserve(checker, (void **)&checker->text, &checker->text_capacity, checker->text_length + length + 1, 1) != EXIT_SUCCESS)
+        return;
+
+    memcpy(&checker->text[checker->text_length], data, length);
+    checker->text_length += length;
+}
+
+static void append_string(struct Checker *checker, const char *string)
+{
+    append(checker, string, strlen(string));
+}
+
+static void append_number(struct Checker *checker, double value)
+{
+    char buffer[32];
+
+    // the shortest that reads back the same
+    for (int precision = 1; precision <= 17; precision++) {
+        snprintf(buffer, sizeof buffer, "%.*g", precision, value);
+        if (strtod(buffer, NULL) == value)
+            break;
+    }
+
+    append_string(checker, buffer);
+}
+
+/**The name a declaration node declares, which is the token after its
+ * keyword.
+ */
+static struct StringView declared_name(const struct Checker *checker, uint32_t declaration)
+{
+    return token_view(checker->tokens, checker->ast->nodes[declaration].token + 1);
+}
+
+static int push_list(struct Checker *checker, uint32_t type);
+
+/**Orders types by their structure rather than their IDs, with null and
+ * undefined last, as they're usually written.
+ */
+static int compare_structure(const struct Checker *checker, uint32_t a, uint32_t b)
+{
+    struct Type x = type_of(checker, a), y = type_of(checker, b);
+    bool x_nullish = a == TKNULL || a == TKUNDEFINED, y_nullish = b == TKNULL || b == TKUNDEFINED;
+
+    if (a == b)
+        return 0;
+    if (x_nullish != y_nullish)
+        return x_nullish - y_nullish;
+    if (x.kind != y.kind)
+        return (x.kind > y.kind) - (x.kind < y.kind);
+
+    switch (x.kind) {
+    case TKSTRINGLITERAL: {
+        struct StringView p = symbol_text(checker, x.a), q = symbol_text(checker, y.a);
+        int order = memcmp(p.data, q.data, p.length < q.length ? p.length : q.length);
+        return order ? order : (p.length > q.length) - (p.length < q.length);
+    }
+    case TKNUMBERLITERAL: {
+        uint64_t p = (uint64_t)x.b << 32 | x.a, q = (uint64_t)y.b << 32 | y.a;
+        double u, v;
+        memcpy(&u, &p, sizeof u);
+        memcpy(&v, &q, sizeof v);
+        return (u > v) - (u < v);
+    }
+    case TKARRAY:
+        return compare_structure(checker, x.a, y.a);
+    case TKPARAMETER:
+        return x.a != y.a ? (x.a > y.a) - (x.a < y.a) : (x.b > y.b) - (x.b < y.b);
+    default:
+        break;
+    }
+
+    if (x.b != y.b)
+        return (x.b > y.b) - (x.b < y.b);
+
+    for (uint32_t i = 0; i < x.b; i++) {
+        uint32_t p = checker->types->extra[x.a + i], q = checker->types->extra[y.a + i];
+        // which entries are types rather than names, counts or nodes
+        bool type = x.kind == TKUNION || (x.kind == TKOBJECT && i % 3 == 1)
+                 || (x.kind == TKFUNCTION && (i == 0 || i > 2)) || (x.kind == TKINSTANCE && i > 0);
+        int order = type ? compare_structure(checker, p, q) : (p > q) - (p < q);
+
+        if (order != 0)
+            return order;
+    }
+
+    return 0;
+}
+
+static void append_type(struct Checker *checker, uint32_t type)
+{
+    struct Type t = type_of(checker, type);
+    const uint32_t *extra = checker->types->extra;
+
+    if (t.kind < TKPRIMITIVEMAX) {
+        append_string(checker, primitive_names[type]);
+        return;
+    }
+
+    switch (t.kind) {
+    case TKSTRINGLITERAL: {
+        struct StringView value = symbol_text(checker, t.a);
+        append(checker, "\"", 1);
+        append(checker, value.data, value.length);
+        append(checker, "\"", 1);
+        break;
+    }
+    case TKNUMBERLITERAL: {
+        uint64_t bits = (uint64_t)t.b << 32 | t.a;
+        double value;
+        memcpy(&value, &bits, sizeof value);
+        append_number(checker, value);
+        break;
+    }
+    case TKARRAY: {
+        uint8_t element = type_of(checker, t.a).kind;
+        bool parenthesise = element == TKUNION || element == TKFUNCTION;
+        append_string(checker, parenthesise ? "(" : "");
+        append_type(checker, t.a);
+        append_string(checker, parenthesise ? ")[]" : "[]");
+        break;
+    }
+    case TKPARAMETER: {
+        struct StringView name = symbol_text(checker, t.a);
+        append(checker, name.data, name.length);
+        break;
+    }
+    case TKUNION: {
+        size_t base = checker->list_count;
+
+        for (uint32_t i = 0; i < t.b; i++)
+            if (push_list(checker, checker->types->extra[t.a + i]) != EXIT_SUCCESS)
+                break;
+
+        // members are kept in order of ID, which isn't the same from one run
+        // to the next when checking in parallel
+        for (size_t i = base + 1; i < checker->list_count; i++) {
+            uint32_t member = checker->list[i];
+            size_t j = i;
+            for (; j > base && compare_structure(checker, checker->list[j - 1], member) > 0; j--)
+                checker->list[j] = checker->list[j - 1];
+            checker->list[j] = member;
+        }
+
+        for (size_t i = base; i < checker->list_count; i++) {
+            append_string(checker, i > base ? " | " : "");
+            append_type(checker, checker->list[i]);
+        }
+
+        checker->list_count = base;
+        break;
+    }
+    case TKOBJECT:
+        append_string(checker, t.b ? "{ " : "{}");
+        for (uint32_t i = 0; i < t.b; i += 3) {
+            struct StringView name = symbol_text(checker, extra[t.a + i]);
+            append_string(checker, i ? "; " : "");
+            append(checker, name.data, name.length);
+            append_string(checker, extra[t.a + i + 2] & TMOPTIONAL ? "?: " : ": ");
+            append_type(checker, extra[t.a + i + 1]);
+            extra = checker->types->extra;
+        }
+        append_string(checker, t.b ? " }" : "");
+        break;
+    case TKFUNCTION:
+        append_string(checker, "(");
+        for (uint32_t i = 3; i < t.b; i++) {
+            append_string(checker, i > 3 ? ", " : "");
+            append_string(checker, extra[t.a + 2] && i == t.b - 1 ? "..." : "");
+            append_type(checker, extra[t.a + i]);
+            extra = checker->types->extra;
+            append_string(checker, i - 3 >= extra[t.a + 1] && !(extra[t.a + 2] && i == t.b - 1) ? "?" : "");
+        }
+        append_string(checker, ") => ");
+        append_type(checker, extra[t.a]);
+        break;
+    case TKINSTANCE: {
+        struct StringView name = extra[t.a] & DECLARATION_TOPLEVEL ? symbol_text(checker, extra[t.a] & ~DECLARATION_TOPLEVEL)
+                                                                    : declared_name(checker, extra[t.a]);
+        append(checker, name.data, name.length);
+        for (uint32_t i = 1; i < t.b; i++) {
+            append_string(checker, i > 1 ? ", " : "<");
+            append_type(checker, extra[t.a + i]);
+            extra = checker->types->extra;
+        }
+        append_string(checker, t.b > 1 ? ">" : "");
+        break;
+    }
+    default:
+        assert(0 && "unreachable");
+    }
+}
+
+/**Reports a diagnostic at a token.  The format takes %T for a type ID, %S
+ * for a symbol, %s for a string and %d for an int.
+ */
+static void report(struct Checker *checker, uint32_t token, const char *format, ...)
+{
+    va_list arguments;
+
+    checker->text_length = 0;
+    va_start(arguments, format);
+
+    for (const char *c = format; *c != '\0'; c++) {
+        if (*c != '%') {
+            append(checker, c, 1);
+            continue;
+        }
+
+        switch (*++c) {
+        case 'T':
+            append_type(checker, va_arg(arguments, uint32_t));
+            break;
+        case 'S': {
+            struct StringView name = symbol_text(checker, va_arg(arguments, uint32_t));
+            append(checker, name.data, name.length);
+            break;
+        }
+        case 's':
+            append_string(checker, va_arg(arguments, const char *));
+            break;
+        case 'd': {
+            char number[16];
+            snprintf(number, sizeof number, "%d", va_arg(arguments, int));
+            append_string(checker, number);
+            break;
+        }
+        default:
+            assert(0 && "unknown format");
+        }
+    }
+
+    va_end(arguments);
+    append(checker, "", 1);
+
+    if (!checker->failed)
+        add_diagnostic(checker, token, checker->text, checker->text_length);
+}
+
+/**Adds a diagnostic whose message is already formatted; length includes the
+ * terminating NUL.
+ */
+static void add_diagnostic(struct Checker *checker, uint32_t token, const char *text, size_t length)
+{
+    struct Diagnostics *diagnostics = checker->diagnostics;
+
+    if (reserve(checker, (void **)&diagnostics->items, &diagnostics->capacity, diagnostics->count + 1, sizeof *diagnostics->items) != EXIT_SUCCESS)
+        return;
+
+    const char *message = arena_copy_text(&diagnostics->text, text, length);
+    if (message == NULL) {
+        checker->failed = true;
+        return;
+    }
+
+    diagnostics->items[diagnostics->count] = (struct Diagnostic) {
+        .token = token,
+        .order = diagnostics->count,
+        .message = message,
+    };
+    diagnostics->count++;
+}
+
+/* Bindings */
+
+static int ensure_names(struct Checker *checker)
+{
+    size_t old = checker->name_capacity, capacity = old;
+    uint32_t **arrays[3] = { &checker->names[0], &checker->names[1], &checker->shapes };
+
+    if (checker->interner->count <= old)
+        return EXIT_SUCCESS;
+
+    for (int i = 0; i < 3; i++) {
+        capacity = old;
+        if (reserve(checker, (void **)arrays[i], &capacity, checker->interner->count, sizeof **arrays[i]) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+        memset(&(*arrays[i])[old], 0, (capacity - old) * sizeof **arrays[i]);
+    }
+
+    checker->name_capacity = capacity;
+
+    return EXIT_SUCCESS;
+}
+
+static uint32_t bind(struct Checker *checker, uint32_t symbol, uint8_t flags, uint32_t type, uint32_t node)
+{
+    if (symbol == SYMBOL_NONE || ensure_names(checker) != EXIT_SUCCESS
+            || reserve(checker, (void **)&checker->bindings, &checker->binding_capacity,
+                       checker->binding_count + 1, sizeof *checker->bindings) != EXIT_SUCCESS)
+        return 0;
+
+    uint32_t *names = checker->names[flags & BFTYPE ? 1 : 0];
+    uint32_t binding = checker->binding_count++;
+    bool top = checker->depth == 0;
+
+    checker->bindings[binding] = (struct Binding) {
+        .symbol = symbol,
+        .type = type,
+        .node = node,
+        .statement = top ? checker->statement : NO_DECLARATION,
+        .shadowed = names[symbol],
+        .flags = flags | (top ? BFTOPLEVEL : 0),
+    };
+    names[symbol] = binding + 1;
+
+    if (top && checker->statements != NULL && checker->statement != NO_DECLARATION)
+        checker->statements[checker->statement].type = type;
+
+    return binding + 1;
+}
+
+static void unbind_to(struct Checker *checker, size_t mark)
+{
+    while (checker->binding_count > mark) {
+        struct Binding b = checker->bindings[--checker->binding_count];
+        checker->names[b.flags & BFTYPE ? 1 : 0][b.symbol] = b.shadowed;
+    }
+}
+
+/**The binding of a name plus one, or 0 if it isn't bound.
+ */
+static uint32_t lookup(const struct Checker *checker, uint32_t symbol, bool type)
+{
+    return symbol != SYMBOL_NONE && symbol < checker->name_capacity ? checker->names[type][symbol] : 0;
+}
+
+/* Per-node types */
+
+static int ensure_nodes(struct Checker *checker)
+{
+    size_t old = checker->node_capacity;
+
+    if (checker->ast->count <= old)
+        return EXIT_SUCCESS;
+
+    if (reserve(checker, (void **)&checker->node_types, &checker->node_capacity, checker->ast->count, sizeof *checker->node_types) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    memset(&checker->node_types[old], 0, (checker->node_capacity - old) * sizeof *checker->node_types);
+
+    return EXIT_SUCCESS;
+}
+
+int push_list(struct Checker *checker, uint32_t type)
+{
+    if (reserve(checker, (void **)&checker->list, &checker->list_capacity, checker->list_count + 1, sizeof *checker->list) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    checker->list[checker->list_count++] = type;
+
+    return EXIT_SUCCESS;
+}
+
+static uint32_t intern_result(struct Checker *checker, uint32_t type)
+{
+    if (type == TYPE_NONE) {
+        checker->failed = true;
+        return TKANY;
+    }
+
+    return type;
+}
+
+/**The union of the types gathered on the list stack from base, which are
+ * popped.
+ */
+static uint32_t union_from(struct Checker *checker, size_t base)
+{
+    uint32_t type = type_union(checker->types, &checker->list[base], checker->list_count - base);
+
+    checker->list_count = base;
+
+    return intern_result(checker, type);
+}
+
+static uint32_t union2(struct Checker *checker, uint32_t a, uint32_t b)
+{
+    uint32_t members[2] = { a, b };
+
+    return a == b ? a : intern_result(checker, type_union(checker->types, members, 2));
+}
+
+/**The type of a literal as something mutable holds it: "a" becomes string,
+ * 1 number and true boolean.
+ */
+static uint32_t widen(struct Checker *checker, uint32_t type)
+{
+    struct Type t = type_of(checker, type);
+
+    switch (t.kind) {
+    case TKSTRINGLITERAL:
+        return TKSTRING;
+    case TKNUMBERLITERAL:
+        return TKNUMBER;
+    case TKTRUE:
+    case TKFALSE:
+        return TKBOOLEAN;
+    case TKUNION: {
+        size_t base = checker->list_count;
+        for (uint32_t i = 0; i < t.b; i++)
+            if (push_list(checker, widen(checker, checker->types->extra[t.a + i])) != EXIT_SUCCESS)
+                break;
+        return union_from(checker, base);
+    }
+    default:
+        return type;
+    }
+}
+
+/**The type without null and undefined.
+ */
+static uint32_t non_nullable(struct Checker *checker, uint32_t type)
+{
+    struct Type t = type_of(checker, type);
+
+    if (type == TKNULL || type == TKUNDEFINED)
+        return TKNEVER;
+
+    if (t.kind != TKUNION)
+        return type;
+
+    size_t base = checker->list_count;
+    for (uint32_t i = 0; i < t.b; i++) {
+        uint32_t member = checker->types->extra[t.a + i];
+        if (member != TKNULL && member != TKUNDEFINED && push_list(checker, member) != EXIT_SUCCESS)
+            break;
+    }
+
+    return union_from(checker, base);
+}
+
+static uint32_t string_literal_type(struct Checker *checker, uint32_t token)
+{
+    struct StringView text = token_view(checker->tokens, token);
+
+    // the quotes aren't part of the value; escapes are kept as written
+    return intern_result(checker, type_string_literal(checker->types, intern_text(checker, text.data + 1, text.length - 2)));
+}
+
+/**The object type of an interface, or of the target of a type instance.
+ */
+static uint32_t expand(struct Checker *checker, uint32_t type)
+{
+    struct Type t = type_of(checker, type);
+
+    if (t.kind != TKINSTANCE)
+        return type;
+
+    uint32_t declaration = checker->types->extra[t.a], shape = TYPE_NONE;
+
+    if (declaration & DECLARATION_TOPLEVEL) {
+        uint32_t symbol = declaration & ~DECLARATION_TOPLEVEL;
+        note_use(checker, symbol, CSSHAPE);
+        shape = symbol < checker->name_capacity ? checker->shapes[symbol] : TYPE_NONE;
+    } else if (declaration < checker->node_capacity) {
+        shape = checker->node_types[declaration];
+    }
+
+    return shape != TYPE_NONE ? shape : TKANY;
+}
+
+/* Annotations */
+
+static uint32_t resolve_alias(struct Checker *checker, uint32_t binding)
+{
+    struct Binding *b = &checker->bindings[binding - 1];
+
+    if (b->type != TYPE_NONE)
+        return b->type;
+
+    struct Node declaration = checker->ast->nodes[b->node];
+
+    if (b->flags & BFRESOLVING) {
+        report(checker, declaration.token + 1, "type alias '%S' circularly references itself", declaration.lhs);
+        return TKANY;
+    }
+
+    uint32_t statement = checker->statement, part = checker->part, top = b->statement, type;
+
+    b->flags |= BFRESOLVING;
+
+    // uses are noted against the alias, wherever it's resolved from
+    if (top != NO_DECLARATION) {
+        checker->statement = top;
+        checker->part = 0;
+    }
+
+    if (top != NO_DECLARATION && keep_statement(checker, top))
+        type = checker->previous->statements[checker->statements[top].previous].type;
+    else
+        type = resolve_type(checker, declaration.rhs);
+
+    checker->statement = statement;
+    checker->part = part;
+
+    // resolving may have bound nothing, but the array may have moved
+    b = &checker->bindings[binding - 1];
+    b->flags &= ~BFRESOLVING;
+    if (b->type == TYPE_NONE)
+        b->type = type;
+    if (top != NO_DECLARATION && checker->statements != NULL)
+        checker->statements[top].type = b->type;
+
+    return b->type;
+}
+
+static uint32_t resolve_reference(struct Checker *checker, struct Node n)
+{
+    uint32_t binding = lookup(checker, n.lhs, true);
+    uint32_t type = binding != 0 ? resolve_alias(checker, binding) : TKANY;
+
+    note_use(checker, n.lhs, CSTYPE);
+
+    for (uint8_t kind = TKANY; kind <= TKNONPRIMITIVE && binding == 0; kind++)
+        if (checker->builtin_symbols[kind] == n.lhs)
+            return kind;
+
+    return type;
+}
+
+/* Keeping statements from the last run */
+
+static void push_use(struct Checker *checker, uint32_t symbol, uint8_t space, uint8_t flags, uint32_t seen)
+{
+    if (reserve(checker, (void **)&checker->uses, &checker->use_capacity, checker->use_count + 1, sizeof *checker->uses) != EXIT_SUCCESS)
+        return;
+
+    checker->uses[checker->use_count++] = (struct Use) {
+        .statement = checker->statement,
+        .use = { .symbol = symbol, .seen = seen, .part = checker->part, .space = space, .flags = flags },
+    };
+}
+
+/**What a top-level name resolves to now, and the flags of its binding.  Only
+ * a type alias still being resolved gives something other than what using it
+ * would.
+ */
+static uint32_t current_use(struct Checker *checker, uint32_t symbol, uint8_t space, uint8_t *flags)
+{
+    *flags = 0;
+
+    if (space == CSSHAPE)
+        return symbol < checker->name_capacity ? checker->shapes[symbol] : TYPE_NONE;
+
+    uint32_t binding = lookup(checker, symbol, space == CSTYPE);
+    if (binding == 0)
+        return TYPE_NONE;
+
+    struct Binding b = checker->bindings[binding - 1];
+    *flags = b.flags & (BFCONSTANT | BFTOPLEVEL);
+
+    if (space == CSVALUE || b.type != TYPE_NONE)
+        return b.type;
+
+    return b.flags & BFRESOLVING ? TKANY : resolve_alias(checker, binding);
+}
+
+/**Notes that the part being checked used a name, unless it's bound inside a
+ * function or block.
+ */
+void note_use(struct Checker *checker, uint32_t symbol, uint8_t space)
+{
+    uint8_t flags;
+
+    if (checker->statements == NULL || checker->statement == NO_DECLARATION || symbol == SYMBOL_NONE)
+        return;
+
+    uint32_t seen = current_use(checker, symbol, space, &flags);
+
+    if (space == CSSHAPE || lookup(checker, symbol, space == CSTYPE) == 0 || (flags & BFTOPLEVEL))
+        push_use(checker, symbol, space, flags & BFCONSTANT, seen);
+}
+
+/**Whether every name a part used last time resolves as it did then.  A use
+ * of no name stands for the signature a body was checked with.
+ */
+static bool uses_unchanged(struct Checker *checker, const struct CheckedStatement *previous, uint32_t part, uint32_t signature)
+{
+    for (uint32_t i = 0; i < previous->use_count; i++) {
+        struct CheckedUse use = checker->previous->uses[previous->uses + i];
+        uint8_t flags = 0;
+
+        if (use.part != part)
+            continue;
+
+        uint32_t seen = use.symbol != SYMBOL_NONE ? current_use(checker, use.symbol, use.space, &flags) : signature;
+        if (seen != use.seen || (flags & BFCONSTANT) != use.flags)
+            return false;
+    }
+
+    return true;
+}
+
+/**Reports again what a statement reported last time, at tokens inside the
+ * range or outside it.
+ */
+static void keep_reports(struct Checker *checker, const struct CheckedStatement *previous, uint32_t first,
+                         uint32_t start, uint32_t end, bool inside)
+{
+    for (uint32_t i = 0; i < previous->report_count && !checker->failed; i++) {
+        struct CheckedReport r = checker->previous->reports[previous->reports + i];
+        uint32_t token = first + r.offset;
+
+        if ((token >= start && token <= end) == inside)
+            add_diagnostic(checker, token, r.message, strlen(r.message) + 1);
+    }
+}
+
+static const struct CheckedStatement *previous_statement(const struct Checker *checker, uint32_t statement)
+{
+    uint32_t previous = checker->statements != NULL ? checker->statements[statement].previous : NO_DECLARATION;
+
+    return previous != NO_DECLARATION ? &checker->previous->statements[previous] : NULL;
+}
+
+/**Whether a top-level statement, not counting the bodies it leaves, can keep
+ * what it did last time.  It's decided when it's first needed, which is
+ * where a full check would check it.  A statement that left bodies is only
+ * kept if it's a function declaration, as otherwise it has to be checked to
+ * leave them again.
+ */
+bool keep_statement(struct Checker *checker, uint32_t statement)
+{
+    if (checker->statements == NULL)
+        return false;
+
+    struct StatementRecord *record = &checker->statements[statement];
+    const struct CheckedStatement *previous = previous_statement(checker, statement);
+
+    if (record->progress != SPWAITING)
+        return record->progress == SPKEPT;
+
+    struct Node n = checker->ast->nodes[record->node];
+    bool function = node_layouts[n.kind] == NLFUNCTION;
+
+    record->progress = SPCHECKED;
+    if (previous != NULL && (previous->bodies == 0 || function) && uses_unchanged(checker, previous, 0, TYPE_NONE)) {
+        struct Function f = function ? checker->ast->functions[n.lhs] : (struct Function) { .body_start = 1 };
+        keep_reports(checker, previous, record->first, f.body_start, f.body_end, false);
+        record->progress = SPKEPT;
+    }
+
+    if (record->progress == SPKEPT)
+        checker->kept++;
+    else
+        checker->checked++;
+
+    return record->progress == SPKEPT;
+}
+
+static int compare_members(const void *a, const void *b)
+{
+    const struct TypeMember *x = a, *y = b;
+    return (x->name > y->name) - (x->name < y->name);
+}
+
+static uint32_t resolve_object(struct Checker *checker, struct Node n)
+{
+    size_t base = checker->member_count, count = n.rhs;
+
+    if (reserve(checker, (void **)&checker->members, &checker->member_capacity, base + count, sizeof *checker->members) != EXIT_SUCCESS)
+        return TKANY;
+
+    for (size_t i = 0; i < count; i++) {
+        struct Node member = checker->ast->nodes[checker->ast->extra[n.lhs + i]];
+        uint32_t type = resolve_type(checker, member.rhs);
+
+        checker->members[checker->member_count++] = (struct TypeMember) {
+            .name = name_symbol(checker, member.token, member.lhs),
+            .type = type,
+            .flags = member.kind == TEOPTIONALMEMBER ? TMOPTIONAL : 0,
+        };
+    }
+
+    struct TypeMember *members = &checker->members[base];
+    size_t unique = 0;
+
+    if (count > 1)
+        qsort(members, count, sizeof *members, compare_members);
+    for (size_t i = 0; i < count; i++) {
+        if (unique > 0 && members[unique - 1].name == members[i].name) {
+            report(checker, n.token, "duplicate member '%S'", members[i].name);
+            continue;
+        }
+        members[unique++] = members[i];
+    }
+
+    uint32_t type = type_object(checker->types, members, unique);
+    checker->member_count = base;
+
+    return intern_result(checker, type);
+}
+
+/**The parameter a parameter node declares, under its annotation and
+ * default value, and the type it's annotated with (or TYPE_NONE).
+ */
+static uint32_t parameter_name(const struct Ast *ast, uint32_t parameter, uint32_t *annotation, bool *optional, bool *rest)
+{
+    struct Node p = ast->nodes[parameter];
+
+    *annotation = NODE_NONE;
+    *optional = *rest = false;
+
+    if (p.kind == TEANNOTATION || p.kind == TEOPTIONAL) {
+        *annotation = p.rhs;
+        *optional = p.kind == TEOPTIONAL;
+        p = ast->nodes[parameter = p.lhs];
+    }
+
+    if (p.kind == ETASSIGN) {
+        *optional = true;
+        p = ast->nodes[parameter = p.lhs];
+    } else if (p.kind == ETSPREAD) {
+        *rest = true;
+        p = ast->nodes[parameter = p.lhs];
+    }
+
+    return parameter;
+}
+
+/**The function type of a list of parameters and a result.
+ */
+static uint32_t signature(struct Checker *checker, uint32_t parameters, uint32_t result)
+{
+    size_t base = checker->list_count, count = checker->ast->extra[parameters], required = count;
+    bool rest = false;
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t annotation;
+        bool optional;
+
+        parameter_name(checker->ast, checker->ast->extra[parameters + 1 + i], &annotation, &optional, &rest);
+
+        uint32_t type = annotation != NODE_NONE ? resolve_type(checker, annotation) : TKANY;
+        if (rest && annotation == NODE_NONE)
+            type = intern_result(checker, type_array(checker->types, TKANY));
+
+        if ((optional || rest) && required == count)
+            required = i;
+
+        if (push_list(checker, type) != EXIT_SUCCESS)
+            break;
+    }
+
+    if (checker->list_count != base + count) {
+        checker->list_count = base;
+        return TKANY;
+    }
+
+    uint32_t type = type_function(checker->types, &checker->list[base], count, required, rest, result);
+    checker->list_count = base;
+
+    return intern_result(checker, type);
+}
+
+uint32_t resolve_type(struct Checker *checker, uint32_t node)
+{
+    struct Ast *ast = checker->ast;
+    struct Node n = ast->nodes[node];
+
+    switch (n.kind) {
+    case TEREFERENCE:
+        return resolve_reference(checker, n);
+    case TEINSTANCE: {
+        struct Node name = ast->nodes[n.lhs];
+        uint32_t arguments = ast->extra[n.rhs];
+
+        note_use(checker, name.lhs, CSTYPE);
+
+        if (name.lhs == checker->array_symbol && lookup(checker, name.lhs, true) == 0 && arguments == 1)
+            return intern_result(checker, type_array(checker->types, resolve_type(checker, ast->extra[n.rhs + 1])));
+
+        if (lookup(checker, name.lhs, true) != 0)
+            report(checker, n.token - 1, "type '%S' is not generic", name.lhs);
+        return TKANY;
+    }
+    case TEARRAY:
+        return intern_result(checker, type_array(checker->types, resolve_type(checker, n.lhs)));
+    case TEUNION: {
+        size_t base = checker->list_count;
+        for (uint32_t i = 0; i < n.rhs; i++)
+            if (push_list(checker, resolve_type(checker, ast->extra[n.lhs + i])) != EXIT_SUCCESS)
+                break;
+        return union_from(checker, base);
+    }
+    case TEOBJECT:
+        return resolve_object(checker, n);
+    case TEFUNCTION:
+        return signature(checker, n.rhs, resolve_type(checker, n.lhs));
+    case TEVOID:
+        return TKVOID;
+    case ETNULL:
+        return TKNULL;
+    case ETBOOLEANLITERAL:
+        return n.lhs ? TKTRUE : TKFALSE;
+    case ETSTRINGLITERAL:
+        return string_literal_type(checker, n.token);
+    case ETNUMERICLITERAL:
+        return n.rhs ? TKBIGINT : intern_result(checker, type_number_literal(checker->types, ast->numbers[n.lhs]));
+    default:
+        return TKANY;
+    }
+}
+
+/* Relations
+ *
+ * Comparisons of primitives are decided on the spot.  Anything structured
+ * goes through the cache, keyed on both types and the relation.  Recursive
+ * types make comparisons that come back round to themselves, and a
+ * comparison already in progress is assumed to hold (if it doesn't, some
+ * other part of the comparison will fail).  A result that relied on such an
+ * assumption is only cached once the comparison it assumed finishes: with
+ * it if that holds, and otherwise it's thrown away.  A failure never relies
+ * on an assumption, so it's always cached.
+ */
+
+static bool is_structured(uint8_t kind)
+{
+    return kind == TKARRAY || type_kind_has_list(kind);
+}
+
+static uint32_t hash_relation(uint32_t source, uint32_t target, uint8_t relation)
+{
+    uint64_t h = ((uint64_t)source << 32 | target) * 0x9e3779b97f4a7c15ull;
+    h ^= h >> 29;
+    h = (h ^ relation) * 0x9e3779b97f4a7c15ull;
+
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+static struct RelationSlot *find_relation(struct Checker *checker, uint32_t source, uint32_t target, uint8_t relation)
+{
+    size_t mask = checker->relation_slot_count - 1;
+    size_t i = hash_relation(source, target, relation) & mask;
+
+    for (; checker->relations[i].source != TYPE_NONE; i = (i + 1) & mask) {
+        struct RelationSlot *slot = &checker->relations[i];
+        if (slot->source == source && slot->target == target && slot->relation == relation)
+            return slot;
+    }
+
+    return &checker->relations[i];
+}
+
+static void cache_relation(struct Checker *checker, struct RelationSlot relation)
+{
+    struct RelationSlot *slot = find_relation(checker, relation.source, relation.target, relation.relation);
+
+    if (slot->source != TYPE_NONE) {
+        slot->result = relation.result;
+        slot->epoch = relation.epoch;
+        return;
+    }
+
+    *slot = relation;
+
+    // keep the load factor at or below a half
+    if (++checker->relation_count * 2 <= checker->relation_slot_count)
+        return;
+
+    struct RelationSlot *old = checker->relations;
+    size_t old_count = checker->relation_slot_count;
+    struct RelationSlot *slots = calloc(old_count * 2, sizeof *slots);
+
+    if (slots == NULL) {
+        checker->failed = true;
+        return;
+    }
+
+    checker->relations = slots;
+    checker->relation_slot_count = old_count * 2;
+
+    for (size_t i = 0; i < old_count; i++)
+        if (old[i].source != TYPE_NONE)
+            *find_relation(checker, old[i].source, old[i].target, old[i].relation) = old[i];
+
+    free(old);
+}
+
+static bool is_object_like(uint8_t kind)
+{
+    return kind == TKOBJECT || kind == TKARRAY || kind == TKFUNCTION || kind == TKINSTANCE || kind == TKNONPRIMITIVE;
+}
+
+/**Compares types that aren't structured, where target isn't any or
+ * unknown and source isn't any or never.
+ */
+static bool primitive_assignable(struct Checker *checker, uint32_t source, uint32_t target)
+{
+    switch (type_of(checker, source).kind) {
+    case TKSTRINGLITERAL:
+        return target == TKSTRING;
+    case TKNUMBERLITERAL:
+        return target == TKNUMBER;
+    case TKTRUE:
+    case TKFALSE:
+        return target == TKBOOLEAN;
+    case TKUNDEFINED:
+        return target == TKVOID;
+    default:
+        return false;
+    }
+}
+
+static bool objects_related(struct Checker *checker, uint32_t source, uint32_t target, uint8_t relation)
+{
+    struct Type s = type_of(checker, source), t = type_of(checker, target);
+    uint32_t i = 0;
+
+    if (s.kind != TKOBJECT) {
+        // arrays and functions only have the properties everything has
+        for (uint32_t j = 0; j < t.b; j += 3)
+            if (!(checker->types->extra[t.a + j + 2] & TMOPTIONAL))
+                return false;
+        return true;
+    }
+
+    // both lists are in order of name, so one pass matches them up
+    for (uint32_t j = 0; j < t.b; j += 3) {
+        const uint32_t *extra = checker->types->extra;
+        uint32_t name = extra[t.a + j], flags = extra[t.a + j + 2];
+
+        while (i < s.b && extra[s.a + i] < name)
+            i += 3;
+
+        if (i >= s.b || extra[s.a + i] != name) {
+            if (!(flags & TMOPTIONAL))
+                return false;
+            continue;
+        }
+
+        if ((extra[s.a + i + 2] & TMOPTIONAL) && !(flags & TMOPTIONAL))
+            return false;
+
+        if (!related(checker, extra[s.a + i + 1], extra[t.a + j + 1], relation))
+            return false;
+    }
+
+    return true;
+}
+
+static bool functions_related(struct Checker *checker, uint32_t source, uint32_t target, uint8_t relation)
+{
+    struct Type s = type_of(checker, source), t = type_of(checker, target);
+    const uint32_t *extra = checker->types->extra;
+    uint32_t s_count = s.b - 3, t_count = t.b - 3;
+
+    // the source can't need more arguments than the target is given
+    if (extra[s.a + 1] > t_count && !extra[t.a + 2])
+        return false;
+
+    // parameters are compared the other way round
+    for (uint32_t i = 0; i < s_count && i < t_count; i++) {
+        extra = checker->types->extra;
+        if (!related(checker, extra[t.a + 3 + i], extra[s.a + 3 + i], relation))
+            return false;
+    }
+
+    extra = checker->types->extra;
+    return extra[t.a] == TKVOID || related(checker, extra[s.a], extra[t.a], relation);
+}
+
+static bool structure_related(struct Checker *checker, uint32_t source, uint32_t target, uint8_t relation)
+{
+    struct Type s = type_of(checker, source), t = type_of(checker, target);
+
+    if (s.kind == TKUNION) {
+        // for assignability every member has to fit, to be comparable one
+        for (uint32_t i = 0; i < s.b; i++) {
+            bool fits = related(checker, checker->types->extra[s.a + i], target, relation);
+            if (fits != (relation == RKASSIGNABLE))
+                return fits;
+        }
+        return relation == RKASSIGNABLE;
+    }
+
+    if (t.kind == TKUNION) {
+        for (uint32_t i = 0; i < t.b; i++)
+            if (related(checker, source, checker->types->extra[t.a + i], relation))
+                return true;
+        return false;
+    }
+
+    if (relation == RKCOMPARABLE)
+        return related(checker, source, target, RKASSIGNABLE) || related(checker, target, source, RKASSIGNABLE);
+
+    if (s.kind == TKINSTANCE || t.kind == TKINSTANCE)
+        return related(checker, expand(checker, source), expand(checker, target), relation);
+
+    if (target == TKNONPRIMITIVE)
+        return is_object_like(s.kind);
+
+    if (s.kind == TKARRAY && t.kind == TKARRAY)
+        return related(checker, s.a, t.a, relation);
+
+    if (s.kind == TKFUNCTION && t.kind == TKFUNCTION)
+        return functions_related(checker, source, target, relation);
+
+    if (t.kind == TKOBJECT && is_object_like(s.kind))
+        return objects_related(checker, source, target, relation);
+
+    return false;
+}
+
+bool related(struct Checker *checker, uint32_t source, uint32_t target, uint8_t relation)
+{
+    if (source == target || target == TKANY || target == TKUNKNOWN || source == TKNEVER)
+        return true;
+
+    if (source == TKANY)
+        return target != TKNEVER;
+
+    struct Type s = type_of(checker, source), t = type_of(checker, target);
+
+    if (!is_structured(s.kind) && !is_structured(t.kind)) {
+        if (relation == RKCOMPARABLE && (source == TKUNKNOWN || target == TKNEVER))
+            return true;
+        return primitive_assignable(checker, source, target)
+            || (relation == RKCOMPARABLE && primitive_assignable(checker, target, source));
+    }
+
+    struct RelationSlot *slot = find_relation(checker, source, target, relation);
+    if (slot->source != TYPE_NONE && slot->epoch == checker->epoch)
+        return slot->result;
+
+    // a comparison that comes back round to one in progress
+    for (size_t i = checker->frame_count; i-- > 0; ) {
+        struct RelationFrame *frame = &checker->frames[i];
+
+        if (frame->source == source && frame->target == target && frame->relation == relation) {
+            struct RelationFrame *top = &checker->frames[checker->frame_count - 1];
+            if (i < top->lowest)
+                top->lowest = i;
+            return true;
+        }
+    }
+
+    if (checker->frame_count >= RELATION_MAX_DEPTH) {
+        checker->frames[checker->frame_count - 1].lowest = 0;
+        return true;
+    }
+
+    if (reserve(checker, (void **)&checker->frames, &checker->frame_capacity, checker->frame_count + 1, sizeof *checker->frames) != EXIT_SUCCESS)
+        return true;
+
+    size_t depth = checker->frame_count++;
+    checker->frames[depth] = (struct RelationFrame) {
+        .source = source,
+        .target = target,
+        .relation = relation,
+        .lowest = depth,
+        .pending = checker->pending_count,
+    };
+
+    bool result = structure_related(checker, source, target, relation);
+    struct RelationFrame frame = checker->frames[--checker->frame_count];
+    struct RelationSlot answer = {
+        .source = source,
+        .target = target,
+        .epoch = checker->epoch,
+        .relation = relation,
+        .result = result,
+    };
+
+    if (result && frame.lowest < depth) {
+        // only as good as an assumption further out
+        struct RelationFrame *outer = &checker->frames[depth - 1];
+        if (frame.lowest < outer->lowest)
+            outer->lowest = frame.lowest;
+
+        if (reserve(checker, (void **)&checker->pending, &checker->pending_capacity, checker->pending_count + 1, sizeof *checker->pending) == EXIT_SUCCESS)
+            checker->pending[checker->pending_count++] = answer;
+        return result;
+    }
+
+    // everything this one assumed is settled, one way or the other
+    if (result)
+        for (size_t i = frame.pending; i < checker->pending_count; i++)
+            cache_relation(checker, checker->pending[i]);
+
+    checker->pending_count = frame.pending;
+    cache_relation(checker, answer);
+
+    return result;
+}
+
+static void check_assignable(struct Checker *checker, uint32_t source, uint32_t target, uint32_t token)
+{
+    if (!related(checker, source, target, RKASSIGNABLE))
+        report(checker, token, "type '%T' is not assignable to type '%T'", source, target);
+}
+
+/* Expressions */
+
+/**The type of a property, or TYPE_NONE if the type doesn't have it.
+ */
+static uint32_t property_type(struct Checker *checker, uint32_t type, uint32_t name, uint32_t token)
+{
+    struct Type t = type_of(checker, expand(checker, type));
+
+    switch (t.kind) {
+    case TKOBJECT: {
+        // members are in order of name
+        uint32_t low = 0, high = t.b / 3;
+
+        while (low < high) {
+            uint32_t middle = (low + high) / 2;
+            const uint32_t *member = &checker->types->extra[t.a + middle * 3];
+
+            if (member[0] == name)
+                return member[2] & TMOPTIONAL ? union2(checker, member[1], TKUNDEFINED) : member[1];
+
+            if (member[0] < name)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        return TYPE_NONE;
+    }
+    case TKUNION: {
+        size_t base = checker->list_count;
+
+        for (uint32_t i = 0; i < t.b; i++) {
+            uint32_t member = checker->types->extra[t.a + i];
+
+            if (member == TKNULL || member == TKUNDEFINED) {
+                report(checker, token, "object is possibly '%T'", member);
+                continue;
+            }
+
+            uint32_t property = property_type(checker, member, name, token);
+            if (property == TYPE_NONE) {
+                checker->list_count = base;
+                return TYPE_NONE;
+            }
+
+            if (push_list(checker, property) != EXIT_SUCCESS)
+                break;
+        }
+
+        return union_from(checker, base);
+    }
+    case TKNULL:
+    case TKUNDEFINED:
+        report(checker, token, "object is possibly '%T'", type);
+        return TKANY;
+    default:
+        // without declarations for the built-in objects, anything goes
+        return TKANY;
+    }
+}
+
+static bool is_arithmetic(struct Checker *checker, uint32_t type)
+{
+    struct Type t = type_of(checker, type);
+
+    if (t.kind == TKUNION) {
+        for (uint32_t i = 0; i < t.b; i++)
+            if (!is_arithmetic(checker, checker->types->extra[t.a + i]))
+                return false;
+        return true;
+    }
+
+    return type == TKANY || type == TKNUMBER || type == TKBIGINT || t.kind == TKNUMBERLITERAL;
+}
+
+static bool is_string(struct Checker *checker, uint32_t type)
+{
+    return type == TKSTRING || type_of(checker, type).kind == TKSTRINGLITERAL;
+}
+
+static void check_arithmetic(struct Checker *checker, uint32_t type, uint32_t token)
+{
+    if (!is_arithmetic(checker, type))
+        report(checker, token, "an arithmetic operand must be of type 'any', 'number' or 'bigint', not '%T'", type);
+}
+
+/**The type of a + b, checking that the operator applies.
+ */
+static uint32_t addition_type(struct Checker *checker, uint32_t a, uint32_t b, uint32_t token)
+{
+    if (is_string(checker, a) || is_string(checker, b))
+        return TKSTRING;
+
+    if (a == TKANY || b == TKANY)
+        return TKANY;
+
+    if (is_arithmetic(checker, a) && is_arithmetic(checker, b))
+        return a == TKBIGINT && b == TKBIGINT ? TKBIGINT : TKNUMBER;
+
+    report(checker, token, "operator '+' cannot be applied to types '%T' and '%T'", a, b);
+    return TKANY;
+}
+
+/**Reports an assignment to a constant, returning whether it was one.
+ */
+static bool check_constant_target(struct Checker *checker, uint32_t target)
+{
+    struct Node n = checker->ast->nodes[target];
+
+    if (n.kind != ETIDENTIFIER)
+        return false;
+
+    uint32_t binding = lookup(checker, n.lhs, false);
+    if (binding == 0 || !(checker->bindings[binding - 1].flags & BFCONSTANT))
+        return false;
+
+    report(checker, n.token, "cannot assign to '%S' because it is a constant", n.lhs);
+    return true;
+}
+
+static uint32_t call_type(struct Checker *checker, struct Node n)
+{
+    const struct Ast *ast = checker->ast;
+    uint32_t callee = checker->node_types[n.lhs], count = ast->extra[n.rhs];
+    struct Type f = type_of(checker, callee);
+
+    if (callee == TKANY || f.kind != TKFUNCTION) {
+        if (callee != TKANY && f.kind != TKINSTANCE && f.kind != TKUNION && f.kind < TKPRIMITIVEMAX)
+            report(checker, n.token, "this expression is not callable: type '%T' has no call signatures", callee);
+        return TKANY;
+    }
+
+    const uint32_t *extra = checker->types->extra;
+    uint32_t parameters = f.b - 3, required = extra[f.a + 1];
+    bool rest = extra[f.a + 2];
+
+    for (uint32_t i = 0; i < count; i++)
+        if (ast->nodes[ast->extra[n.rhs + 1 + i]].kind == ETSPREAD)
+            return extra[f.a]; // the count isn't known
+
+    if (count < required || (!rest && count > parameters)) {
+        if (rest || required < parameters)
+            report(checker, n.token, count < required ? "expected at least %d arguments, but got %d"
+                   : "expected at most %d arguments, but got %d", count < required ? (int)required : (int)parameters, (int)count);
+        else
+            report(checker, n.token, "expected %d arguments, but got %d", (int)parameters, (int)count);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t argument = ast->extra[n.rhs + 1 + i], parameter;
+
+        extra = checker->types->extra;
+        if (rest && i + 1 >= parameters) {
+            struct Type array = type_of(checker, extra[f.a + 3 + parameters - 1]);
+            parameter = array.kind == TKARRAY ? array.a : TKANY;
+        } else if (i < parameters) {
+            parameter = extra[f.a + 3 + i];
+        } else {
+            break;
+        }
+
+        check_assignable(checker, checker->node_types[argument], parameter, ast->nodes[argument].token);
+    }
+
+    return checker->types->extra[f.a];
+}
+
+static uint32_t object_type(struct Checker *checker, struct Node n)
+{
+    const struct Ast *ast = checker->ast;
+    size_t base = checker->member_count;
+
+    if (reserve(checker, (void **)&checker->members, &checker->member_capacity, base + n.rhs, sizeof *checker->members) != EXIT_SUCCESS)
+        return TKANY;
+
+    for (uint32_t i = 0; i < n.rhs; i++) {
+        uint32_t property = ast->extra[n.lhs + i];
+        struct Node p = ast->nodes[property], key = ast->nodes[p.lhs];
+        uint32_t name;
+
+        bool named = (p.kind == ETPROPERTYINIT || p.kind == ETGETTER || p.kind == ETSETTER)
+                  && token_type(checker->tokens, p.token) != TTOPENBRACKET;
+
+        if (p.kind == ETIDENTIFIER) {
+            name = p.lhs; // shorthand
+        } else if (named && key.kind == ETIDENTIFIER) {
+            name = name_symbol(checker, key.token, key.lhs);
+        } else if (named && key.kind == ETSTRINGLITERAL) {
+            struct StringView text = token_view(checker->tokens, key.token);
+            name = intern_text(checker, text.data + 1, text.length - 2);
+        } else {
+            // spreads and computed keys could add anything
+            checker->member_count = base;
+            return TKANY;
+        }
+
+        if (name == SYMBOL_NONE) {
+            checker->member_count = base;
+            return TKANY;
+        }
+
+        checker->members[checker->member_count++] = (struct TypeMember) {
+            .name = name,
+            .type = widen(checker, checker->node_types[property]),
+        };
+    }
+
+    // a later property with the same name replaces an earlier one
+    struct TypeMember *members = &checker->members[base];
+    size_t count = n.rhs, unique = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t j = 0;
+        while (j < unique && members[j].name != members[i].name)
+            ++j;
+        members[j] = members[i];
+        if (j == unique)
+            ++unique;
+    }
+
+    uint32_t type = type_object(checker->types, members, unique);
+    checker->member_count = base;
+
+    return intern_result(checker, type);
+}
+
+static uint32_t check_function(struct Checker *checker, uint32_t function, uint32_t type, uint8_t kind);
+
+/**Works out a node's type from its children's, which are already known.
+ */
+static uint32_t expression_type(struct Checker *checker, uint32_t node)
+{
+    const struct Ast *ast = checker->ast;
+    struct Node n = ast->nodes[node];
+    const uint32_t *types = checker->node_types;
+    uint8_t layout = node_layouts[n.kind];
+    bool operand = layout == NLUNARY || layout == NLBINARY || layout == NLMEMBER || layout == NLTERNARY || layout == NLCALL;
+    uint32_t lhs = operand ? types[n.lhs] : TYPE_NONE;
+    uint32_t rhs = layout == NLBINARY ? types[n.rhs] : TYPE_NONE;
+
+    switch (n.kind) {
+    case ETNUMERICLITERAL:
+        return n.rhs ? TKBIGINT : intern_result(checker, type_number_literal(checker->types, ast->numbers[n.lhs]));
+    case ETSTRINGLITERAL:
+        return string_literal_type(checker, n.token);
+    case ETBOOLEANLITERAL:
+        return n.lhs ? TKTRUE : TKFALSE;
+    case ETNULL:
+        return TKNULL;
+    case ETIDENTIFIER: {
+        uint32_t binding = lookup(checker, n.lhs, false);
+        note_use(checker, n.lhs, CSVALUE);
+        if (binding != 0)
+            return checker->bindings[binding - 1].type;
+        return n.lhs == checker->undefined_symbol ? TKUNDEFINED : TKANY;
+    }
+    case ETGROUP:
+    case ETCOMMA:
+        return n.kind == ETGROUP ? lhs : rhs;
+    case ETTYPEOF:
+        return TKSTRING;
+    case ETVOID:
+        return TKUNDEFINED;
+    case ETDELETE:
+    case ETLOGICNOT:
+    case ETLESS:
+    case ETLESSEQUAL:
+    case ETGREATER:
+    case ETGREATEREQUAL:
+    case ETIN:
+    case ETINSTANCEOF:
+        return TKBOOLEAN;
+    case ETEQUAL:
+    case ETINEQUAL:
+    case ETSTRICTEQUAL:
+    case ETSTRICTINEQUAL:
+        if (!related(checker, lhs, rhs, RKCOMPARABLE))
+            report(checker, n.token, "this comparison appears to be unintentional because the types '%T' and '%T' have no overlap", lhs, rhs);
+        return TKBOOLEAN;
+    case ETUNARYPLUS:
+        return TKNUMBER;
+    case ETUNARYNEGATE:
+    case ETBITNOT:
+        check_arithmetic(checker, lhs, n.token);
+        return lhs == TKBIGINT ? TKBIGINT : TKNUMBER;
+    case ETINCREMENT:
+    case ETDECREMENT:
+        check_arithmetic(checker, lhs, n.token);
+        check_constant_target(checker, n.lhs);
+        return lhs == TKBIGINT ? TKBIGINT : TKNUMBER;
+    case ETSUBTRACT:
+    case ETMULTIPLY:
+    case ETDIVISION:
+    case ETREMAINDER:
+    case ETEXPONENT:
+    case ETLEFTSHIFT:
+    case ETRIGHTSHIFT:
+    case ETUNSIGNEDRIGHTSHIFT:
+    case ETBITAND:
+    case ETBITOR:
+    case ETBITXOR:
+        check_arithmetic(checker, lhs, n.token);
+        check_arithmetic(checker, rhs, n.token);
+        return lhs == TKBIGINT && rhs == TKBIGINT ? TKBIGINT : TKNUMBER;
+    case ETADDITION:
+        return addition_type(checker, lhs, rhs, n.token);
+    case ETLOGICAND:
+    case ETLOGICOR:
+        return union2(checker, lhs, rhs);
+    case ETNULLCOALESCE:
+        return union2(checker, non_nullable(checker, lhs), rhs);
+    case ETTERNARY:
+        return union2(checker, types[ast->extra[n.rhs]], types[ast->extra[n.rhs + 1]]);
+    case ETASSIGN:
+    case ETLOGICANDASSIGN:
+    case ETLOGICORASSIGN:
+    case ETNULLCOALESCEASSIGN:
+        if (!check_constant_target(checker, n.lhs))
+            check_assignable(checker, rhs, lhs, ast->nodes[n.rhs].token);
+        return rhs;
+    case ETADDITIONASSIGN:
+        if (!check_constant_target(checker, n.lhs))
+            check_assignable(checker, addition_type(checker, lhs, rhs, n.token), lhs, n.token);
+        return lhs;
+    case ETSUBTRACTASSIGN:
+    case ETMULTIPLYASSIGN:
+    case ETDIVISIONASSIGN:
+    case ETREMAINDERASSIGN:
+    case ETEXPONENTASSIGN:
+    case ETLEFTSHIFTASSIGN:
+    case ETRIGHTSHIFTASSIGN:
+    case ETUNSIGNEDRIGHTSHIFTASSIGN:
+    case ETBITANDASSIGN:
+    case ETBITORASSIGN:
+    case ETBITXORASSIGN:
+        check_constant_target(checker, n.lhs);
+        check_arithmetic(checker, lhs, n.token);
+        check_arithmetic(checker, rhs, n.token);
+        return lhs;
+    case ETDESTRUCTUREASSIGN:
+        return rhs;
+    case ETPROPERTYACCESS: {
+        uint32_t name = name_symbol(checker, n.token + 1, n.rhs);
+        uint32_t type = property_type(checker, lhs, name, n.token + 1);
+        if (type == TYPE_NONE) {
+            report(checker, n.token + 1, "property '%S' does not exist on type '%T'", name, lhs);
+            return TKANY;
+        }
+        return type;
+    }
+    case ETOPTIONALCHAIN:
+        return non_nullable(checker, lhs);
+    case ETINDEX: {
+        struct Type object = type_of(checker, lhs);
+        if (object.kind == TKARRAY)
+            return object.a;
+        return is_string(checker, lhs) ? TKSTRING : TKANY;
+    }
+    case ETCALL:
+        return call_type(checker, n);
+    case ETSPREAD:
+        return lhs;
+    case ETARRAYINIT: {
+        size_t base = checker->list_count;
+
+        if (n.rhs == 0)
+            return intern_result(checker, type_array(checker->types, TKANY));
+
+        for (uint32_t i = 0; i < n.rhs; i++) {
+            uint32_t element = ast->extra[n.lhs + i], type = TKUNDEFINED;
+
+            if (element != NODE_NONE) {
+                struct Type t = type_of(checker, types[element]);
+                type = ast->nodes[element].kind != ETSPREAD ? types[element] : t.kind == TKARRAY ? t.a : TKANY;
+            }
+            if (push_list(checker, widen(checker, type)) != EXIT_SUCCESS)
+                break;
+            types = checker->node_types;
+        }
+
+        return intern_result(checker, type_array(checker->types, union_from(checker, base)));
+    }
+    case ETOBJECTINIT:
+        return object_type(checker, n);
+    case ETPROPERTYINIT:
+        return rhs;
+    case ETGETTER:
+    case ETSETTER: {
+        // the property has the type the getter returns or the setter takes
+        struct Type f = type_of(checker, rhs);
+        if (f.kind != TKFUNCTION)
+            return TKANY;
+        return checker->types->extra[n.kind == ETGETTER ? f.a : f.a + 3];
+    }
+    case ETFUNCTION:
+    case ETGENFUNCTION:
+    case ETASYNCFUNCTION:
+    case ETASYNCGENFUNCTION:
+    case ETARROWFUNCTION: {
+        struct Function f = ast->functions[n.lhs];
+        uint32_t type = signature(checker, f.parameters, f.result != NODE_NONE ? resolve_type(checker, f.result) : TKANY);
+        return check_function(checker, n.lhs, type, n.kind);
+    }
+    default:
+        // this, super, new, await, yield, import, classes...
+        return TKANY;
+    }
+}
+
+static int push_visit(struct Checker *checker, uint32_t node)
+{
+    if (node == NODE_NONE)
+        return EXIT_SUCCESS;
+
+    if (reserve(checker, (void **)&checker->visits, &checker->visit_capacity, checker->visit_count + 1, sizeof *checker->visits) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    checker->visits[checker->visit_count++] = (struct Visit) { .node = node };
+
+    return EXIT_SUCCESS;
+}
+
+/**Pushes a node's operands, last first so the first is worked out first.
+ */
+static int push_operands(struct Checker *checker, struct Node n)
+{
+    const uint32_t *extra = checker->ast->extra;
+    int result = EXIT_SUCCESS;
+
+    switch (node_layouts[n.kind]) {
+    case NLUNARY:
+    case NLMEMBER:
+        return push_visit(checker, n.lhs);
+    case NLBINARY:
+        return push_visit(checker, n.rhs) == EXIT_SUCCESS ? push_visit(checker, n.lhs) : EXIT_FAILURE;
+    case NLTERNARY:
+        result |= push_visit(checker, extra[n.rhs + 1]);
+        result |= push_visit(checker, extra[n.rhs]);
+        return result | push_visit(checker, n.lhs);
+    case NLCALL:
+        for (uint32_t i = extra[n.rhs]; i > 0; i--)
+            result |= push_visit(checker, checker->ast->extra[n.rhs + i]);
+        return result | push_visit(checker, n.lhs);
+    case NLLIST:
+        for (uint32_t i = n.rhs; i > 0; i--)
+            result |= push_visit(checker, checker->ast->extra[n.lhs + i - 1]);
+        return result;
+    default:
+        // leaves, and functions, which check their own bodies
+        return EXIT_SUCCESS;
+    }
+}
+
+uint32_t check_expression(struct Checker *checker, uint32_t root)
+{
+    size_t base = checker->visit_count;
+
+    if (push_visit(checker, root) != EXIT_SUCCESS)
+        return TKANY;
+
+    while (checker->visit_count > base && !checker->failed) {
+        struct Visit *visit = &checker->visits[checker->visit_count - 1];
+        uint32_t node = visit->node;
+
+        if (!visit->expanded) {
+            visit->expanded = true;
+            push_operands(checker, checker->ast->nodes[node]);
+            continue;
+        }
+
+        --checker->visit_count;
+
+        // a function's body may have been parsed, adding nodes
+        uint32_t type = expression_type(checker, node);
+        if (ensure_nodes(checker) == EXIT_SUCCESS)
+            checker->node_types[node] = type;
+    }
+
+    checker->visit_count = base;
+
+    return checker->failed ? TKANY : checker->node_types[root];
+}
+
+/* Statements */
+
+/**Whether a declaration names an object type, which like an interface can
+ * refer to itself.
+ */
+static bool declares_shape(const struct Ast *ast, struct Node n)
+{
+    return n.kind == SDINTERFACE || (n.kind == SDTYPEALIAS && ast->nodes[n.rhs].kind == TEOBJECT);
+}
+
+static void declare_statements(struct Checker *checker, uint32_t start, uint32_t count)
+{
+    const struct Ast *ast = checker->ast;
+    bool top = checker->depth == 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t statement = ast->extra[start + i];
+        struct Node n = ast->nodes[statement];
+        uint32_t declaration = top ? DECLARATION_TOPLEVEL | n.lhs : statement;
+
+        checker->statement = top ? i : checker->statement;
+
+        if (declares_shape(ast, n))
+            bind(checker, n.lhs, BFTYPE, intern_result(checker, type_instance(checker->types, declaration, NULL, 0)), statement);
+        else if (n.kind == SDTYPEALIAS)
+            bind(checker, n.lhs, BFTYPE, TYPE_NONE, statement);
+        else if (node_layouts[n.kind] == NLFUNCTION)
+            bind(checker, ast->functions[n.lhs].name, 0, TKANY, statement);
+    }
+
+    // aliases first, as interfaces' members and signatures may use them
+    for (uint32_t i = 0; i < count; i++) {
+        struct Node n = ast->nodes[ast->extra[start + i]];
+        if (n.kind == SDTYPEALIAS && !declares_shape(ast, n))
+            resolve_alias(checker, lookup(checker, n.lhs, true));
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t statement = ast->extra[start + i];
+        struct Node n = ast->nodes[statement];
+        bool shape = declares_shape(ast, n), function = node_layouts[n.kind] == NLFUNCTION;
+
+        if (!shape && !function)
+            continue;
+
+        checker->statement = top ? i : checker->statement;
+        checker->part = 0;
+
+        const struct CheckedStatement *previous = top && keep_statement(checker, i) ? previous_statement(checker, i) : NULL;
+
+        if (shape) {
+            uint32_t members = previous != NULL ? previous->shape : resolve_type(checker, n.rhs);
+
+            if (ensure_nodes(checker) == EXIT_SUCCESS)
+                checker->node_types[statement] = members;
+            if (top)
+                checker->shapes[n.lhs] = members;
+            if (top && checker->statements != NULL)
+                checker->statements[i].shape = members;
+        } else {
+            struct Function f = ast->functions[n.lhs];
+            uint32_t binding = lookup(checker, f.name, false);
+            uint32_t type = previous != NULL ? previous->type
+                          : signature(checker, f.parameters, f.result != NODE_NONE ? resolve_type(checker, f.result) : TKANY);
+
+            if (binding != 0 && checker->bindings[binding - 1].node == statement)
+                checker->bindings[binding - 1].type = type;
+            if (top && checker->statements != NULL)
+                checker->statements[i].type = type;
+        }
+    }
+}
+
+static void check_statements(struct Checker *checker, uint32_t start, uint32_t count)
+{
+    declare_statements(checker, start, count);
+
+    for (uint32_t i = 0; i < count && !checker->failed; i++)
+        check_statement(checker, checker->ast->extra[start + i]);
+}
+
+/**Checks the file's statements, keeping what it can from the last run.
+ */
+static void check_top_level(struct Checker *checker)
+{
+    const struct Ast *ast = checker->ast;
+    struct Node root = ast->nodes[0];
+
+    declare_statements(checker, root.lhs, root.rhs);
+
+    for (uint32_t i = 0; i < root.rhs && !checker->failed; i++) {
+        uint32_t statement = ast->extra[root.lhs + i];
+        struct Node n = ast->nodes[statement];
+        bool declared = declares_shape(ast, n) || n.kind == SDTYPEALIAS || node_layouts[n.kind] == NLFUNCTION;
+
+        checker->statement = i;
+        checker->part = 0;
+        checker->epoch += checker->statements != NULL;
+
+        if (declared || !keep_statement(checker, i))
+            check_statement(checker, statement);
+        else if (n.kind == SDLET || n.kind == SDCONST || n.kind == SDVAR)
+            bind(checker, n.lhs, n.kind == SDCONST ? BFCONSTANT : 0, previous_statement(checker, i)->type, statement);
+    }
+}
+
+/**Checks a function's body, with its parameters bound, and returns its
+ * type.  An arrow function's expression body gives its result type, unless
+ * one was declared.
+ */
+static uint32_t check_body(struct Checker *checker, uint32_t function, uint32_t type, uint8_t kind)
+{
+    struct Ast *ast = checker->ast;
+    struct Function f = ast->functions[function];
+    size_t mark = checker->binding_count;
+    uint32_t result = checker->result;
+
+    if (f.body == NODE_NONE && f.body_end != 0) {
+        if (parse_function_body(checker->tokens, ast, function, &checker->error_token) != EXIT_SUCCESS) {
+            checker->failed = true;
+            return TKANY;
+        }
+        if (ensure_nodes(checker) != EXIT_SUCCESS)
+            return TKANY;
+        f = ast->functions[function];
+    }
+
+    struct Type t = type_of(checker, type);
+
+    ++checker->depth;
+
+    for (uint32_t i = 0; i < ast->extra[f.parameters] && t.kind == TKFUNCTION; i++) {
+        uint32_t annotation;
+        bool optional, rest;
+        struct Node name = ast->nodes[parameter_name(ast, ast->extra[f.parameters + 1 + i], &annotation, &optional, &rest)];
+        uint32_t parameter = checker->types->extra[t.a + 3 + i];
+
+        // destructuring patterns don't bind anything yet
+        if (name.kind == ETIDENTIFIER)
+            bind(checker, name.lhs, 0, optional && annotation != NODE_NONE ? union2(checker, parameter, TKUNDEFINED) : parameter, NODE_NONE);
+    }
+
+    // the results of async functions and generators are wrapped
+    bool plain = kind == SDFUNCTION || kind == ETFUNCTION || kind == ETARROWFUNCTION;
+    checker->result = f.result != NODE_NONE && plain ? checker->types->extra[t.a] : TYPE_NONE;
+
+    if (f.body != NODE_NONE && ast->nodes[f.body].kind == SDBLOCK) {
+        struct Node body = ast->nodes[f.body];
+        check_statements(checker, body.lhs, body.rhs);
+    } else if (f.body != NODE_NONE) {
+        uint32_t value = check_expression(checker, f.body);
+
+        // a declared result stands; the body is only checked against it
+        if (checker->result != TYPE_NONE)
+            check_assignable(checker, value, checker->result, ast->nodes[f.body].token);
+        else
+            type = signature(checker, f.parameters, widen(checker, value));
+    }
+
+    --checker->depth;
+    unbind_to(checker, mark);
+    checker->result = result;
+
+    return type;
+}
+
+/**Checks a function's body now, or for one with a block body at the top
+ * level, leaves it as a task for later.
+ */
+uint32_t check_function(struct Checker *checker, uint32_t function, uint32_t type, uint8_t kind)
+{
+    struct Function f = checker->ast->functions[function];
+    bool block = f.body != NODE_NONE ? checker->ast->nodes[f.body].kind == SDBLOCK : f.body_end != 0;
+
+    if (!block || checker->depth > 0)
+        return check_body(checker, function, type, kind);
+
+    if (reserve(checker, (void **)&checker->tasks, &checker->task_capacity, checker->task_count + 1, sizeof *checker->tasks) != EXIT_SUCCESS)
+        return type;
+
+    checker->tasks[checker->task_count++] = (struct Task) {
+        .function = function,
+        .type = type,
+        .statement = checker->statement,
+        .part = checker->statements != NULL ? ++checker->statements[checker->statement].bodies : 0,
+        .kind = kind,
+    };
+
+    return type;
+}
+
+void check_statement(struct Checker *checker, uint32_t node)
+{
+    struct Ast *ast = checker->ast;
+    struct Node n = ast->nodes[node];
+
+    switch (n.kind) {
+    case SDLET:
+    case SDCONST:
+    case SDVAR: {
+        uint32_t initialiser = n.rhs, annotation = TYPE_NONE, type = TKANY;
+
+        if (initialiser != NODE_NONE && ast->nodes[initialiser].kind == TEANNOTATION) {
+            struct Node typed = ast->nodes[initialiser];
+            annotation = resolve_type(checker, typed.rhs);
+            initialiser = typed.lhs;
+        }
+
+        if (initialiser != NODE_NONE) {
+            type = check_expression(checker, initialiser);
+            if (annotation != TYPE_NONE)
+                check_assignable(checker, type, annotation, ast->nodes[initialiser].token);
+            else if (n.kind != SDCONST)
+                type = widen(checker, type);
+        }
+
+        bind(checker, n.lhs, n.kind == SDCONST ? BFCONSTANT : 0, annotation != TYPE_NONE ? annotation : type, node);
+        break;
+    }
+    case SDEXPRSTATEMENT:
+        check_expression(checker, n.lhs);
+        break;
+    case SDRETURN: {
+        uint32_t type = n.lhs != NODE_NONE ? check_expression(checker, n.lhs) : TKUNDEFINED;
+        if (checker->result != TYPE_NONE)
+            check_assignable(checker, type, checker->result, n.lhs != NODE_NONE ? ast->nodes[n.lhs].token : n.token);
+        break;
+    }
+    case SDBLOCK: {
+        size_t mark = checker->binding_count;
+        ++checker->depth;
+        check_statements(checker, n.lhs, n.rhs);
+        --checker->depth;
+        unbind_to(checker, mark);
+        break;
+    }
+    case SDFUNCTION:
+    case SDGENFUNCTION:
+    case SDASYNCFUNCTION:
+    case SDASYNCGENFUNCTION: {
+        uint32_t binding = lookup(checker, ast->functions[n.lhs].name, false);
+        uint32_t type = binding != 0 && checker->bindings[binding - 1].node == node ? checker->bindings[binding - 1].type : TKANY;
+        check_function(checker, n.lhs, type, n.kind);
+        break;
+    }
+    default:
+        // interfaces and aliases were resolved with their scope
+        break;
+    }
+}
+
+static int compare_diagnostics(const void *a, const void *b)
+{
+    const struct Diagnostic *x = a, *y = b;
+
+    if (x->token != y->token)
+        return (x->token > y->token) - (x->token < y->token);
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+void diagnostics_free(struct Diagnostics *diagnostics)
+{
+    free(diagnostics->items);
+    arena_free(&diagnostics->text);
+    *diagnostics = (struct Diagnostics) {0};
+}
+
+struct Pool;
+
+struct Worker {
+    struct Checker checker;
+    struct TypeTable types;
+    struct Arena arena;         // what types is allocated from
+    struct Diagnostics diagnostics;
+    pthread_mutex_t lock;       // guards next and end
+    size_t next, end;           // what's left of its run of tasks
+    struct Pool *pool;
+    size_t index;
+};
+
+struct Pool {
+    struct Task *tasks;
+    struct Worker *workers;
+    size_t count;
+};
+
+static size_t task_cost(const struct Checker *checker, struct Task task)
+{
+    struct Function f = checker->ast->functions[task.function];
+    return f.body_end - f.body_start + 1;
+}
+
+/**Checks a body left by a top-level statement, unless it can keep what it
+ * did last time.
+ */
+static void check_task(struct Checker *checker, struct Task *task)
+{
+    const struct CheckedStatement *previous = previous_statement(checker, task->statement);
+
+    checker->statement = task->statement;
+    checker->part = task->part;
+    checker->epoch += checker->statements != NULL;
+
+    if (previous != NULL && task->part <= previous->bodies && uses_unchanged(checker, previous, task->part, task->type)) {
+        struct Function f = checker->ast->functions[task->function];
+        keep_reports(checker, previous, checker->statements[task->statement].first, f.body_start, f.body_end, true);
+        task->kept = true;
+        checker->kept++;
+        return;
+    }
+
+    if (checker->statements != NULL) {
+        push_use(checker, SYMBOL_NONE, CSVALUE, 0, task->type);
+        checker->checked++;
+    }
+
+    check_body(checker, task->function, task->type, task->kind);
+}
+
+static bool take_task(struct Worker *worker, size_t *task)
+{
+    struct Pool *pool = worker->pool;
+    bool found = false;
+
+    pthread_mutex_lock(&worker->lock);
+    if (worker->next < worker->end) {
+        *task = worker->next++;
+        found = true;
+    }
+    pthread_mutex_unlock(&worker->lock);
+
+    // steal the back half of someone else's run, holding one lock at a time
+    for (size_t k = 1; k < pool->count && !found; k++) {
+        struct Worker *victim = &pool->workers[(worker->index + k) % pool->count];
+        size_t begin = 0, end = 0;
+
+        pthread_mutex_lock(&victim->lock);
+        if (victim->next < victim->end) {
+            end = victim->end;
+            begin = victim->end -= (end - victim->next + 1) / 2;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (begin == end)
+            continue;
+
+        pthread_mutex_lock(&worker->lock);
+        worker->next = begin + 1;
+        worker->end = end;
+        pthread_mutex_unlock(&worker->lock);
+
+        *task = begin;
+        found = true;
+    }
+
+    return found;
+}
+
+static void *run_worker(void *argument)
+{
+    struct Worker *worker = argument;
+    size_t task;
+
+    while (!worker->checker.failed && take_task(worker, &task))
+        check_task(&worker->checker, &worker->pool->tasks[task]);
+
+    return NULL;
+}
+
+static void *copy_array(const void *array, size_t size, bool *failed)
+{
+    void *copy = malloc(size ? size : 1);
+
+    if (copy == NULL)
+        *failed = true;
+    else if (size > 0)
+        memcpy(copy, array, size);
+
+    return copy;
+}
+
+static void checker_free(struct Checker *checker)
+{
+    free(checker->bindings);
+    free(checker->names[0]);
+    free(checker->names[1]);
+    free(checker->visits);
+    free(checker->list);
+    free(checker->members);
+    free(checker->relations);
+    free(checker->frames);
+    free(checker->pending);
+    free(checker->text);
+    free(checker->tasks);
+    free(checker->uses);
+}
+
+/**Sets a worker up to check bodies as checker would, from where checker got
+ * to.
+ */
+static int worker_init(struct Worker *worker, const struct Checker *checker, struct Pool *pool, size_t index)
+{
+    struct Checker *copy = &worker->checker;
+    bool failed = false;
+
+    *worker = (struct Worker) { .pool = pool, .index = index };
+    arena_init(&worker->diagnostics.text);
+    arena_init(&worker->arena);
+
+    if (type_table_copy(&worker->types, checker->types, &worker->arena) != EXIT_SUCCESS)
+        failed = true;
+
+    *copy = (struct Checker) {
+        .tokens = checker->tokens,
+        .ast = checker->ast,
+        .interner = checker->interner,
+        .types = &worker->types,
+        .diagnostics = &worker->diagnostics,
+        .error_token = checker->error_token,
+        .binding_count = checker->binding_count,
+        .binding_capacity = checker->binding_count,
+        .name_capacity = checker->name_capacity,
+        .node_types = checker->node_types,
+        .node_capacity = checker->node_capacity,
+        .relation_count = checker->relation_count,
+        .relation_slot_count = checker->relation_slot_count,
+        .result = TYPE_NONE,
+        .shared = true,
+        .shapes = checker->shapes,
+        .previous = checker->previous,
+        .statements = checker->statements,
+        .statement = NO_DECLARATION,
+        .epoch = checker->epoch,
+        .undefined_symbol = checker->undefined_symbol,
+        .array_symbol = checker->array_symbol,
+    };
+    memcpy(copy->builtin_symbols, checker->builtin_symbols, sizeof copy->builtin_symbols);
+
+    copy->bindings = copy_array(checker->bindings, checker->binding_count * sizeof *checker->bindings, &failed);
+    copy->names[0] = copy_array(checker->names[0], checker->name_capacity * sizeof **checker->names, &failed);
+    copy->names[1] = copy_array(checker->names[1], checker->name_capacity * sizeof **checker->names, &failed);
+    copy->relations = copy_array(checker->relations, checker->relation_slot_count * sizeof *checker->relations, &failed);
+
+    if (failed || pthread_mutex_init(&worker->lock, NULL) != 0) {
+        checker_free(copy);
+        arena_free(&worker->arena);
+        diagnostics_free(&worker->diagnostics);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**Interns the contents of every string literal, and every keyword used as
+ * a name (see name_symbol), so checking bodies never adds a symbol.
+ */
+static int intern_strings(struct Checker *checker)
+{
+    for (size_t i = 0; i < checker->ast->count; i++) {
+        struct Node n = checker->ast->nodes[i];
+        uint32_t token = n.token;
+
+        if (n.kind == ETPROPERTYACCESS && n.rhs == SYMBOL_NONE)
+            token++;
+        else if (!(n.kind == ETSTRINGLITERAL
+                   || ((n.kind == ETIDENTIFIER || n.kind == TEMEMBER || n.kind == TEOPTIONALMEMBER) && n.lhs == SYMBOL_NONE)))
+            continue;
+
+        // nodes reparse_edits threw away can point at any token, or past them
+        if (token >= checker->tokens->count)
+            continue;
+
+        enum TokenType ttype = token_type(checker->tokens, token);
+        struct StringView text = token_view(checker->tokens, token);
+
+        if (n.kind == ETSTRINGLITERAL) {
+            if ((ttype == TTSINGLESTRING || ttype == TTDOUBLESTRING)
+                    && intern_text(checker, text.data + 1, text.length - 2) == SYMBOL_NONE)
+                return EXIT_FAILURE;
+        } else if (ttype != TTIDENTIFIER && intern_text(checker, text.data, text.length) == SYMBOL_NONE) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**Checks the tasks with up to threads threads, merging what the workers
+ * report into checker's diagnostics.
+ */
+static void check_tasks_parallel(struct Checker *checker, size_t threads)
+{
+    struct Pool pool = { .tasks = checker->tasks };
+    struct Worker *workers = calloc(threads, sizeof *workers);
+    pthread_t *handles = calloc(threads, sizeof *handles);
+    size_t total = 0, ready = 0, started = 0;
+
+    if (workers == NULL || handles == NULL) {
+        checker->failed = true;
+        goto done;
+    }
+
+    for (size_t i = 0; i < checker->task_count; i++)
+        total += task_cost(checker, checker->tasks[i]);
+
+    for (ready = 0; ready < threads; ready++)
+        if (worker_init(&workers[ready], checker, &pool, ready) != EXIT_SUCCESS)
+            break;
+
+    if (ready < threads) {
+        checker->failed = true;
+        goto done;
+    }
+
+    pool.workers = workers;
+    pool.count = threads;
+
+    // runs of about equal cost, in source order
+    for (size_t i = 0, k = 0, cost = 0; k < threads; k++) {
+        workers[k].next = i;
+        while (i < checker->task_count && (k + 1 == threads || cost < total / threads * (k + 1)))
+            cost += task_cost(checker, checker->tasks[i++]);
+        workers[k].end = i;
+    }
+
+    // the calling thread is the first worker; a run without a thread of its
+    // own is stolen by the others
+    for (started = 1; started < threads; started++)
+        if (pthread_create(&handles[started], NULL, run_worker, &workers[started]) != 0)
+            break;
+
+    run_worker(&workers[0]);
+
+    for (size_t k = 1; k < started; k++)
+        pthread_join(handles[k], NULL);
+
+    for (size_t k = 0; k < threads; k++) {
+        struct Diagnostics *reported = &workers[k].diagnostics;
+
+        struct Checker *worker = &workers[k].checker;
+
+        checker->failed |= worker->failed;
+        checker->checked += worker->checked;
+        checker->kept += worker->kept;
+
+        if (reserve(checker, (void **)&checker->uses, &checker->use_capacity, checker->use_count + worker->use_count, sizeof *checker->uses) == EXIT_SUCCESS
+                && worker->use_count > 0) {
+            memcpy(&checker->uses[checker->use_count], worker->uses, worker->use_count * sizeof *worker->uses);
+            checker->use_count += worker->use_count;
+        }
+
+        for (size_t i = 0; i < reported->count && !checker->failed; i++) {
+            struct Diagnostics *diagnostics = checker->diagnostics;
+            struct Diagnostic d = reported->items[i];
+
+            if (reserve(checker, (void **)&diagnostics->items, &diagnostics->capacity, diagnostics->count + 1, sizeof *diagnostics->items) != EXIT_SUCCESS)
+                break;
+            if ((d.message = arena_copy_text(&diagnostics->text, d.message, strlen(d.message) + 1)) == NULL) {
+                checker->failed = true;
+                break;
+            }
+            diagnostics->items[diagnostics->count++] = d;
+        }
+    }
+
+done:
+    for (size_t k = 0; k < ready && workers != NULL; k++) {
+        pthread_mutex_destroy(&workers[k].lock);
+        checker_free(&workers[k].checker);
+        arena_free(&workers[k].arena);
+        diagnostics_free(&workers[k].diagnostics);
+    }
+    free(workers);
+    free(handles);
+}
+
+/**A hash of a statement's tokens, which doesn't depend on where it is.
+ */
+static uint64_t hash_tokens(const struct TokenBuffer *tokens, uint32_t start, uint32_t end)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+
+    for (uint32_t i = start; i < end; i++) {
+        struct StringView text = token_view(tokens, i);
+        h = (h ^ ((uint64_t)token_type(tokens, i) << 32 | intern_hash(text.data, text.length))) * 0x100000001b3ull;
+        h ^= h >> 31;
+    }
+
+    return h;
+}
+
+struct Matching {
+    uint64_t text;
+    uint32_t statement; // NO_DECLARATION once it's been matched
+};
+
+static int compare_matchings(const void *a, const void *b)
+{
+    const struct Matching *x = a, *y = b;
+
+    if (x->text != y->text)
+        return (x->text > y->text) - (x->text < y->text);
+    return (x->statement > y->statement) - (x->statement < y->statement);
+}
+
+/**Records each top-level statement, and matches it to the first of the last
+ * run's with the same tokens that isn't already taken.
+ */
+static int match_statements(struct Checker *checker, const struct CheckState *state)
+{
+    const struct Ast *ast = checker->ast;
+    struct Node root = ast->nodes[0];
+    size_t count = state->interner == checker->interner && state->types == checker->types ? state->count : 0;
+    struct Matching *previous = malloc((count ? count : 1) * sizeof *previous);
+
+    checker->statements = calloc(root.rhs ? root.rhs : 1, sizeof *checker->statements);
+    if (checker->statements == NULL || previous == NULL) {
+        free(previous);
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+        previous[i] = (struct Matching) { .text = state->statements[i].text, .statement = i };
+    if (count > 1)
+        qsort(previous, count, sizeof *previous, compare_matchings);
+
+    for (uint32_t i = 0; i < root.rhs; i++) {
+        uint32_t node = ast->extra[root.lhs + i];
+        uint32_t first = ast->nodes[node].token;
+        uint32_t end = i + 1 < root.rhs ? ast->nodes[ast->extra[root.lhs + i + 1]].token : checker->tokens->count;
+        struct StatementRecord *record = &checker->statements[i];
+
+        *record = (struct StatementRecord) {
+            .text = hash_tokens(checker->tokens, first, end),
+            .node = node,
+            .first = first,
+            .previous = NO_DECLARATION,
+            .type = TYPE_NONE,
+            .shape = TYPE_NONE,
+        };
+
+        size_t low = 0, high = count;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (previous[middle].text < record->text)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        for (; low < count && previous[low].text == record->text; low++) {
+            if (previous[low].statement != NO_DECLARATION) {
+                record->previous = previous[low].statement;
+                previous[low].statement = NO_DECLARATION;
+                break;
+            }
+        }
+    }
+
+    free(previous);
+
+    return EXIT_SUCCESS;
+}
+
+static int compare_uses(const void *a, const void *b)
+{
+    const struct Use *x = a, *y = b;
+    uint32_t p[5] = { x->statement, x->use.part, x->use.symbol, x->use.space, x->use.seen };
+    uint32_t q[5] = { y->statement, y->use.part, y->use.symbol, y->use.space, y->use.seen };
+
+    for (int i = 0; i < 5; i++)
+        if (p[i] != q[i])
+            return (p[i] > q[i]) - (p[i] < q[i]);
+    return (x->use.flags > y->use.flags) - (x->use.flags < y->use.flags);
+}
+
+/**Adds the uses a kept part had last time, as it'll have the same ones next
+ * time.
+ */
+static void keep_uses(struct Checker *checker, uint32_t statement, uint32_t part)
+{
+    const struct CheckedStatement *previous = previous_statement(checker, statement);
+
+    checker->statement = statement;
+    checker->part = part;
+
+    for (uint32_t i = 0; i < previous->use_count; i++) {
+        struct CheckedUse use = checker->previous->uses[previous->uses + i];
+        if (use.part == part)
+            push_use(checker, use.symbol, use.space, use.flags, use.seen);
+    }
+}
+
+void check_state_free(struct CheckState *state)
+{
+    free(state->statements);
+    free(state->uses);
+    free(state->reports);
+    arena_free(&state->text);
+    *state = (struct CheckState) {0};
+}
+
+/**Replaces the state with what this run found.  diagnostics must be sorted.
+ */
+static int save_state(struct Checker *checker, struct CheckState *state)
+{
+    struct Diagnostics *diagnostics = checker->diagnostics;
+    uint32_t count = checker->ast->nodes[0].rhs;
+    struct CheckState saved = {
+        .interner = checker->interner,
+        .types = checker->types,
+        .count = count,
+        .checked = checker->checked,
+        .kept = checker->kept,
+    };
+
+    for (uint32_t i = 0; i < count; i++)
+        if (checker->statements[i].progress == SPKEPT)
+            keep_uses(checker, i, 0);
+    for (size_t i = 0; i < checker->task_count; i++)
+        if (checker->tasks[i].kept)
+            keep_uses(checker, checker->tasks[i].statement, checker->tasks[i].part);
+
+    if (checker->use_count > 1)
+        qsort(checker->uses, checker->use_count, sizeof *checker->uses, compare_uses);
+
+    arena_init(&saved.text);
+    saved.statements = calloc(count ? count : 1, sizeof *saved.statements);
+    saved.uses = malloc((checker->use_count ? checker->use_count : 1) * sizeof *saved.uses);
+    saved.reports = malloc((diagnostics->count ? diagnostics->count : 1) * sizeof *saved.reports);
+
+    if (checker->failed || saved.statements == NULL || saved.uses == NULL || saved.reports == NULL) {
+        check_state_free(&saved);
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        struct StatementRecord record = checker->statements[i];
+        saved.statements[i] = (struct CheckedStatement) {
+            .text = record.text,
+            .type = record.type,
+            .shape = record.shape,
+            .bodies = record.bodies,
+        };
+    }
+
+    for (size_t i = 0; i < checker->use_count; i++) {
+        struct Use use = checker->uses[i];
+        struct CheckedStatement *statement = &saved.statements[use.statement];
+
+        if (i > 0 && compare_uses(&checker->uses[i - 1], &use) == 0)
+            continue;
+        if (statement->use_count++ == 0)
+            statement->uses = saved.use_count;
+        saved.uses[saved.use_count++] = use.use;
+    }
+
+    // diagnostics are in order of token, so each statement's are together
+    for (size_t i = 0, statement = 0; i < diagnostics->count && count > 0; i++) {
+        struct Diagnostic d = diagnostics->items[i];
+
+        while (statement + 1 < count && checker->statements[statement + 1].first <= d.token)
+            statement++;
+
+        const char *message = arena_copy_text(&saved.text, d.message, strlen(d.message) + 1);
+        if (message == NULL) {
+            check_state_free(&saved);
+            return EXIT_FAILURE;
+        }
+
+        struct CheckedStatement *s = &saved.statements[statement];
+        if (s->report_count++ == 0)
+            s->reports = saved.report_count;
+        saved.reports[saved.report_count++] = (struct CheckedReport) {
+            .offset = d.token - checker->statements[statement].first,
+            .message = message,
+        };
+    }
+
+    check_state_free(state);
+    *state = saved;
+
+    return EXIT_SUCCESS;
+}
+
+int check_program(const struct TokenBuffer *tokens, struct Ast *ast, struct Interner *interner,
+                  struct TypeTable *types, struct Diagnostics *diagnostics, size_t *error_token, size_t threads,
+                  struct CheckState *state)
+{
+    struct Checker checker = {
+        .tokens = tokens,
+        .ast = ast,
+        .interner = interner,
+        .types = types,
+        .diagnostics = diagnostics,
+        .error_token = tokens->count,
+        .previous = state,
+        .statement = NO_DECLARATION,
+    };
+
+    checker.relations = calloc(RELATION_INITIAL_SLOTS, sizeof *checker.relations);
+    checker.relation_slot_count = RELATION_INITIAL_SLOTS;
+
+    for (uint8_t kind = TKANY; kind <= TKNONPRIMITIVE; kind++)
+        checker.builtin_symbols[kind] = intern_text(&checker, primitive_names[kind], strlen(primitive_names[kind]));
+    checker.undefined_symbol = checker.builtin_symbols[TKUNDEFINED];
+    checker.array_symbol = intern_text(&checker, "Array", 5);
+
+    // true, false, null and void are keywords, so aren't type names
+    checker.builtin_symbols[TKTRUE] = checker.builtin_symbols[TKFALSE] = SYMBOL_NONE;
+    checker.builtin_symbols[TKNULL] = checker.builtin_symbols[TKVOID] = SYMBOL_NONE;
+
+    if (checker.relations != NULL && ensure_nodes(&checker) == EXIT_SUCCESS && ensure_names(&checker) == EXIT_SUCCESS
+            && (state == NULL || match_statements(&checker, state) == EXIT_SUCCESS)) {
+        check_top_level(&checker);
+    } else {
+        checker.failed = true;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < checker.task_count; i++)
+        total += task_cost(&checker, checker.tasks[i]);
+
+    if (threads > total / PARALLEL_MIN_TOKENS)
+        threads = total / PARALLEL_MIN_TOKENS;
+
+    if (checker.failed) {
+        // nothing more to do
+    } else if (threads <= 1) {
+        for (size_t i = 0; i < checker.task_count && !checker.failed; i++)
+            check_task(&checker, &checker.tasks[i]);
+    } else if (parse_function_bodies(tokens, ast, &checker.error_token) != EXIT_SUCCESS) {
+        checker.failed = true;
+    } else if (intern_strings(&checker) == EXIT_SUCCESS && ensure_nodes(&checker) == EXIT_SUCCESS
+               && ensure_names(&checker) == EXIT_SUCCESS) {
+        check_tasks_parallel(&checker, threads);
+    } else {
+        checker.failed = true;
+    }
+
+    if (diagnostics->count > 1)
+        qsort(diagnostics->items, diagnostics->count, sizeof *diagnostics->items, compare_diagnostics);
+    *error_token = checker.error_token;
+
+    if (state != NULL && save_state(&checker, state) != EXIT_SUCCESS) {
+        check_state_free(state);
+        checker.failed = true;
+    }
+
+    checker_free(&checker);
+    free(checker.node_types);
+    free(checker.shapes);
+    free(checker.statements);
+
+    return checker.failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -2,7 +2,10 @@
 #define COMPILE_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 enum TokenType {
     // used for signalling
@@ -95,6 +98,23 @@ enum TokenType {
     TTLESSEQ,           // <=
     TTGREATEREQ,        // >=
     TTDOT,              // .
+    TTINCREMENT,        // ++
+    TTDECREMENT,        // --
+    TTEXPONENT,         // **
+    TTEXPONENTASSIGN,   // **=
+    TTBITANDASSIGN,     // &=
+    TTBITORASSIGN,      // |=
+    TTBITXORASSIGN,     // ^=
+    TTBITSHLASSIGN,     // <<=
+    TTBITSHRASSIGN,     // >>=
+    TTBITSHRZEROASSIGN, // >>>=
+    TTANDASSIGN,        // &&=
+    TTORASSIGN,         // ||=
+    TTNULLISH,          // ??
+    TTNULLISHASSIGN,    // ??=
+    TTOPTIONALCHAIN,    // ?.
+    TTARROW,            // =>
+    TTSPREAD,           // ...
     // literals
     TTNUMLITERAL,
     // syntax
@@ -107,6 +127,8 @@ enum TokenType {
     TTCLOSEBRACKET,
     TTCOLON,
     TTCOMMA,
+    // number of token types; must stay <= 256 to fit in TokenBuffer.types
+    TTMAX,
 };
 
 /**A string view that does not own a string.
@@ -116,12 +138,442 @@ struct StringView {
     size_t length;
 };
 
-struct Token {
+/**The offset at which each line starts; starts[0] is always 0.
+ */
+struct LineTable {
+    uint32_t *starts;
+    size_t count;
+};
+
+/**A 1-based line and byte column.
+ */
+struct SourcePosition {
+    size_t line;
+    size_t column;
+};
+
+int line_table_build(const char *text, size_t length, struct LineTable *out);
+void line_table_free(struct LineTable *table);
+struct SourcePosition line_table_position(const struct LineTable *table, size_t offset);
+
+/**The text of a source file (source.c), NUL terminated and followed by at
+ * least SOURCE_PADDING zero bytes so scanners may read past the end.
+ *
+ * Regular files are memory mapped, so data points straight into the mapping
+ * and is never copied.  lines is only built the first time a position is
+ * asked for, so lexing never has to count lines.
+ */
+#define SOURCE_PADDING 64
+
+struct SourceFile {
+    const char *data;
+    size_t length;
+    void *allocation;
+    size_t mapping_length;  // 0 if allocation is a heap block
+    struct LineTable lines;
+};
+
+int source_load(const char *name, struct SourceFile *out);
+void source_free(struct SourceFile *source);
+/**The line and column of a byte offset in the source.  Builds the line table
+ * on first use; if that fails, reports line 0.
+ */
+struct SourcePosition source_position(struct SourceFile *source, size_t offset);
+
+/**A bump-pointer arena (arena.c).
+ *
+ * Everything a compilation builds (AST nodes, types, interned text) is
+ * allocated from an arena and released all at once by arena_free, never one
+ * piece at a time.  Things allocated one after another sit next to each other
+ * in memory.  arena_mark and arena_reset free everything allocated since the
+ * mark, for scratch work like a parse attempt that has to be abandoned.
+ *
+ * An arena starts out empty and takes its first chunk on first use.
+ */
+#define ARENA_ALIGNMENT 16
+
+struct ArenaChunk;
+
+struct Arena {
+    struct ArenaChunk *chunk;   // the newest chunk
+    char *next;
+    char *limit;                // end of the newest chunk, aligned
+};
+
+struct ArenaMark {
+    struct ArenaChunk *chunk;
+    char *next;
+};
+
+void arena_init(struct Arena *arena);
+void arena_free(struct Arena *arena);
+/**Takes a new chunk and allocates size bytes at its start, for when the
+ * current chunk is full.  Call arena_alloc instead.
+ */
+void *arena_grow(struct Arena *arena, size_t size);
+void arena_reset(struct Arena *arena, struct ArenaMark mark);
+/**Grows the allocation at old from old_size to new_size bytes, in place if
+ * it was the last thing allocated and the chunk has room, otherwise by
+ * copying it to a new allocation.
+ */
+void *arena_resize(struct Arena *arena, void *old, size_t old_size, size_t new_size);
+/**Copies text into the arena with no alignment, so strings pack tightly.
+ */
+const char *arena_copy_text(struct Arena *arena, const char *data, size_t length);
+
+/**size bytes aligned to ARENA_ALIGNMENT, or NULL if out of memory.
+ */
+static inline void *arena_alloc(struct Arena *arena, size_t size)
+{
+    char *next = (char *)(((uintptr_t)arena->next + ARENA_ALIGNMENT - 1) & ~(uintptr_t)(ARENA_ALIGNMENT - 1));
+
+    if (arena->next == NULL || (size_t)(arena->limit - next) < size)
+        return arena_grow(arena, size);
+
+    arena->next = next + size;
+
+    return next;
+}
+
+#define ARENA_NEW(arena, type, count) ((type *)arena_alloc((arena), sizeof(type) * (count)))
+
+static inline struct ArenaMark arena_mark(const struct Arena *arena)
+{
+    return (struct ArenaMark) { .chunk = arena->chunk, .next = arena->next };
+}
+
+/**Interned strings (intern.c).
+ *
+ * Each distinct string is stored once and named by a 32-bit symbol, so names
+ * can be compared with == instead of by their bytes.  One interner is shared
+ * by everything in a compilation.
+ */
+#define SYMBOL_NONE 0
+
+struct InternSlot {
+    uint32_t hash;
+    uint32_t symbol;
+};
+
+struct Interner {
+    struct InternSlot *slots;
+    size_t slot_count;
+    struct StringView *strings;     // indexed by symbol
+    uint32_t count;
+    uint32_t capacity;
+    struct Arena text;
+};
+
+/**A fast hash for identifiers, taking eight bytes at a time.
+ */
+static inline uint32_t intern_hash(const char *data, size_t length)
+{
+    const uint64_t K = 0x9e3779b97f4a7c15ull;
+    uint64_t h = length * K, word;
+
+    for (; length >= 8; data += 8, length -= 8) {
+        memcpy(&word, data, 8);
+        h = (h ^ word) * K;
+        h ^= h >> 29;
+    }
+
+    if (length > 0) {
+        word = 0;
+        memcpy(&word, data, length);
+        h = (h ^ word) * K;
+        h ^= h >> 29;
+    }
+
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+static inline struct StringView symbol_string(const struct Interner *interner, uint32_t symbol)
+{
+    return interner->strings[symbol];
+}
+
+int interner_init(struct Interner *interner);
+void interner_free(struct Interner *interner);
+/**Returns the symbol for the string, adding it if it's new, or SYMBOL_NONE if
+ * out of memory.  hash must be intern_hash(data, length).
+ */
+uint32_t intern(struct Interner *interner, const char *data, size_t length, uint32_t hash);
+/**Returns the symbol for the string if it's been interned, or SYMBOL_NONE.
+ * This only reads, so any number of threads may call it at once.
+ */
+uint32_t intern_find(const struct Interner *interner, const char *data, size_t length, uint32_t hash);
+
+/**A lexed file, stored as parallel arrays indexed by token number.
+ *
+ * Token types are kept dense in their own array so scanning them (lookahead,
+ * brace matching) touches as little memory as possible.  starts and lengths
+ * are byte offsets into source, which must outlive the buffer.  symbols holds
+ * the interned name of each identifier, and SYMBOL_NONE for other tokens.
+ *
+ * After retokenise_edits the starts from shift_from on may be behind by
+ * shift, which is only added in when they're read through token_start or
+ * token_view, until token_buffer_settle writes it in.
+ */
+struct TokenBuffer {
+    const char *source;
+    uint8_t *types;
+    uint32_t *starts;
+    uint32_t *lengths;
+    uint32_t *symbols;
+    size_t count;
+    size_t capacity;
+    size_t shift_from;
+    ptrdiff_t shift;
+};
+
+static inline enum TokenType token_type(const struct TokenBuffer *tokens, size_t i)
+{
+    return (enum TokenType)tokens->types[i];
+}
+
+static inline uint32_t token_start(const struct TokenBuffer *tokens, size_t i)
+{
+    return tokens->starts[i] + (i >= tokens->shift_from ? tokens->shift : 0);
+}
+
+static inline struct StringView token_view(const struct TokenBuffer *tokens, size_t i)
+{
+    return (struct StringView) {
+        .data = tokens->source + token_start(tokens, i),
+        .length = tokens->lengths[i],
+    };
+}
+
+/**The source spelling of each keyword, operator and piece of syntax, indexed
+ * by enum TokenType.  NULL for token types with no fixed spelling.
+ */
+extern const char *const token_type_strings[];
+
+static inline bool token_type_is_keyword(enum TokenType ttype)
+{
+    return ttype >= TTBREAK && ttype <= TTYIELD;
+}
+
+/**ASCII character classes (token.c), used instead of ctype.h: no locale,
+ * and bytes from 0x80 up are in no class.
+ */
+enum CharClass {
+    CCSPACE = 1 << 0,
+    CCDIGIT = 1 << 1,
+    CCIDENTSTART = 1 << 2,
+    CCIDENT = 1 << 3, // includes CCIDENTSTART and CCDIGIT
+};
+
+extern const uint8_t char_classes[256];
+
+static inline bool char_is(char c, enum CharClass class)
+{
+    return (char_classes[(unsigned char)c] & class) != 0;
+}
+
+/**The value of a hex digit, or 99 for anything else.
+ */
+static inline int digit_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') return (c | 0x20) - 'a' + 10;
+    return 99;
+}
+
+/**Converts the text of a numeric literal token (number.c).  For BigInt
+ * literals, sets *bigint and gives the nearest double.
+ */
+int numeric_literal_value(struct StringView text, double *value, bool *bigint);
+
+enum TokenType get_keyword_type(struct StringView word);
+const char *get_punctuator(const char *begin, enum TokenType *ttype);
+int token_buffer_reserve(struct TokenBuffer *buffer, size_t capacity);
+void token_buffer_free(struct TokenBuffer *buffer);
+/**Writes any shift retokenise_edits left pending into the starts, so they
+ * can be read directly.
+ */
+void token_buffer_settle(struct TokenBuffer *buffer);
+
+/* Most source is at least a few bytes per token once whitespace and names are
+ * counted, so buffers pre-sized this way rarely have to grow.
+ */
+#define TOKEN_ESTIMATE_BYTES_PER_TOKEN 4
+#define TOKEN_ESTIMATE_MIN 64
+
+static inline int token_buffer_push(struct TokenBuffer *buffer, enum TokenType ttype, uint32_t start, uint32_t length, uint32_t symbol)
+{
+    if (buffer->count >= buffer->capacity
+            && token_buffer_reserve(buffer, buffer->capacity ? buffer->capacity * 2 : TOKEN_ESTIMATE_MIN) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    size_t i = buffer->count++;
+    buffer->types[i] = ttype;
+    buffer->starts[i] = start;
+    buffer->lengths[i] = length;
+    buffer->symbols[i] = symbol;
+
+    return EXIT_SUCCESS;
+}
+
+// lex_token looks at up to this many bytes from the start of a token past its
+// end (a short punctuator like "?" before ".")
+#define LEXER_LOOKAHEAD 4
+
+const char *lex_token(const char *contents, enum TokenType *ttype, uint32_t *hash);
+
+/**Where lexing at contents went wrong, given that lex_token returned NULL
+ * there: the misplaced '_' or missing digits of a number, the line break or
+ * end of input that cut a string short, or contents itself for a character
+ * that can't start a token.
+ */
+const char *lex_token_error(const char *contents);
+
+/**Lexes the whole of contents into tokens.  On failure, writes the offset of
+ * the byte lexing failed at to error_offset, or length if no token was to
+ * blame.
+ */
+int tokenise_file(const char *contents, size_t length, struct Interner *interner, struct TokenBuffer *tokens,
+                  size_t *error_offset);
+
+/**A change to a file's text: old_length bytes at start were replaced by
+ * new_length bytes.  A list of edits is in order, doesn't overlap, and gives
+ * offsets in the text before any of them.
+ */
+struct TextEdit {
+    size_t start;
+    size_t old_length;
+    size_t new_length;
+};
+
+/**Which tokens retokenise_edits replaced: the old tokens first to
+ * first + old_count became the new tokens first to first + new_count, and
+ * the tokens after them moved by new_count - old_count.
+ */
+struct TokenChange {
+    size_t first;
+    size_t old_count;
+    size_t new_count;
+};
+
+/**Updates tokens, lexed from the text before the edits, to match contents,
+ * the text after them.  Only the damaged region is lexed again, stopping as
+ * soon as a token starts where one did before.  The starts of the tokens
+ * after it are left to be shifted on read, so only those between these edits
+ * and the last ones are touched.  On failure tokens is left as it was.
+ */
+int retokenise_edits(const char *contents, size_t length, struct Interner *interner, struct TokenBuffer *tokens,
+                     const struct TextEdit *edits, size_t edit_count, struct TokenChange *change);
+
+/**Like tokenise_file, lexing chunks of the file on up to threads threads and
+ * stitching the results (parlex.c).  The tokens and symbols, and the offset
+ * of any failure, are identical to tokenise_file's.  Small files are lexed
+ * serially.
+ */
+int tokenise_file_parallel(const char *contents, size_t length, struct Interner *interner,
+                           struct TokenBuffer *tokens, size_t threads, size_t *error_offset);
+
+/**A pull-based lexer over a bounded window of input (stream.c).
+ *
+ * Input is written straight into the window: lexer_reserve returns where to
+ * write and how much space there is, lexer_commit says how much was written
+ * and lexer_finish says there is no more.  lexer_next then hands out tokens
+ * until it needs more input.
+ */
+struct Lexer {
+    char *window;
+    size_t capacity;
+    size_t begin;       // first unconsumed byte in window
+    size_t end;         // end of the input in window
+    size_t base;        // offset of window[0] in the whole input
+    int trivia;         // enum LexerTrivia, when stopped inside a comment
+    bool newline;       // a line break was skipped since the last token
+    bool finished;
+    struct Interner *interner;
+};
+
+enum LexerStatus {
+    LSREADY,
+    LSNEEDINPUT,
+    LSEND,
+    LSERROR,            // malformed, or a token longer than the window
+};
+
+/**A token from lexer_next.  view points into the lexer's window and is only
+ * valid until the next lexer_reserve.
+ */
+struct LexedToken {
     enum TokenType type;
+    uint32_t symbol;
+    size_t offset;
     struct StringView view;
+    bool newline;       // a line break comes before it
+};
+
+/**The tokens of one top-level statement, with their own copy of the token
+ * text so they stay valid after the lexer's window has moved on.  Tokens that
+ * were apart in the input are kept apart by a space, or a line break where
+ * there was one.  tokens.source points at text, so it can be handed to
+ * parse_tokens.
+ */
+struct StatementTokens {
+    struct TokenBuffer tokens;
+    char *text;
+    size_t text_length;
+    size_t text_capacity;
+    size_t offset;      // of the first token in the whole input
+    size_t end;         // of the last token in the whole input
+    int depth;
+    int dos, whiles;    // "do" and "while" keywords at depth 0
+    bool ended;         // it could end here, depending on the next token
+    bool complete;
+};
+
+int lexer_init(struct Lexer *lexer, size_t capacity, struct Interner *interner);
+void lexer_free(struct Lexer *lexer);
+char *lexer_reserve(struct Lexer *lexer, size_t *space);
+void lexer_commit(struct Lexer *lexer, size_t length);
+void lexer_finish(struct Lexer *lexer);
+enum LexerStatus lexer_next(struct Lexer *lexer, struct LexedToken *out);
+/**Collects tokens up to the end of the next top-level statement.  Returns
+ * LSREADY once the statement is complete, which for a statement ending in
+ * ";" or '}' is once the token after it shows it doesn't go on, as an
+ * "else", "catch" or "finally" would.  A statement without a ";" ends at a
+ * line break where automatic semicolon insertion would put one.
+ */
+enum LexerStatus lexer_next_statement(struct Lexer *lexer, struct StatementTokens *statement);
+void statement_tokens_free(struct StatementTokens *statement);
+
+enum ScanKernelSet {
+    SKBEST = 0,
+    SKSCALAR,
+    SKSSE2,
+    SKAVX2,
 };
 
-int tokenise_file(const char *contents, struct Token **tokens, size_t *tokens_written);
+/* Scanning kernels (scan.c), picked at runtime by CPUID on first use.  All of
+ * them stop at the terminating NUL.
+ */
+
+/**Skips ASCII whitespace.
+ */
+extern const char *(*scan_skip_whitespace)(const char *string);
+/**Skips [A-Za-z0-9_$].
+ */
+extern const char *(*scan_skip_identifier)(const char *string);
+/**Finds the first of a, b, c or NUL.
+ */
+extern const char *(*scan_find_any)(const char *string, char a, char b, char c);
+/**Counts the newlines in the first length bytes of string and, if starts is
+ * not NULL, writes base plus the offset just past each one to it.
+ */
+extern size_t (*scan_line_starts)(const char *string, size_t length, uint32_t base, uint32_t *starts);
+extern const char *scan_kernel_name;
+void scan_select_kernels(enum ScanKernelSet which);
+
+/**Resolves the scanning kernels now if nothing has yet, once across all
+ * threads.  Call it before starting threads that lex.
+ */
+void scan_resolve_kernels(void);
 
 enum ExpressionType {
     ETADDITION,
@@ -197,162 +649,23 @@ enum ExpressionType {
     ETVOID,
     ETYIELD,
     ETGENYIELD,
-};
-
-struct etAddition                 {};
-struct etAdditionAssign           {};
-struct etAssign                   {};
-struct etAsyncFunction            {};
-struct etAsyncGenFunction         {};
-struct etAwait                    {};
-struct etBitAnd                   {};
-struct etBitAndAssign             {};
-struct etBitNot                   {};
-struct etBitOr                    {};
-struct etBitOrAssign              {};
-struct etBitXor                   {};
-struct etBitXorAssign             {};
-struct etClass                    {};
-struct etComma                    {};
-struct etTernary                  {};
-struct etDecrement                {};
-struct etDelete                   {};
-struct etDestructureAssign        {};
-struct etDivision                 {};
-struct etDivisionAssign           {};
-struct etEqual                    {};
-struct etExponent                 {};
-struct etExponentAssign           {};
-struct etFunction                 {};
-struct etGenFunction              {};
-struct etGreater                  {};
-struct etGreaterEqual             {};
-struct etGroup                    {};
-struct etImportMeta               {};
-struct etImport                   {};
-struct etIn                       {};
-struct etIncrement                {};
-struct etInequal                  {};
-struct etInstanceof               {};
-struct etLeftShift                {};
-struct etLeftShiftAssign          {};
-struct etLess                     {};
-struct etLessEqual                {};
-struct etLogicAnd                 {};
-struct etLogicOr                  {};
-struct etLogicOrAssign            {};
-struct etMultiply                 {};
-struct etMultiplyAssign           {};
-struct etNew                      {};
-struct etNewTarget                {};
-struct etNull                     {};
-struct etNullCoalesceAssign       {};
-struct etNullCoalesce             {};
-struct etNumericLiteral           { int value; };
-struct etObjectInit               {};
-struct etOptionalChain            {};
-struct etPropertyAccess           {};
-struct etRemainder                {};
-struct etRemainderAssign          {};
-struct etRightShift               {};
-struct etRightShiftAssign         {};
-struct etSpread                   {};
-struct etStrictEqual              {};
-struct etStrictInequal            {};
-struct etStringLiteral            { char *value; size_t length; };
-struct etSubtract                 {};
-struct etSubtractAssign           {};
-struct etSuper                    {};
-struct etThis                     {};
-struct etTypeof                   {};
-struct etUnaryNegate              {};
-struct etUnaryPlus                {};
-struct etUnsignedRightShift       {};
-struct etUnsignedRightShiftAssign {};
-struct etVoid                     {};
-struct etYield                    {};
-struct etGenYield                 {};
-
-struct Expression {
-    enum ExpressionType etype;
-    union {
-        struct etAddition                 et_addition;
-        struct etAdditionAssign           et_addition_assign;
-        struct etAssign                   et_assign;
-        struct etAsyncFunction            et_async_function;
-        struct etAsyncGenFunction         et_async_gen_function;
-        struct etAwait                    et_await;
-        struct etBitAnd                   et_bit_and;
-        struct etBitAndAssign             et_bit_and_assign;
-        struct etBitNot                   et_bit_not;
-        struct etBitOr                    et_bit_or;
-        struct etBitOrAssign              et_bit_or_assign;
-        struct etBitXor                   et_bit_xor;
-        struct etBitXorAssign             et_bit_xor_assign;
-        struct etClass                    et_class;
-        struct etComma                    et_comma;
-        struct etTernary                  et_ternary;
-        struct etDecrement                et_decrement;
-        struct etDelete                   et_delete;
-        struct etDestructureAssign        et_destructure_assign;
-        struct etDivision                 et_division;
-        struct etDivisionAssign           et_division_assign;
-        struct etEqual                    et_equal;
-        struct etExponent                 et_exponent;
-        struct etExponentAssign           et_exponent_assign;
-        struct etFunction                 et_function;
-        struct etGenFunction              et_gen_function;
-        struct etGreater                  et_greater;
-        struct etGreaterEqual             et_greater_equal;
-        struct etGroup                    et_group;
-        struct etImportMeta               et_import_meta;
-        struct etImport                   et_import;
-        struct etIn                       et_in;
-        struct etIncrement                et_increment;
-        struct etInequal                  et_inequal;
-        struct etInstanceof               et_instanceof;
-        struct etLeftShift                et_left_shift;
-        struct etLeftShiftAssign          et_left_shift_assign;
-        struct etLess                     et_less;
-        struct etLessEqual                et_less_equal;
-        struct etLogicAnd                 et_logic_and;
-        struct etLogicOr                  et_logic_or;
-        struct etLogicOrAssign            et_logic_or_assign;
-        struct etMultiply                 et_multiply;
-        struct etMultiplyAssign           et_multiply_assign;
-        struct etNew                      et_new;
-        struct etNewTarget                et_new_target;
-        struct etNull                     et_null;
-        struct etNullCoalesceAssign       et_null_coalesce_assign;
-        struct etNullCoalesce             et_null_coalesce;
-        struct etNumericLiteral           et_numeric_literal;
-        struct etObjectInit               et_object_init;
-        struct etOptionalChain            et_optional_chain;
-        struct etPropertyAccess           et_property_access;
-        struct etRemainder                et_remainder;
-        struct etRemainderAssign          et_remainder_assign;
-        struct etRightShift               et_right_shift;
-        struct etRightShiftAssign         et_right_shift_assign;
-        struct etSpread                   et_spread;
-        struct etStrictEqual              et_strict_equal;
-        struct etStrictInequal            et_strict_inequal;
-        struct etSubtract                 et_subtract;
-        struct etSubtractAssign           et_subtract_assign;
-        struct etSuper                    et_super;
-        struct etThis                     et_this;
-        struct etTypeof                   et_typeof;
-        struct etUnaryNegate              et_unary_negate;
-        struct etUnaryPlus                et_unary_plus;
-        struct etUnsignedRightShift       et_unsigned_right_shift;
-        struct etUnsignedRightShiftAssign et_unsigned_right_shift_assign;
-        struct etVoid                     et_void;
-        struct etYield                    et_yield;
-        struct etGenYield                 et_gen_yield;
-    };
+    ETIDENTIFIER,
+    ETBOOLEANLITERAL,
+    ETLOGICANDASSIGN,
+    ETCALL,
+    ETINDEX, // a[b]
+    ETARRAYINIT,
+    ETPROPERTYINIT, // one "key: value" of an object literal, or a method
+    ETARROWFUNCTION,
+    ETLOGICNOT,
+    ETGETTER, // "get key() {}" in an object literal
+    ETSETTER, // "set key(value) {}"
+    ETMAX,
 };
 
 enum StatementOrDeclarationType {
-    SDNONE = 0, // used for signalling
+    // numbered on from the expression types so either fits in a node's kind
+    SDPROGRAM = ETMAX, // the root, holding the top-level statements
     SDASYNCFUNCTION,
     SDASYNCGENFUNCTION,
     SDBLOCK,
@@ -381,78 +694,669 @@ enum StatementOrDeclarationType {
     SDTRYCATCH,
     SDVAR,
     SDWHILE,
+    SDINTERFACE,
+    SDTYPEALIAS,
+    SDMAX,
 };
 
-struct Type {};
-
-struct FunctionParameter {
-    struct StringView name;
-    struct Type type;
-};
-
-struct sdAsyncFunction    { struct FunctionParameter *parameters; size_t num_parameters; struct StatementOrDeclaration *statements; size_t num_statements; };
-struct sdAsyncGenFunction { struct FunctionParameter *parameters; size_t num_parameters; struct StatementOrDeclaration *statements; size_t num_statements; };
-struct sdBlock            { };
-struct sdBreak            { };
-struct sdClass            { };
-struct sdConst            { struct StringView name; bool initialised; struct Expression initialiser; };
-struct sdContinue         { };
-struct sdDebugger         { };
-struct sdDoWhile          { };
-struct sdEmpty            { };
-struct sdExport           { };
-struct sdExprStatement    { };
-struct sdFor              { };
-struct sdForAwaitOf       { };
-struct sdForIn            { };
-struct sdForOf            { };
-struct sdFunction         { struct FunctionParameter *parameters; size_t num_parameters; struct StatementOrDeclaration *statements; size_t num_statements; };
-struct sdGenFunction      { struct FunctionParameter *parameters; size_t num_parameters; struct StatementOrDeclaration *statements; size_t num_statements; };
-struct sdIfElse           { };
-struct sdImport           { };
-struct sdLabel            { };
-struct sdLet              { struct StringView name; bool initialised; struct Expression initialiser; };
-struct sdReturn           { };
-struct sdSwitch           { };
-struct sdThrow            { };
-struct sdTryCatch         { };
-struct sdVar              { struct StringView name; bool initialised; struct Expression initialiser; };
-struct sdWhile            { };
-
-struct StatementOrDeclaration {
-    enum StatementOrDeclarationType sdtype;
-    union {
-        struct sdAsyncFunction      sd_async_function;
-        struct sdAsyncGenFunction   sd_async_gen_function;
-        struct sdBlock              sd_block;
-        struct sdBreak              sd_break;
-        struct sdClass              sd_class;
-        struct sdConst              sd_const;
-        struct sdContinue           sd_continue;
-        struct sdDebugger           sd_debugger;
-        struct sdDoWhile            sd_do_while;
-        struct sdEmpty              sd_empty;
-        struct sdExport             sd_export;
-        struct sdExprStatement      sd_expr_statement;
-        struct sdFor                sd_for;
-        struct sdForAwaitOf         sd_for_await_of;
-        struct sdForIn              sd_for_in;
-        struct sdForOf              sd_for_of;
-        struct sdFunction           sd_function;
-        struct sdGenFunction        sd_gen_function;
-        struct sdIfElse             sd_if_else;
-        struct sdImport             sd_import;
-        struct sdLabel              sd_label;
-        struct sdLet                sd_let;
-        struct sdReturn             sd_return;
-        struct sdSwitch             sd_switch;
-        struct sdThrow              sd_throw;
-        struct sdTryCatch           sd_try_catch;
-        struct sdVar                sd_var;
-        struct sdWhile              sd_while;
-    };
+enum TypeExpressionType {
+    // numbered on from the statements; these only appear in annotations
+    TEREFERENCE = SDMAX, // a type's name
+    TEINSTANCE, // Name<Arguments>
+    TEARRAY,
+    TEUNION,
+    TEOBJECT,
+    TEMEMBER,
+    TEOPTIONALMEMBER,
+    TEFUNCTION, // (parameters) => result
+    TEVOID,
+    TEANNOTATION, // what a ": type" follows, and the type
+    TEOPTIONAL, // a parameter followed by "?", and its type if it has one
+    TEMAX, // must stay <= 256, kinds are stored in a byte
+};
+
+/**A function's signature and body, kept beside the nodes (NLFUNCTION).
+ *
+ * Block bodies are only brace-matched when the function is parsed, and body
+ * stays NODE_NONE until something needs it and calls parse_function_body;
+ * body_start and body_end are then the tokens of its "{" and "}".  An arrow
+ * function with an expression body has it parsed straight away, and
+ * body_start == body_end == 0.  A function whose node reparse_edits threw
+ * away has neither a body nor a body range.
+ */
+struct Function {
+    uint32_t name;          // the symbol, or SYMBOL_NONE if anonymous
+    uint32_t parameters;    // a counted list in extra
+    uint32_t body;          // an SDBLOCK, an expression, or NODE_NONE
+    uint32_t result;        // the return type annotation, or NODE_NONE
+    uint32_t body_start, body_end;
+};
+
+/**A file's syntax tree as flat arrays (parse.c).
+ *
+ * Every expression and statement is a 16-byte Node in one array, and nodes
+ * refer to each other by index.  A node's kind is an ExpressionType or a
+ * StatementOrDeclarationType.  token is the operator's token for operators,
+ * the opening bracket for calls, indexing and literals with brackets, and
+ * otherwise the first token.  What lhs and rhs hold depends on the kind's
+ * layout (node_layouts):
+ *
+ *   NLLEAF          nothing, or for ETIDENTIFIER lhs: the symbol (which is
+ *                   SYMBOL_NONE for a keyword used as a property name),
+ *                   ETNUMERICLITERAL lhs: index into numbers, rhs: true for
+ *                   a BigInt, ETBOOLEANLITERAL lhs: the value
+ *   NLUNARY         lhs: the operand, which ETYIELD and SDRETURN may lack;
+ *                   ETINCREMENT and ETDECREMENT have rhs: true for the
+ *                   prefix form
+ *   NLBINARY        lhs, rhs: the operands; for ETPROPERTYINIT the key and
+ *                   the value, where a computed key's token is its "[";
+ *                   a TEANNOTATION may lack lhs and a TEOPTIONAL rhs
+ *   NLMEMBER        lhs: the object, rhs: the property name's symbol; the
+ *                   name is the token after the "."
+ *   NLTERNARY       lhs: the condition, rhs: a pair in extra
+ *   NLCALL          lhs: the callee, rhs: a counted list of arguments
+ *   NLLIST          lhs, rhs: a list (array holes are NODE_NONE)
+ *   NLFUNCTION      lhs: index into functions
+ *   NLDECLARATION   lhs: the name's symbol, rhs: initialiser or NODE_NONE;
+ *                   the name is the token after the keyword.  An annotated
+ *                   variable's rhs is a TEANNOTATION of the initialiser
+ *   NLNAMED         lhs: the name's symbol, rhs: what it names; the name
+ *                   is the node's token
+ *
+ * A list is a run of node indices in extra, given by lhs = the index of its
+ * first entry and rhs = its length, so nodes are never variable length.
+ * Where only one field is free, a counted list is used instead: the index in
+ * extra of its length, followed by its entries.  Payloads that don't fit in
+ * 32 bits live in side arrays.
+ *
+ * a?.b is a property access whose object is an ETOPTIONALCHAIN wrapping a,
+ * and the same for a?.[b] and a?.(b).
+ *
+ * Type annotations are nodes too, of the TypeExpressionType kinds.  Literal
+ * types use the expression literal kinds.  An interface is an SDINTERFACE
+ * declaration of a TEOBJECT, whose members are TEMEMBERs, and a type alias
+ * an SDTYPEALIAS declaration of its type.  A TEFUNCTION has the layout of a
+ * call: lhs is the result and rhs the parameters.  An annotated parameter is
+ * a TEANNOTATION wrapping it, or TEOPTIONAL for "x?" and "x?: T".
+ *
+ * The arrays are allocated from the arena given to ast_init and live as long
+ * as it does.  The root is always node 0, which is nobody's child, so
+ * NODE_NONE (0) marks a missing child.
+ *
+ * reparse_edits leaves the token indices of what it kept to be shifted on
+ * read, by ast_node_token and ast_function, until reparse_settle writes the
+ * shifts in.
+ */
+#define NODE_NONE 0
+
+// how many edits' shifts a tree holds before reparse_edits settles it
+#define AST_MAX_SHIFTS 32
+
+/**A shift an edit made to the tokens, not yet written into the tree: tokens
+ * from from on moved by by.  It only applies to the nodes and functions
+ * there were at the time, the ones below nodes and functions.
+ */
+struct AstShift {
+    uint32_t nodes, functions;
+    uint32_t from;
+    int32_t by;
+};
+
+struct Node {
+    uint8_t kind;
+    uint32_t token;
+    uint32_t lhs;
+    uint32_t rhs;
 };
 
-int parse_tokens(const struct Token *tokens, size_t num_tokens, struct StatementOrDeclaration *out);
+struct Ast {
+    struct Arena *arena;
+    struct Node *nodes;
+    size_t count, capacity;
+    uint32_t *extra;
+    size_t extra_count, extra_capacity;
+    double *numbers;
+    size_t number_count, number_capacity;
+    struct Function *functions;
+    size_t function_count, function_capacity;
+    struct AstShift shifts[AST_MAX_SHIFTS];    // in the order they were made
+    size_t shift_count;
+};
+
+/**A token index as it is after the shifts pending for the node or function
+ * at index, taking function for which.
+ */
+static inline uint32_t ast_shift_token(const struct Ast *ast, uint32_t token, size_t index, bool function)
+{
+    for (size_t i = 0; i < ast->shift_count; i++) {
+        const struct AstShift *shift = &ast->shifts[i];
+        if (index < (function ? shift->functions : shift->nodes) && token >= shift->from)
+            token += shift->by;
+    }
+
+    return token;
+}
+
+static inline uint32_t ast_node_token(const struct Ast *ast, uint32_t node)
+{
+    // the root starts at token 0 whatever happens
+    return node == 0 ? 0 : ast_shift_token(ast, ast->nodes[node].token, node, false);
+}
+
+static inline struct Function ast_function(const struct Ast *ast, uint32_t function)
+{
+    struct Function f = ast->functions[function];
+
+    if (f.body_end != 0) {
+        f.body_start = ast_shift_token(ast, f.body_start, function, true);
+        f.body_end = ast_shift_token(ast, f.body_end, function, true);
+    }
+
+    return f;
+}
+
+enum NodeLayout {
+    NLLEAF = 0,
+    NLUNARY,
+    NLBINARY,
+    NLMEMBER,
+    NLTERNARY,
+    NLCALL,
+    NLLIST,
+    NLFUNCTION,
+    NLDECLARATION,
+    NLNAMED,
+};
+
+extern const char *const node_kind_strings[TEMAX];
+extern const uint8_t node_layouts[TEMAX];
+
+static inline bool node_is_statement(uint8_t kind)
+{
+    return kind >= SDPROGRAM && kind < SDMAX;
+}
+
+int ast_init(struct Ast *ast, struct Arena *arena, size_t expected_nodes);
+int ast_reserve(struct Ast *ast, size_t capacity);
+
+/**Appends a node and returns its index, or NODE_NONE if out of memory.
+ */
+static inline uint32_t ast_push(struct Ast *ast, uint8_t kind, uint32_t token, uint32_t lhs, uint32_t rhs)
+{
+    if (ast->count == ast->capacity && ast_reserve(ast, ast->count + 1) != EXIT_SUCCESS)
+        return NODE_NONE;
+
+    uint32_t i = ast->count++;
+    ast->nodes[i] = (struct Node) { .kind = kind, .token = token, .lhs = lhs, .rhs = rhs };
+
+    return i;
+}
+
+/**Copies a list of node indices into extra and writes where it starts.
+ */
+int ast_push_list(struct Ast *ast, const uint32_t *items, size_t count, uint32_t *start);
+int ast_push_number(struct Ast *ast, double value, uint32_t *index);
+int ast_push_function(struct Ast *ast, struct Function function, uint32_t *index);
+
+/**Appends all of part, renumbering the nodes, lists, numbers and functions it
+ * refers to.  part's node 0 is a placeholder that isn't copied, so its node i
+ * becomes node ast->count - 1 + i.
+ */
+int ast_append(struct Ast *ast, const struct Ast *part);
+
+/**Parses a whole file's tokens into ast, which must have been initialised.
+ * Function bodies are only skipped over (see struct Function).  On failure,
+ * writes the index of the token that couldn't be parsed to *error_token.
+ */
+int parse_tokens(const struct TokenBuffer *tokens, struct Ast *ast, size_t *error_token);
+
+/**Like parse_tokens, parsing runs of top-level statements on up to threads
+ * threads and stitching the results.  The tree is identical to
+ * parse_tokens's, including how it is numbered.  Small files are parsed
+ * serially.
+ */
+int parse_tokens_parallel(const struct TokenBuffer *tokens, struct Ast *ast, size_t *error_token, size_t threads);
+
+/**Brings tokens and ast, built from the text before the edits, up to date
+ * with contents, lexing and parsing again only around the damage.  Token
+ * starts and indices after it are shifted lazily: call reparse_settle before
+ * handing the tokens or tree to anything that reads them directly.  On
+ * failure the tree no longer matches the tokens, and has to be built again
+ * with parse_tokens once the text parses.
+ */
+int reparse_edits(const char *contents, size_t length, struct Interner *interner, struct TokenBuffer *tokens,
+                  struct Ast *ast, const struct TextEdit *edits, size_t edit_count, size_t *error_token);
+/**Writes the shifts reparse_edits left pending into the tokens and tree.
+ */
+void reparse_settle(struct TokenBuffer *tokens, struct Ast *ast);
+
+/**If parsing failed at error_token because it starts a form the parser
+ * doesn't handle yet, names the form ("classes", "if statements"), else NULL.
+ */
+const char *parse_unsupported(const struct TokenBuffer *tokens, size_t error_token);
+
+/**Parses the body of ast->functions[function] if that hasn't been done yet.
+ * Functions nested in it get their own unparsed bodies.
+ */
+int parse_function_body(const struct TokenBuffer *tokens, struct Ast *ast, uint32_t function, size_t *error_token);
+
+/**Parses every body that hasn't been parsed yet, nested ones included.
+ */
+int parse_function_bodies(const struct TokenBuffer *tokens, struct Ast *ast, size_t *error_token);
+
+/**A table of structural types (types.c).
+ *
+ * Every type in a compilation is hash-consed through one table and named by
+ * a 32-bit ID, so two types are identical exactly when their IDs are equal,
+ * and each distinct type is stored once however often it appears.  Types are
+ * structural: an interface is the object type of its members, and its name
+ * plays no part.  IDs are handed out densely, and the primitives come first,
+ * so a primitive's ID is its kind (TKNUMBER is the ID of number).  A Type's
+ * a and b depend on its kind:
+ *
+ *   TKSTRINGLITERAL a: the symbol of the string's value
+ *   TKNUMBERLITERAL a, b: the low and high halves of the double
+ *   TKARRAY         a: the element type
+ *   TKPARAMETER     a: the name's symbol, b: the declaration that owns it
+ *   TKUNION         a list of two or more member IDs in increasing order
+ *   TKOBJECT        a list of (name symbol, type, TypeMemberFlags) triples
+ *                   in increasing order of name
+ *   TKFUNCTION      a list of the return type, the number of required
+ *                   parameters, whether the last is a rest parameter, then
+ *                   the parameter types
+ *   TKINSTANCE      a list of the generic declaration, then the type
+ *                   arguments
+ *
+ * A list is a run in extra given by a = its first entry and b = its length.
+ * A declaration is whatever number the checker gives each generic
+ * declaration; the table only compares them.
+ */
+#define TYPE_NONE 0
+
+enum TypeKind {
+    TKNONE = 0,
+    // primitives
+    TKANY,
+    TKUNKNOWN,
+    TKNEVER,
+    TKVOID,
+    TKUNDEFINED,
+    TKNULL,
+    TKBOOLEAN,
+    TKTRUE,
+    TKFALSE,
+    TKNUMBER,
+    TKSTRING,
+    TKBIGINT,
+    TKSYMBOL,
+    TKNONPRIMITIVE, // object
+    TKPRIMITIVEMAX,
+    // types with a payload
+    TKSTRINGLITERAL = TKPRIMITIVEMAX,
+    TKNUMBERLITERAL,
+    TKARRAY,
+    TKPARAMETER,
+    // types with a list
+    TKUNION,
+    TKOBJECT,
+    TKFUNCTION,
+    TKINSTANCE,
+    TKMAX,
+};
+
+enum TypeMemberFlags {
+    TMOPTIONAL = 1,
+    TMREADONLY = 2,
+};
+
+struct Type {
+    uint8_t kind;
+    uint32_t a;
+    uint32_t b;
+};
+
+struct TypeMember {
+    uint32_t name;
+    uint32_t type;
+    uint32_t flags;
+};
+
+struct TypeSlot {
+    uint32_t hash;
+    uint32_t type;
+};
+
+struct TypeTable {
+    struct Arena *arena;    // where the arrays live, and die with
+    struct Type *types;     // indexed by ID
+    size_t count, capacity;
+    uint32_t *extra;
+    size_t extra_count, extra_capacity;
+    uint32_t *scratch;      // where constructors build candidate lists
+    size_t scratch_capacity;
+    struct TypeSlot *slots;
+    size_t slot_count;
+};
+
+static inline bool type_kind_has_list(uint8_t kind)
+{
+    return kind >= TKUNION;
+}
+
+static inline const uint32_t *type_list(const struct TypeTable *table, uint32_t type)
+{
+    return &table->extra[table->types[type].a];
+}
+
+/**The table's arrays are allocated from arena and live as long as it does.
+ */
+int type_table_init(struct TypeTable *table, struct Arena *arena);
+/**Makes copy an independent table holding the same types under the same
+ * IDs, in arena, so types can be added to it without touching the original.
+ */
+int type_table_copy(struct TypeTable *copy, const struct TypeTable *table, struct Arena *arena);
+
+/**Returns the ID of the type, adding it if it's new, or TYPE_NONE if out of
+ * memory.  For a kind with a list, a and b are ignored and the list is
+ * copied; it must already be in canonical order, which the constructors
+ * below take care of.
+ */
+uint32_t type_intern(struct TypeTable *table, uint8_t kind, uint32_t a, uint32_t b, const uint32_t *list, size_t length);
+
+uint32_t type_string_literal(struct TypeTable *table, uint32_t symbol);
+uint32_t type_number_literal(struct TypeTable *table, double value);
+uint32_t type_array(struct TypeTable *table, uint32_t element);
+uint32_t type_parameter(struct TypeTable *table, uint32_t symbol, uint32_t declaration);
+
+/**The union of the members, flattening nested unions and dropping repeats
+ * and never.  A union of one type is that type, and of none is never.
+ */
+uint32_t type_union(struct TypeTable *table, const uint32_t *members, size_t count);
+
+/**The object type with the members, which are sorted in place by name.
+ * Names must be distinct.
+ */
+uint32_t type_object(struct TypeTable *table, struct TypeMember *members, size_t count);
+uint32_t type_function(struct TypeTable *table, const uint32_t *parameters, size_t count, size_t required,
+                       bool rest, uint32_t result);
+uint32_t type_instance(struct TypeTable *table, uint32_t declaration, const uint32_t *arguments, size_t count);
+
+/**Type checking of a parsed file (check.c).
+ *
+ * Annotations are resolved to types in the TypeTable, the types of
+ * expressions are worked out bottom up, and wherever a value flows into
+ * something annotated the checker asks whether its type is assignable.
+ * Those questions go through a relation cache, so comparing the same two
+ * interfaces again costs a lookup.  Function bodies are parsed as the
+ * checker reaches them.  The bodies of top-level functions are checked last,
+ * spread over up to threads threads.  Type errors become diagnostics, sorted
+ * by where they are, which are the same whatever the number of threads;
+ * check_program only fails for a body that doesn't parse, whose token is
+ * written to *error_token, or when out of memory.
+ */
+struct Diagnostic {
+    uint32_t token;
+    uint32_t order;         // the order reported in, which breaks ties
+    const char *message;
+};
+
+struct Diagnostics {
+    struct Diagnostic *items;
+    size_t count, capacity;
+    struct Arena text;
+};
+
+/**What a check remembers about each top-level statement, so that checking
+ * the file again after an edit (see reparse_edits) can skip what can't have
+ * changed.
+ *
+ * A statement is matched to the last run's by a hash of its tokens, so it
+ * matches wherever it has moved to.  Its parts are what it does at the top
+ * level and each of the function bodies left until after it (see
+ * check_program).  For each part, the state records the top-level names it
+ * used, in which namespace, and the type each resolved to.  The table is
+ * hash-consed, so a type's ID is its signature: if every name resolves to
+ * the same type again, checking the part again would come out the same.  It
+ * is skipped, and keeps the types it bound and the diagnostics it had.
+ *
+ * A state only makes sense with the interner and type table it was made
+ * with; given others, every statement is checked.
+ */
+enum CheckedSpace {
+    CSVALUE = 0,
+    CSTYPE,
+    CSSHAPE,    // the members of an interface
+};
+
+struct CheckedUse {
+    uint32_t symbol;
+    uint32_t seen;          // the type it resolved to, or TYPE_NONE
+    uint32_t part;          // 0 for the statement, or 1 + which of its bodies
+    uint8_t space;
+    uint8_t flags;          // of the binding it resolved to
+};
+
+struct CheckedReport {
+    uint32_t offset;        // in tokens from the start of the statement
+    const char *message;
+};
+
+struct CheckedStatement {
+    uint64_t text;          // a hash of its tokens
+    uint32_t type;          // the type of what it declares, or TYPE_NONE
+    uint32_t shape;         // an interface's members, or TYPE_NONE
+    uint32_t bodies;        // how many function bodies it left
+    uint32_t uses, use_count;           // a run in CheckState.uses
+    uint32_t reports, report_count;     // a run in CheckState.reports
+};
+
+struct CheckState {
+    const struct Interner *interner;
+    const struct TypeTable *types;
+    struct CheckedStatement *statements;
+    size_t count;
+    struct CheckedUse *uses;
+    size_t use_count;
+    struct CheckedReport *reports;
+    size_t report_count;
+    struct Arena text;
+    size_t checked, kept;   // how many parts the last run checked and skipped
+};
+
+void diagnostics_free(struct Diagnostics *diagnostics);
+void check_state_free(struct CheckState *state);
+/**state may be NULL.  Otherwise it's used to skip work, and replaced with
+ * what this run found.
+ */
+int check_program(const struct TokenBuffer *tokens, struct Ast *ast, struct Interner *interner,
+                  struct TypeTable *types, struct Diagnostics *diagnostics, size_t *error_token, size_t threads,
+                  struct CheckState *state);
+
+/**Type stripping (strip.c), which turns a file's tokens into JavaScript
+ * without parsing it, by cutting out the type syntax and keeping the rest
+ * of the text as it is.
+ *
+ * Interfaces, type aliases, declare statements, type imports and exports,
+ * annotations, optional marks, non-null assertions, as and satisfies casts,
+ * type parameters and arguments, implements clauses, access modifiers,
+ * abstract and declared members, index signatures, this parameters and
+ * overloads are cut.  Enums, namespaces and parameter properties would need
+ * code written for them, so they fail, with error_token at the first token.
+ */
+struct SourceSpan {
+    uint32_t start, length;
+};
+
+struct SpanBuffer {
+    struct SourceSpan *spans;
+    size_t count, capacity;
+};
+
+void span_buffer_free(struct SpanBuffer *spans);
+/**Fills spans with the parts of the length bytes of source to keep, in
+ * order.
+ */
+int strip_types(const struct TokenBuffer *tokens, size_t length, struct SpanBuffer *spans, size_t *error_token);
+
+/**JavaScript output (emit.c).
+ *
+ * A file is emitted by copying its text into an OutputBuffer with the types
+ * the tree holds cut out, and written with output_write.
+ */
+struct OutputBuffer {
+    char *data;
+    size_t length, capacity;
+};
+
+int output_reserve(struct OutputBuffer *out, size_t capacity);
+int output_append(struct OutputBuffer *out, const char *data, size_t length);
+void output_buffer_free(struct OutputBuffer *out);
+/**Writes the buffers to fd in order, with one writev for up to IOV_MAX of
+ * them, so one system call per file at most.
+ */
+int output_write(int fd, const struct OutputBuffer *buffers, size_t count);
+
+struct SourceMap;
+struct Folding;
+
+/**Appends the parsed file whose source is length bytes long to out as
+ * JavaScript, and maps what it writes in map, unless that's NULL.  With a
+ * folding, known values are written in place of the expressions that give
+ * them, where that's no longer.  Every function body has to have been
+ * parsed; on failure, *error_token is the first token of the one that
+ * wasn't.
+ */
+int emit_program(const struct TokenBuffer *tokens, const struct Ast *ast, const struct Folding *folding, size_t length,
+                 struct OutputBuffer *out, struct SourceMap *map, size_t *error_token);
+
+/**Version 3 source maps (sourcemap.c) for output that is the source with
+ * parts cut out, as both emit_program's and strip_types's are.
+ *
+ * MDTOKENS maps the start of every token copied to the output; MDLINES only
+ * maps the start of each line, which is far less to build and to load.
+ * Columns are counted in bytes, as everywhere else.
+ */
+enum MapDetail {
+    MDTOKENS = 0,
+    MDLINES,
+};
+
+struct SourceMap {
+    const struct TokenBuffer *tokens;
+    const struct LineTable *lines;
+    uint8_t detail;
+    struct OutputBuffer mappings;   // the text of the mappings field
+    size_t token, line;             // how far the cursors have got
+    size_t column_line, column_offset;  // the last source column counted,
+    uint32_t column;                // and where it was
+    uint32_t generated_line, generated_column;  // the end of the output so far
+    uint32_t mapped_line;           // the output line of the last segment
+    bool line_mapped;               // whether there's a segment on it
+    uint32_t previous_column, previous_source_line, previous_source_column;
+    bool failed;
+};
+
+void source_map_init(struct SourceMap *map, const struct TokenBuffer *tokens, const struct LineTable *lines,
+                     uint8_t detail);
+void source_map_free(struct SourceMap *map);
+/**Records that the source text from start to end was copied to the end of
+ * the output.  Runs have to be added in order.
+ */
+void source_map_add_run(struct SourceMap *map, size_t start, size_t end);
+/**Writes the map as JSON to fd, naming source_name as its one source.
+ */
+int source_map_write(int fd, const struct SourceMap *map, const char *source_name);
+/**Records that length bytes of text, with no line breaks, were written to
+ * the end of the output in place of the source text at start.
+ */
+void source_map_add_text(struct SourceMap *map, size_t start, const char *text, size_t length);
+
+/**Constant folding (fold.c) of a parsed file, for emit_program.
+ *
+ * Each expression whose value can be worked out is given a Constant, and
+ * each "&&", "||", "??" or conditional that comes down to one operand whose
+ * value can't is given that operand as its stand-in.  A const whose
+ * initialiser is known lends its value to the names that refer to it.  The
+ * tree isn't changed.
+ */
+enum ConstantKind {
+    CKNONE = 0,
+    CKUNDEFINED,
+    CKNULL,
+    CKBOOLEAN,
+    CKNUMBER,
+    CKSTRING,
+};
+
+struct Constant {
+    uint8_t kind;
+    bool boolean;
+    double number;
+    struct StringView string;   // its UTF-8, without quotes or escapes
+};
+
+struct Folding {
+    uint32_t *values;           // by node: index into constants, or 0
+    uint32_t *stand_ins;        // by node: the operand it comes to, or NODE_NONE
+    struct Constant *constants; // constants[0] is none
+    size_t constant_count, constant_capacity;
+    struct Arena text;          // strings made by folding
+};
+
+// the longest text number_to_string gives, with its NUL
+#define NUMBER_TEXT_MAX 32
+
+/**Every function body has to have been parsed.
+ */
+int fold_constants(const struct TokenBuffer *tokens, const struct Ast *ast, const struct Interner *interner,
+                   struct Folding *folding);
+void folding_free(struct Folding *folding);
+/**Writes ToString of value, as JavaScript gives it, to text and returns its
+ * length.
+ */
+size_t number_to_string(double value, char *text);
+/**The index of the first token of the node's text.
+ */
+uint32_t node_first_token(const struct TokenBuffer *tokens, const struct Ast *ast, uint32_t node);
+
+/**An on-disk cache of lexed and parsed files (cache.c).
+ *
+ * An entry holds a file's tokens, its tree as parse_tokens left it, and the
+ * text of its symbols, under a key hashed from the file's contents and
+ * COMPILER_VERSION, with a copy of the contents so that files whose keys
+ * collide are told apart.  A hit maps the entry and points the tokens and tree
+ * straight into the mapping, skipping lexing and parsing.  COMPILER_VERSION
+ * must change whenever the tokens or the tree would come out differently.
+ */
+#define COMPILER_VERSION "0.3"
+
+struct CacheEntry {
+    void *mapping;
+    size_t mapping_length;
+};
+
+uint64_t cache_key(const char *data, size_t length);
+
+/**Looks for source's entry in directory.  On a hit, interns the file's
+ * symbols into interner, which must be empty, and fills in tokens and ast.
+ * Their arrays belong to entry and are released by cache_entry_free, never
+ * token_buffer_free; the tree can still grow, into arena.
+ */
+int cache_load(const char *directory, uint64_t key, const struct SourceFile *source, struct Interner *interner,
+               struct TokenBuffer *tokens, struct Ast *ast, struct Arena *arena, struct CacheEntry *entry);
+void cache_entry_free(struct CacheEntry *entry);
+
+/**Writes an entry for source, creating directory if it doesn't exist.
+ */
+int cache_store(const char *directory, uint64_t key, const struct SourceFile *source, const struct Interner *interner,
+                const struct TokenBuffer *tokens, const struct Ast *ast);
+
+/**Edits the file over and over, bringing its tokens and tree up to date with
+ * reparse_edits after each edit and comparing them with lexing and parsing
+ * it from scratch (verify.c).  With bench, both ways are timed; with recheck,
+ * checking again with a CheckState is compared with checking from scratch
+ * too.  Prints what it found, and fails if anything differed.
+ */
+int verify_reparse(const char *name, bool bench, bool recheck);
 
 #endif // COMPILE_H
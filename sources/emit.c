@@ -0,0 +1,687 @@
+#define _XOPEN_SOURCE 700 // writev and IOV_MAX
+
+#include "compile.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/* Everything in a tree that isn't a type is written back exactly as it was,
+ * so the emitter never prints a node.  It walks the tree in source order,
+ * holding the offset up to which the text has been dealt with, and each
+ * annotation or type declaration it meets cuts the tokens it covers: the
+ * text before them is copied into the output in one run, and the offset
+ * moves past them.  Whole functions and statements without types go out as
+ * a single copy however many nodes they hold.
+ *
+ * Types don't record where they end, so the end is found by skipping over
+ * the tokens the way parse_type read them.
+ *
+ * Given a Folding, an expression with a known value is cut like a type and
+ * its value written in its place, as long as that's no longer than what it
+ * replaces; and one that comes down to a stand-in has the text around the
+ * stand-in cut.  Neither is done at the start of a statement or an arrow
+ * function's body where what's left could read differently: as a directive,
+ * a block or a declaration, or as going on from the line before.
+ */
+
+// what statement_start holds outside statements and arrow function bodies
+#define NO_TOKEN UINT32_MAX
+
+struct Emitter {
+    const struct TokenBuffer *tokens;
+    const struct Ast *ast;
+    struct OutputBuffer *out;
+    struct SourceMap *map;
+    const struct Folding *folding;
+    size_t kept;            // the text before this has been copied or cut
+    size_t error_token;
+    bool failed;
+    uint32_t parent;        // the node whose children are being emitted
+    uint32_t statement_start;   // the first token of the expression statement
+                                // or arrow function body, or NO_TOKEN
+};
+
+int output_reserve(struct OutputBuffer *out, size_t capacity)
+{
+    if (capacity <= out->capacity)
+        return EXIT_SUCCESS;
+
+    size_t wanted = out->capacity ? out->capacity : capacity;
+    while (wanted < capacity)
+        wanted *= 2;
+
+    char *resized = realloc(out->data, wanted);
+    if (resized == NULL)
+        return EXIT_FAILURE;
+
+    out->data = resized;
+    out->capacity = wanted;
+
+    return EXIT_SUCCESS;
+}
+
+void output_buffer_free(struct OutputBuffer *out)
+{
+    free(out->data);
+    *out = (struct OutputBuffer) {0};
+}
+
+int output_append(struct OutputBuffer *out, const char *data, size_t length)
+{
+    if (output_reserve(out, out->length + length) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    memcpy(out->data + out->length, data, length);
+    out->length += length;
+
+    return EXIT_SUCCESS;
+}
+
+int output_write(int fd, const struct OutputBuffer *buffers, size_t count)
+{
+    struct iovec vectors[IOV_MAX];
+    size_t next = 0, offset = 0; // the first buffer not yet written, and how much of it was
+
+    while (next < count) {
+        size_t used = 0;
+
+        for (size_t i = next; i < count && used < IOV_MAX; i++) {
+            size_t skip = i == next ? offset : 0;
+            if (buffers[i].length > skip)
+                vectors[used++] = (struct iovec) { .iov_base = buffers[i].data + skip, .iov_len = buffers[i].length - skip };
+        }
+
+        if (used == 0)
+            break;
+
+        ssize_t written = writev(fd, vectors, (int)used);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return EXIT_FAILURE;
+        }
+
+        // a short write stops partway through a buffer
+        for (size_t left = (size_t)written; next < count; next++, offset = 0) {
+            if (buffers[next].length - offset > left) {
+                offset += left;
+                break;
+            }
+            left -= buffers[next].length - offset;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static void keep_to(struct Emitter *e, size_t end)
+{
+    if (end <= e->kept)
+        return;
+
+    if (e->map != NULL)
+        source_map_add_run(e->map, e->kept, end);
+
+    if (output_append(e->out, e->tokens->source + e->kept, end - e->kept) != EXIT_SUCCESS)
+        e->failed = true;
+
+    e->kept = end;
+}
+
+/**Cuts the text from start to end, which must come after everything cut so
+ * far; first is the token to blame if it doesn't.
+ */
+static void cut_text(struct Emitter *e, size_t start, size_t end, size_t first)
+{
+    if (start < e->kept) {
+        if (!e->failed)
+            e->error_token = first;
+        e->failed = true;
+        return;
+    }
+
+    keep_to(e, start);
+    e->kept = end;
+}
+
+/**Cuts tokens first to last, inclusive.
+ */
+static void cut_tokens(struct Emitter *e, size_t first, size_t last)
+{
+    const struct TokenBuffer *tokens = e->tokens;
+
+    if (last >= tokens->count) {
+        if (!e->failed)
+            e->error_token = first;
+        e->failed = true;
+        return;
+    }
+
+    cut_text(e, tokens->starts[first], tokens->starts[last] + tokens->lengths[last], first);
+}
+
+/**The index after the bracket that closes the one at "at".
+ */
+static size_t skip_brackets(const struct TokenBuffer *tokens, size_t at)
+{
+    size_t depth = 0;
+
+    for (; at < tokens->count; at++) {
+        switch (token_type(tokens, at)) {
+        case TTOPENPAREN:
+        case TTOPENBRACKET:
+        case TTOPENBRACE:
+            ++depth;
+            break;
+        case TTCLOSEPAREN:
+        case TTCLOSEBRACKET:
+        case TTCLOSEBRACE:
+            if (--depth == 0)
+                return at + 1;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return at;
+}
+
+/**The index after the list of type arguments whose "<" is at "at", counting
+ * the ends of lists nested in it that a ">>" or ">>>" closes.
+ */
+static size_t skip_type_arguments(const struct TokenBuffer *tokens, size_t at)
+{
+    int depth = 0;
+
+    for (; at < tokens->count; at++) {
+        switch (token_type(tokens, at)) {
+        case TTLESS:
+            ++depth;
+            break;
+        case TTGREATER:
+            --depth;
+            break;
+        case TTBITSHR:
+            depth -= 2;
+            break;
+        case TTBITSHRZERO:
+            depth -= 3;
+            break;
+        default:
+            break;
+        }
+
+        if (depth <= 0)
+            return at + 1;
+    }
+
+    return at;
+}
+
+/**The index after the type starting at "at", read as parse_type reads it.
+ */
+static size_t skip_type(const struct TokenBuffer *tokens, size_t at)
+{
+    if (at < tokens->count && token_type(tokens, at) == TTBITOR)
+        ++at;
+
+    while (at < tokens->count) {
+        switch (token_type(tokens, at)) {
+        case TTIDENTIFIER:
+            if (++at < tokens->count && token_type(tokens, at) == TTLESS)
+                at = skip_type_arguments(tokens, at);
+            break;
+        case TTOPENBRACE:
+            at = skip_brackets(tokens, at);
+            break;
+        case TTOPENPAREN:
+            at = skip_brackets(tokens, at);
+            if (at < tokens->count && token_type(tokens, at) == TTARROW)
+                at = skip_type(tokens, at + 1);
+            break;
+        default:
+            ++at;
+            break;
+        }
+
+        while (at + 1 < tokens->count
+                && token_type(tokens, at) == TTOPENBRACKET && token_type(tokens, at + 1) == TTCLOSEBRACKET)
+            at += 2;
+
+        if (at >= tokens->count || token_type(tokens, at) != TTBITOR)
+            break;
+        ++at;
+    }
+
+    return at;
+}
+
+/**The index of the last token of the node's text.
+ */
+static uint32_t last_token(const struct Emitter *e, uint32_t node)
+{
+    const struct Ast *ast = e->ast;
+
+    while (true) {
+        struct Node n = ast->nodes[node];
+
+        switch (n.kind) {
+        case ETGROUP:
+        case ETCALL:
+        case ETINDEX:
+        case ETARRAYINIT:
+        case ETOBJECTINIT:
+        case SDBLOCK:
+            return skip_brackets(e->tokens, n.token) - 1;
+        case ETNEW:
+            // "new a(b)" is a call, "new a" isn't
+            if (token_type(e->tokens, n.token) == TTOPENPAREN)
+                return skip_brackets(e->tokens, n.token) - 1;
+            node = n.lhs;
+            continue;
+        case ETINCREMENT:
+        case ETDECREMENT:
+            if (!n.rhs)
+                return n.token;
+            node = n.lhs;
+            continue;
+        case ETPROPERTYACCESS:
+            return n.token + 1;
+        case ETOPTIONALCHAIN:
+            return n.token;
+        case ETNEWTARGET:
+        case ETIMPORTMETA:
+            return n.token + 2;
+        case ETTERNARY:
+            node = ast->extra[n.rhs + 1];
+            continue;
+        default:
+            break;
+        }
+
+        switch (node_layouts[n.kind]) {
+        case NLUNARY:
+            if (n.lhs == NODE_NONE)
+                return n.token;
+            node = n.lhs;
+            continue;
+        case NLBINARY:
+            node = n.rhs;
+            continue;
+        case NLFUNCTION: {
+            const struct Function *f = &ast->functions[n.lhs];
+            if (f->body_start != f->body_end)
+                return f->body_end;
+            node = f->body;
+            continue;
+        }
+        default:
+            return n.token;
+        }
+    }
+}
+
+static bool is_name_char(char c)
+{
+    return char_is(c, CCIDENT) || (unsigned char)c >= 0x80;
+}
+
+/**Whether text starting with the token at "at" can start a statement or an
+ * arrow function's body and be read as the expression it was.
+ */
+static bool starts_plainly(const struct TokenBuffer *tokens, size_t at)
+{
+    switch (token_type(tokens, at)) {
+    case TTIDENTIFIER:
+        // not "async function"
+        return at + 1 >= tokens->count || token_type(tokens, at + 1) != TTFUNCTION;
+    case TTNUMLITERAL:
+    case TTTHIS:
+    case TTNEW:
+    case TTTRUE:
+    case TTFALSE:
+    case TTNULL:
+    case TTTYPEOF:
+    case TTVOID:
+    case TTDELETE:
+    case TTBANG:
+    case TTBITNOT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**Writes the text of a constant to out, or with out NULL, just gives its
+ * length.
+ */
+static size_t constant_text(const struct Constant *c, char *out)
+{
+    char number[NUMBER_TEXT_MAX];
+    const char *text = number;
+    size_t length;
+
+    switch (c->kind) {
+    case CKSTRING:
+        length = c->string.length + 2;
+        for (size_t i = 0; i < c->string.length; i++)
+            length += c->string.data[i] == '"';
+
+        if (out != NULL) {
+            *out++ = '"';
+            for (size_t i = 0; i < c->string.length; i++) {
+                if (c->string.data[i] == '"')
+                    *out++ = '\\';
+                *out++ = c->string.data[i];
+            }
+            *out = '"';
+        }
+        return length;
+    case CKUNDEFINED:
+        text = "void 0";
+        break;
+    case CKNULL:
+        text = "null";
+        break;
+    case CKBOOLEAN:
+        text = c->boolean ? "true" : "false";
+        break;
+    default:
+        // the literals for these would be names that could be shadowed
+        if (isnan(c->number))
+            text = "(0/0)";
+        else if (isinf(c->number))
+            text = c->number > 0 ? "(1/0)" : "(-1/0)";
+        else if (c->number == 0 && signbit(c->number))
+            text = "-0";
+        else
+            number_to_string(c->number, number);
+        break;
+    }
+
+    length = strlen(text);
+    if (out != NULL)
+        memcpy(out, text, length);
+
+    return length;
+}
+
+/**Writes the node's value in place of its text, if that's no longer and
+ * safe where it is.  Returns whether it did.
+ */
+static bool emit_constant(struct Emitter *e, uint32_t node, const struct Constant *c)
+{
+    const struct TokenBuffer *tokens = e->tokens;
+    const struct Node *parent = &e->ast->nodes[e->parent];
+    uint32_t first = node_first_token(tokens, e->ast, node), last = last_token(e, node);
+    size_t start = tokens->starts[first], end = tokens->starts[last] + tokens->lengths[last];
+    char head[NUMBER_TEXT_MAX];
+    size_t length = constant_text(c, NULL);
+
+    if (c->kind != CKSTRING)
+        constant_text(c, head);
+    else
+        head[0] = '"';
+
+    // numbers and void 0 need parentheses to be called or have properties
+    // taken, and a negative base of ** too
+    bool object = parent->lhs == node
+        && (parent->kind == ETPROPERTYACCESS || parent->kind == ETOPTIONALCHAIN || parent->kind == ETINDEX
+            || parent->kind == ETCALL || parent->kind == ETNEW);
+    bool base = parent->lhs == node && parent->kind == ETEXPONENT;
+    bool wrap = head[0] != '(' && ((object && (c->kind == CKNUMBER || c->kind == CKUNDEFINED))
+                                   || (base && (head[0] == '-' || c->kind == CKUNDEFINED)));
+    char opening = wrap ? '(' : head[0];
+
+    if (start < e->kept || (first == e->statement_start && !char_is(opening, CCIDENT)))
+        return false;
+
+    keep_to(e, start);
+
+    // the value mustn't run into the text either side of it
+    char before = e->out->length > 0 ? e->out->data[e->out->length - 1] : ' ';
+    char after = tokens->source[end];
+    bool space_before = (is_name_char(before) && is_name_char(opening)) || (before == '-' && opening == '-');
+    bool space_after = !wrap && c->kind != CKSTRING && is_name_char(head[length - 1]) && is_name_char(after);
+    size_t total = length + 2 * wrap + space_before + space_after;
+
+    if (total > end - start)
+        return false;
+
+    if (output_reserve(e->out, e->out->length + total) != EXIT_SUCCESS) {
+        e->failed = true;
+        return true;
+    }
+
+    char *to = e->out->data + e->out->length;
+    if (space_before)
+        *to++ = ' ';
+    if (wrap)
+        *to++ = '(';
+    to += constant_text(c, to);
+    if (wrap)
+        *to++ = ')';
+    if (space_after)
+        *to++ = ' ';
+
+    if (e->map != NULL)
+        source_map_add_text(e->map, start, to - total, total);
+
+    e->out->length = to - e->out->data;
+    e->kept = end;
+
+    return true;
+}
+
+static void emit_node(struct Emitter *e, uint32_t node);
+
+/**Writes only the stand-in of a node that comes down to it, if that's safe
+ * where it is.  Returns whether it did.
+ */
+static bool emit_stand_in(struct Emitter *e, uint32_t node, uint32_t stand_in)
+{
+    const struct TokenBuffer *tokens = e->tokens;
+    const struct Ast *ast = e->ast;
+    struct Node n = ast->nodes[node];
+    uint32_t first = node_first_token(tokens, ast, node), last = last_token(e, node), start = e->statement_start;
+
+    // the operator just before the stand-in: "?" or ":", "&&", "||" or "??"
+    uint32_t operator = n.kind == ETTERNARY && stand_in != ast->extra[n.rhs] ? last_token(e, ast->extra[n.rhs]) + 1
+                      : n.token;
+
+    if (first == start && !starts_plainly(tokens, operator + 1))
+        return false;
+
+    cut_text(e, tokens->starts[first], tokens->starts[operator + 1], first);
+    if (first == start)
+        e->statement_start = operator + 1;
+    emit_node(e, stand_in);
+    e->statement_start = start;
+
+    uint32_t end = last_token(e, stand_in);
+    if (end < last)
+        cut_text(e, tokens->starts[end] + tokens->lengths[end], tokens->starts[last] + tokens->lengths[last], end + 1);
+
+    return true;
+}
+
+static void emit_list(struct Emitter *e, uint32_t start, uint32_t count)
+{
+    for (uint32_t i = 0; i < count && !e->failed; i++)
+        emit_node(e, e->ast->extra[start + i]);
+}
+
+/**A parameter, cutting its annotation or "?" from around it.
+ */
+static void emit_parameter(struct Emitter *e, uint32_t node)
+{
+    const struct TokenBuffer *tokens = e->tokens;
+    struct Node p = e->ast->nodes[node];
+
+    if (p.kind == TEOPTIONAL) {
+        // "x?" or "x?: T", where x is a name
+        cut_tokens(e, p.token, p.rhs != NODE_NONE ? skip_type(tokens, p.token + 2) - 1 : p.token);
+    } else if (p.kind == TEANNOTATION) {
+        struct Node inner = e->ast->nodes[p.lhs];
+        size_t last = skip_type(tokens, p.token + 1) - 1;
+
+        // "x: T = value" has its default after the type
+        if (inner.kind == ETASSIGN && inner.token > p.token) {
+            cut_tokens(e, p.token, last);
+            emit_node(e, inner.rhs);
+        } else {
+            emit_node(e, p.lhs);
+            cut_tokens(e, p.token, last);
+        }
+    } else {
+        emit_node(e, node);
+    }
+}
+
+static void emit_function(struct Emitter *e, const struct Node *n)
+{
+    const struct TokenBuffer *tokens = e->tokens;
+    const struct Function *f = &e->ast->functions[n->lhs];
+
+    uint32_t count = e->ast->extra[f->parameters];
+    for (uint32_t i = 0; i < count && !e->failed; i++)
+        emit_parameter(e, e->ast->extra[f->parameters + 1 + i]);
+
+    if (f->result != NODE_NONE && n->kind == ETARROWFUNCTION) {
+        // an arrow function is named by its "=>", which ends the result
+        size_t colon = node_first_token(tokens, e->ast, f->result) - 1;
+        if (colon < tokens->count && token_type(tokens, colon) == TTBITOR)
+            --colon;
+        cut_tokens(e, colon, n->token - 1);
+    } else if (f->result != NODE_NONE) {
+        // the result runs from after the parameters to the body
+        size_t open = n->token;
+        while (open < tokens->count && token_type(tokens, open) != TTOPENPAREN)
+            ++open;
+        cut_tokens(e, skip_brackets(tokens, open), f->body_start - 1);
+    }
+
+    if (f->body == NODE_NONE && f->body_start != f->body_end) {
+        // a body nobody parsed could hold anything
+        if (!e->failed)
+            e->error_token = f->body_start;
+        e->failed = true;
+        return;
+    }
+
+    uint32_t start = e->statement_start;
+    e->statement_start = f->body_start == f->body_end ? node_first_token(tokens, e->ast, f->body) : NO_TOKEN;
+    emit_node(e, f->body);
+    e->statement_start = start;
+}
+
+void emit_node(struct Emitter *e, uint32_t node)
+{
+    const struct Ast *ast = e->ast;
+    const struct Node *n = &ast->nodes[node];
+
+    if (e->failed || node == NODE_NONE)
+        return;
+
+    if (e->folding != NULL) {
+        uint32_t value = e->folding->values[node], stand_in = e->folding->stand_ins[node];
+        bool literal = n->kind == ETNUMERICLITERAL || n->kind == ETSTRINGLITERAL || n->kind == ETBOOLEANLITERAL
+                    || n->kind == ETNULL;
+
+        if (value != 0 && !literal && emit_constant(e, node, &e->folding->constants[value]))
+            return;
+        if (stand_in != NODE_NONE && emit_stand_in(e, node, stand_in))
+            return;
+    }
+
+    switch (n->kind) {
+    case SDINTERFACE:
+        cut_tokens(e, n->token, skip_type(e->tokens, n->token + 2) - 1);
+        return;
+    case SDTYPEALIAS:
+        cut_tokens(e, n->token, skip_type(e->tokens, n->token + 3)); // and the ";"
+        return;
+    default:
+        break;
+    }
+
+    uint32_t parent = e->parent, start = e->statement_start;
+    e->parent = node;
+    if (n->kind == SDEXPRSTATEMENT)
+        e->statement_start = node_first_token(e->tokens, ast, n->lhs);
+
+    switch (node_layouts[n->kind]) {
+    case NLLEAF:
+        break;
+    case NLUNARY:
+    case NLMEMBER:
+        emit_node(e, n->lhs);
+        break;
+    case NLBINARY:
+        emit_node(e, n->lhs);
+        emit_node(e, n->rhs);
+        break;
+    case NLTERNARY:
+        emit_node(e, n->lhs);
+        emit_node(e, ast->extra[n->rhs]);
+        emit_node(e, ast->extra[n->rhs + 1]);
+        break;
+    case NLCALL:
+        emit_node(e, n->lhs);
+        emit_list(e, n->rhs + 1, ast->extra[n->rhs]);
+        break;
+    case NLLIST:
+        emit_list(e, n->lhs, n->rhs);
+        break;
+    case NLFUNCTION:
+        emit_function(e, n);
+        break;
+    case NLDECLARATION:
+        if (n->rhs != NODE_NONE && ast->nodes[n->rhs].kind == TEANNOTATION) {
+            // "let x: T = value", the type first
+            const struct Node *annotation = &ast->nodes[n->rhs];
+            cut_tokens(e, annotation->token, skip_type(e->tokens, annotation->token + 1) - 1);
+            emit_node(e, annotation->lhs);
+        } else {
+            emit_node(e, n->rhs);
+        }
+        break;
+    case NLNAMED:
+        emit_node(e, n->rhs);
+        break;
+    }
+
+    e->parent = parent;
+    e->statement_start = start;
+}
+
+int emit_program(const struct TokenBuffer *tokens, const struct Ast *ast, const struct Folding *folding, size_t length,
+                 struct OutputBuffer *out, struct SourceMap *map, size_t *error_token)
+{
+    struct Emitter e = {
+        .tokens = tokens,
+        .ast = ast,
+        .out = out,
+        .map = map,
+        .folding = folding,
+        .statement_start = NO_TOKEN,
+    };
+
+    // the output is never longer than the source
+    if (output_reserve(out, out->length + length) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    // the root is node 0, NODE_NONE to emit_node
+    emit_list(&e, ast->nodes[0].lhs, ast->nodes[0].rhs);
+    if (!e.failed)
+        keep_to(&e, length);
+
+    *error_token = e.error_token;
+
+    return e.failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
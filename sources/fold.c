@@ -0,0 +1,1134 @@
+#include "compile.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Folding walks the tree once in source order, giving each expression whose
+ * value it can work out a Constant, bottom up.  Only literals, the globals
+ * undefined, NaN and Infinity, and names of consts with known values start
+ * out known, and nothing with a side effect is ever known, so an expression
+ * whose operands are known can always be replaced by its value.  Where the
+ * language leaves a result to the engine (** of fractions) or the work isn't
+ * worth it (strings with escapes, or outside ASCII where it matters), the
+ * value is just left unknown.
+ *
+ * Names are resolved with the same scheme as the checker's: an array indexed
+ * by symbol holding the innermost binding, and bindings on a stack that
+ * remember the binding they hide.  Every name a scope declares is bound on
+ * entering it, var and function declarations in nested blocks included in
+ * the function's scope, so a const is only ever found by the uses it really
+ * reaches.  Its value is set when its declaration is reached, so uses before
+ * it, which would throw, stay as they are.
+ *
+ * A function declaration's body can run as soon as its scope is entered, and
+ * before the consts declared ahead of it have been set.  So it's only given
+ * the values set before the first statement in that scope that could call
+ * anything; up to there the scope's clock is "settled".
+ *
+ * A file that mentions eval could declare anything anywhere, so in one no
+ * names are resolved at all.
+ */
+
+#define FOLD_INITIAL_CAPACITY 256
+
+// strings longer than this are left unknown, so that a long chain of
+// concatenations doesn't copy quadratically
+#define FOLD_MAX_STRING 1024
+
+// the doubles are exact integers up to here, and the results of ** are only
+// known while they stay within it
+#define MAX_EXACT_INTEGER 9007199254740992.0
+
+#define TWO_TO_32 4294967296.0
+
+struct Binding {
+    uint32_t symbol;
+    uint32_t shadowed;  // the binding this one hides plus one, or 0
+    uint32_t value;     // index into constants, or 0
+    uint32_t set_at;    // the clock when value was set
+    bool repeated;      // declared twice in one scope, so never known
+};
+
+struct Scope {
+    size_t mark;        // binding_count on entry
+    uint32_t settled;   // the clock when the scope last ran nothing that
+                        // could call a function
+    bool inert;         // whether everything reached in it so far was
+    bool hoisted;       // a function declaration's body
+};
+
+struct Folder {
+    const struct TokenBuffer *tokens;
+    const struct Ast *ast;
+    struct Folding *folding;
+    bool failed;
+
+    struct Binding *bindings;
+    size_t binding_count, binding_capacity;
+    uint32_t *names;            // by symbol: binding index plus one
+    size_t name_count;
+    struct Scope *scopes;
+    size_t scope_count, scope_capacity;
+    uint32_t clock;             // counts the consts given values
+    bool resolve;               // false if the file mentions eval
+
+    uint32_t undefined_symbol, nan_symbol, infinity_symbol;
+    uint32_t undefined_value, nan_value, infinity_value;
+};
+
+static uint32_t fold_expression(struct Folder *f, uint32_t node);
+static void fold_statements(struct Folder *f, uint32_t start, uint32_t count);
+
+static int reserve(struct Folder *f, void **array, size_t *capacity, size_t needed, size_t size)
+{
+    if (needed <= *capacity)
+        return EXIT_SUCCESS;
+
+    size_t wanted = *capacity ? *capacity : FOLD_INITIAL_CAPACITY;
+    while (wanted < needed)
+        wanted *= 2;
+
+    void *resized = realloc(*array, wanted * size);
+    if (resized == NULL) {
+        f->failed = true;
+        return EXIT_FAILURE;
+    }
+
+    *array = resized;
+    *capacity = wanted;
+
+    return EXIT_SUCCESS;
+}
+
+/* Numbers and strings */
+
+/**The shortest digits that read back as value, which must be finite and
+ * above 0, as value = 0.digits * 10^exponent.
+ */
+static size_t shortest_digits(double value, char *digits, int *exponent)
+{
+    for (int precision = 1; precision <= 17; precision++) {
+        char text[NUMBER_TEXT_MAX], check[NUMBER_TEXT_MAX + 8];
+        size_t count = 0;
+
+        // d.ddde+x, rounded to nearest
+        snprintf(text, sizeof text, "%.*e", precision - 1, value);
+        for (const char *at = text; *at != 'e'; at++)
+            if (*at != '.')
+                digits[count++] = *at;
+        *exponent = atoi(strchr(text, 'e') + 1) + 1;
+
+        for (int attempt = 0; attempt < 2; attempt++) {
+            snprintf(check, sizeof check, "0.%.*se%d", (int)count, digits, *exponent);
+            if (strtod(check, NULL) == value) {
+                while (count > 1 && digits[count - 1] == '0')
+                    --count;
+                return count;
+            }
+
+            // below a power of two the doubles are twice as close together,
+            // so the digits nearest can miss where the next ones up don't
+            size_t i = count;
+            while (i > 0 && digits[i - 1] == '9')
+                digits[--i] = '0';
+            if (i > 0) {
+                ++digits[i - 1];
+            } else {
+                digits[0] = '1';
+                ++*exponent;
+            }
+        }
+    }
+
+    return 0; // unreachable, 17 digits always read back
+}
+
+size_t number_to_string(double value, char *text)
+{
+    char digits[NUMBER_TEXT_MAX], *at = text;
+    int n;
+
+    if (isnan(value))
+        return (size_t)sprintf(text, "NaN");
+    if (value == 0)
+        return (size_t)sprintf(text, "0");
+    if (value < 0) {
+        *at++ = '-';
+        value = -value;
+    }
+    if (isinf(value))
+        return (size_t)(at - text) + sprintf(at, "Infinity");
+
+    int k = (int)shortest_digits(value, digits, &n);
+
+    if (k <= n && n <= 21) {
+        // an integer
+        memcpy(at, digits, k);
+        memset(at + k, '0', n - k);
+        at += n;
+    } else if (0 < n && n <= 21) {
+        memcpy(at, digits, n);
+        at[n] = '.';
+        memcpy(at + n + 1, digits + n, k - n);
+        at += k + 1;
+    } else if (-6 < n && n <= 0) {
+        memcpy(at, "0.", 2);
+        memset(at + 2, '0', -n);
+        memcpy(at + 2 - n, digits, k);
+        at += 2 - n + k;
+    } else {
+        *at++ = digits[0];
+        if (k > 1) {
+            *at++ = '.';
+            memcpy(at, digits + 1, k - 1);
+            at += k - 1;
+        }
+        at += sprintf(at, "e%c%d", n - 1 < 0 ? '-' : '+', abs(n - 1));
+    }
+
+    *at = '\0';
+
+    return (size_t)(at - text);
+}
+
+static bool is_string_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**ToNumber of a string, if it's ASCII; elsewhere there's more white space.
+ */
+static bool string_to_number(struct StringView string, double *value)
+{
+    const char *at = string.data, *end = string.data + string.length;
+    char text[64];
+
+    for (const char *c = at; c < end; c++)
+        if ((unsigned char)*c >= 0x80 || *c == '\0')
+            return false;
+
+    while (at < end && is_string_space(*at))
+        ++at;
+    while (end > at && is_string_space(end[-1]))
+        --end;
+
+    if (at == end) {
+        *value = 0;
+        return true;
+    }
+
+    // 0x, 0o and 0b integers, which can't be signed
+    if (end - at > 2 && at[0] == '0') {
+        int base = (at[1] | 0x20) == 'x' ? 16 : (at[1] | 0x20) == 'o' ? 8 : (at[1] | 0x20) == 'b' ? 2 : 0;
+
+        if (base != 0) {
+            double result = 0;
+            for (const char *c = at + 2; c < end; c++) {
+                int digit = digit_value(*c);
+                if (digit >= base || (result = result * base + digit) > MAX_EXACT_INTEGER)
+                    return false;
+            }
+            *value = result;
+            return true;
+        }
+    }
+
+    const char *digits = at + (*at == '+' || *at == '-');
+    if (end - digits == 8 && memcmp(digits, "Infinity", 8) == 0) {
+        *value = *at == '-' ? -INFINITY : INFINITY;
+        return true;
+    }
+
+    // strtod takes more than the grammar allows, so the text is checked first
+    const char *c = digits;
+    size_t count = 0;
+    for (; c < end && char_is(*c, CCDIGIT); c++)
+        ++count;
+    if (c < end && *c == '.')
+        for (++c; c < end && char_is(*c, CCDIGIT); c++)
+            ++count;
+    if (count == 0)
+        return false;
+    if (c < end && (*c | 0x20) == 'e') {
+        ++c;
+        if (c < end && (*c == '+' || *c == '-'))
+            ++c;
+        if (c == end || !char_is(*c, CCDIGIT))
+            return false;
+        while (c < end && char_is(*c, CCDIGIT))
+            ++c;
+    }
+    if (c != end || (size_t)(end - at) >= sizeof text)
+        return false;
+
+    memcpy(text, at, end - at);
+    text[end - at] = '\0';
+    *value = strtod(text, NULL);
+
+    return true;
+}
+
+/**Whether string has a character outside the BMP, where the order of the
+ * UTF-16 that strings compare by isn't the order of the UTF-8.
+ */
+static bool has_astral(struct StringView string)
+{
+    for (size_t i = 0; i < string.length; i++)
+        if ((unsigned char)string.data[i] >= 0xf0)
+            return true;
+
+    return false;
+}
+
+static bool strings_equal(struct StringView a, struct StringView b)
+{
+    return a.length == b.length && memcmp(a.data, b.data, a.length) == 0;
+}
+
+static int32_t to_int32(double value)
+{
+    if (!isfinite(value))
+        return 0;
+
+    double wrapped = fmod(trunc(value), TWO_TO_32);
+    uint32_t bits = (uint32_t)(wrapped < 0 ? wrapped + TWO_TO_32 : wrapped);
+
+    return bits <= INT32_MAX ? (int32_t)bits : -(int32_t)(UINT32_MAX - bits) - 1;
+}
+
+static uint32_t to_uint32(double value)
+{
+    return (uint32_t)to_int32(value);
+}
+
+/* Constants */
+
+static uint32_t add_constant(struct Folder *f, struct Constant c)
+{
+    struct Folding *folding = f->folding;
+
+    if (reserve(f, (void **)&folding->constants, &folding->constant_capacity, folding->constant_count + 1,
+                sizeof *folding->constants) != EXIT_SUCCESS)
+        return 0;
+
+    folding->constants[folding->constant_count] = c;
+
+    return (uint32_t)folding->constant_count++;
+}
+
+static struct Constant constant(const struct Folder *f, uint32_t value)
+{
+    return f->folding->constants[value];
+}
+
+static uint32_t add_number(struct Folder *f, double number)
+{
+    return add_constant(f, (struct Constant) { .kind = CKNUMBER, .number = number });
+}
+
+static uint32_t add_boolean(struct Folder *f, bool boolean)
+{
+    return add_constant(f, (struct Constant) { .kind = CKBOOLEAN, .boolean = boolean });
+}
+
+static uint32_t add_string(struct Folder *f, const char *data, size_t length)
+{
+    return add_constant(f, (struct Constant) { .kind = CKSTRING, .string = { data, length } });
+}
+
+static bool to_boolean(struct Constant c)
+{
+    switch (c.kind) {
+    case CKBOOLEAN:
+        return c.boolean;
+    case CKNUMBER:
+        return c.number != 0 && !isnan(c.number);
+    case CKSTRING:
+        return c.string.length > 0;
+    default:
+        return false;
+    }
+}
+
+static bool to_number(struct Constant c, double *number)
+{
+    switch (c.kind) {
+    case CKUNDEFINED:
+        *number = NAN;
+        return true;
+    case CKNULL:
+        *number = 0;
+        return true;
+    case CKBOOLEAN:
+        *number = c.boolean;
+        return true;
+    case CKNUMBER:
+        *number = c.number;
+        return true;
+    case CKSTRING:
+        return string_to_number(c.string, number);
+    default:
+        return false;
+    }
+}
+
+/**ToString of c, into text if it has to be made.
+ */
+static struct StringView to_string(struct Constant c, char *text)
+{
+    switch (c.kind) {
+    case CKUNDEFINED:
+        return (struct StringView) { "undefined", 9 };
+    case CKNULL:
+        return (struct StringView) { "null", 4 };
+    case CKBOOLEAN:
+        return c.boolean ? (struct StringView) { "true", 4 } : (struct StringView) { "false", 5 };
+    case CKNUMBER:
+        return (struct StringView) { text, number_to_string(c.number, text) };
+    default:
+        return c.string;
+    }
+}
+
+static uint32_t concatenate(struct Folder *f, struct Constant a, struct Constant b)
+{
+    char a_text[NUMBER_TEXT_MAX], b_text[NUMBER_TEXT_MAX];
+    struct StringView x = to_string(a, a_text), y = to_string(b, b_text);
+
+    if (x.length + y.length > FOLD_MAX_STRING)
+        return 0;
+
+    char *text = arena_alloc(&f->folding->text, x.length + y.length + 1);
+    if (text == NULL) {
+        f->failed = true;
+        return 0;
+    }
+
+    memcpy(text, x.data, x.length);
+    memcpy(text + x.length, y.data, y.length);
+
+    return add_string(f, text, x.length + y.length);
+}
+
+static bool strictly_equal(struct Constant a, struct Constant b)
+{
+    if (a.kind != b.kind)
+        return false;
+
+    switch (a.kind) {
+    case CKBOOLEAN:
+        return a.boolean == b.boolean;
+    case CKNUMBER:
+        return a.number == b.number;
+    case CKSTRING:
+        return strings_equal(a.string, b.string);
+    default:
+        return true;
+    }
+}
+
+/**a == b as 1 or 0, or -1 if it can't be known.
+ */
+static int loosely_equal(struct Constant a, struct Constant b)
+{
+    double x, y;
+
+    if (a.kind == b.kind)
+        return strictly_equal(a, b);
+
+    bool a_nullish = a.kind == CKNULL || a.kind == CKUNDEFINED, b_nullish = b.kind == CKNULL || b.kind == CKUNDEFINED;
+    if (a_nullish || b_nullish)
+        return a_nullish && b_nullish;
+
+    // what's left of booleans, numbers and strings compares as numbers
+    if (!to_number(a, &x) || !to_number(b, &y))
+        return -1;
+
+    return x == y;
+}
+
+/**x ** y where the result is exact, as engines differ on the rest.
+ */
+static bool exponentiate(double x, double y, double *result)
+{
+    // even NaN ** 0 is 1
+    if (y == 0) {
+        *result = 1;
+        return true;
+    }
+
+    if (!(y > 0 && y <= 64 && y == trunc(y) && fabs(x) <= MAX_EXACT_INTEGER && x == trunc(x)))
+        return false;
+
+    double power = 1;
+    for (int i = 0; i < (int)y; i++)
+        if (fabs(power *= x) > MAX_EXACT_INTEGER)
+            return false;
+
+    *result = power;
+
+    return true;
+}
+
+static uint32_t fold_unary(struct Folder *f, uint8_t kind, struct Constant a)
+{
+    static const struct StringView types[] = {
+        [CKUNDEFINED] = { "undefined", 9 },
+        [CKNULL] = { "object", 6 },
+        [CKBOOLEAN] = { "boolean", 7 },
+        [CKNUMBER] = { "number", 6 },
+        [CKSTRING] = { "string", 6 },
+    };
+    double x;
+
+    switch (kind) {
+    case ETLOGICNOT:
+        return add_boolean(f, !to_boolean(a));
+    case ETTYPEOF:
+        return add_string(f, types[a.kind].data, types[a.kind].length);
+    case ETVOID:
+        return f->undefined_value;
+    default:
+        break;
+    }
+
+    if (!to_number(a, &x))
+        return 0;
+
+    switch (kind) {
+    case ETUNARYNEGATE:
+        return add_number(f, -x);
+    case ETUNARYPLUS:
+        return add_number(f, x);
+    case ETBITNOT:
+        return add_number(f, ~to_int32(x));
+    default:
+        return 0;
+    }
+}
+
+static uint32_t fold_binary(struct Folder *f, uint8_t kind, struct Constant a, struct Constant b)
+{
+    double x, y, result;
+    int equal;
+
+    switch (kind) {
+    case ETADDITION:
+        if (a.kind == CKSTRING || b.kind == CKSTRING)
+            return concatenate(f, a, b);
+        break;
+    case ETSTRICTEQUAL:
+    case ETSTRICTINEQUAL:
+        return add_boolean(f, strictly_equal(a, b) == (kind == ETSTRICTEQUAL));
+    case ETEQUAL:
+    case ETINEQUAL:
+        equal = loosely_equal(a, b);
+        return equal < 0 ? 0 : add_boolean(f, equal == (kind == ETEQUAL));
+    case ETLESS:
+    case ETLESSEQUAL:
+    case ETGREATER:
+    case ETGREATEREQUAL:
+        if (a.kind == CKSTRING && b.kind == CKSTRING) {
+            if (has_astral(a.string) || has_astral(b.string))
+                return 0;
+
+            size_t shorter = a.string.length < b.string.length ? a.string.length : b.string.length;
+            int order = memcmp(a.string.data, b.string.data, shorter);
+            if (order == 0)
+                order = (a.string.length > b.string.length) - (a.string.length < b.string.length);
+
+            return add_boolean(f, kind == ETLESS ? order < 0 : kind == ETLESSEQUAL ? order <= 0
+                                  : kind == ETGREATER ? order > 0 : order >= 0);
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (!to_number(a, &x) || !to_number(b, &y))
+        return 0;
+
+    switch (kind) {
+    case ETADDITION:
+        return add_number(f, x + y);
+    case ETSUBTRACT:
+        return add_number(f, x - y);
+    case ETMULTIPLY:
+        return add_number(f, x * y);
+    case ETDIVISION:
+        return add_number(f, x / y);
+    case ETREMAINDER:
+        // fmod has the sign of the dividend and the same NaNs as %
+        return add_number(f, fmod(x, y));
+    case ETEXPONENT:
+        return exponentiate(x, y, &result) ? add_number(f, result) : 0;
+    case ETLEFTSHIFT:
+        return add_number(f, (int32_t)(to_uint32(x) << (to_uint32(y) & 31)));
+    case ETRIGHTSHIFT: {
+        int32_t value = to_int32(x);
+        uint32_t shift = to_uint32(y) & 31;
+        // shifting a negative number right is up to the compiler in C
+        return add_number(f, value < 0 ? ~(~value >> shift) : value >> shift);
+    }
+    case ETUNSIGNEDRIGHTSHIFT:
+        return add_number(f, to_uint32(x) >> (to_uint32(y) & 31));
+    case ETBITAND:
+        return add_number(f, to_int32(x) & to_int32(y));
+    case ETBITOR:
+        return add_number(f, to_int32(x) | to_int32(y));
+    case ETBITXOR:
+        return add_number(f, to_int32(x) ^ to_int32(y));
+    // comparisons with NaN are false, as in C
+    case ETLESS:
+        return add_boolean(f, x < y);
+    case ETLESSEQUAL:
+        return add_boolean(f, x <= y);
+    case ETGREATER:
+        return add_boolean(f, x > y);
+    case ETGREATEREQUAL:
+        return add_boolean(f, x >= y);
+    default:
+        return 0;
+    }
+}
+
+/* Names */
+
+static int push_scope(struct Folder *f, bool hoisted)
+{
+    if (reserve(f, (void **)&f->scopes, &f->scope_capacity, f->scope_count + 1, sizeof *f->scopes) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    f->scopes[f->scope_count++] = (struct Scope) {
+        .mark = f->binding_count,
+        .settled = f->clock,
+        .inert = true,
+        .hoisted = hoisted,
+    };
+
+    return EXIT_SUCCESS;
+}
+
+static void pop_scope(struct Folder *f)
+{
+    struct Scope scope = f->scopes[--f->scope_count];
+
+    while (f->binding_count > scope.mark) {
+        struct Binding b = f->bindings[--f->binding_count];
+        f->names[b.symbol] = b.shadowed;
+    }
+}
+
+static void bind(struct Folder *f, uint32_t symbol)
+{
+    if (symbol == SYMBOL_NONE || symbol >= f->name_count)
+        return;
+
+    // a second declaration in the same scope
+    uint32_t existing = f->names[symbol];
+    if (existing > f->scopes[f->scope_count - 1].mark) {
+        f->bindings[existing - 1].repeated = true;
+        return;
+    }
+
+    if (reserve(f, (void **)&f->bindings, &f->binding_capacity, f->binding_count + 1, sizeof *f->bindings) != EXIT_SUCCESS)
+        return;
+
+    f->bindings[f->binding_count] = (struct Binding) { .symbol = symbol, .shadowed = existing };
+    f->names[symbol] = (uint32_t)++f->binding_count;
+}
+
+/**The value of a name, or 0 if it isn't known here.
+ */
+static uint32_t lookup(const struct Folder *f, uint32_t symbol)
+{
+    if (!f->resolve || symbol == SYMBOL_NONE || symbol >= f->name_count)
+        return 0;
+
+    uint32_t binding = f->names[symbol];
+    if (binding == 0) {
+        // globals that can't be assigned to
+        return symbol == f->undefined_symbol ? f->undefined_value
+             : symbol == f->nan_symbol ? f->nan_value
+             : symbol == f->infinity_symbol ? f->infinity_value : 0;
+    }
+
+    struct Binding b = f->bindings[binding - 1];
+    if (b.value == 0 || b.repeated)
+        return 0;
+
+    for (size_t i = f->scope_count - 1; i > 0 && f->scopes[i].mark >= binding; i--)
+        if (f->scopes[i].hoisted && b.set_at > f->scopes[i - 1].settled)
+            return 0;
+
+    return b.value;
+}
+
+/**Binds the var declarations in a list of statements and the blocks in it,
+ * and, in the blocks, the function declarations, which are vars too outside
+ * strict mode.
+ */
+static void hoist(struct Folder *f, uint32_t start, uint32_t count, bool nested)
+{
+    const struct Ast *ast = f->ast;
+
+    for (uint32_t i = 0; i < count; i++) {
+        struct Node n = ast->nodes[ast->extra[start + i]];
+
+        if (n.kind == SDVAR)
+            bind(f, n.lhs);
+        else if (n.kind == SDBLOCK)
+            hoist(f, n.lhs, n.rhs, true);
+        else if (nested && node_layouts[n.kind] == NLFUNCTION)
+            bind(f, ast->functions[n.lhs].name);
+    }
+}
+
+/* The walk */
+
+static uint32_t fold_to(struct Folder *f, uint32_t node, uint32_t value)
+{
+    if (value != 0)
+        f->folding->values[node] = value;
+
+    return value;
+}
+
+/**Folds what's in an assignment target, which isn't itself a value.
+ */
+static void fold_target(struct Folder *f, uint32_t node)
+{
+    struct Node n = f->ast->nodes[node];
+
+    switch (n.kind) {
+    case ETIDENTIFIER:
+    case ETARRAYINIT:
+    case ETOBJECTINIT:
+        // names, or patterns of them
+        break;
+    case ETGROUP:
+        fold_target(f, n.lhs);
+        break;
+    default:
+        fold_expression(f, node);
+        break;
+    }
+}
+
+/**Binds the names in a parameter, folding its defaults.
+ */
+static void bind_pattern(struct Folder *f, uint32_t node)
+{
+    const struct Ast *ast = f->ast;
+    struct Node n = ast->nodes[node];
+
+    if (node == NODE_NONE)
+        return;
+
+    switch (n.kind) {
+    case ETIDENTIFIER:
+        bind(f, n.lhs);
+        break;
+    case TEANNOTATION:
+    case TEOPTIONAL:
+    case ETSPREAD:
+        bind_pattern(f, n.lhs);
+        break;
+    case ETASSIGN:
+    case ETDESTRUCTUREASSIGN:
+        fold_expression(f, n.rhs);
+        bind_pattern(f, n.lhs);
+        break;
+    case ETARRAYINIT:
+    case ETOBJECTINIT:
+        for (uint32_t i = 0; i < n.rhs; i++) {
+            uint32_t item = ast->extra[n.lhs + i];
+            bind_pattern(f, item != NODE_NONE && ast->nodes[item].kind == ETPROPERTYINIT ? ast->nodes[item].rhs : item);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void fold_function(struct Folder *f, struct Node n)
+{
+    const struct Ast *ast = f->ast;
+    struct Function function = ast->functions[n.lhs];
+
+    if (push_scope(f, node_is_statement(n.kind)) != EXIT_SUCCESS)
+        return;
+
+    // a named function expression sees its own name
+    if (!node_is_statement(n.kind))
+        bind(f, function.name);
+
+    for (uint32_t i = 0; i < ast->extra[function.parameters]; i++)
+        bind_pattern(f, ast->extra[function.parameters + 1 + i]);
+
+    if (function.body != NODE_NONE && ast->nodes[function.body].kind == SDBLOCK) {
+        struct Node body = ast->nodes[function.body];
+        hoist(f, body.lhs, body.rhs, false);
+        fold_statements(f, body.lhs, body.rhs);
+    } else {
+        fold_expression(f, function.body);
+    }
+
+    pop_scope(f);
+}
+
+/**Gives node the value of operand, or if that isn't known, makes operand
+ * its stand-in.
+ */
+static uint32_t reduce_to(struct Folder *f, uint32_t node, uint32_t operand, uint32_t value)
+{
+    if (value == 0)
+        f->folding->stand_ins[node] = operand;
+
+    return fold_to(f, node, value);
+}
+
+uint32_t fold_expression(struct Folder *f, uint32_t node)
+{
+    const struct Ast *ast = f->ast;
+    struct Node n = ast->nodes[node];
+    uint32_t a, b, c;
+
+    if (node == NODE_NONE || f->failed)
+        return 0;
+
+    switch (n.kind) {
+    case ETNUMERICLITERAL:
+        return n.rhs ? 0 : fold_to(f, node, add_number(f, ast->numbers[n.lhs])); // BigInts aren't folded
+    case ETSTRINGLITERAL: {
+        // only strings without escapes, whose text is their value
+        struct StringView text = token_view(f->tokens, n.token);
+        if (text.length < 2 || memchr(text.data, '\\', text.length) != NULL)
+            return 0;
+        return fold_to(f, node, add_string(f, text.data + 1, text.length - 2));
+    }
+    case ETBOOLEANLITERAL:
+        return fold_to(f, node, add_boolean(f, n.lhs));
+    case ETNULL:
+        return fold_to(f, node, add_constant(f, (struct Constant) { .kind = CKNULL }));
+    case ETIDENTIFIER:
+        return fold_to(f, node, lookup(f, n.lhs));
+    case ETGROUP:
+        return fold_to(f, node, fold_expression(f, n.lhs));
+    case ETDELETE:
+    case ETINCREMENT:
+    case ETDECREMENT:
+        fold_target(f, n.lhs);
+        return 0;
+    case ETASSIGN:
+    case ETADDITIONASSIGN:
+    case ETSUBTRACTASSIGN:
+    case ETMULTIPLYASSIGN:
+    case ETDIVISIONASSIGN:
+    case ETREMAINDERASSIGN:
+    case ETEXPONENTASSIGN:
+    case ETLEFTSHIFTASSIGN:
+    case ETRIGHTSHIFTASSIGN:
+    case ETUNSIGNEDRIGHTSHIFTASSIGN:
+    case ETBITANDASSIGN:
+    case ETBITORASSIGN:
+    case ETBITXORASSIGN:
+    case ETLOGICANDASSIGN:
+    case ETLOGICORASSIGN:
+    case ETNULLCOALESCEASSIGN:
+    case ETDESTRUCTUREASSIGN:
+        fold_target(f, n.lhs);
+        fold_expression(f, n.rhs);
+        return 0;
+    case ETLOGICAND:
+    case ETLOGICOR:
+    case ETNULLCOALESCE: {
+        a = fold_expression(f, n.lhs);
+        b = fold_expression(f, n.rhs);
+        if (a == 0)
+            return 0;
+
+        struct Constant left = constant(f, a);
+        bool decided = n.kind == ETLOGICAND ? !to_boolean(left)
+                     : n.kind == ETLOGICOR ? to_boolean(left)
+                     : left.kind != CKNULL && left.kind != CKUNDEFINED;
+
+        return decided ? fold_to(f, node, a) : reduce_to(f, node, n.rhs, b);
+    }
+    case ETTERNARY: {
+        uint32_t then = ast->extra[n.rhs], otherwise = ast->extra[n.rhs + 1];
+        c = fold_expression(f, n.lhs);
+        a = fold_expression(f, then);
+        b = fold_expression(f, otherwise);
+        if (c == 0)
+            return 0;
+        return to_boolean(constant(f, c)) ? reduce_to(f, node, then, a) : reduce_to(f, node, otherwise, b);
+    }
+    case ETPROPERTYINIT:
+    case ETGETTER:
+    case ETSETTER:
+        // "{ a }" has the one name as key and value, and only a computed
+        // key is a value
+        if (n.lhs == n.rhs)
+            return 0;
+        if (token_type(f->tokens, n.token) == TTOPENBRACKET)
+            fold_expression(f, n.lhs);
+        fold_expression(f, n.rhs);
+        return 0;
+    default:
+        break;
+    }
+
+    switch (node_layouts[n.kind]) {
+    case NLUNARY:
+    case NLMEMBER:
+        a = fold_expression(f, n.lhs);
+        return a != 0 && node_layouts[n.kind] == NLUNARY ? fold_to(f, node, fold_unary(f, n.kind, constant(f, a))) : 0;
+    case NLBINARY:
+        a = fold_expression(f, n.lhs);
+        b = fold_expression(f, n.rhs);
+        return a != 0 && b != 0 ? fold_to(f, node, fold_binary(f, n.kind, constant(f, a), constant(f, b))) : 0;
+    case NLCALL:
+        fold_expression(f, n.lhs);
+        for (uint32_t i = 0; i < ast->extra[n.rhs]; i++)
+            fold_expression(f, ast->extra[n.rhs + 1 + i]);
+        return 0;
+    case NLLIST:
+        for (uint32_t i = 0; i < n.rhs; i++)
+            fold_expression(f, ast->extra[n.lhs + i]);
+        return 0;
+    case NLFUNCTION:
+        fold_function(f, n);
+        return 0;
+    default:
+        return 0;
+    }
+}
+
+/**Folds a statement, and returns whether running it could never call
+ * anything.
+ */
+static bool fold_statement(struct Folder *f, uint32_t node)
+{
+    const struct Ast *ast = f->ast;
+    struct Node n = ast->nodes[node];
+
+    switch (n.kind) {
+    case SDLET:
+    case SDCONST:
+    case SDVAR: {
+        uint32_t initialiser = n.rhs;
+        if (initialiser != NODE_NONE && ast->nodes[initialiser].kind == TEANNOTATION)
+            initialiser = ast->nodes[initialiser].lhs;
+
+        uint32_t value = fold_expression(f, initialiser), binding = n.lhs < f->name_count ? f->names[n.lhs] : 0;
+
+        if (n.kind == SDCONST && value != 0 && binding > f->scopes[f->scope_count - 1].mark) {
+            f->bindings[binding - 1].value = value;
+            f->bindings[binding - 1].set_at = ++f->clock;
+        }
+
+        return initialiser == NODE_NONE || value != 0 || node_layouts[ast->nodes[initialiser].kind] == NLFUNCTION;
+    }
+    case SDEXPRSTATEMENT:
+    case SDRETURN:
+        fold_expression(f, n.lhs);
+        return false;
+    case SDBLOCK: {
+        if (push_scope(f, false) != EXIT_SUCCESS)
+            return false;
+        fold_statements(f, n.lhs, n.rhs);
+        bool inert = f->scopes[f->scope_count - 1].inert;
+        pop_scope(f);
+        return inert;
+    }
+    case SDFUNCTION:
+    case SDGENFUNCTION:
+    case SDASYNCFUNCTION:
+    case SDASYNCGENFUNCTION:
+        fold_function(f, n);
+        return true;
+    default:
+        return n.kind == SDINTERFACE || n.kind == SDTYPEALIAS || n.kind == SDEMPTY;
+    }
+}
+
+void fold_statements(struct Folder *f, uint32_t start, uint32_t count)
+{
+    const struct Ast *ast = f->ast;
+
+    // let, const and functions belong to the list they're in
+    for (uint32_t i = 0; i < count; i++) {
+        struct Node n = ast->nodes[ast->extra[start + i]];
+
+        if (n.kind == SDLET || n.kind == SDCONST)
+            bind(f, n.lhs);
+        else if (node_layouts[n.kind] == NLFUNCTION)
+            bind(f, ast->functions[n.lhs].name);
+    }
+
+    for (uint32_t i = 0; i < count && !f->failed; i++) {
+        bool inert = fold_statement(f, ast->extra[start + i]);
+        struct Scope *scope = &f->scopes[f->scope_count - 1];
+
+        if (scope->inert && inert)
+            scope->settled = f->clock;
+        else
+            scope->inert = false;
+    }
+}
+
+static uint32_t find_symbol(const struct Interner *interner, const char *name)
+{
+    size_t length = strlen(name);
+
+    return intern_find(interner, name, length, intern_hash(name, length));
+}
+
+int fold_constants(const struct TokenBuffer *tokens, const struct Ast *ast, const struct Interner *interner,
+                   struct Folding *folding)
+{
+    struct Folder f = {
+        .tokens = tokens,
+        .ast = ast,
+        .folding = folding,
+        .name_count = interner->count,
+        .resolve = true,
+        .undefined_symbol = find_symbol(interner, "undefined"),
+        .nan_symbol = find_symbol(interner, "NaN"),
+        .infinity_symbol = find_symbol(interner, "Infinity"),
+    };
+
+    *folding = (struct Folding) {0};
+    arena_init(&folding->text);
+    folding->values = calloc(ast->count, sizeof *folding->values);
+    folding->stand_ins = calloc(ast->count, sizeof *folding->stand_ins);
+    f.names = calloc(f.name_count, sizeof *f.names);
+
+    // constants[0] stands for none
+    if (folding->values == NULL || folding->stand_ins == NULL || f.names == NULL
+            || add_constant(&f, (struct Constant) { .kind = CKNONE }) != 0)
+        f.failed = true;
+
+    f.undefined_value = add_constant(&f, (struct Constant) { .kind = CKUNDEFINED });
+    f.nan_value = add_number(&f, NAN);
+    f.infinity_value = add_number(&f, INFINITY);
+
+    uint32_t eval = find_symbol(interner, "eval");
+    for (size_t i = 0; i < tokens->count && eval != SYMBOL_NONE; i++)
+        if (tokens->symbols[i] == eval)
+            f.resolve = false;
+
+    struct Node root = ast->nodes[0];
+    if (!f.failed && push_scope(&f, false) == EXIT_SUCCESS) {
+        hoist(&f, root.lhs, root.rhs, false);
+        fold_statements(&f, root.lhs, root.rhs);
+        pop_scope(&f);
+    }
+
+    free(f.bindings);
+    free(f.names);
+    free(f.scopes);
+
+    if (f.failed) {
+        folding_free(folding);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void folding_free(struct Folding *folding)
+{
+    free(folding->values);
+    free(folding->stand_ins);
+    free(folding->constants);
+    arena_free(&folding->text);
+    *folding = (struct Folding) {0};
+}
+
+/**The "(" or the parameter that starts the arrow function whose "=>" is at
+ * arrow.  Arrow functions have no result types, so the token before the
+ * arrow is always one or the other's end.
+ */
+static uint32_t arrow_start(const struct TokenBuffer *tokens, uint32_t arrow)
+{
+    uint32_t at = arrow - 1;
+    size_t depth = 0;
+
+    if (token_type(tokens, at) != TTCLOSEPAREN)
+        return at;
+
+    for (; at > 0; at--) {
+        enum TokenType ttype = token_type(tokens, at);
+
+        if (ttype == TTCLOSEPAREN || ttype == TTCLOSEBRACKET || ttype == TTCLOSEBRACE)
+            ++depth;
+        else if ((ttype == TTOPENPAREN || ttype == TTOPENBRACKET || ttype == TTOPENBRACE) && --depth == 0)
+            break;
+    }
+
+    return at;
+}
+
+/**How many tokens come before the key of an object literal member: "get"
+ * or "set", or a method's "async" and "*".
+ */
+static uint32_t member_modifiers(const struct TokenBuffer *tokens, const struct Ast *ast, struct Node n)
+{
+    if (n.kind != ETPROPERTYINIT)
+        return 1;
+
+    // a method's function is at its "(", a function expression isn't
+    struct Node value = ast->nodes[n.rhs];
+    if (node_layouts[value.kind] != NLFUNCTION || token_type(tokens, value.token) != TTOPENPAREN)
+        return 0;
+
+    return (value.kind == ETASYNCFUNCTION || value.kind == ETASYNCGENFUNCTION)
+         + (value.kind == ETGENFUNCTION || value.kind == ETASYNCGENFUNCTION);
+}
+
+uint32_t node_first_token(const struct TokenBuffer *tokens, const struct Ast *ast, uint32_t node)
+{
+    while (true) {
+        struct Node n = ast->nodes[node];
+
+        switch (n.kind) {
+        case ETINCREMENT:
+        case ETDECREMENT:
+            if (n.rhs)
+                return n.token;
+            node = n.lhs;
+            continue;
+        case ETNEW:
+            // "new a(b)" is the "(" of a call, and the "new" is before a
+            if (token_type(tokens, n.token) != TTOPENPAREN)
+                return n.token;
+            return node_first_token(tokens, ast, n.lhs) - 1;
+        case ETOPTIONALCHAIN:
+        case ETTERNARY:
+        case SDEXPRSTATEMENT:
+            node = n.lhs;
+            continue;
+        case ETPROPERTYINIT:
+        case ETGETTER:
+        case ETSETTER:
+            return n.token - member_modifiers(tokens, ast, n);
+        case ETARROWFUNCTION:
+            return arrow_start(tokens, n.token);
+        default:
+            break;
+        }
+
+        switch (node_layouts[n.kind]) {
+        case NLBINARY:
+        case NLMEMBER:
+        case NLCALL:
+            node = n.lhs;
+            continue;
+        default:
+            return n.token;
+        }
+    }
+}
@@ -0,0 +1,121 @@
+#include "compile.h"
+
+#include <assert.h>
+#include <string.h>
+
+/* Symbols are handed out densely from 1 (0 is SYMBOL_NONE) and index the
+ * strings array.  The hash table is open addressing with linear probing and
+ * stores each entry's full hash, so probing and growing never touch the text.
+ * Text is copied into the interner's own arena, so every distinct string is
+ * stored once and the source it came from can be released.
+ */
+
+#define INTERN_INITIAL_SLOTS 1024
+
+int interner_init(struct Interner *interner)
+{
+    *interner = (struct Interner) {0};
+
+    interner->slots = calloc(INTERN_INITIAL_SLOTS, sizeof *interner->slots);
+    if (interner->slots == NULL)
+        return EXIT_FAILURE;
+
+    interner->slot_count = INTERN_INITIAL_SLOTS;
+    interner->count = 1; // SYMBOL_NONE
+    arena_init(&interner->text);
+
+    return EXIT_SUCCESS;
+}
+
+void interner_free(struct Interner *interner)
+{
+    arena_free(&interner->text);
+    free(interner->slots);
+    free(interner->strings);
+    *interner = (struct Interner) {0};
+}
+
+static int grow_slots(struct Interner *interner)
+{
+    size_t slot_count = interner->slot_count * 2;
+    struct InternSlot *slots = calloc(slot_count, sizeof *slots);
+
+    if (slots == NULL)
+        return EXIT_FAILURE;
+
+    for (size_t i = 0; i < interner->slot_count; i++) {
+        struct InternSlot slot = interner->slots[i];
+        if (slot.symbol == SYMBOL_NONE)
+            continue;
+
+        size_t j = slot.hash & (slot_count - 1);
+        while (slots[j].symbol != SYMBOL_NONE)
+            j = (j + 1) & (slot_count - 1);
+        slots[j] = slot;
+    }
+
+    free(interner->slots);
+    interner->slots = slots;
+    interner->slot_count = slot_count;
+
+    return EXIT_SUCCESS;
+}
+
+/**The slot holding the string, or the empty slot it would go in.
+ */
+static size_t find_slot(const struct Interner *interner, const char *data, size_t length, uint32_t hash)
+{
+    size_t mask = interner->slot_count - 1;
+    size_t i = hash & mask;
+
+    for (; interner->slots[i].symbol != SYMBOL_NONE; i = (i + 1) & mask) {
+        struct InternSlot slot = interner->slots[i];
+        struct StringView existing = interner->strings[slot.symbol];
+
+        if (slot.hash == hash && existing.length == length && memcmp(existing.data, data, length) == 0)
+            break;
+    }
+
+    return i;
+}
+
+uint32_t intern_find(const struct Interner *interner, const char *data, size_t length, uint32_t hash)
+{
+    return interner->slots[find_slot(interner, data, length, hash)].symbol;
+}
+
+uint32_t intern(struct Interner *interner, const char *data, size_t length, uint32_t hash)
+{
+    size_t i = find_slot(interner, data, length, hash);
+
+    if (interner->slots[i].symbol != SYMBOL_NONE)
+        return interner->slots[i].symbol;
+
+    // a new string: everything that can fail is done before it goes in, so a
+    // failure leaves the table as it was.  The load factor is kept at or
+    // below a half.
+    if ((interner->count + 1) * 2 > interner->slot_count) {
+        if (grow_slots(interner) != EXIT_SUCCESS)
+            return SYMBOL_NONE;
+        i = find_slot(interner, data, length, hash);
+    }
+
+    if (interner->count >= interner->capacity) {
+        size_t capacity = interner->capacity ? interner->capacity * 2 : INTERN_INITIAL_SLOTS;
+        struct StringView *strings = realloc(interner->strings, capacity * sizeof *strings);
+        if (strings == NULL)
+            return SYMBOL_NONE;
+        interner->strings = strings;
+        interner->capacity = capacity;
+    }
+
+    const char *text = arena_copy_text(&interner->text, data, length);
+    if (text == NULL)
+        return SYMBOL_NONE;
+
+    uint32_t symbol = interner->count++;
+    interner->strings[symbol] = (struct StringView) { .data = text, .length = length };
+    interner->slots[i] = (struct InternSlot) { .hash = hash, .symbol = symbol };
+
+    return symbol;
+}
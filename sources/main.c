@@ -1,33 +1,109 @@
+#define _POSIX_C_SOURCE 200112L // clock_gettime
+
 #include "compile.h"
 
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <getopt.h>
+#include <inttypes.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 struct Arguments {
     bool strict;
+    bool stream;
+    bool bench_lex;
+    bool bench_parse;
+    bool ast;
+    bool preparse;
+    bool check;
+    bool transpile_only;
+    bool emit;
+    bool bench_emit;
+    bool map_lines;
+    bool fold;
+    bool reparse;
+    bool bench_reparse;
+    bool recheck;
+    size_t threads;
+    const char *cache;
+    const char *source_map;
     const char *file;
 };
 
 enum OptionIndex {
     OISTRICT = 0,
-    OIMAX = 1,
+    OISTREAM = 1,
+    OITHREADS = 2,
+    OIBENCHLEX = 3,
+    OIAST = 4,
+    OIPREPARSE = 5,
+    OIBENCHPARSE = 6,
+    OICACHE = 7,
+    OICHECK = 8,
+    OITRANSPILEONLY = 9,
+    OIEMIT = 10,
+    OIBENCHEMIT = 11,
+    OISOURCEMAP = 12,
+    OIMAPLINES = 13,
+    OIFOLD = 14,
+    OIREPARSE = 15,
+    OIBENCHREPARSE = 16,
+    OIRECHECK = 17,
+    OIMAX = 18,
 };
 
 const static struct option options[] = {
     [OISTRICT] = { "strict", no_argument, NULL, 0 },
+    [OISTREAM] = { "stream", no_argument, NULL, 0 },
+    [OITHREADS] = { "threads", required_argument, NULL, 0 },
+    [OIBENCHLEX] = { "bench-lex", no_argument, NULL, 0 },
+    [OIAST] = { "ast", no_argument, NULL, 0 },
+    [OIPREPARSE] = { "preparse", no_argument, NULL, 0 },
+    [OIBENCHPARSE] = { "bench-parse", no_argument, NULL, 0 },
+    [OICACHE] = { "cache", required_argument, NULL, 0 },
+    [OICHECK] = { "check", no_argument, NULL, 0 },
+    [OITRANSPILEONLY] = { "transpile-only", no_argument, NULL, 0 },
+    [OIEMIT] = { "emit", no_argument, NULL, 0 },
+    [OIBENCHEMIT] = { "bench-emit", no_argument, NULL, 0 },
+    [OISOURCEMAP] = { "source-map", required_argument, NULL, 0 },
+    [OIMAPLINES] = { "map-lines", no_argument, NULL, 0 },
+    [OIFOLD] = { "fold", no_argument, NULL, 0 },
+    [OIREPARSE] = { "reparse", no_argument, NULL, 0 },
+    [OIBENCHREPARSE] = { "bench-reparse", no_argument, NULL, 0 },
+    [OIRECHECK] = { "recheck", no_argument, NULL, 0 },
     [OIMAX] = {0},
 };
 
-static int load_file(const char *name, char **out_data);
-static void print_token(const struct Token *token);
+// window for --stream; the longest single token must fit in it
+#define STREAM_WINDOW_SIZE (64 * 1024)
+
+// timed runs per configuration for --bench-lex and --bench-parse; the best is
+// reported
+#define BENCH_RUNS 5
+
+static int stream_file(const char *name, bool ast);
+static int bench_lex(const char *name, size_t max_threads);
+static int bench_parse(const char *name, size_t max_threads);
+static int transpile_file(const char *name, size_t threads, const char *map_name, bool map_lines);
+static int bench_emit(const char *name);
+static void print_token(const struct TokenBuffer *tokens, size_t i);
+static int print_file_ast(const char *name, struct SourceFile *source, const struct TokenBuffer *tokens,
+                          struct Ast *ast, bool parsed, size_t error_token, bool preparse);
+static int emit_file(const char *name, struct SourceFile *source, const struct TokenBuffer *tokens,
+                     struct Ast *ast, const struct Interner *interner, bool parsed, size_t error_token,
+                     const char *map_name, bool map_lines, bool fold);
+static int check_file(const char *name, struct SourceFile *source, const struct TokenBuffer *tokens,
+                      struct Ast *ast, struct Interner *interner, bool parsed, size_t error_token, size_t threads);
 static void print_usage(void);
 
 int main(int argc, const char *argv[])
 {
-    struct Arguments arguments = {0};
+    struct Arguments arguments = { .threads = 1 };
 
     while (true) {
         int index, c;
@@ -41,6 +117,60 @@ int main(int argc, const char *argv[])
         case OISTRICT:
             arguments.strict = true;
             break;
+        case OISTREAM:
+            arguments.stream = true;
+            break;
+        case OITHREADS:
+            if ((arguments.threads = strtoul(optarg, NULL, 10)) == 0) {
+                print_usage();
+                return EXIT_FAILURE;
+            }
+            break;
+        case OIBENCHLEX:
+            arguments.bench_lex = true;
+            break;
+        case OIAST:
+            arguments.ast = true;
+            break;
+        case OIPREPARSE:
+            arguments.preparse = true;
+            break;
+        case OIBENCHPARSE:
+            arguments.bench_parse = true;
+            break;
+        case OICACHE:
+            arguments.cache = optarg;
+            break;
+        case OICHECK:
+            arguments.check = true;
+            break;
+        case OITRANSPILEONLY:
+            arguments.transpile_only = true;
+            break;
+        case OIEMIT:
+            arguments.emit = true;
+            break;
+        case OIBENCHEMIT:
+            arguments.bench_emit = true;
+            break;
+        case OISOURCEMAP:
+            arguments.source_map = optarg;
+            break;
+        case OIMAPLINES:
+            arguments.map_lines = true;
+            break;
+        case OIFOLD:
+            arguments.fold = true;
+            break;
+        case OIREPARSE:
+            arguments.reparse = true;
+            break;
+        case OIBENCHREPARSE:
+            arguments.bench_reparse = true;
+            break;
+        case OIRECHECK:
+            arguments.recheck = true;
+            break;
         default:
             assert(0 && "unreachable");
         }
@@ -52,225 +182,908 @@ int main(int argc, const char *argv[])
         print_usage();
         return EXIT_FAILURE;
     } else {
-        printf("%susing strict mode\n", arguments.strict ? "" : "not ");
+        // the output of --transpile-only and --emit is the program
+        if (!arguments.transpile_only && !arguments.emit)
+            printf("%susing strict mode\n", arguments.strict ? "" : "not ");
         arguments.file = argv[optind];
     }
 
-    char *to_read = NULL;
+    if (arguments.transpile_only)
+        return transpile_file(arguments.file, arguments.threads, arguments.source_map, arguments.map_lines);
+
+    if (arguments.stream)
+        return stream_file(arguments.file, arguments.ast);
+
+    if (arguments.bench_lex)
+        return bench_lex(arguments.file, arguments.threads);
+
+    if (arguments.bench_parse)
+        return bench_parse(arguments.file, arguments.threads);
+
+    if (arguments.bench_emit)
+        return bench_emit(arguments.file);
+
+    if (arguments.reparse || arguments.bench_reparse || arguments.recheck)
+        return verify_reparse(arguments.file, arguments.bench_reparse, arguments.recheck);
+
+    struct SourceFile source;
 
-    if (load_file(arguments.file, &to_read) != EXIT_SUCCESS) {
+    if (source_load(arguments.file, &source) != EXIT_SUCCESS) {
         fprintf(stderr, "could not load file\n");
+        return EXIT_FAILURE;
     }
 
-    struct Token *tokens = NULL;
-    size_t num_tokens;
-    if (tokenise_file(to_read, &tokens, &num_tokens) != EXIT_SUCCESS) {
-        fprintf(stderr, "failure to tokenise\n");
+    struct Interner interner;
+    if (interner_init(&interner) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not allocate interner\n");
+        return EXIT_FAILURE;
+    }
+
+    struct TokenBuffer tokens = {0};
+    struct Arena arena;
+    struct Ast ast = {0};
+    struct CacheEntry cached = {0};
+    uint64_t key = 0;
+    bool lexed = true, parsed = false;
+    size_t error_token = 0;
+
+    arena_init(&arena);
+
+    if (arguments.cache != NULL) {
+        key = cache_key(source.data, source.length);
+        parsed = cache_load(arguments.cache, key, &source, &interner, &tokens, &ast, &arena, &cached) == EXIT_SUCCESS;
+    }
+
+    if (!parsed) {
+        size_t error_offset = 0;
+        lexed = tokenise_file_parallel(source.data, source.length, &interner, &tokens, arguments.threads,
+                                            &error_offset) == EXIT_SUCCESS;
+
+        if (!lexed) {
+            struct SourcePosition position = source_position(&source, error_offset);
+            fprintf(stderr, "%s:%zu:%zu: failure to tokenise\n", arguments.file, position.line, position.column);
+        }
+
+        // an entry is only written for a file that lexes and parses
+        if (lexed && (arguments.ast || arguments.check || arguments.emit || arguments.cache != NULL)) {
+            if (ast_init(&ast, &arena, tokens.count) != EXIT_SUCCESS) {
+                fprintf(stderr, "could not allocate syntax tree\n");
+                error_token = tokens.count;
+            } else {
+                parsed = parse_tokens_parallel(&tokens, &ast, &error_token, arguments.threads) == EXIT_SUCCESS;
+            }
+        }
+
+        if (arguments.cache != NULL && parsed
+                && cache_store(arguments.cache, key, &source, &interner, &tokens, &ast) != EXIT_SUCCESS)
+            fprintf(stderr, "could not write to cache %s\n", arguments.cache);
+    }
+
+    // the tokens are listed as far as they go, but nothing is made of them
+    int result = lexed ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if (!lexed && (arguments.check || arguments.emit || arguments.ast)) {
+        // already reported
+    } else if (arguments.check) {
+        result = check_file(arguments.file, &source, &tokens, &ast, &interner, parsed, error_token, arguments.threads);
+    } else if (arguments.emit) {
+        result = emit_file(arguments.file, &source, &tokens, &ast, &interner, parsed, error_token,
+                           arguments.source_map, arguments.map_lines, arguments.fold);
+    } else if (arguments.ast) {
+        result = print_file_ast(arguments.file, &source, &tokens, &ast, parsed, error_token, arguments.preparse);
+    } else {
+        printf("Got a list of tokens:\n");
+        for (size_t i = 0; i < tokens.count; i++) {
+            struct SourcePosition position = source_position(&source, tokens.starts[i]);
+            printf("%zu:%zu ", position.line, position.column);
+            print_token(&tokens, i);
+        }
+    }
+
+    if (cached.mapping != NULL)
+        cache_entry_free(&cached);
+    else
+        token_buffer_free(&tokens);
+    arena_free(&arena);
+    interner_free(&interner);
+    source_free(&source);
+
+    return result;
+}
+
+static void print_node(const struct TokenBuffer *tokens, const struct Ast *ast, uint32_t node, int depth);
+
+static void print_list(const struct TokenBuffer *tokens, const struct Ast *ast, uint32_t start, uint32_t count, int depth)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        if (ast->extra[start + i] == NODE_NONE)
+            printf("%*shole\n", depth * 2, "");
+        else
+            print_node(tokens, ast, ast->extra[start + i], depth);
+    }
+}
+
+static void print_node(const struct TokenBuffer *tokens, const struct Ast *ast, uint32_t node, int depth)
+{
+    struct Node n = ast->nodes[node];
+    struct StringView view = token_view(tokens, n.token);
+
+    printf("%*s%s", depth * 2, "", node_kind_strings[n.kind]);
+
+    switch (node_layouts[n.kind]) {
+    case NLLEAF:
+        if (n.kind == ETNUMERICLITERAL)
+            printf(" %.*s (%.17g%s)\n", (int)view.length, view.data, ast->numbers[n.lhs], n.rhs ? ", bigint" : "");
+        else if (n.kind == ETSTRINGLITERAL || n.kind == ETIDENTIFIER || n.kind == ETBOOLEANLITERAL || n.kind == TEREFERENCE)
+            printf(" %.*s\n", (int)view.length, view.data);
+        else
+            printf("\n");
+        break;
+    case NLUNARY:
+        if (n.kind == ETINCREMENT || n.kind == ETDECREMENT)
+            printf(n.rhs ? " prefix\n" : " postfix\n");
+        else
+            printf("\n");
+        if (n.lhs != NODE_NONE)
+            print_node(tokens, ast, n.lhs, depth + 1);
+        break;
+    case NLBINARY:
+        printf("\n");
+        if (n.lhs != NODE_NONE)
+            print_node(tokens, ast, n.lhs, depth + 1);
+        if (n.rhs != NODE_NONE)
+            print_node(tokens, ast, n.rhs, depth + 1);
+        break;
+    case NLMEMBER: {
+        struct StringView name = token_view(tokens, n.token + 1);
+        printf(" %.*s\n", (int)name.length, name.data);
+        print_node(tokens, ast, n.lhs, depth + 1);
+        break;
+    }
+    case NLTERNARY:
+        printf("\n");
+        print_node(tokens, ast, n.lhs, depth + 1);
+        print_list(tokens, ast, n.rhs, 2, depth + 1);
+        break;
+    case NLCALL:
+        printf("\n");
+        print_node(tokens, ast, n.lhs, depth + 1);
+        print_list(tokens, ast, n.rhs + 1, ast->extra[n.rhs], depth + 1);
+        break;
+    case NLLIST:
+        printf("\n");
+        print_list(tokens, ast, n.lhs, n.rhs, depth + 1);
+        break;
+    case NLFUNCTION: {
+        struct Function f = ast->functions[n.lhs];
+        uint32_t parameters = ast->extra[f.parameters];
+        if (f.name != SYMBOL_NONE) {
+            // the name comes after "async", "function" and "*"
+            uint32_t t = n.token;
+            while (tokens->symbols[t] != f.name)
+                ++t;
+            struct StringView name = token_view(tokens, t);
+            printf(" %.*s", (int)name.length, name.data);
+        }
+        printf(" (%" PRIu32 " parameters)\n", parameters);
+        print_list(tokens, ast, f.parameters + 1, parameters, depth + 1);
+        if (f.result != NODE_NONE) {
+            printf("%*sreturns\n", (depth + 1) * 2, "");
+            print_node(tokens, ast, f.result, depth + 2);
+        }
+        if (f.body != NODE_NONE)
+            print_node(tokens, ast, f.body, depth + 1);
+        else
+            printf("%*sbody not parsed, tokens %" PRIu32 " to %" PRIu32 "\n", (depth + 1) * 2, "", f.body_start, f.body_end);
+        break;
+    }
+    case NLDECLARATION:
+    case NLNAMED: {
+        struct StringView name = token_view(tokens, node_layouts[n.kind] == NLNAMED ? n.token : n.token + 1);
+        printf(" %.*s\n", (int)name.length, name.data);
+        if (n.rhs != NODE_NONE)
+            print_node(tokens, ast, n.rhs, depth + 1);
+        break;
+    }
     }
+}
+
+/**Reports where parsing failed, and what wasn't supported there if that
+ * was the trouble.
+ */
+static void report_parse_failure(const char *name, struct SourceFile *source, const struct TokenBuffer *tokens,
+                                 size_t error_token)
+{
+    size_t offset = error_token < tokens->count ? tokens->starts[error_token] : source->length;
+    struct SourcePosition position = source_position(source, offset);
+    const char *unsupported = parse_unsupported(tokens, error_token);
 
-    printf("Got a list of tokens:\n");
-    for (int i = 0; i < num_tokens; i++) {
-        print_token(&tokens[i]);
+    if (unsupported != NULL)
+        fprintf(stderr, "%s:%zu:%zu: failure to parse, %s aren't supported\n", name, position.line, position.column,
+                unsupported);
+    else
+        fprintf(stderr, "%s:%zu:%zu: failure to parse\n", name, position.line, position.column);
+}
+
+/**Prints the tree parse_tokens built, one node per line, or where parsing
+ * failed.  Function bodies are parsed first, unless preparse asks for them to
+ * be left as token ranges.
+ */
+int print_file_ast(const char *name, struct SourceFile *source, const struct TokenBuffer *tokens,
+                   struct Ast *ast, bool parsed, size_t error_token, bool preparse)
+{
+    if (!parsed || (!preparse && parse_function_bodies(tokens, ast, &error_token) != EXIT_SUCCESS)) {
+        report_parse_failure(name, source, tokens, error_token);
+        return EXIT_FAILURE;
     }
 
-    free(to_read);
+    print_node(tokens, ast, 0, 0);
 
     return EXIT_SUCCESS;
 }
 
-int load_file(const char *name, char **out_data)
+/**Type checks the tree parse_tokens built and prints what's wrong with it,
+ * in order of position.
+ */
+int check_file(const char *name, struct SourceFile *source, const struct TokenBuffer *tokens,
+               struct Ast *ast, struct Interner *interner, bool parsed, size_t error_token, size_t threads)
 {
-    FILE *f;
+    struct Arena arena;
+    struct TypeTable types;
+    struct Diagnostics diagnostics = {0};
+    int result = EXIT_FAILURE;
 
-    if ((f = fopen(name, "rt")) == NULL) {
+    arena_init(&arena);
+    if (type_table_init(&types, &arena) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not allocate type table\n");
+        arena_free(&arena);
         return EXIT_FAILURE;
     }
 
-    fseek(f, 0, SEEK_END);
-    size_t size = ftell(f);
-    fseek(f, 0, SEEK_SET);
+    arena_init(&diagnostics.text);
+
+    if (parsed)
+        result = check_program(tokens, ast, interner, &types, &diagnostics, &error_token, threads, NULL);
+
+    for (size_t i = 0; i < diagnostics.count; i++) {
+        struct Diagnostic d = diagnostics.items[i];
+        struct SourcePosition position = source_position(source, tokens->starts[d.token]);
+        fprintf(stderr, "%s:%zu:%zu: %s\n", name, position.line, position.column, d.message);
+    }
+
+    if (result != EXIT_SUCCESS) {
+        report_parse_failure(name, source, tokens, error_token);
+    } else if (diagnostics.count > 0) {
+        result = EXIT_FAILURE;
+    }
+
+    diagnostics_free(&diagnostics);
+    arena_free(&arena);
 
-    char *contents = malloc(sizeof *contents * (size + 1));
+    return result;
+}
 
-    fread(contents, sizeof *contents, size, f);
-    contents[size] = '\0';
+/**Parses the tokens of one streamed statement on their own and prints the
+ * tree, or where parsing failed.
+ */
+static int print_statement_ast(const char *name, const struct StatementTokens *statement)
+{
+    struct Arena arena;
+    struct Ast ast;
+    size_t error_token = 0;
+    int result = EXIT_SUCCESS;
 
-    *out_data = contents;
+    arena_init(&arena);
+
+    if (ast_init(&ast, &arena, statement->tokens.count) != EXIT_SUCCESS
+            || parse_tokens(&statement->tokens, &ast, &error_token) != EXIT_SUCCESS
+            || parse_function_bodies(&statement->tokens, &ast, &error_token) != EXIT_SUCCESS) {
+        struct StringView view = error_token < statement->tokens.count
+                               ? token_view(&statement->tokens, error_token) : (struct StringView) {0};
+        const char *unsupported = parse_unsupported(&statement->tokens, error_token);
+        fprintf(stderr, "%s: failure to parse the statement at byte %zu, at \"%.*s\"", name, statement->offset,
+                (int)view.length, view.data);
+        if (unsupported != NULL)
+            fprintf(stderr, ", %s aren't supported", unsupported);
+        fputc('\n', stderr);
+        result = EXIT_FAILURE;
+    } else {
+        print_node(&statement->tokens, &ast, 0, 0);
+    }
+
+    arena_free(&arena);
+
+    return result;
+}
+
+/**Lexes a file (or stdin for "-") through the streaming lexer one top-level
+ * statement at a time, so memory stays bounded however big the input is, and
+ * prints each statement's tokens, or with ast its tree.  The source isn't
+ * kept, so statements are placed by their byte offset and tokens are printed
+ * without positions.
+ */
+int stream_file(const char *name, bool ast)
+{
+    FILE *f = strcmp(name, "-") == 0 ? stdin : fopen(name, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "could not load file\n");
+        return EXIT_FAILURE;
+    }
+
+    struct Interner interner;
+    struct Lexer lexer;
+    struct StatementTokens statement = {0};
+    int result = EXIT_SUCCESS;
+
+    if (interner_init(&interner) != EXIT_SUCCESS || lexer_init(&lexer, STREAM_WINDOW_SIZE, &interner) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not allocate lexer\n");
+        if (f != stdin) fclose(f);
+        return EXIT_FAILURE;
+    }
+
+    printf("Got a list of statements:\n");
+
+    while (true) {
+        enum LexerStatus status = lexer_next_statement(&lexer, &statement);
+
+        if (status == LSREADY) {
+            printf("statement at byte %zu\n", statement.offset);
+            if (ast && print_statement_ast(name, &statement) != EXIT_SUCCESS)
+                result = EXIT_FAILURE;
+            for (size_t i = 0; i < statement.tokens.count && !ast; i++)
+                print_token(&statement.tokens, i);
+        } else if (status == LSNEEDINPUT) {
+            size_t space;
+            char *input = lexer_reserve(&lexer, &space);
+            size_t read = fread(input, 1, space, f);
+            lexer_commit(&lexer, read);
+
+            if (read < space) {
+                if (ferror(f)) {
+                    fprintf(stderr, "could not read file\n");
+                    result = EXIT_FAILURE;
+                    break;
+                }
+                if (feof(f))
+                    lexer_finish(&lexer);
+            }
+        } else if (status == LSEND) {
+            break;
+        } else {
+            fprintf(stderr, "failure to tokenise\n");
+            result = EXIT_FAILURE;
+            break;
+        }
+    }
+
+    statement_tokens_free(&statement);
+    lexer_free(&lexer);
+    interner_free(&interner);
+    if (f != stdin) fclose(f);
+
+    return result;
+}
+
+static double seconds_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static bool same_tokens(const struct TokenBuffer *a, const struct Interner *ai,
+                        const struct TokenBuffer *b, const struct Interner *bi)
+{
+    if (a->count != b->count)
+        return false;
+
+    for (size_t i = 0; i < a->count; i++) {
+        if (a->types[i] != b->types[i] || a->starts[i] != b->starts[i] || a->lengths[i] != b->lengths[i])
+            return false;
+
+        // symbols are numbered in order of first appearance, so these match too
+        if (a->symbols[i] != b->symbols[i])
+            return false;
+    }
+
+    return ai->count == bi->count;
+}
+
+/**Times serial lexing against parallel lexing at 1, 2, 4... up to max_threads
+ * threads, checking that each run produces exactly the serial tokens.
+ */
+int bench_lex(const char *name, size_t max_threads)
+{
+    struct SourceFile source;
+
+    if (source_load(name, &source) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not load file\n");
+        return EXIT_FAILURE;
+    }
+
+    struct Interner serial_interner = {0};
+    struct TokenBuffer serial = {0};
+    int result = EXIT_SUCCESS;
+    double best = 0;
+    size_t error_offset;
+
+    if (interner_init(&serial_interner) != EXIT_SUCCESS
+            || tokenise_file(source.data, source.length, &serial_interner, &serial, &error_offset) != EXIT_SUCCESS) {
+        fprintf(stderr, "failure to tokenise\n");
+        result = EXIT_FAILURE;
+        goto done;
+    }
+
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        struct Interner interner;
+        struct TokenBuffer tokens = {0};
+
+        interner_init(&interner);
+        double start = seconds_now();
+        tokenise_file(source.data, source.length, &interner, &tokens, &error_offset);
+        double elapsed = seconds_now() - start;
+        if (run == 0 || elapsed < best)
+            best = elapsed;
+
+        token_buffer_free(&tokens);
+        interner_free(&interner);
+    }
+
+    printf("%zu bytes, %zu tokens\n", source.length, serial.count);
+    printf("serial     %8.1f MB/s\n", source.length / best / 1e6);
+
+    double serial_best = best;
+
+    for (size_t threads = 1; threads <= max_threads; threads = threads * 2 > max_threads && threads < max_threads ? max_threads : threads * 2) {
+        bool identical = true;
+
+        for (int run = 0; run < BENCH_RUNS; run++) {
+            struct Interner interner;
+            struct TokenBuffer tokens = {0};
+
+            interner_init(&interner);
+            double start = seconds_now();
+            int lexed = tokenise_file_parallel(source.data, source.length, &interner, &tokens, threads, &error_offset);
+            double elapsed = seconds_now() - start;
+            if (run == 0 || elapsed < best)
+                best = elapsed;
+
+            identical &= lexed == EXIT_SUCCESS && same_tokens(&serial, &serial_interner, &tokens, &interner);
+
+            token_buffer_free(&tokens);
+            interner_free(&interner);
+        }
+
+        printf("%2zu threads %8.1f MB/s  x%.2f%s\n", threads, source.length / best / 1e6,
+               serial_best / best, identical ? "" : "  MISMATCH");
+
+        if (!identical)
+            result = EXIT_FAILURE;
+    }
+
+done:
+    token_buffer_free(&serial);
+    interner_free(&serial_interner);
+    source_free(&source);
+
+    return result;
+}
+
+static bool same_ast(const struct Ast *a, const struct Ast *b)
+{
+    if (a->count != b->count || a->extra_count != b->extra_count
+            || a->number_count != b->number_count || a->function_count != b->function_count)
+        return false;
+
+    for (size_t i = 0; i < a->count; i++) {
+        struct Node x = a->nodes[i], y = b->nodes[i];
+        if (x.kind != y.kind || x.token != y.token || x.lhs != y.lhs || x.rhs != y.rhs)
+            return false;
+    }
+
+    for (size_t i = 0; i < a->function_count; i++) {
+        struct Function x = a->functions[i], y = b->functions[i];
+        if (x.name != y.name || x.parameters != y.parameters || x.body != y.body || x.result != y.result
+                || x.body_start != y.body_start || x.body_end != y.body_end)
+            return false;
+    }
+
+    return memcmp(a->extra, b->extra, a->extra_count * sizeof *a->extra) == 0
+        && memcmp(a->numbers, b->numbers, a->number_count * sizeof *a->numbers) == 0;
+}
+
+/**Times serial parsing of the top level against parallel parsing at 1, 2,
+ * 4... up to max_threads threads, checking that each run builds exactly the
+ * serial tree.  Lexing isn't timed.
+ */
+int bench_parse(const char *name, size_t max_threads)
+{
+    struct SourceFile source;
+    struct Interner interner = {0};
+    struct TokenBuffer tokens = {0};
+    struct Arena serial_arena;
+    struct Ast serial;
+    size_t error_token, error_offset;
+    int result = EXIT_SUCCESS;
+    double best = 0;
+
+    if (source_load(name, &source) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not load file\n");
+        return EXIT_FAILURE;
+    }
+
+    arena_init(&serial_arena);
+
+    if (interner_init(&interner) != EXIT_SUCCESS
+            || tokenise_file(source.data, source.length, &interner, &tokens, &error_offset) != EXIT_SUCCESS) {
+        fprintf(stderr, "failure to tokenise\n");
+        result = EXIT_FAILURE;
+        goto done;
+    }
+
+    if (ast_init(&serial, &serial_arena, tokens.count) != EXIT_SUCCESS
+            || parse_tokens(&tokens, &serial, &error_token) != EXIT_SUCCESS) {
+        fprintf(stderr, "failure to parse\n");
+        result = EXIT_FAILURE;
+        goto done;
+    }
+
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        struct Arena arena;
+        struct Ast ast;
+
+        arena_init(&arena);
+        ast_init(&ast, &arena, tokens.count);
+        double start = seconds_now();
+        parse_tokens(&tokens, &ast, &error_token);
+        double elapsed = seconds_now() - start;
+        if (run == 0 || elapsed < best)
+            best = elapsed;
+
+        arena_free(&arena);
+    }
+
+    printf("%zu tokens, %zu nodes\n", tokens.count, serial.count);
+    printf("serial     %8.1f MB/s\n", source.length / best / 1e6);
+
+    double serial_best = best;
+
+    for (size_t threads = 1; threads <= max_threads; threads = threads * 2 > max_threads && threads < max_threads ? max_threads : threads * 2) {
+        bool identical = true;
+
+        for (int run = 0; run < BENCH_RUNS; run++) {
+            struct Arena arena;
+            struct Ast ast;
+
+            arena_init(&arena);
+            ast_init(&ast, &arena, tokens.count);
+            double start = seconds_now();
+            int parsed = parse_tokens_parallel(&tokens, &ast, &error_token, threads);
+            double elapsed = seconds_now() - start;
+            if (run == 0 || elapsed < best)
+                best = elapsed;
+
+            identical &= parsed == EXIT_SUCCESS && same_ast(&serial, &ast);
+
+            arena_free(&arena);
+        }
+
+        printf("%2zu threads %8.1f MB/s  x%.2f%s\n", threads, source.length / best / 1e6,
+               serial_best / best, identical ? "" : "  MISMATCH");
+
+        if (!identical)
+            result = EXIT_FAILURE;
+    }
+
+done:
+    arena_free(&serial_arena);
+    token_buffer_free(&tokens);
+    interner_free(&interner);
+    source_free(&source);
+
+    return result;
+}
+
+/**Starts a map of the output compiled from source, building the line table
+ * if no position has been asked for yet.
+ */
+static int start_source_map(struct SourceFile *source, const struct TokenBuffer *tokens, bool map_lines,
+                            struct SourceMap *map)
+{
+    if (source->lines.starts == NULL
+            && line_table_build(source->data, source->length, &source->lines) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    source_map_init(map, tokens, &source->lines, map_lines ? MDLINES : MDTOKENS);
 
     return EXIT_SUCCESS;
 }
 
-void print_usage()
+/**Writes out to stdout and, if there's a map, points out at it and writes
+ * it to map_name.
+ */
+static int write_output(const char *name, struct OutputBuffer *out, const struct SourceMap *map, const char *map_name)
 {
-    printf("Usage: compile [--strict] file\n");
+    static const char url[] = "//# sourceMappingURL=";
+
+    if (map != NULL) {
+        bool appended = (out->length == 0 || out->data[out->length - 1] == '\n'
+                         || output_append(out, "\n", 1) == EXIT_SUCCESS)
+                     && output_append(out, url, sizeof url - 1) == EXIT_SUCCESS
+                     && output_append(out, map_name, strlen(map_name)) == EXIT_SUCCESS
+                     && output_append(out, "\n", 1) == EXIT_SUCCESS;
+        if (!appended) {
+            fprintf(stderr, "could not write output\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    fflush(stdout);
+    if (output_write(STDOUT_FILENO, out, 1) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not write output\n");
+        return EXIT_FAILURE;
+    }
+
+    if (map == NULL)
+        return EXIT_SUCCESS;
+
+    int fd = open(map_name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    int result = fd >= 0 ? source_map_write(fd, map, name) : EXIT_FAILURE;
+
+    if (fd >= 0 && close(fd) != 0)
+        result = EXIT_FAILURE;
+    if (result != EXIT_SUCCESS)
+        fprintf(stderr, "could not write source map %s\n", map_name);
+
+    return result;
 }
 
-const char *token_type_strings[] = {
-    [TTBREAK] = "break",
-    [TTCASE] = "case",
-    [TTCATCH] = "catch",
-    [TTCLASS] = "class",
-    [TTCONST] = "const",
-    [TTCONTINUE] = "continue",
-    [TTDEBUGGER] = "debugger",
-    [TTDEFAULT] = "default",
-    [TTDELETE] = "delete",
-    [TTDO] = "do",
-    [TTELSE] = "else",
-    [TTENUM] = "enum",
-    [TTEXPORT] = "export",
-    [TTEXTENDS] = "extends",
-    [TTFALSE] = "false",
-    [TTFINALLY] = "finally",
-    [TTFOR] = "for",
-    [TTFUNCTION] = "function",
-    [TTIF] = "if",
-    [TTIMPORT] = "import",
-    [TTIN] = "in",
-    [TTINSTANCEOF] = "instanceof",
-    [TTNEW] = "new",
-    [TTNULL] = "null",
-    [TTRETURN] = "return",
-    [TTSUPER] = "super",
-    [TTSWITCH] = "switch",
-    [TTTHIS] = "this",
-    [TTTHROW] = "throw",
-    [TTTRUE] = "true",
-    [TTTRY] = "try",
-    [TTTYPEOF] = "typeof",
-    [TTVAR] = "var",
-    [TTVOID] = "void",
-    [TTWHILE] = "while",
-    [TTWITH] = "with",
-    // strict mode keywords
-    [TTAS] = "as",
-    [TTIMPLEMENTS] = "implements",
-    [TTINTERFACE] = "interface",
-    [TTLET] = "let",
-    [TTPACKAGE] = "package",
-    [TTPRIVATE] = "private",
-    [TTPROTECTED] = "protected",
-    [TTPUBLIC] = "public",
-    [TTSTATIC] = "static",
-    [TTYIELD] = "yield",
-    // operators
-    [TTIDENT] = "===",
-    [TTNOTIDENT] = "!==",
-    [TTEQ] = "==",
-    [TTNOTEQ] = "!=",
-    [TTASSIGN] = "=",
-    [TTPLUS] = "+",
-    [TTMINUS] = "-",
-    [TTDIVIDE] = "/",
-    [TTMULTIPLY] = "*",
-    [TTMODULO] = "%",
-    [TTPLUSASSIGN] = "+=",
-    [TTMINUSASSIGN] = "-=",
-    [TTDIVIDEASSIGN] = "/=",
-    [TTMULTIPLYASSIGN] = "*=",
-    [TTMODULOASSIGN] = "%=",
-    [TTBITAND] = "&",
-    [TTBITOR] = "|",
-    [TTBITXOR] = "^",
-    [TTBITNOT] = "~",
-    [TTBITSHRZERO] = ">>>",
-    [TTBITSHR] = ">>",
-    [TTBITSHL] = "<<",
-    [TTAND] = "&&",
-    [TTOR] = "||",
-    [TTBANG] = "!",
-    [TTCONDITIONAL] = "?",
-    [TTLESS] = "<",
-    [TTGREATER] = ">",
-    [TTLESSEQ] = "<=",
-    [TTGREATEREQ] = ">=",
-    [TTDOT] = ".",
-    // syntax
-    [TTSEMICOLON] = ";",
-    [TTOPENPAREN] = "(",
-    [TTCLOSEPAREN] = ")",
-    [TTOPENBRACE] = "{",
-    [TTCLOSEBRACE] = "}",
-    [TTOPENBRACKET] = "[",
-    [TTCLOSEBRACKET] = "]",
-    [TTCOLON] = ":",
-    [TTCOMMA] = ",",
-};
+/**Writes the file to stdout with its types stripped, straight from the
+ * tokens: no tree is built and nothing is checked.
+ */
+int transpile_file(const char *name, size_t threads, const char *map_name, bool map_lines)
+{
+    struct SourceFile source;
 
-static const struct {
-    const char *keyword;
-    enum TokenType ttype;
-} keywords[] = {
-    // always reserved words
-    { "break", TTBREAK },
-    { "case", TTCASE },
-    { "catch", TTCATCH },
-    { "class", TTCLASS },
-    { "const", TTCONST },
-    { "continue", TTCONTINUE },
-    { "debugger", TTDEBUGGER },
-    { "default", TTDEFAULT },
-    { "delete", TTDELETE },
-    { "do", TTDO },
-    { "else", TTELSE },
-    { "enum", TTENUM },
-    { "export", TTEXPORT },
-    { "extends", TTEXTENDS },
-    { "false", TTFALSE },
-    { "finally", TTFINALLY },
-    { "for", TTFOR },
-    { "function", TTFUNCTION },
-    { "if", TTIF },
-    { "import", TTIMPORT },
-    { "in", TTIN },
-    { "instanceof", TTINSTANCEOF },
-    { "new", TTNEW },
-    { "null", TTNULL },
-    { "return", TTRETURN },
-    { "super", TTSUPER },
-    { "switch", TTSWITCH },
-    { "this", TTTHIS },
-    { "throw", TTTHROW },
-    { "true", TTTRUE },
-    { "try", TTTRY },
-    { "typeof", TTTYPEOF },
-    { "var", TTVAR },
-    { "void", TTVOID },
-    { "while", TTWHILE },
-    { "with", TTWITH },
-    // TODO: strict mode only; handle this later
-    { "as", TTAS },
-    { "implements", TTIMPLEMENTS },
-    { "interface", TTINTERFACE },
-    { "let", TTLET },
-    { "package", TTPACKAGE },
-    { "private", TTPRIVATE },
-    { "protected", TTPROTECTED },
-    { "public", TTPUBLIC },
-    { "static", TTSTATIC },
-    { "yield", TTYIELD },
-};
+    if (source_load(name, &source) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not load file\n");
+        return EXIT_FAILURE;
+    }
+
+    struct Interner interner;
+    struct TokenBuffer tokens = {0};
+    struct SpanBuffer spans = {0};
+    struct OutputBuffer out = {0};
+    struct SourceMap map = {0};
+    size_t error_token = 0, error_offset = 0;
+    int result = EXIT_SUCCESS;
+
+    if (interner_init(&interner) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not allocate interner\n");
+        source_free(&source);
+        return EXIT_FAILURE;
+    }
+
+    if (tokenise_file_parallel(source.data, source.length, &interner, &tokens, threads, &error_offset) != EXIT_SUCCESS) {
+        struct SourcePosition position = source_position(&source, error_offset);
+        fprintf(stderr, "%s:%zu:%zu: failure to tokenise\n", name, position.line, position.column);
+        result = EXIT_FAILURE;
+    } else if (strip_types(&tokens, source.length, &spans, &error_token) != EXIT_SUCCESS) {
+        size_t offset = error_token < tokens.count ? tokens.starts[error_token] : source.length;
+        struct SourcePosition position = source_position(&source, offset);
+        fprintf(stderr, "%s:%zu:%zu: failure to strip types\n", name, position.line, position.column);
+        result = EXIT_FAILURE;
+    } else if (map_name != NULL && start_source_map(&source, &tokens, map_lines, &map) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not allocate source map\n");
+        result = EXIT_FAILURE;
+    } else {
+        // gathered into one buffer, so the file goes out in one write
+        bool copied = output_reserve(&out, source.length) == EXIT_SUCCESS;
+        for (size_t i = 0; i < spans.count && copied; i++) {
+            struct SourceSpan span = spans.spans[i];
+            if (map_name != NULL)
+                source_map_add_run(&map, span.start, span.start + span.length);
+            copied = output_append(&out, source.data + span.start, span.length) == EXIT_SUCCESS;
+        }
+
+        if (!copied) {
+            fprintf(stderr, "could not write output\n");
+            result = EXIT_FAILURE;
+        } else {
+            result = write_output(name, &out, map_name != NULL ? &map : NULL, map_name);
+        }
+    }
+
+    source_map_free(&map);
+    output_buffer_free(&out);
+    span_buffer_free(&spans);
+    token_buffer_free(&tokens);
+    interner_free(&interner);
+    source_free(&source);
+
+    return result;
+}
+
+/**Writes the parsed file to stdout as JavaScript, folding its constants
+ * first if fold is set.
+ */
+int emit_file(const char *name, struct SourceFile *source, const struct TokenBuffer *tokens,
+              struct Ast *ast, const struct Interner *interner, bool parsed, size_t error_token,
+              const char *map_name, bool map_lines, bool fold)
+{
+    if (!parsed || parse_function_bodies(tokens, ast, &error_token) != EXIT_SUCCESS) {
+        report_parse_failure(name, source, tokens, error_token);
+        return EXIT_FAILURE;
+    }
+
+    struct OutputBuffer out = {0};
+    struct SourceMap map = {0};
+    struct Folding folding = {0};
+    int result = EXIT_SUCCESS;
+
+    if (fold && fold_constants(tokens, ast, interner, &folding) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not fold constants\n");
+        result = EXIT_FAILURE;
+    } else if (map_name != NULL && start_source_map(source, tokens, map_lines, &map) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not allocate source map\n");
+        result = EXIT_FAILURE;
+    } else if (emit_program(tokens, ast, fold ? &folding : NULL, source->length, &out, map_name != NULL ? &map : NULL,
+                            &error_token) != EXIT_SUCCESS) {
+        size_t offset = error_token < tokens->count ? tokens->starts[error_token] : source->length;
+        struct SourcePosition position = source_position(source, offset);
+        fprintf(stderr, "%s:%zu:%zu: failure to emit\n", name, position.line, position.column);
+        result = EXIT_FAILURE;
+    } else {
+        result = write_output(name, &out, map_name != NULL ? &map : NULL, map_name);
+    }
+
+    folding_free(&folding);
+    source_map_free(&map);
+    output_buffer_free(&out);
+
+    return result;
+}
 
-void print_token(const struct Token *token)
+/**Times parsing, function bodies included, and emitting the tree it gives
+ * separately, emitting into a buffer that isn't written anywhere: without a
+ * source map, with one mapping every token, with one mapping lines, and
+ * with constants folded first.
+ */
+int bench_emit(const char *name)
 {
-    const size_t NUM_KEYWORDS = sizeof keywords / sizeof keywords[0];
-    for (int i = 0; i < NUM_KEYWORDS; i++) {
-        if (keywords[i].ttype == token->type) {
-            printf("keyword %s\n", keywords[i].keyword);
-            return;
+    static const char *const labels[] = { "emit", "emit+map", "emit+lines", "fold+emit" };
+    struct SourceFile source;
+    struct Interner interner = {0};
+    struct TokenBuffer tokens = {0};
+    struct Arena arena;
+    size_t error_token, error_offset;
+    double parse_best = 0, emit_best[4] = {0};
+    size_t node_count = 0, output_length = 0, folded_length = 0, mappings_length[4] = {0};
+    int result = EXIT_SUCCESS;
+
+    if (source_load(name, &source) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not load file\n");
+        return EXIT_FAILURE;
+    }
+
+    // each run's tree is freed before the next, and a failed run's at done
+    arena_init(&arena);
+
+    if (interner_init(&interner) != EXIT_SUCCESS
+            || tokenise_file(source.data, source.length, &interner, &tokens, &error_offset) != EXIT_SUCCESS
+            || line_table_build(source.data, source.length, &source.lines) != EXIT_SUCCESS) {
+        fprintf(stderr, "failure to tokenise\n");
+        result = EXIT_FAILURE;
+        goto done;
+    }
+
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        struct Ast ast;
+
+        if (ast_init(&ast, &arena, tokens.count) != EXIT_SUCCESS) {
+            fprintf(stderr, "could not allocate syntax tree\n");
+            result = EXIT_FAILURE;
+            goto done;
+        }
+
+        double start = seconds_now();
+        if (parse_tokens(&tokens, &ast, &error_token) != EXIT_SUCCESS
+                || parse_function_bodies(&tokens, &ast, &error_token) != EXIT_SUCCESS) {
+            fprintf(stderr, "failure to parse\n");
+            result = EXIT_FAILURE;
+            goto done;
+        }
+        double elapsed = seconds_now() - start;
+        if (run == 0 || elapsed < parse_best)
+            parse_best = elapsed;
+        node_count = ast.count;
+
+        for (int variant = 0; variant < 4 && result == EXIT_SUCCESS; variant++) {
+            struct OutputBuffer out = {0};
+            struct SourceMap map;
+            struct Folding folding = {0};
+            bool fold = variant == 3, mapped = variant == 1 || variant == 2;
+
+            source_map_init(&map, &tokens, &source.lines, variant == 2 ? MDLINES : MDTOKENS);
+            start = seconds_now();
+            if (fold && fold_constants(&tokens, &ast, &interner, &folding) != EXIT_SUCCESS) {
+                fprintf(stderr, "could not fold constants\n");
+                result = EXIT_FAILURE;
+            } else if (emit_program(&tokens, &ast, fold ? &folding : NULL, source.length, &out, mapped ? &map : NULL,
+                                    &error_token) != EXIT_SUCCESS) {
+                fprintf(stderr, "failure to emit\n");
+                result = EXIT_FAILURE;
+            } else {
+                elapsed = seconds_now() - start;
+                if (run == 0 || elapsed < emit_best[variant])
+                    emit_best[variant] = elapsed;
+                if (fold)
+                    folded_length = out.length;
+                else
+                    output_length = out.length;
+                mappings_length[variant] = map.mappings.length;
+            }
+
+            folding_free(&folding);
+            source_map_free(&map);
+            output_buffer_free(&out);
         }
+
+        if (result != EXIT_SUCCESS)
+            goto done;
+
+        arena_free(&arena);
+    }
+
+    printf("%zu bytes, %zu nodes, %zu bytes out\n", source.length, node_count, output_length);
+    printf("parse      %8.1f MB/s\n", source.length / parse_best / 1e6);
+    for (int variant = 0; variant < 4; variant++) {
+        printf("%-10s %8.1f MB/s", labels[variant], source.length / emit_best[variant] / 1e6);
+        if (variant == 1 || variant == 2)
+            printf("  %zu bytes of mappings", mappings_length[variant]);
+        if (variant == 3)
+            printf("  %zu bytes out", folded_length);
+        printf("\n");
+    }
+
+done:
+    arena_free(&arena);
+    token_buffer_free(&tokens);
+    interner_free(&interner);
+    source_free(&source);
+
+    return result;
+}
+
+void print_usage()
+{
+    printf("Usage: compile [--strict] [--stream] [--threads n] [--bench-lex] [--bench-parse] [--ast [--preparse]] [--check] [--cache dir] [--transpile-only] [--emit [--fold]] [--bench-emit] [--reparse] [--bench-reparse] [--recheck] [--source-map file [--map-lines]] file\n");
+}
+
+void print_token(const struct TokenBuffer *tokens, size_t i)
+{
+    enum TokenType ttype = token_type(tokens, i);
+    struct StringView view = token_view(tokens, i);
+
+    if (token_type_is_keyword(ttype)) {
+        printf("keyword %s\n", token_type_strings[ttype]);
+        return;
     }
 
-    switch (token->type) {
+    switch (ttype) {
     case TTNONE:
         printf("(none)\n");
         break;
         break;
     case TTIDENTIFIER:
-        printf("identifier %.*s\n", (int)token->view.length, token->view.data);
+        printf("identifier %.*s\n", (int)view.length, view.data);
         break;
     case TTNUMLITERAL:
-        printf("numeric literal %.*s\n", (int)token->view.length, token->view.data);
+        printf("numeric literal %.*s\n", (int)view.length, view.data);
+        break;
+    case TTSINGLESTRING:
+    case TTDOUBLESTRING:
+        printf("string literal %.*s\n", (int)view.length, view.data);
         break;
     case TTBREAK:
     case TTCASE:
@@ -358,7 +1171,24 @@ void print_token(const struct Token *token)
     case TTCOLON:
     case TTCOMMA:
     case TTDOT:
-        printf("%s\n", token_type_strings[token->type]);
+    case TTINCREMENT:
+    case TTDECREMENT:
+    case TTEXPONENT:
+    case TTEXPONENTASSIGN:
+    case TTBITANDASSIGN:
+    case TTBITORASSIGN:
+    case TTBITXORASSIGN:
+    case TTBITSHLASSIGN:
+    case TTBITSHRASSIGN:
+    case TTBITSHRZEROASSIGN:
+    case TTANDASSIGN:
+    case TTORASSIGN:
+    case TTNULLISH:
+    case TTNULLISHASSIGN:
+    case TTOPTIONALCHAIN:
+    case TTARROW:
+    case TTSPREAD:
+        printf("%s\n", token_type_strings[ttype]);
         break;
     default:
         assert(0 && "unreachable");
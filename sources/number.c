@@ -0,0 +1,260 @@
+#include "compile.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+/* Conversion of numeric literal text to doubles.
+ *
+ * Decimal literals take a fast path whenever the result is exact in double
+ * arithmetic (Clinger): up to 19 significant digits are gathered into a
+ * 64-bit mantissa, eight digits at a time with SWAR where the bytes allow,
+ * and if the mantissa fits in 53 bits and the decimal exponent is within
+ * +-22, a single multiply or divide by an exact power of ten is correctly
+ * rounded.  Everything else goes to strtod, which rounds correctly, on a copy
+ * of the text with the separators removed.
+ *
+ * Hex, octal and binary integers, legacy octal ones like 010 included, are
+ * exact whenever they fit in 64 bits, and otherwise are rewritten as hex for
+ * strtod.
+ */
+
+#define MAX_FAST_DIGITS 19
+#define MAX_EXACT_MANTISSA (1ull << 53)
+#define MAX_EXACT_POWER 22
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define NUMBER_SWAR 1
+#endif
+
+static const double exact_powers_of_ten[MAX_EXACT_POWER + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+#ifdef NUMBER_SWAR
+
+static bool is_eight_digits(const char *string)
+{
+    uint64_t word;
+    memcpy(&word, string, sizeof word);
+
+    return ((word & 0xf0f0f0f0f0f0f0f0ull)
+            | (((word + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4))
+        == 0x3333333333333333ull;
+}
+
+static uint32_t parse_eight_digits(const char *string)
+{
+    uint64_t word;
+    memcpy(&word, string, sizeof word);
+
+    word = (word & 0x0f0f0f0f0f0f0f0full) * 2561 >> 8;
+    word = (word & 0x00ff00ff00ff00ffull) * 6553601 >> 16;
+
+    return (uint32_t)((word & 0x0000ffff0000ffffull) * 42949672960001ull >> 32);
+}
+
+#endif // NUMBER_SWAR
+
+/**strtod on prefix + text with the '_' separators taken out.
+ */
+static int convert_exact(const char *prefix, const char *text, size_t length, double *out)
+{
+    char small[128];
+    size_t needed = strlen(prefix) + length + 1;
+    char *buffer = needed <= sizeof small ? small : malloc(needed);
+
+    if (buffer == NULL)
+        return EXIT_FAILURE;
+
+    size_t n = strlen(prefix);
+    memcpy(buffer, prefix, n);
+    for (size_t i = 0; i < length; i++)
+        if (text[i] != '_')
+            buffer[n++] = text[i];
+    buffer[n] = '\0';
+
+    *out = strtod(buffer, NULL);
+
+    if (buffer != small)
+        free(buffer);
+
+    return EXIT_SUCCESS;
+}
+
+/**Collects up to MAX_FAST_DIGITS significant digits into *mantissa, adjusting
+ * *exponent for digits dropped before the point (integer part) or kept after
+ * it (fraction).  Returns the end of the digits.
+ */
+static const char *gather_digits(const char *string, const char *end, bool fraction,
+                                 uint64_t *mantissa, int *digits, long *exponent, bool *truncated)
+{
+    while (string < end) {
+#ifdef NUMBER_SWAR
+        if (end - string >= 8 && *digits + 8 <= MAX_FAST_DIGITS && is_eight_digits(string)) {
+            *mantissa = *mantissa * 100000000 + parse_eight_digits(string);
+            *digits += 8;
+            if (fraction)
+                *exponent -= 8;
+            string += 8;
+            continue;
+        }
+#endif
+        if (*string == '_') {
+            ++string;
+            continue;
+        }
+
+        if (!char_is(*string, CCDIGIT))
+            break;
+
+        if (*digits < MAX_FAST_DIGITS) {
+            *mantissa = *mantissa * 10 + (*string - '0');
+            if (*mantissa != 0)
+                ++*digits; // leading zeros aren't significant
+            if (fraction)
+                --*exponent;
+        } else {
+            *truncated |= *string != '0';
+            if (!fraction)
+                ++*exponent;
+        }
+
+        ++string;
+    }
+
+    return string;
+}
+
+static int convert_decimal(const char *text, size_t length, double *out)
+{
+    const char *string = text, *end = text + length;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    long exponent = 0;
+    bool truncated = false;
+
+    string = gather_digits(string, end, false, &mantissa, &digits, &exponent, &truncated);
+
+    if (string < end && *string == '.')
+        string = gather_digits(string + 1, end, true, &mantissa, &digits, &exponent, &truncated);
+
+    if (string < end && (*string | 0x20) == 'e') {
+        bool negative = false;
+        long written = 0;
+
+        if (*++string == '+' || *string == '-')
+            negative = *string++ == '-';
+
+        for (; string < end; ++string) {
+            if (*string == '_')
+                continue;
+            if (written < 100000) // far past the range of a double either way
+                written = written * 10 + (*string - '0');
+        }
+
+        exponent += negative ? -written : written;
+    }
+
+    if (mantissa == 0) {
+        *out = 0.0;
+        return EXIT_SUCCESS;
+    }
+
+    if (!truncated && mantissa <= MAX_EXACT_MANTISSA
+            && exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER) {
+        double value = (double)mantissa;
+        *out = exponent < 0 ? value / exact_powers_of_ten[-exponent] : value * exact_powers_of_ten[exponent];
+        return EXIT_SUCCESS;
+    }
+
+    return convert_exact("", text, length, out);
+}
+
+/**Whether the digits after a leading zero make a legacy octal literal like
+ * 010, rather than a decimal like 08 or 0.5.
+ */
+static bool is_legacy_octal(const char *digits, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+        if (digits[i] < '0' || digits[i] > '7')
+            return false;
+
+    return true;
+}
+
+static int convert_radix(const char *digits, size_t length, int bits, double *out)
+{
+    uint64_t value = 0;
+    size_t i = 0;
+
+    for (; i < length; i++) {
+        if (digits[i] == '_')
+            continue;
+        if (value >> (64 - bits) != 0)
+            break; // won't fit
+        value = value << bits | digit_value(digits[i]);
+    }
+
+    if (i == length) {
+        *out = (double)value;
+        return EXIT_SUCCESS;
+    }
+
+    if (bits == 4)
+        return convert_exact("0x", digits, length, out);
+
+    // regroup octal or binary digits into hex nibbles, from the right
+    char small[256];
+    size_t needed = length * bits / 4 + 2;
+    char *hex = needed <= sizeof small ? small : malloc(needed);
+    size_t n = needed - 1;
+    unsigned accumulator = 0, held = 0;
+
+    if (hex == NULL)
+        return EXIT_FAILURE;
+
+    hex[n] = '\0';
+    for (i = length; i-- > 0;) {
+        if (digits[i] == '_')
+            continue;
+        accumulator |= (unsigned)digit_value(digits[i]) << held;
+        for (held += bits; held >= 4; held -= 4, accumulator >>= 4)
+            hex[--n] = "0123456789abcdef"[accumulator & 0xf];
+    }
+    if (held > 0)
+        hex[--n] = "0123456789abcdef"[accumulator & 0xf];
+
+    int result = convert_exact("0x", &hex[n], needed - 1 - n, out);
+
+    if (hex != small)
+        free(hex);
+
+    return result;
+}
+
+int numeric_literal_value(struct StringView text, double *value, bool *bigint)
+{
+    const char *data = text.data;
+    size_t length = text.length;
+
+    if (length == 0)
+        return EXIT_FAILURE;
+
+    *bigint = data[length - 1] == 'n';
+    if (*bigint)
+        --length;
+
+    if (length > 2 && data[0] == '0') {
+        switch (data[1] | 0x20) {
+        case 'x': return convert_radix(&data[2], length - 2, 4, value);
+        case 'o': return convert_radix(&data[2], length - 2, 3, value);
+        case 'b': return convert_radix(&data[2], length - 2, 1, value);
+        }
+    }
+
+    if (length > 1 && data[0] == '0' && is_legacy_octal(&data[1], length - 1))
+        return convert_radix(&data[1], length - 1, 3, value);
+
+    return convert_decimal(data, length, value);
+}
@@ -0,0 +1,227 @@
+#include "compile.h"
+
+#include <pthread.h>
+
+/* Parallel lexing of one large file.
+ *
+ * The file is cut into equal chunks and each worker lexes its chunk as if it
+ * started at a token boundary, carrying on past the end of its chunk to
+ * finish the last token.  That guess is wrong when a chunk starts inside a
+ * string or comment (or in the middle of a token), so the chunks are then
+ * stitched together on the calling thread:
+ *
+ * Starting where the previous chunk's lexing stopped, the stitcher lexes
+ * serially until it reaches an offset where the next chunk's speculative
+ * lexing also started a token.  The lexer carries no state between tokens,
+ * so from that token on the speculative tokens are exactly what serial lexing
+ * would produce and are copied over wholesale.  Normally the seam costs one
+ * or two tokens; a comment or string spanning a seam just means lexing it
+ * serially until the two agree again.
+ *
+ * Workers don't intern (they may lex garbage, and the interner isn't thread
+ * safe).  They leave each identifier's hash in its symbol slot and the
+ * stitched buffer is interned in one pass at the end.
+ */
+
+// below this much text per thread, threads cost more than they save
+#define PARALLEL_MIN_CHUNK (256 * 1024)
+
+struct Chunk {
+    const char *contents;
+    size_t begin;       // where this chunk's speculative lexing started
+    size_t limit;       // the start of the next chunk
+    size_t stop;        // where lexing stopped: at or past limit, or an error
+    bool failed;
+    struct TokenBuffer tokens;
+};
+
+static void *lex_chunk(void *argument)
+{
+    struct Chunk *chunk = argument;
+    const char *contents = &chunk->contents[chunk->begin];
+    enum TokenType ttype;
+    uint32_t hash = 0;
+
+    while (*contents != '\0' && (size_t)(contents - chunk->contents) < chunk->limit) {
+        const char *end = lex_token(contents, &ttype, &hash);
+
+        if (end == NULL) {
+            chunk->failed = true;
+            break;
+        }
+
+        if (ttype != TTNONE
+                && token_buffer_push(&chunk->tokens, ttype, contents - chunk->contents, end - contents,
+                                     ttype == TTIDENTIFIER ? hash : SYMBOL_NONE) != EXIT_SUCCESS) {
+            chunk->failed = true;
+            break;
+        }
+
+        contents = end;
+    }
+
+    chunk->stop = contents - chunk->contents;
+
+    return NULL;
+}
+
+/**The index of the token starting at offset, or -1.
+ */
+static long find_token_start(const struct TokenBuffer *tokens, size_t offset)
+{
+    size_t low = 0, high = tokens->count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (tokens->starts[middle] < offset)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low < tokens->count && tokens->starts[low] == offset ? (long)low : -1;
+}
+
+static int append_tokens(struct TokenBuffer *out, const struct TokenBuffer *in, size_t from)
+{
+    size_t n = in->count - from;
+
+    if (out->count + n > out->capacity && token_buffer_reserve(out, (out->count + n) * 2) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    memcpy(&out->types[out->count], &in->types[from], n * sizeof *out->types);
+    memcpy(&out->starts[out->count], &in->starts[from], n * sizeof *out->starts);
+    memcpy(&out->lengths[out->count], &in->lengths[from], n * sizeof *out->lengths);
+    memcpy(&out->symbols[out->count], &in->symbols[from], n * sizeof *out->symbols);
+    out->count += n;
+
+    return EXIT_SUCCESS;
+}
+
+static int stitch(const char *contents, size_t length, struct Chunk *chunks, size_t num_chunks, struct TokenBuffer *tokens,
+                  size_t *error_offset)
+{
+    size_t offset = 0, k = 0;
+    enum TokenType ttype;
+    uint32_t hash = 0;
+
+    while (contents[offset] != '\0') {
+        // the chunk whose speculative lexing covers this offset
+        while (k + 1 < num_chunks && offset >= chunks[k].limit)
+            ++k;
+
+        long from = chunks[k].begin <= offset && offset < chunks[k].stop
+                  ? find_token_start(&chunks[k].tokens, offset) : -1;
+
+        if (from >= 0) {
+            if (append_tokens(tokens, &chunks[k].tokens, from) != EXIT_SUCCESS)
+                return EXIT_FAILURE;
+
+            if (chunks[k].failed) {
+                // serial lexing fails at the same place
+                *error_offset = lex_token_error(&contents[chunks[k].stop]) - contents;
+                return EXIT_FAILURE;
+            }
+
+            offset = chunks[k].stop;
+            continue;
+        }
+
+        // not in step with the chunk yet, so lex one token serially
+        const char *end = lex_token(&contents[offset], &ttype, &hash);
+
+        if (end == NULL) {
+            *error_offset = lex_token_error(&contents[offset]) - contents;
+            return EXIT_FAILURE;
+        }
+
+        if (ttype != TTNONE
+                && token_buffer_push(tokens, ttype, offset, end - &contents[offset],
+                                     ttype == TTIDENTIFIER ? hash : SYMBOL_NONE) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+
+        offset = end - contents;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int tokenise_file_parallel(const char *contents, size_t length, struct Interner *interner,
+                           struct TokenBuffer *tokens, size_t threads, size_t *error_offset)
+{
+    *error_offset = length; // unless a token is to blame
+
+    if (length > UINT32_MAX)
+        return EXIT_FAILURE; // offsets are 32 bits
+
+    if (threads > length / PARALLEL_MIN_CHUNK)
+        threads = length / PARALLEL_MIN_CHUNK;
+
+    if (threads <= 1)
+        return tokenise_file(contents, length, interner, tokens, error_offset);
+
+    struct Chunk *chunks = calloc(threads, sizeof *chunks);
+    pthread_t *workers = calloc(threads, sizeof *workers);
+    int result = EXIT_FAILURE;
+    size_t started = 0;
+
+    *tokens = (struct TokenBuffer) { .source = contents };
+
+    if (chunks == NULL || workers == NULL)
+        goto done;
+
+    for (size_t k = 0; k < threads; k++) {
+        chunks[k] = (struct Chunk) {
+            .contents = contents,
+            .begin = length / threads * k,
+            .limit = k + 1 == threads ? length : length / threads * (k + 1),
+            .tokens = { .source = contents },
+        };
+        if (token_buffer_reserve(&chunks[k].tokens, (chunks[k].limit - chunks[k].begin) / TOKEN_ESTIMATE_BYTES_PER_TOKEN + TOKEN_ESTIMATE_MIN) != EXIT_SUCCESS)
+            goto done;
+    }
+
+    // the workers call the scanning kernels, which mustn't be picked under them
+    scan_resolve_kernels();
+
+    // the calling thread takes the first chunk itself
+    for (started = 1; started < threads; started++)
+        if (pthread_create(&workers[started], NULL, lex_chunk, &chunks[started]) != 0)
+            break;
+
+    lex_chunk(&chunks[0]);
+
+    for (size_t k = 1; k < started; k++)
+        pthread_join(workers[k], NULL);
+
+    // any chunk that couldn't get a thread is lexed here
+    for (size_t k = started; k < threads; k++)
+        lex_chunk(&chunks[k]);
+
+    if (token_buffer_reserve(tokens, length / TOKEN_ESTIMATE_BYTES_PER_TOKEN + TOKEN_ESTIMATE_MIN) != EXIT_SUCCESS)
+        goto done;
+
+    if (stitch(contents, length, chunks, threads, tokens, error_offset) != EXIT_SUCCESS)
+        goto done;
+
+    for (size_t i = 0; i < tokens->count; i++) {
+        if (token_type(tokens, i) != TTIDENTIFIER)
+            continue;
+
+        struct StringView id = token_view(tokens, i);
+        if ((tokens->symbols[i] = intern(interner, id.data, id.length, tokens->symbols[i])) == SYMBOL_NONE)
+            goto done;
+    }
+
+    result = EXIT_SUCCESS;
+
+done:
+    if (chunks != NULL)
+        for (size_t k = 0; k < threads; k++)
+            token_buffer_free(&chunks[k].tokens);
+
+    free(chunks);
+    free(workers);
+
+    return result;
+}
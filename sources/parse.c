@@ -1,110 +1,2592 @@
 #include "compile.h"
 
 #include <assert.h>
-#include <ctype.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
 
-int parse_tokens(const struct Token *tokens, size_t num_tokens, struct StatementOrDeclaration *out)
+/* Each of these takes the index of the first token to parse and returns the
+ * index one past the end of the parsed sequence, or PARSE_FAILED.  The index
+ * of the node built is written to "out".
+ */
+
+#define PARSE_FAILED ((size_t)-1)
+
+// the initial room on the expression stacks, which also hold statements
+#define PARSE_INITIAL_STACK 64
+
+/* Expressions are parsed by precedence climbing, but with explicit operand
+ * and operator stacks in place of recursion, so the depth of nesting only
+ * costs stack entries.  A token is either read where an operand is expected
+ * (literals, names, prefix operators, opening brackets) or where an operator
+ * is expected (binary and postfix operators, closing brackets).
+ *
+ * A binary operator first reduces every operator above it on the stack that
+ * binds more tightly, comparing its left binding power with their right
+ * binding powers; left associative operators have right > left, so equal
+ * precedence reduces, and right associative ones the reverse.  Brackets are
+ * frames on the same stack that nothing but their closing token reduces.
+ *
+ * The stacks belong to the Parser, and one parse_expression only works above
+ * where they stood when it started, so it can be re-entered.
+ */
+
+enum FrameType {
+    // operators, reduced by binding power
+    FTBINARY,
+    FTPREFIX,
+    FTNEW,          // "new" with no arguments (yet)
+    FTTERNARY,      // "c ? t :" waiting for the else branch
+    FTPROPERTY,     // "key:" waiting for the value
+    FTARROW,        // "params =>" waiting for the body
+    // brackets, reduced by their closing token
+    FTGROUP,
+    FTCALL,
+    FTNEWCALL,
+    FTINDEX,
+    FTARRAY,
+    FTOBJECT,
+    FTCOMPUTEDKEY,
+    FTCONDITION,    // "c ?" waiting for ":"
+};
+
+struct Frame {
+    uint8_t type;
+    uint8_t kind;       // the node kind an operator builds, or the
+                        // MemberModifiers before a computed key
+    uint8_t power;      // an operator's right binding power
+    uint32_t token;
+    uint32_t base;      // the operand count when a bracket opened, or an
+                        // arrow function's parameters
+};
+
+struct Parser {
+    const struct TokenBuffer *tokens;
+    struct Ast *ast;
+    struct Frame *frames;
+    size_t frame_count, frame_capacity;
+    uint32_t *operands;
+    size_t operand_count, operand_capacity;
+    size_t error_token;     // where the innermost failed statement starts,
+                            // or a form in it that isn't parsed yet
+    uint8_t angles;         // type argument lists a ">>" or ">>>" closed
+                            // beyond the innermost
+};
+
+/* What can come before an object literal member's key, making it a method
+ * or an accessor.
+ */
+enum MemberModifier {
+    MMASYNC = 1,
+    MMGENERATOR = 2,
+    MMGET = 4,
+    MMSET = 8,
+};
+
+/* Binding powers, from loosest to tightest.  Each binary operator has a left
+ * and a right power; prefix operators only have a right one.
+ */
+enum BindingPower {
+    BPNONE = 0,
+    BPCOMMA = 2,
+    BPASSIGN = 4,       // also anything taking an AssignmentExpression
+    BPCONDITIONAL = 7,
+    BPNULLISH = 8,
+    BPOR = 10,
+    BPAND = 12,
+    BPBITOR = 14,
+    BPBITXOR = 16,
+    BPBITAND = 18,
+    BPEQUALITY = 20,
+    BPRELATIONAL = 22,
+    BPSHIFT = 24,
+    BPADDITIVE = 26,
+    BPMULTIPLICATIVE = 28,
+    BPEXPONENT = 30,
+    BPPREFIX = 32,
+    BPNEW = 34,
+};
+
+struct Operator {
+    uint8_t binary;         // ExpressionType as a binary operator
+    uint8_t left, right;    // binding powers, left is BPNONE if not binary
+    uint8_t prefix;         // ExpressionType as a prefix operator
+    uint8_t prefix_power;   // BPNONE if not prefix
+};
+
+#define LEFT(et, bp) .binary = et, .left = bp, .right = bp + 1
+#define RIGHT(et, bp) .binary = et, .left = bp + 1, .right = bp
+#define PREFIX(et) .prefix = et, .prefix_power = BPPREFIX
+
+static const struct Operator operators[TTMAX] = {
+    [TTCOMMA] = { LEFT(ETCOMMA, BPCOMMA) },
+    [TTASSIGN] = { RIGHT(ETASSIGN, BPASSIGN) },
+    [TTPLUSASSIGN] = { RIGHT(ETADDITIONASSIGN, BPASSIGN) },
+    [TTMINUSASSIGN] = { RIGHT(ETSUBTRACTASSIGN, BPASSIGN) },
+    [TTMULTIPLYASSIGN] = { RIGHT(ETMULTIPLYASSIGN, BPASSIGN) },
+    [TTDIVIDEASSIGN] = { RIGHT(ETDIVISIONASSIGN, BPASSIGN) },
+    [TTMODULOASSIGN] = { RIGHT(ETREMAINDERASSIGN, BPASSIGN) },
+    [TTEXPONENTASSIGN] = { RIGHT(ETEXPONENTASSIGN, BPASSIGN) },
+    [TTBITSHLASSIGN] = { RIGHT(ETLEFTSHIFTASSIGN, BPASSIGN) },
+    [TTBITSHRASSIGN] = { RIGHT(ETRIGHTSHIFTASSIGN, BPASSIGN) },
+    [TTBITSHRZEROASSIGN] = { RIGHT(ETUNSIGNEDRIGHTSHIFTASSIGN, BPASSIGN) },
+    [TTBITANDASSIGN] = { RIGHT(ETBITANDASSIGN, BPASSIGN) },
+    [TTBITORASSIGN] = { RIGHT(ETBITORASSIGN, BPASSIGN) },
+    [TTBITXORASSIGN] = { RIGHT(ETBITXORASSIGN, BPASSIGN) },
+    [TTANDASSIGN] = { RIGHT(ETLOGICANDASSIGN, BPASSIGN) },
+    [TTORASSIGN] = { RIGHT(ETLOGICORASSIGN, BPASSIGN) },
+    [TTNULLISHASSIGN] = { RIGHT(ETNULLCOALESCEASSIGN, BPASSIGN) },
+    [TTNULLISH] = { LEFT(ETNULLCOALESCE, BPNULLISH) },
+    [TTOR] = { LEFT(ETLOGICOR, BPOR) },
+    [TTAND] = { LEFT(ETLOGICAND, BPAND) },
+    [TTBITOR] = { LEFT(ETBITOR, BPBITOR) },
+    [TTBITXOR] = { LEFT(ETBITXOR, BPBITXOR) },
+    [TTBITAND] = { LEFT(ETBITAND, BPBITAND) },
+    [TTEQ] = { LEFT(ETEQUAL, BPEQUALITY) },
+    [TTNOTEQ] = { LEFT(ETINEQUAL, BPEQUALITY) },
+    [TTIDENT] = { LEFT(ETSTRICTEQUAL, BPEQUALITY) },
+    [TTNOTIDENT] = { LEFT(ETSTRICTINEQUAL, BPEQUALITY) },
+    [TTLESS] = { LEFT(ETLESS, BPRELATIONAL) },
+    [TTGREATER] = { LEFT(ETGREATER, BPRELATIONAL) },
+    [TTLESSEQ] = { LEFT(ETLESSEQUAL, BPRELATIONAL) },
+    [TTGREATEREQ] = { LEFT(ETGREATEREQUAL, BPRELATIONAL) },
+    [TTIN] = { LEFT(ETIN, BPRELATIONAL) },
+    [TTINSTANCEOF] = { LEFT(ETINSTANCEOF, BPRELATIONAL) },
+    [TTBITSHL] = { LEFT(ETLEFTSHIFT, BPSHIFT) },
+    [TTBITSHR] = { LEFT(ETRIGHTSHIFT, BPSHIFT) },
+    [TTBITSHRZERO] = { LEFT(ETUNSIGNEDRIGHTSHIFT, BPSHIFT) },
+    [TTPLUS] = { LEFT(ETADDITION, BPADDITIVE), PREFIX(ETUNARYPLUS) },
+    [TTMINUS] = { LEFT(ETSUBTRACT, BPADDITIVE), PREFIX(ETUNARYNEGATE) },
+    [TTMULTIPLY] = { LEFT(ETMULTIPLY, BPMULTIPLICATIVE) },
+    [TTDIVIDE] = { LEFT(ETDIVISION, BPMULTIPLICATIVE) },
+    [TTMODULO] = { LEFT(ETREMAINDER, BPMULTIPLICATIVE) },
+    [TTEXPONENT] = { RIGHT(ETEXPONENT, BPEXPONENT) },
+    [TTBANG] = { PREFIX(ETLOGICNOT) },
+    [TTBITNOT] = { PREFIX(ETBITNOT) },
+    [TTTYPEOF] = { PREFIX(ETTYPEOF) },
+    [TTVOID] = { PREFIX(ETVOID) },
+    [TTDELETE] = { PREFIX(ETDELETE) },
+    [TTINCREMENT] = { PREFIX(ETINCREMENT) },
+    [TTDECREMENT] = { PREFIX(ETDECREMENT) },
+};
+
+#undef LEFT
+#undef RIGHT
+#undef PREFIX
+
+static size_t               parse_expression(struct Parser *parser, size_t at, bool allow_comma, uint32_t *out);
+static size_t          parse_numeric_literal(struct Parser *parser, size_t at, uint32_t *out);
+static size_t                 parse_function(struct Parser *parser, size_t at, bool expression, uint32_t *out);
+static size_t               parse_parameters(struct Parser *parser, size_t at, uint32_t *list);
+static size_t                     parse_type(struct Parser *parser, size_t at, uint32_t *out);
+static size_t               parse_annotation(struct Parser *parser, size_t at, uint32_t *out);
+
+static size_t    parse_variable_declaration(struct Parser *parser, size_t at, uint32_t *out);
+static size_t parse_statement_or_declaration(struct Parser *parser, size_t at, uint32_t *out);
+static size_t               parse_statements(struct Parser *parser, size_t at, uint32_t *start, uint32_t *count);
+
+static int parser_init(struct Parser *parser, const struct TokenBuffer *tokens, struct Ast *ast)
+{
+    *parser = (struct Parser) {
+        .tokens = tokens,
+        .ast = ast,
+        .frames = malloc(PARSE_INITIAL_STACK * sizeof *parser->frames),
+        .frame_capacity = PARSE_INITIAL_STACK,
+        .operands = malloc(PARSE_INITIAL_STACK * sizeof *parser->operands),
+        .operand_capacity = PARSE_INITIAL_STACK,
+        .error_token = PARSE_FAILED,
+    };
+
+    return parser->frames != NULL && parser->operands != NULL ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void parser_free(struct Parser *parser)
+{
+    free(parser->frames);
+    free(parser->operands);
+}
+
+int parse_tokens(const struct TokenBuffer *tokens, struct Ast *ast, size_t *error_token)
+{
+    struct Parser parser;
+    uint32_t start, count;
+    int result = EXIT_FAILURE;
+
+    *error_token = 0;
+
+    // the root has to be node 0
+    assert(ast->count == 0);
+    if (parser_init(&parser, tokens, ast) != EXIT_SUCCESS || ast_push(ast, SDPROGRAM, 0, 0, 0) != 0)
+        goto done;
+
+    size_t end = parse_statements(&parser, 0, &start, &count);
+
+    if (end == tokens->count) {
+        ast->nodes[0].lhs = start;
+        ast->nodes[0].rhs = count;
+        result = EXIT_SUCCESS;
+    } else {
+        // a stray "}" if nothing failed before it
+        *error_token = parser.error_token != PARSE_FAILED ? parser.error_token : end;
+    }
+
+done:
+    parser_free(&parser);
+
+    return result;
+}
+
+int parse_function_body(const struct TokenBuffer *tokens, struct Ast *ast, uint32_t function, size_t *error_token)
+{
+    struct Function f = ast_function(ast, function);
+    struct Parser parser;
+    uint32_t start, count, body;
+    int result = EXIT_FAILURE;
+
+    *error_token = 0;
+
+    if (f.body != NODE_NONE || f.body_end == 0)
+        return EXIT_SUCCESS; // already parsed, or dropped by reparse_edits
+
+    if (parser_init(&parser, tokens, ast) != EXIT_SUCCESS)
+        goto done;
+
+    size_t end = parse_statements(&parser, f.body_start + 1, &start, &count);
+
+    if (end != f.body_end) {
+        *error_token = parser.error_token != PARSE_FAILED ? parser.error_token : end;
+        goto done;
+    }
+
+    if ((body = ast_push(ast, SDBLOCK, f.body_start, start, count)) == NODE_NONE)
+        goto done;
+
+    // not f, the array may have moved for functions nested in this one
+    ast->functions[function].body = body;
+    result = EXIT_SUCCESS;
+
+done:
+    parser_free(&parser);
+
+    return result;
+}
+
+int parse_function_bodies(const struct TokenBuffer *tokens, struct Ast *ast, size_t *error_token)
+{
+    // parsing a body adds its nested functions to the end, to be reached later
+    for (uint32_t i = 0; i < ast->function_count; i++) {
+        if (parse_function_body(tokens, ast, i, error_token) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static int push_frame(struct Parser *parser, struct Frame frame)
+{
+    if (parser->frame_count == parser->frame_capacity) {
+        struct Frame *frames = realloc(parser->frames, parser->frame_capacity * 2 * sizeof *frames);
+        if (frames == NULL)
+            return EXIT_FAILURE;
+        parser->frames = frames;
+        parser->frame_capacity *= 2;
+    }
+
+    parser->frames[parser->frame_count++] = frame;
+
+    return EXIT_SUCCESS;
+}
+
+static int push_operand(struct Parser *parser, uint32_t node)
+{
+    if (parser->operand_count == parser->operand_capacity) {
+        uint32_t *operands = realloc(parser->operands, parser->operand_capacity * 2 * sizeof *operands);
+        if (operands == NULL)
+            return EXIT_FAILURE;
+        parser->operands = operands;
+        parser->operand_capacity *= 2;
+    }
+
+    parser->operands[parser->operand_count++] = node;
+
+    return EXIT_SUCCESS;
+}
+
+static int push_node(struct Parser *parser, uint8_t kind, uint32_t token, uint32_t lhs, uint32_t rhs)
+{
+    uint32_t node = ast_push(parser->ast, kind, token, lhs, rhs);
+
+    return node != NODE_NONE ? push_operand(parser, node) : EXIT_FAILURE;
+}
+
+static int push_counted_list(struct Ast *ast, const uint32_t *items, uint32_t count, uint32_t *start)
+{
+    uint32_t ignored;
+
+    if (ast_push_list(ast, &count, 1, start) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    return ast_push_list(ast, items, count, &ignored);
+}
+
+static bool is_bracket(uint8_t type)
+{
+    return type >= FTGROUP;
+}
+
+static bool is_name(enum TokenType ttype)
+{
+    return ttype == TTIDENTIFIER || token_type_is_keyword(ttype);
+}
+
+/**Whether a member access is part of an optional chain, "a?.b.c", which
+ * can be read but not assigned to.  Parentheses end the chain.
+ */
+static bool in_optional_chain(const struct Ast *ast, uint32_t node)
+{
+    while (true) {
+        switch (ast->nodes[node].kind) {
+        case ETOPTIONALCHAIN:
+            return true;
+        case ETPROPERTYACCESS:
+        case ETINDEX:
+        case ETCALL:
+            node = ast->nodes[node].lhs;
+            break;
+        default:
+            return false;
+        }
+    }
+}
+
+static bool is_assignable(const struct Ast *ast, uint32_t node)
+{
+    while (ast->nodes[node].kind == ETGROUP)
+        node = ast->nodes[node].lhs;
+
+    switch (ast->nodes[node].kind) {
+    case ETIDENTIFIER:
+        return true;
+    case ETPROPERTYACCESS:
+    case ETINDEX:
+        return !in_optional_chain(ast, node);
+    default:
+        return false;
+    }
+}
+
+/**Whether a "..." at "at" starts an argument, an array element, or an item
+ * of parentheses that may turn out to be an arrow function's parameters.
+ * Anywhere else it isn't an expression at all.  Object literals and
+ * parameter lists read their own.
+ */
+static bool can_spread(const struct Parser *parser, size_t base, size_t at)
+{
+    const struct Frame *top = parser->frame_count > base ? &parser->frames[parser->frame_count - 1] : NULL;
+    enum TokenType previous = at > 0 ? token_type(parser->tokens, at - 1) : TTNONE;
+
+    if (top == NULL || (previous != TTOPENPAREN && previous != TTOPENBRACKET && previous != TTCOMMA))
+        return false;
+
+    // "(a, ...b)" has the comma operator waiting on top of the parentheses
+    if (top->type == FTBINARY && top->kind == ETCOMMA && parser->frame_count - 1 > base)
+        return parser->frames[parser->frame_count - 2].type == FTGROUP;
+
+    return top->type == FTCALL || top->type == FTNEWCALL || top->type == FTARRAY || top->type == FTGROUP;
+}
+
+static bool is_parameter_form(uint8_t kind)
+{
+    return kind == ETSPREAD || kind == TEANNOTATION || kind == TEOPTIONAL;
+}
+
+/**Whether parenthesised items hold a spread, an annotation or an optional
+ * mark, which only parameters can.
+ */
+static bool holds_parameter_forms(const struct Ast *ast, uint32_t node)
 {
-    return -1; // TODO
+    for (; ast->nodes[node].kind == ETCOMMA; node = ast->nodes[node].lhs)
+        if (is_parameter_form(ast->nodes[ast->nodes[node].rhs].kind))
+            return true;
+
+    return is_parameter_form(ast->nodes[node].kind);
 }
 
-/* Each of these returns the end of the parsed sequence.
+/**Whether the operand on top is an item of parentheses, first or after a
+ * comma, which may yet turn out to be an arrow function's parameters.
  */
+static bool in_group(const struct Parser *parser, size_t base)
+{
+    size_t top = parser->frame_count;
 
-static const struct Token *               parse_expression(const struct Token *tokens, size_t num_tokens, struct Expression *out);
-static const struct Token *          parse_numeric_literal(const struct Token *tokens, size_t num_tokens, struct Expression *out);
+    if (top > base + 1 && parser->frames[top - 1].type == FTBINARY && parser->frames[top - 1].kind == ETCOMMA)
+        --top;
 
-static const struct Token *            parse_let_statement(const struct Token *tokens, size_t num_tokens, struct StatementOrDeclaration *out);
-static const struct Token * parse_statement_or_declaration(const struct Token *tokens, size_t num_tokens, struct StatementOrDeclaration *out);
+    return top > base && parser->frames[top - 1].type == FTGROUP;
+}
 
-const struct Token *parse_expression(const struct Token *tokens, size_t num_tokens, struct Expression *out)
+/**Whether a token can start an operand, for the operators whose operand is
+ * optional or which are only operators when followed by one.
+ */
+static bool starts_operand(const struct TokenBuffer *tokens, size_t at)
 {
-    const struct Token *end = NULL;
+    if (at >= tokens->count)
+        return false;
 
-    switch (tokens[0].type) {
+    enum TokenType ttype = token_type(tokens, at);
+
+    switch (ttype) {
+    case TTIDENTIFIER:
     case TTNUMLITERAL:
-        end = parse_numeric_literal(tokens, num_tokens, out);
-        break;
+    case TTSINGLESTRING:
+    case TTDOUBLESTRING:
+    case TTOPENPAREN:
+    case TTOPENBRACKET:
+    case TTOPENBRACE:
+    case TTTHIS:
+    case TTSUPER:
+    case TTNULL:
+    case TTTRUE:
+    case TTFALSE:
+    case TTNEW:
+    case TTIMPORT:
+    case TTYIELD:
+    case TTSPREAD:
+        return true;
     default:
-        assert(0 && "unhandled");
+        return operators[ttype].prefix_power != BPNONE;
     }
+}
 
-    return end;
+/**Whether the token is an identifier spelling a contextual keyword, such as
+ * "async" or "await", which are names everywhere they aren't keywords.
+ */
+static bool is_contextual(const struct TokenBuffer *tokens, size_t at, const char *keyword)
+{
+    if (at >= tokens->count || token_type(tokens, at) != TTIDENTIFIER)
+        return false;
+
+    struct StringView view = token_view(tokens, at);
+    size_t length = strlen(keyword);
+
+    return view.length == length && memcmp(view.data, keyword, length) == 0;
 }
 
-const struct Token *parse_numeric_literal(const struct Token *tokens, size_t num_tokens, struct Expression *out)
+/**Finds the "}" matching the "{" at "at".  Nothing that can hold an
+ * unmatched brace (template literals, regexps) is lexed, so counting them is
+ * enough.
+ */
+static size_t match_brace(const struct TokenBuffer *tokens, size_t at)
 {
-    assert(tokens[0].type == TTNUMLITERAL);
-    assert(num_tokens == 1);
-    assert(out != NULL);
+    size_t depth = 0;
 
-    if (num_tokens == 0) {
-        return NULL;
+    assert(token_type(tokens, at) == TTOPENBRACE);
+
+    for (; at < tokens->count; at++) {
+        switch (token_type(tokens, at)) {
+        case TTOPENBRACE:
+            ++depth;
+            break;
+        case TTCLOSEBRACE:
+            if (--depth == 0)
+                return at;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return PARSE_FAILED;
+}
+
+/**Records a function whose body starts at the "{" at "at", skipping over
+ * the body.  Returns the index after it.
+ */
+static size_t skip_body(struct Parser *parser, size_t at, uint32_t name, uint32_t parameters, uint32_t result,
+                        uint32_t *function)
+{
+    size_t end = match_brace(parser->tokens, at);
+
+    if (end == PARSE_FAILED)
+        return PARSE_FAILED;
+
+    struct Function f = { .name = name, .parameters = parameters, .result = result, .body_start = at, .body_end = end };
+
+    return ast_push_function(parser->ast, f, function) == EXIT_SUCCESS ? end + 1 : PARSE_FAILED;
+}
+
+/**Whether a node can be a parameter, of the forms also allowed in an arrow
+ * function's parenthesised cover grammar, where one may also be annotated
+ * or marked optional.
+ */
+static bool is_parameter(const struct Ast *ast, uint32_t node, bool last)
+{
+    struct Node p = ast->nodes[node];
+
+    return p.kind == ETIDENTIFIER || p.kind == ETARRAYINIT || p.kind == ETOBJECTINIT
+        || p.kind == ETDESTRUCTUREASSIGN
+        || (p.kind == ETASSIGN && ast->nodes[p.lhs].kind == ETIDENTIFIER)
+        || (p.kind == ETSPREAD && last) // only the last may be a rest parameter
+        || ((p.kind == TEANNOTATION || p.kind == TEOPTIONAL) && is_parameter(ast, p.lhs, last));
+}
+
+/**Builds the node for the operator frame on top of the stack from the
+ * operands it takes.
+ */
+static int reduce(struct Parser *parser)
+{
+    struct Frame frame = parser->frames[--parser->frame_count];
+    struct Ast *ast = parser->ast;
+    uint32_t *operands = parser->operands;
+    uint32_t rhs = operands[--parser->operand_count];
+    uint32_t lhs, pair[2], list;
+
+    switch (frame.type) {
+    case FTBINARY:
+        lhs = operands[--parser->operand_count];
+
+        if (frame.kind == ETASSIGN && ast->nodes[lhs].kind == TEANNOTATION) {
+            // "(x: T = value) =>", with the default under the annotation as
+            // parse_parameters puts it
+            struct Node annotation = ast->nodes[lhs];
+            uint32_t assign;
+
+            if (ast->nodes[annotation.lhs].kind != ETIDENTIFIER
+                    || (assign = ast_push(ast, ETASSIGN, frame.token, annotation.lhs, rhs)) == NODE_NONE)
+                return EXIT_FAILURE;
+            return push_node(parser, TEANNOTATION, annotation.token, assign, annotation.rhs);
+        }
+
+        if (frame.kind == ETASSIGN && (ast->nodes[lhs].kind == ETARRAYINIT || ast->nodes[lhs].kind == ETOBJECTINIT))
+            frame.kind = ETDESTRUCTUREASSIGN;
+        else if (operators[token_type(parser->tokens, frame.token)].left == BPASSIGN + 1 && !is_assignable(ast, lhs))
+            return EXIT_FAILURE;
+
+        // ?? can't be mixed with && or || without parentheses
+        if (frame.kind == ETNULLCOALESCE || frame.kind == ETLOGICAND || frame.kind == ETLOGICOR) {
+            bool nullish = frame.kind == ETNULLCOALESCE;
+            for (int i = 0; i < 2; i++) {
+                uint8_t kind = ast->nodes[i == 0 ? lhs : rhs].kind;
+                if (nullish ? kind == ETLOGICAND || kind == ETLOGICOR : kind == ETNULLCOALESCE)
+                    return EXIT_FAILURE;
+            }
+        }
+
+        return push_node(parser, frame.kind, frame.token, lhs, rhs);
+    case FTPREFIX:
+        if ((frame.kind == ETINCREMENT || frame.kind == ETDECREMENT) && !is_assignable(ast, rhs))
+            return EXIT_FAILURE;
+
+        return push_node(parser, frame.kind, frame.token, rhs, frame.kind == ETINCREMENT || frame.kind == ETDECREMENT);
+    case FTNEW:
+        if (push_counted_list(ast, NULL, 0, &list) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+        return push_node(parser, ETNEW, frame.token, rhs, list);
+    case FTTERNARY:
+        pair[1] = rhs;
+        pair[0] = operands[--parser->operand_count];
+        lhs = operands[--parser->operand_count];
+        if (ast_push_list(ast, pair, 2, &list) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+        return push_node(parser, ETTERNARY, frame.token, lhs, list);
+    case FTPROPERTY:
+        lhs = operands[--parser->operand_count];
+        return push_node(parser, ETPROPERTYINIT, frame.token, lhs, rhs);
+    case FTARROW: {
+        struct Function f = { .name = SYMBOL_NONE, .parameters = frame.base, .body = rhs };
+        uint32_t function;
+        if (ast_push_function(ast, f, &function) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+        return push_node(parser, ETARROWFUNCTION, frame.token, function, 0);
+    }
+    default:
+        assert(0 && "brackets are only reduced by their closing token");
+        return EXIT_FAILURE;
+    }
+}
+
+/**Reduces operators down to the nearest bracket, or to base, while they bind
+ * more tightly than power.
+ */
+static int reduce_while(struct Parser *parser, size_t base, uint8_t power)
+{
+    while (parser->frame_count > base) {
+        struct Frame *top = &parser->frames[parser->frame_count - 1];
+
+        if (is_bracket(top->type) || top->power <= power)
+            break;
+
+        if (reduce(parser) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
     }
 
-    assert(tokens[0].view.length != 0 && "empty numeric literal");
-    assert(tokens[0].view.data[0] != '-' && "negative integers not handled");
+    return EXIT_SUCCESS;
+}
+
+/**The open bracket frame nearest the top, or NULL if there is none above
+ * base.  Call after reducing all the operators above it.
+ */
+static struct Frame *open_bracket(struct Parser *parser, size_t base)
+{
+    if (parser->frame_count > base && is_bracket(parser->frames[parser->frame_count - 1].type))
+        return &parser->frames[parser->frame_count - 1];
+
+    return NULL;
+}
+
+/**Turns the operand of a parenthesised group, just closed before "=>", into
+ * an arrow function's parameter list: the operands of a chain of commas.
+ */
+static int arrow_parameters(struct Parser *parser, uint32_t inner, uint32_t *list)
+{
+    struct Ast *ast = parser->ast;
+    size_t base = parser->operand_count, count = 0;
 
-    int power = 1, value = 0;
-    for (int i = tokens[0].view.length; i >= 0; i--) {
-        if (!isdigit(tokens[0].view.data[i])) {
-            // TODO error
-            return NULL;
+    // the chain leans left, so this collects the parameters last first
+    for (uint32_t node = inner; node != NODE_NONE; ++count) {
+        uint32_t parameter = node;
+
+        if (ast->nodes[node].kind == ETCOMMA) {
+            parameter = ast->nodes[node].rhs;
+            node = ast->nodes[node].lhs;
         } else {
-            value += power * (tokens[0].view.data[i] - '0');
-            power *= 10;
+            node = NODE_NONE;
         }
+
+        if (!is_parameter(ast, parameter, count == 0) || push_operand(parser, parameter) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
     }
 
-    out->etype = ETNUMERICLITERAL;
-    out->et_numeric_literal.value = value;
+    for (size_t i = 0; i < count / 2; i++) {
+        uint32_t swap = parser->operands[base + i];
+        parser->operands[base + i] = parser->operands[base + count - 1 - i];
+        parser->operands[base + count - 1 - i] = swap;
+    }
+
+    parser->operand_count = base;
 
-    return &tokens[1];
+    return push_counted_list(ast, &parser->operands[base], count, list);
 }
 
-const struct Token *
-parse_let_statement(const struct Token *tokens, size_t num_tokens, struct StatementOrDeclaration *out)
+/**Starts an arrow function at the "=>" at "at".  A block body is skipped
+ * over and the function is done, otherwise its body is the operand to come,
+ * as *operand says.  With a result type, which the frame has no room for,
+ * an expression body is read here instead.
+ */
+static size_t parse_arrow(struct Parser *parser, size_t at, uint32_t parameters, uint32_t result, bool *operand)
 {
-    /*
-    only allows format: let <identifier> = <expression>;
-    does not allow:
-        let x;
-        let x: string;
-        let a, b = 2;
-        let a = 1, b = a;
-        let a: string = 'hello world';
-    */
-    assert(tokens[0].type == TTLET);
+    const struct TokenBuffer *tokens = parser->tokens;
+    uint32_t function, body;
+    size_t end;
 
-    if (num_tokens < 3) {
-        // malformed let statement
-        return NULL;
+    *operand = false;
+
+    if (at + 1 < tokens->count && token_type(tokens, at + 1) == TTOPENBRACE) {
+        end = skip_body(parser, at + 1, SYMBOL_NONE, parameters, result, &function);
+
+        if (end == PARSE_FAILED || push_node(parser, ETARROWFUNCTION, at, function, 0) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+        return end;
     }
 
-    if (tokens[1].type != TTIDENTIFIER) return NULL;
-    if (tokens[2].type != TTASSIGN) return NULL;
+    if (result != NODE_NONE) {
+        struct Function f = { .name = SYMBOL_NONE, .parameters = parameters, .result = result };
+
+        if ((end = parse_expression(parser, at + 1, false, &body)) == PARSE_FAILED)
+            return PARSE_FAILED;
 
-    const size_t num_parsed_tokens = 3;
-    out->sdtype = SDLET;
-    parse_expression(&tokens[num_parsed_tokens], num_tokens - num_parsed_tokens, &out->sd_let.initialiser);
+        f.body = body;
+        if (ast_push_function(parser->ast, f, &function) != EXIT_SUCCESS
+                || push_node(parser, ETARROWFUNCTION, at, function, 0) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+        return end;
+    }
 
-    return NULL; // TODO implement this
+    *operand = true;
+    return push_frame(parser, (struct Frame) { .type = FTARROW, .power = BPASSIGN, .token = at, .base = parameters })
+        == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
 }
 
-const struct Token *
-parse_statement_or_declaration(const struct Token *tokens, size_t num_tokens, struct StatementOrDeclaration *out)
+/**Reads the rest of an object literal's method or accessor from the "(" of
+ * its parameters at "at", and turns the key on top of the operands into the
+ * member starting at the token "member".
+ */
+static size_t parse_method(struct Parser *parser, size_t member, size_t at, unsigned modifiers)
 {
-    if (num_tokens == 0) {
-        return NULL;
+    const struct TokenBuffer *tokens = parser->tokens;
+    struct Ast *ast = parser->ast;
+    uint32_t parameters, result = NODE_NONE, function, node;
+    size_t open = at;
+
+    if ((at = parse_parameters(parser, at, &parameters)) == PARSE_FAILED || at >= tokens->count)
+        return PARSE_FAILED;
+
+    if (token_type(tokens, at) == TTCOLON
+            && ((at = parse_annotation(parser, at + 1, &result)) == PARSE_FAILED || at >= tokens->count))
+        return PARSE_FAILED;
+
+    if (token_type(tokens, at) != TTOPENBRACE
+            || (at = skip_body(parser, at, SYMBOL_NONE, parameters, result, &function)) == PARSE_FAILED)
+        return PARSE_FAILED;
+
+    // a getter takes nothing, and a setter just the value, which can't be a
+    // rest parameter, typed or not
+    uint32_t count = ast->extra[parameters];
+    if (((modifiers & MMGET) && count != 0) || ((modifiers & MMSET) && count != 1))
+        return PARSE_FAILED;
+
+    if (modifiers & MMSET) {
+        uint32_t value = ast->extra[parameters + 1];
+
+        if (ast->nodes[value].kind == TEANNOTATION)
+            value = ast->nodes[value].lhs;
+        if (ast->nodes[value].kind == ETSPREAD)
+            return PARSE_FAILED;
     }
 
-    switch (tokens[0].type) {
-    case TTLET:
-        parse_let_statement(tokens, num_tokens, out);
+    static const uint8_t kinds[2][2] = {
+        // [async][generator]
+        { ETFUNCTION, ETGENFUNCTION }, { ETASYNCFUNCTION, ETASYNCGENFUNCTION },
+    };
+    uint8_t kind = modifiers & MMGET ? ETGETTER : modifiers & MMSET ? ETSETTER : ETPROPERTYINIT;
+    uint32_t key = parser->operands[--parser->operand_count];
+
+    // the function is named by its "(", as it has no keyword of its own
+    if ((node = ast_push(ast, kinds[(modifiers & MMASYNC) != 0][(modifiers & MMGENERATOR) != 0], open, function, 0)) == NODE_NONE
+            || push_node(parser, kind, member, key, node) != EXIT_SUCCESS)
+        return PARSE_FAILED;
+
+    return at;
+}
+
+/**Closes the bracket on top of the stack with the token at "at".  Returns
+ * the index after anything else consumed, or PARSE_FAILED, and sets *operand
+ * if what it consumed wants an operand next (an arrow function's body or a
+ * computed key's value).
+ */
+static size_t close_bracket(struct Parser *parser, size_t at, bool *operand)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    struct Ast *ast = parser->ast;
+    struct Frame frame = parser->frames[--parser->frame_count];
+    enum TokenType closer = token_type(tokens, at);
+    uint32_t *items = &parser->operands[frame.base];
+    uint32_t count = parser->operand_count - frame.base, list;
+    size_t end = at + 1;
+
+    *operand = false;
+
+    switch (frame.type) {
+    case FTGROUP: {
+        uint32_t result = NODE_NONE;
+
+        if (closer != TTCLOSEPAREN)
+            return PARSE_FAILED;
+
+        if (end < tokens->count && token_type(tokens, end) == TTCOLON) {
+            // "(x): T => body", or else the ":" of a conditional, "c ? (x) : y",
+            // which the type read so far is taken back for
+            size_t counts[] = { ast->count, ast->extra_count, ast->number_count, ast->function_count };
+            size_t operand_count = parser->operand_count, frame_count = parser->frame_count;
+            size_t after = parse_annotation(parser, end + 1, &result);
+
+            if (after != PARSE_FAILED && after < tokens->count && token_type(tokens, after) == TTARROW) {
+                end = after;
+            } else {
+                ast->count = counts[0];
+                ast->extra_count = counts[1];
+                ast->number_count = counts[2];
+                ast->function_count = counts[3];
+                parser->operand_count = operand_count;
+                parser->frame_count = frame_count;
+                result = NODE_NONE;
+            }
+            items = &parser->operands[frame.base];
+        }
+
+        if (end < tokens->count && token_type(tokens, end) == TTARROW) {
+            parser->operand_count = frame.base;
+            if (count == 0 ? push_counted_list(ast, NULL, 0, &list) : arrow_parameters(parser, items[0], &list))
+                return PARSE_FAILED;
+
+            return parse_arrow(parser, end, list, result, operand);
+        }
+
+        // "(...a)", "(a, ...b)", "(a: T)" and "(a?)" are only allowed as
+        // parameters
+        if (count != 1 || holds_parameter_forms(ast, items[0]))
+            return PARSE_FAILED;
+
+        parser->operand_count = frame.base;
+        return push_node(parser, ETGROUP, frame.token, items[0], 0) == EXIT_SUCCESS ? end : PARSE_FAILED;
+    }
+    case FTCALL:
+    case FTNEWCALL:
+        if (closer != TTCLOSEPAREN || push_counted_list(ast, items, count, &list) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+
+        parser->operand_count = frame.base - 1;
+        uint32_t callee = parser->operands[parser->operand_count];
+        uint8_t kind = frame.type == FTCALL ? ETCALL : ETNEW;
+        return push_node(parser, kind, frame.token, callee, list) == EXIT_SUCCESS ? end : PARSE_FAILED;
+    case FTINDEX:
+        if (closer != TTCLOSEBRACKET || count != 1)
+            return PARSE_FAILED;
+
+        parser->operand_count = frame.base - 1;
+        uint32_t object = parser->operands[parser->operand_count];
+        return push_node(parser, ETINDEX, frame.token, object, items[0]) == EXIT_SUCCESS ? end : PARSE_FAILED;
+    case FTARRAY:
+    case FTOBJECT:
+        if (closer != (frame.type == FTARRAY ? TTCLOSEBRACKET : TTCLOSEBRACE))
+            return PARSE_FAILED;
+
+        if (ast_push_list(ast, items, count, &list) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+
+        parser->operand_count = frame.base;
+        kind = frame.type == FTARRAY ? ETARRAYINIT : ETOBJECTINIT;
+        return push_node(parser, kind, frame.token, list, count) == EXIT_SUCCESS ? end : PARSE_FAILED;
+    case FTCOMPUTEDKEY:
+        if (closer != TTCLOSEBRACKET || count != 1 || end >= tokens->count)
+            return PARSE_FAILED;
+
+        // "[key](" a method, the key staying on top of the operands
+        if (token_type(tokens, end) == TTOPENPAREN)
+            return parse_method(parser, frame.token, end, frame.kind);
+
+        // "[key]:" then the value
+        if (token_type(tokens, end) != TTCOLON || frame.kind != 0)
+            return PARSE_FAILED;
+
+        struct Frame property = { .type = FTPROPERTY, .power = BPASSIGN, .token = frame.token };
+        *operand = true;
+        return push_frame(parser, property) == EXIT_SUCCESS ? end + 1 : PARSE_FAILED;
+    default:
+        return PARSE_FAILED; // FTCONDITION, closed by ':'
+    }
+}
+
+/**Whether the token can start an object literal member's key, or the "*"
+ * of a generator method, so that a modifier before it isn't the key itself.
+ */
+static bool starts_key(const struct TokenBuffer *tokens, size_t at)
+{
+    if (at >= tokens->count)
+        return false;
+
+    switch (token_type(tokens, at)) {
+    case TTNUMLITERAL:
+    case TTSINGLESTRING:
+    case TTDOUBLESTRING:
+    case TTOPENBRACKET:
+    case TTMULTIPLY:
+        return true;
+    default:
+        return is_name(token_type(tokens, at));
+    }
+}
+
+/**Reads one member of an object literal up to its value, or the whole of a
+ * method or accessor, or the literal's closing brace.  Returns where to
+ * carry on, and sets *operand if an operand is expected next (a value or a
+ * spread argument), otherwise an operator.
+ */
+static size_t parse_property_key(struct Parser *parser, size_t at, bool *operand)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    enum TokenType ttype = token_type(tokens, at);
+    unsigned modifiers = 0;
+    uint32_t key;
+
+    *operand = true;
+
+    switch (ttype) {
+    case TTCLOSEBRACE:
+        return close_bracket(parser, at, operand);
+    case TTSPREAD:
+        return push_frame(parser, (struct Frame) { .type = FTPREFIX, .kind = ETSPREAD, .power = BPASSIGN, .token = at })
+            == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    default:
+        break;
+    }
+
+    // "async", "get" and "set" are keys themselves unless another key follows
+    if (is_contextual(tokens, at, "async") && starts_key(tokens, at + 1))
+        modifiers |= MMASYNC;
+    else if (is_contextual(tokens, at, "get") && starts_key(tokens, at + 1))
+        modifiers |= MMGET;
+    else if (is_contextual(tokens, at, "set") && starts_key(tokens, at + 1))
+        modifiers |= MMSET;
+
+    if (modifiers != 0)
+        ++at;
+
+    if (!(modifiers & (MMGET | MMSET)) && at < tokens->count && token_type(tokens, at) == TTMULTIPLY) {
+        modifiers |= MMGENERATOR;
+        ++at;
+    }
+
+    if (at >= tokens->count)
+        return PARSE_FAILED;
+
+    // the member is named by its key, whatever comes before it
+    switch (ttype = token_type(tokens, at)) {
+    case TTOPENBRACKET:
+        return push_frame(parser, (struct Frame) {
+            .type = FTCOMPUTEDKEY,
+            .kind = modifiers,
+            .token = at,
+            .base = parser->operand_count,
+        }) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTNUMLITERAL:
+        if (parse_numeric_literal(parser, at, &key) == PARSE_FAILED)
+            return PARSE_FAILED;
+        break;
+    case TTSINGLESTRING:
+    case TTDOUBLESTRING:
+        key = ast_push(parser->ast, ETSTRINGLITERAL, at, 0, 0);
+        break;
+    default:
+        if (!is_name(ttype))
+            return PARSE_FAILED;
+        key = ast_push(parser->ast, ETIDENTIFIER, at, tokens->symbols[at], 0);
         break;
+    }
+
+    if (key == NODE_NONE || push_operand(parser, key) != EXIT_SUCCESS || at + 1 >= tokens->count)
+        return PARSE_FAILED;
+
+    switch (token_type(tokens, at + 1)) {
+    case TTOPENPAREN:
+        *operand = false;
+        return parse_method(parser, at, at + 1, modifiers);
+    case TTCOLON:
+        if (modifiers != 0)
+            return PARSE_FAILED;
+
+        return push_frame(parser, (struct Frame) { .type = FTPROPERTY, .power = BPASSIGN, .token = at })
+            == EXIT_SUCCESS ? at + 2 : PARSE_FAILED;
+    case TTCOMMA:
+    case TTCLOSEBRACE:
+        // shorthand, "{ a }" is "{ a: a }"
+        if (ttype != TTIDENTIFIER || modifiers != 0)
+            return PARSE_FAILED;
+
+        *operand = false;
+        --parser->operand_count;
+        return push_node(parser, ETPROPERTYINIT, at, key, key) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
     default:
-        assert(0 && "parse_statement_or_declaration unhandled token type");
+        return PARSE_FAILED;
     }
+}
+
+/**Reads an operand, or a prefix operator or opening bracket before one.
+ * Returns where to carry on, and sets *operand if another operand is
+ * expected next.
+ */
+static size_t parse_operand(struct Parser *parser, size_t base, size_t at, bool *operand)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    enum TokenType ttype = token_type(tokens, at);
+    enum TokenType next = at + 1 < tokens->count ? token_type(tokens, at + 1) : TTNONE;
+    struct Frame *bracket = open_bracket(parser, base);
+    uint32_t node, list;
+
+    *operand = false;
+
+    switch (ttype) {
+    case TTNUMLITERAL:
+        if (parse_numeric_literal(parser, at, &node) == PARSE_FAILED || push_operand(parser, node) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+        return at + 1;
+    case TTSINGLESTRING:
+    case TTDOUBLESTRING:
+        return push_node(parser, ETSTRINGLITERAL, at, 0, 0) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTTRUE:
+    case TTFALSE:
+        return push_node(parser, ETBOOLEANLITERAL, at, ttype == TTTRUE, 0) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTNULL:
+        return push_node(parser, ETNULL, at, 0, 0) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTTHIS:
+        return push_node(parser, ETTHIS, at, 0, 0) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTSUPER:
+        return push_node(parser, ETSUPER, at, 0, 0) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTIDENTIFIER:
+        if (next == TTARROW) {
+            // "x => body", with the one parameter
+            if ((node = ast_push(parser->ast, ETIDENTIFIER, at, tokens->symbols[at], 0)) == NODE_NONE
+                    || push_counted_list(parser->ast, &node, 1, &list) != EXIT_SUCCESS)
+                return PARSE_FAILED;
+
+            return parse_arrow(parser, at + 1, list, NODE_NONE, operand);
+        }
+
+        if (is_contextual(tokens, at, "async") && next == TTFUNCTION) {
+            if ((at = parse_function(parser, at, true, &node)) == PARSE_FAILED || push_operand(parser, node) != EXIT_SUCCESS)
+                return PARSE_FAILED;
+            return at;
+        }
+
+        if (is_contextual(tokens, at, "await") && starts_operand(tokens, at + 1)) {
+            // there is no async context yet, so "await" followed by an operand
+            // is always taken as the operator
+            *operand = true;
+            return push_frame(parser, (struct Frame) { .type = FTPREFIX, .kind = ETAWAIT, .power = BPPREFIX, .token = at })
+                == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+        }
+
+        return push_node(parser, ETIDENTIFIER, at, tokens->symbols[at], 0) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTYIELD:
+        if (next == TTMULTIPLY) {
+            *operand = true;
+            return push_frame(parser, (struct Frame) { .type = FTPREFIX, .kind = ETGENYIELD, .power = BPASSIGN, .token = at })
+                == EXIT_SUCCESS ? at + 2 : PARSE_FAILED;
+        }
+
+        if (!starts_operand(tokens, at + 1))
+            return push_node(parser, ETYIELD, at, NODE_NONE, 0) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+
+        *operand = true;
+        return push_frame(parser, (struct Frame) { .type = FTPREFIX, .kind = ETYIELD, .power = BPASSIGN, .token = at })
+            == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTSPREAD:
+        if (!can_spread(parser, base, at))
+            return PARSE_FAILED;
+
+        *operand = true;
+        return push_frame(parser, (struct Frame) { .type = FTPREFIX, .kind = ETSPREAD, .power = BPASSIGN, .token = at })
+            == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTFUNCTION:
+        if ((at = parse_function(parser, at, true, &node)) == PARSE_FAILED || push_operand(parser, node) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+        return at;
+    case TTNEW:
+        if (next == TTDOT) {
+            // new.target
+            struct StringView name = at + 2 < tokens->count ? token_view(tokens, at + 2) : (struct StringView) {0};
+            if (name.length != 6 || memcmp(name.data, "target", 6) != 0)
+                return PARSE_FAILED;
+            return push_node(parser, ETNEWTARGET, at, 0, 0) == EXIT_SUCCESS ? at + 3 : PARSE_FAILED;
+        }
+
+        *operand = true;
+        return push_frame(parser, (struct Frame) { .type = FTNEW, .power = BPNEW, .token = at })
+            == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTIMPORT:
+        if (next == TTDOT) {
+            // import.meta
+            struct StringView name = at + 2 < tokens->count ? token_view(tokens, at + 2) : (struct StringView) {0};
+            if (name.length != 4 || memcmp(name.data, "meta", 4) != 0)
+                return PARSE_FAILED;
+            return push_node(parser, ETIMPORTMETA, at, 0, 0) == EXIT_SUCCESS ? at + 3 : PARSE_FAILED;
+        }
+
+        // import(...) is a call with ETIMPORT as the callee
+        if (next != TTOPENPAREN)
+            return PARSE_FAILED;
+        return push_node(parser, ETIMPORT, at, 0, 0) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTOPENPAREN:
+        *operand = true;
+        return push_frame(parser, (struct Frame) { .type = FTGROUP, .token = at, .base = parser->operand_count })
+            == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTOPENBRACKET:
+        *operand = true;
+        return push_frame(parser, (struct Frame) { .type = FTARRAY, .token = at, .base = parser->operand_count })
+            == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTOPENBRACE:
+        if (push_frame(parser, (struct Frame) { .type = FTOBJECT, .token = at, .base = parser->operand_count }) != EXIT_SUCCESS
+                || at + 1 >= tokens->count)
+            return PARSE_FAILED;
+        return parse_property_key(parser, at + 1, operand);
+    case TTCOMMA:
+        // a hole in an array literal
+        if (bracket == NULL || bracket->type != FTARRAY || push_operand(parser, NODE_NONE) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+        *operand = true;
+        return at + 1;
+    case TTCLOSEPAREN:
+    case TTCLOSEBRACKET:
+        // empty brackets, or a trailing comma: "f()", "[]", "[a,]", "() =>",
+        // "(): T =>"
+        if (bracket == NULL
+                || !(bracket->type == FTCALL || bracket->type == FTNEWCALL || bracket->type == FTARRAY
+                     || (bracket->type == FTGROUP && parser->operand_count == bracket->base
+                         && (next == TTARROW || next == TTCOLON))))
+            return PARSE_FAILED;
+        return close_bracket(parser, at, operand);
+    default:
+        if (operators[ttype].prefix_power == BPNONE) {
+            // a class expression or a regular expression (which lexes as a
+            // "/") is blamed on itself rather than its statement, see
+            // parse_unsupported
+            if ((ttype == TTCLASS || ttype == TTDIVIDE || ttype == TTDIVIDEASSIGN) && parser->error_token == PARSE_FAILED)
+                parser->error_token = at;
+            return PARSE_FAILED;
+        }
+
+        *operand = true;
+        return push_frame(parser, (struct Frame) {
+            .type = FTPREFIX,
+            .kind = operators[ttype].prefix,
+            .power = operators[ttype].prefix_power,
+            .token = at,
+        }) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    }
+}
+
+/**Marks the item on top of the operands, in parentheses, as an optional
+ * parameter, "x?", or an annotated one, "x: T", from the "?" or ":" at
+ * "at", reading any type.  The parentheses have to turn out to be an arrow
+ * function's parameters.
+ */
+static size_t mark_parameter(struct Parser *parser, size_t at, uint8_t kind)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    uint32_t parameter = parser->operands[parser->operand_count - 1], type = NODE_NONE;
+    uint8_t marked = parser->ast->nodes[parameter].kind;
+    size_t end = at + 1;
+
+    if (kind == TEOPTIONAL ? marked != ETIDENTIFIER
+                           : !(marked == ETIDENTIFIER || marked == ETARRAYINIT || marked == ETOBJECTINIT || marked == ETSPREAD))
+        return PARSE_FAILED;
+
+    if ((kind == TEANNOTATION || (end < tokens->count && token_type(tokens, end) == TTCOLON))
+            && (end = parse_annotation(parser, kind == TEANNOTATION ? end : end + 1, &type)) == PARSE_FAILED)
+        return PARSE_FAILED;
+
+    --parser->operand_count;
+
+    return push_node(parser, kind, at, parameter, type) == EXIT_SUCCESS ? end : PARSE_FAILED;
+}
+
+/**Reads an operator, postfix operator or closing bracket after an operand.
+ * Returns where to carry on, or "at" itself if the expression ends there,
+ * and sets *operand if an operand is expected next.
+ */
+static size_t parse_operator(struct Parser *parser, size_t base, size_t at, bool allow_comma, bool *operand)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    struct Ast *ast = parser->ast;
+    enum TokenType ttype = token_type(tokens, at);
+    struct Frame *bracket;
+    uint32_t node;
+
+    *operand = false;
+
+    switch (ttype) {
+    case TTDOT:
+        if (at + 1 >= tokens->count || !is_name(token_type(tokens, at + 1)))
+            return PARSE_FAILED;
+
+        node = parser->operands[--parser->operand_count];
+        return push_node(parser, ETPROPERTYACCESS, at, node, tokens->symbols[at + 1]) == EXIT_SUCCESS ? at + 2 : PARSE_FAILED;
+    case TTOPTIONALCHAIN:
+        node = parser->operands[--parser->operand_count];
+        if (push_node(parser, ETOPTIONALCHAIN, at, node, 0) != EXIT_SUCCESS || at + 1 >= tokens->count)
+            return PARSE_FAILED;
+
+        // "a?.b" goes on as "a.b", "a?.[b]" and "a?.(b)" as "a[b]" and "a(b)"
+        if (is_name(token_type(tokens, at + 1))) {
+            node = parser->operands[--parser->operand_count];
+            return push_node(parser, ETPROPERTYACCESS, at, node, tokens->symbols[at + 1]) == EXIT_SUCCESS ? at + 2 : PARSE_FAILED;
+        }
+
+        ttype = token_type(tokens, ++at);
+        if (ttype != TTOPENBRACKET && ttype != TTOPENPAREN)
+            return PARSE_FAILED;
+        // fall through
+    case TTOPENBRACKET:
+    case TTOPENPAREN: {
+        struct Frame frame = { .type = ttype == TTOPENBRACKET ? FTINDEX : FTCALL, .token = at, .base = parser->operand_count };
+
+        // "new a(b)" passes b to new, rather than calling "new a"
+        if (ttype == TTOPENPAREN && parser->frame_count > base && parser->frames[parser->frame_count - 1].type == FTNEW) {
+            --parser->frame_count;
+            frame.type = FTNEWCALL;
+        }
+
+        *operand = true;
+        return push_frame(parser, frame) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    }
+    case TTINCREMENT:
+    case TTDECREMENT:
+        // postfix
+        node = parser->operands[--parser->operand_count];
+        if (!is_assignable(ast, node))
+            return PARSE_FAILED;
+        return push_node(parser, ttype == TTINCREMENT ? ETINCREMENT : ETDECREMENT, at, node, false)
+            == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    case TTCONDITIONAL: {
+        enum TokenType next = at + 1 < tokens->count ? token_type(tokens, at + 1) : TTNONE;
+
+        // "x?" in parentheses, where a conditional would need an operand
+        if (next == TTCLOSEPAREN || next == TTCOMMA || next == TTCOLON) {
+            if (reduce_while(parser, base, BPCOMMA + 1) != EXIT_SUCCESS || !in_group(parser, base))
+                return PARSE_FAILED;
+            return mark_parameter(parser, at, TEOPTIONAL);
+        }
+
+        if (reduce_while(parser, base, BPCONDITIONAL) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+
+        *operand = true;
+        return push_frame(parser, (struct Frame) { .type = FTCONDITION, .token = at, .base = parser->operand_count })
+            == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+    }
+    case TTCOLON:
+        // "x: T" in parentheses, where there's no conditional to be the ":" of
+        if (reduce_while(parser, base, BPCOMMA + 1) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+        if (in_group(parser, base))
+            return mark_parameter(parser, at, TEANNOTATION);
+
+        if (reduce_while(parser, base, BPNONE) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+
+        if ((bracket = open_bracket(parser, base)) == NULL)
+            return at; // the end, e.g. of a case label
+        if (bracket->type != FTCONDITION || parser->operand_count != bracket->base + 1)
+            return PARSE_FAILED;
+
+        // "c ? t :" now waits for the else branch like an assignment
+        *bracket = (struct Frame) { .type = FTTERNARY, .power = BPASSIGN, .token = bracket->token };
+        *operand = true;
+        return at + 1;
+    case TTCLOSEPAREN:
+    case TTCLOSEBRACKET:
+    case TTCLOSEBRACE:
+        if (reduce_while(parser, base, BPNONE) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+
+        if (open_bracket(parser, base) == NULL)
+            return at; // belongs to whatever contains the expression
+
+        return close_bracket(parser, at, operand);
+    case TTCOMMA:
+        if (reduce_while(parser, base, BPCOMMA) != EXIT_SUCCESS)
+            return PARSE_FAILED;
+
+        if ((bracket = open_bracket(parser, base)) != NULL) {
+            switch (bracket->type) {
+            case FTCALL:
+            case FTNEWCALL:
+            case FTARRAY:
+                *operand = true;
+                return at + 1;
+            case FTOBJECT:
+                if (at + 1 >= tokens->count)
+                    return PARSE_FAILED;
+                return parse_property_key(parser, at + 1, operand);
+            case FTGROUP:
+            case FTINDEX:
+                break; // the comma operator
+            default:
+                return PARSE_FAILED;
+            }
+        } else if (!allow_comma && parser->frame_count == base) {
+            return at;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (operators[ttype].left == BPNONE) {
+        // the end of the expression
+        if (reduce_while(parser, base, BPNONE) != EXIT_SUCCESS || parser->frame_count != base)
+            return PARSE_FAILED;
+        return at;
+    }
+
+    // "-a ** b" is an error rather than either reading of it
+    if (ttype == TTEXPONENT && parser->frame_count > base && parser->frames[parser->frame_count - 1].type == FTPREFIX
+            && parser->frames[parser->frame_count - 1].power == BPPREFIX)
+        return PARSE_FAILED;
+
+    if (reduce_while(parser, base, operators[ttype].left) != EXIT_SUCCESS)
+        return PARSE_FAILED;
+
+    *operand = true;
+    return push_frame(parser, (struct Frame) {
+        .type = FTBINARY,
+        .kind = operators[ttype].binary,
+        .power = operators[ttype].right,
+        .token = at,
+    }) == EXIT_SUCCESS ? at + 1 : PARSE_FAILED;
+}
+
+/**Parses an expression, or with allow_comma false an AssignmentExpression,
+ * which stops at a top-level comma.
+ */
+size_t parse_expression(struct Parser *parser, size_t at, bool allow_comma, uint32_t *out)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    size_t frame_base = parser->frame_count, operand_base = parser->operand_count;
+    bool operand = true;
+
+    while (true) {
+        size_t end;
+
+        if (operand) {
+            if (at >= tokens->count)
+                break;
+            end = parse_operand(parser, frame_base, at, &operand);
+        } else if (at >= tokens->count) {
+            // the end of the file ends the expression
+            if (reduce_while(parser, frame_base, BPNONE) != EXIT_SUCCESS || parser->frame_count != frame_base)
+                break;
+            end = at;
+        } else {
+            end = parse_operator(parser, frame_base, at, allow_comma, &operand);
+        }
+
+        if (end == PARSE_FAILED)
+            break;
+
+        if (end == at) {
+            assert(parser->operand_count == operand_base + 1);
+            *out = parser->operands[--parser->operand_count];
+            return end;
+        }
+
+        at = end;
+    }
+
+    parser->frame_count = frame_base;
+    parser->operand_count = operand_base;
+
+    return PARSE_FAILED;
+}
+
+size_t parse_numeric_literal(struct Parser *parser, size_t at, uint32_t *out)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+
+    assert(out != NULL);
+
+    if (at >= tokens->count) {
+        return PARSE_FAILED;
+    }
+
+    assert(token_type(tokens, at) == TTNUMLITERAL);
+
+    double value;
+    bool bigint;
+    uint32_t index;
+
+    if (numeric_literal_value(token_view(tokens, at), &value, &bigint) != EXIT_SUCCESS)
+        return PARSE_FAILED;
+
+    if (ast_push_number(parser->ast, value, &index) != EXIT_SUCCESS)
+        return PARSE_FAILED;
+
+    if ((*out = ast_push(parser->ast, ETNUMERICLITERAL, at, index, bigint)) == NODE_NONE)
+        return PARSE_FAILED;
+
+    return at + 1;
+}
+
+/**Parses "(a, b = 1, ...c)" into a counted list.
+ */
+static size_t parse_parameters(struct Parser *parser, size_t at, uint32_t *list)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    size_t base = parser->operand_count;
+
+    if (at >= tokens->count || token_type(tokens, at) != TTOPENPAREN)
+        return PARSE_FAILED;
+
+    for (++at; at < tokens->count && token_type(tokens, at) != TTCLOSEPAREN; ) {
+        struct Ast *ast = parser->ast;
+        uint32_t parameter, type = NODE_NONE;
+        size_t optional = 0, colon = at;
+
+        if (token_type(tokens, at) == TTIDENTIFIER && at + 2 < tokens->count
+                && token_type(tokens, at + 1) == TTCONDITIONAL
+                && (token_type(tokens, at + 2) == TTCOLON || token_type(tokens, at + 2) == TTCOMMA
+                    || token_type(tokens, at + 2) == TTCLOSEPAREN)) {
+            // "x?", which would otherwise start a conditional
+            if ((parameter = ast_push(ast, ETIDENTIFIER, at, tokens->symbols[at], 0)) == NODE_NONE)
+                break;
+            optional = at + 1;
+            at += 2;
+        } else if (token_type(tokens, at) == TTSPREAD) {
+            // a rest parameter, "...a" being no expression of its own
+            size_t spread = at;
+
+            if ((at = parse_expression(parser, at + 1, false, &parameter)) == PARSE_FAILED || at >= tokens->count
+                    || (parameter = ast_push(ast, ETSPREAD, spread, parameter, 0)) == NODE_NONE)
+                break;
+        } else if ((at = parse_expression(parser, at, false, &parameter)) == PARSE_FAILED || at >= tokens->count) {
+            break;
+        }
+
+        if (token_type(tokens, at) == TTCOLON) {
+            colon = at;
+            if ((at = parse_annotation(parser, at + 1, &type)) == PARSE_FAILED || at >= tokens->count)
+                break;
+
+            // "x: T = value", where the default comes after the type
+            if (token_type(tokens, at) == TTASSIGN && optional == 0 && ast->nodes[parameter].kind == ETIDENTIFIER) {
+                size_t assign = at;
+                uint32_t value;
+
+                if ((at = parse_expression(parser, at + 1, false, &value)) == PARSE_FAILED || at >= tokens->count
+                        || (parameter = ast_push(ast, ETASSIGN, assign, parameter, value)) == NODE_NONE)
+                    break;
+            }
+        }
+
+        bool last = token_type(tokens, at) == TTCLOSEPAREN;
+        if (!is_parameter(ast, parameter, last))
+            break;
+
+        if (optional != 0)
+            parameter = ast_push(ast, TEOPTIONAL, optional, parameter, type);
+        else if (type != NODE_NONE)
+            parameter = ast_push(ast, TEANNOTATION, colon, parameter, type);
+
+        if (parameter == NODE_NONE || push_operand(parser, parameter) != EXIT_SUCCESS)
+            break;
+
+        if (!last && token_type(tokens, at++) != TTCOMMA)
+            break;
+    }
+
+    if (at >= tokens->count || token_type(tokens, at) != TTCLOSEPAREN
+            || push_counted_list(parser->ast, &parser->operands[base], parser->operand_count - base, list) != EXIT_SUCCESS) {
+        parser->operand_count = base;
+        return PARSE_FAILED;
+    }
+
+    parser->operand_count = base;
+
+    return at + 1;
+}
+
+/* Types are parsed by recursive descent, as annotations nest shallowly:
+ *
+ *   type     := ["|"] array ("|" array)*
+ *   array    := primary ("[" "]")*
+ *   primary  := <identifier> ["<" type ("," type)* ">"] | <literal> | void
+ *             | "{" members "}" | "(" type ")" | "(" parameters ")" "=>" type
+ *   members  := ([readonly] <identifier> ["?"] (":" type | "(" parameters
+ *               ")" ":" type) [";" | ","])*
+ *
+ * A ">>" or ">>>" ends more than one list of type arguments at once, so the
+ * list that reads it leaves the count of the others in parser->angles, and
+ * they close without reading anything.
+ */
+
+static size_t parse_type_arguments(struct Parser *parser, size_t at, uint32_t reference, uint32_t *out)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    size_t base = parser->operand_count, open = at;
+    uint32_t list;
+
+    for (++at; ; ) {
+        uint32_t argument;
+
+        if ((at = parse_type(parser, at, &argument)) == PARSE_FAILED || push_operand(parser, argument) != EXIT_SUCCESS)
+            goto failed;
+
+        if (parser->angles > 0) {
+            --parser->angles;
+            break;
+        }
+
+        enum TokenType ttype = at < tokens->count ? token_type(tokens, at) : TTNONE;
+        ++at;
+
+        if (ttype == TTGREATER)
+            break;
+        else if (ttype == TTBITSHR)
+            parser->angles = 1;
+        else if (ttype == TTBITSHRZERO)
+            parser->angles = 2;
+        else if (ttype != TTCOMMA)
+            goto failed;
+
+        if (ttype != TTCOMMA)
+            break;
+    }
+
+    if (push_counted_list(parser->ast, &parser->operands[base], parser->operand_count - base, &list) != EXIT_SUCCESS
+            || (*out = ast_push(parser->ast, TEINSTANCE, open, reference, list)) == NODE_NONE)
+        goto failed;
+
+    parser->operand_count = base;
+    return at;
+
+failed:
+    parser->operand_count = base;
+    parser->angles = 0;
+    return PARSE_FAILED;
+}
+
+/**Parses a function type or method signature from its "(", where separator
+ * is what comes before the result: "=>" or ":".
+ */
+static size_t parse_function_type(struct Parser *parser, size_t at, enum TokenType separator, uint32_t *out)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    uint32_t parameters, result;
+    size_t open = at;
+
+    if ((at = parse_parameters(parser, at, &parameters)) == PARSE_FAILED
+            || at >= tokens->count || token_type(tokens, at) != separator
+            || (at = parse_type(parser, at + 1, &result)) == PARSE_FAILED
+            || (*out = ast_push(parser->ast, TEFUNCTION, open, result, parameters)) == NODE_NONE)
+        return PARSE_FAILED;
+
+    return at;
+}
+
+static size_t parse_object_type(struct Parser *parser, size_t at, uint32_t *out)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    size_t base = parser->operand_count, open = at;
+    uint32_t list;
+
+    for (++at; at < tokens->count && token_type(tokens, at) != TTCLOSEBRACE; ) {
+        uint8_t kind = TEMEMBER;
+        uint32_t type, member;
+
+        // readonly makes no difference to what can be assigned
+        if (is_contextual(tokens, at, "readonly") && at + 1 < tokens->count && is_name(token_type(tokens, at + 1)))
+            ++at;
+
+        size_t name = at++;
+
+        // a keyword names a member too, with no symbol of its own
+        if (at >= tokens->count || !is_name(token_type(tokens, name)))
+            goto failed;
+
+        if (token_type(tokens, at) == TTCONDITIONAL) {
+            kind = TEOPTIONALMEMBER;
+            ++at;
+        }
+
+        if (at < tokens->count && token_type(tokens, at) == TTOPENPAREN)
+            at = parse_function_type(parser, at, TTCOLON, &type);
+        else if (at < tokens->count && token_type(tokens, at) == TTCOLON)
+            at = parse_type(parser, at + 1, &type);
+        else
+            goto failed;
+
+        if (at == PARSE_FAILED
+                || (member = ast_push(parser->ast, kind, name, tokens->symbols[name], type)) == NODE_NONE
+                || push_operand(parser, member) != EXIT_SUCCESS)
+            goto failed;
+
+        if (at < tokens->count && (token_type(tokens, at) == TTSEMICOLON || token_type(tokens, at) == TTCOMMA))
+            ++at;
+    }
+
+    uint32_t count = parser->operand_count - base;
+
+    if (at >= tokens->count || ast_push_list(parser->ast, &parser->operands[base], count, &list) != EXIT_SUCCESS
+            || (*out = ast_push(parser->ast, TEOBJECT, open, list, count)) == NODE_NONE)
+        goto failed;
+
+    parser->operand_count = base;
+    return at + 1;
+
+failed:
+    parser->operand_count = base;
+    return PARSE_FAILED;
+}
+
+/**Whether the "(" at "at" starts a function type rather than a
+ * parenthesised one.
+ */
+static bool starts_function_type(const struct TokenBuffer *tokens, size_t at)
+{
+    enum TokenType next = at + 1 < tokens->count ? token_type(tokens, at + 1) : TTNONE;
+    enum TokenType after = at + 2 < tokens->count ? token_type(tokens, at + 2) : TTNONE;
+
+    if (next == TTCLOSEPAREN || next == TTSPREAD)
+        return true;
+
+    return next == TTIDENTIFIER
+        && (after == TTCOLON || after == TTCOMMA || after == TTCONDITIONAL
+            || (after == TTCLOSEPAREN && at + 3 < tokens->count && token_type(tokens, at + 3) == TTARROW));
+}
+
+static size_t parse_primary_type(struct Parser *parser, size_t at, uint32_t *out)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    struct Ast *ast = parser->ast;
+
+    if (at >= tokens->count)
+        return PARSE_FAILED;
+
+    switch (token_type(tokens, at)) {
+    case TTIDENTIFIER:
+        if ((*out = ast_push(ast, TEREFERENCE, at, tokens->symbols[at], 0)) == NODE_NONE)
+            return PARSE_FAILED;
+        if (at + 1 < tokens->count && token_type(tokens, at + 1) == TTLESS)
+            return parse_type_arguments(parser, at + 1, *out, out);
+        return at + 1;
+    case TTVOID:
+        return (*out = ast_push(ast, TEVOID, at, 0, 0)) != NODE_NONE ? at + 1 : PARSE_FAILED;
+    case TTNULL:
+        return (*out = ast_push(ast, ETNULL, at, 0, 0)) != NODE_NONE ? at + 1 : PARSE_FAILED;
+    case TTTRUE:
+    case TTFALSE:
+        return (*out = ast_push(ast, ETBOOLEANLITERAL, at, token_type(tokens, at) == TTTRUE, 0)) != NODE_NONE
+            ? at + 1 : PARSE_FAILED;
+    case TTSINGLESTRING:
+    case TTDOUBLESTRING:
+        return (*out = ast_push(ast, ETSTRINGLITERAL, at, 0, 0)) != NODE_NONE ? at + 1 : PARSE_FAILED;
+    case TTNUMLITERAL:
+        return parse_numeric_literal(parser, at, out);
+    case TTOPENBRACE:
+        return parse_object_type(parser, at, out);
+    case TTOPENPAREN:
+        if (starts_function_type(tokens, at))
+            return parse_function_type(parser, at, TTARROW, out);
+
+        if ((at = parse_type(parser, at + 1, out)) == PARSE_FAILED
+                || at >= tokens->count || token_type(tokens, at) != TTCLOSEPAREN)
+            return PARSE_FAILED;
+        return at + 1;
+    default:
+        return PARSE_FAILED;
+    }
+}
+
+size_t parse_type(struct Parser *parser, size_t at, uint32_t *out)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    size_t base = parser->operand_count, first = at;
+    uint32_t list;
+
+    if (at < tokens->count && token_type(tokens, at) == TTBITOR)
+        ++at;
+
+    while (true) {
+        uint32_t member;
+
+        if ((at = parse_primary_type(parser, at, &member)) == PARSE_FAILED)
+            goto failed;
+
+        // once a ">>" has been read, what follows belongs to an outer type
+        while (parser->angles == 0 && at + 1 < tokens->count
+                && token_type(tokens, at) == TTOPENBRACKET && token_type(tokens, at + 1) == TTCLOSEBRACKET) {
+            if ((member = ast_push(parser->ast, TEARRAY, at, member, 0)) == NODE_NONE)
+                goto failed;
+            at += 2;
+        }
+
+        if (push_operand(parser, member) != EXIT_SUCCESS)
+            goto failed;
+
+        if (parser->angles > 0 || at >= tokens->count || token_type(tokens, at) != TTBITOR)
+            break;
+        ++at;
+    }
+
+    uint32_t count = parser->operand_count - base;
+
+    if (count == 1)
+        *out = parser->operands[base];
+    else if (ast_push_list(parser->ast, &parser->operands[base], count, &list) != EXIT_SUCCESS
+            || (*out = ast_push(parser->ast, TEUNION, first, list, count)) == NODE_NONE)
+        goto failed;
+
+    parser->operand_count = base;
+    return at;
+
+failed:
+    parser->operand_count = base;
+    return PARSE_FAILED;
+}
+
+/**Parses the type after a ":" (or a type alias's "="), which can't leave
+ * any ">" unmatched.
+ */
+size_t parse_annotation(struct Parser *parser, size_t at, uint32_t *out)
+{
+    if ((at = parse_type(parser, at, out)) == PARSE_FAILED || parser->angles > 0) {
+        parser->angles = 0;
+        return PARSE_FAILED;
+    }
+
+    return at;
+}
+
+size_t parse_function(struct Parser *parser, size_t at, bool expression, uint32_t *out)
+{
+    /*
+    [async] function [*] <identifier> ( <parameters> ) [: <type>] { <body> }
+    where expressions may leave out the name.  The body is only skipped
+    over, see parse_function_body.
+    */
+    const struct TokenBuffer *tokens = parser->tokens;
+    bool async = is_contextual(tokens, at, "async"), generator = false;
+    size_t end = at + async;
+    uint32_t name = SYMBOL_NONE, parameters, result = NODE_NONE, function;
+
+    assert(token_type(tokens, end) == TTFUNCTION);
+
+    if (++end < tokens->count && token_type(tokens, end) == TTMULTIPLY) {
+        generator = true;
+        ++end;
+    }
+
+    if (end < tokens->count && token_type(tokens, end) == TTIDENTIFIER)
+        name = tokens->symbols[end++];
+    else if (!expression)
+        return PARSE_FAILED; // a declaration has to be named
+
+    if ((end = parse_parameters(parser, end, &parameters)) == PARSE_FAILED || end >= tokens->count)
+        return PARSE_FAILED;
+
+    if (token_type(tokens, end) == TTCOLON
+            && ((end = parse_annotation(parser, end + 1, &result)) == PARSE_FAILED || end >= tokens->count))
+        return PARSE_FAILED;
+
+    if (token_type(tokens, end) != TTOPENBRACE
+            || (end = skip_body(parser, end, name, parameters, result, &function)) == PARSE_FAILED)
+        return PARSE_FAILED;
+
+    static const uint8_t kinds[2][2][2] = {
+        // [expression][async][generator]
+        { { SDFUNCTION, SDGENFUNCTION }, { SDASYNCFUNCTION, SDASYNCGENFUNCTION } },
+        { { ETFUNCTION, ETGENFUNCTION }, { ETASYNCFUNCTION, ETASYNCGENFUNCTION } },
+    };
+
+    if ((*out = ast_push(parser->ast, kinds[expression][async][generator], at, function, 0)) == NODE_NONE)
+        return PARSE_FAILED;
+
+    return end;
+}
+
+size_t
+parse_variable_declaration(struct Parser *parser, size_t at, uint32_t *out)
+{
+    /*
+    only allows format: let|const|var <identifier> [: <type>] [= <expression>];
+    does not allow:
+        let a, b = 2;
+        let a = 1, b = a;
+    */
+    const struct TokenBuffer *tokens = parser->tokens;
+    enum StatementOrDeclarationType sdtype;
+
+    switch (token_type(tokens, at)) {
+    case TTLET: sdtype = SDLET; break;
+    case TTCONST: sdtype = SDCONST; break;
+    case TTVAR: sdtype = SDVAR; break;
+    default:
+        assert(0 && "should have checked for let, const or var");
+        return PARSE_FAILED;
+    }
+
+    if (tokens->count - at < 3) {
+        // malformed declaration
+        return PARSE_FAILED;
+    }
+
+    if (token_type(tokens, at + 1) != TTIDENTIFIER) return PARSE_FAILED;
+
+    size_t end = at + 2;
+    uint32_t initialiser = NODE_NONE, type = NODE_NONE;
+
+    if (token_type(tokens, end) == TTCOLON
+            && ((end = parse_annotation(parser, end + 1, &type)) == PARSE_FAILED || end >= tokens->count))
+        return PARSE_FAILED;
+
+    if (token_type(tokens, end) == TTASSIGN) {
+        end = parse_expression(parser, end + 1, false, &initialiser);
+        if (end == PARSE_FAILED)
+            return PARSE_FAILED;
+    } else if (sdtype == SDCONST) {
+        return PARSE_FAILED; // a const has to be initialised
+    }
+
+    if (end >= tokens->count || token_type(tokens, end) != TTSEMICOLON)
+        return PARSE_FAILED;
+
+    if (type != NODE_NONE
+            && (initialiser = ast_push(parser->ast, TEANNOTATION, at + 2, initialiser, type)) == NODE_NONE)
+        return PARSE_FAILED;
+
+    if ((*out = ast_push(parser->ast, sdtype, at, tokens->symbols[at + 1], initialiser)) == NODE_NONE)
+        return PARSE_FAILED;
+
+    return end + 1;
+}
+
+static size_t parse_object_type(struct Parser *parser, size_t at, uint32_t *out);
+
+/**Parses "interface <identifier> { <members> }" or "type <identifier> =
+ * <type>;", each declaring the type they name.
+ */
+static size_t parse_type_declaration(struct Parser *parser, size_t at, uint32_t *out)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    bool interface = token_type(tokens, at) == TTINTERFACE;
+    uint32_t type;
+    size_t end = at + 2;
+
+    if (end >= tokens->count || token_type(tokens, at + 1) != TTIDENTIFIER)
+        return PARSE_FAILED;
+
+    if (interface) {
+        if (token_type(tokens, end) != TTOPENBRACE || (end = parse_object_type(parser, end, &type)) == PARSE_FAILED)
+            return PARSE_FAILED;
+    } else if (token_type(tokens, end) != TTASSIGN
+            || (end = parse_annotation(parser, end + 1, &type)) == PARSE_FAILED
+            || end >= tokens->count || token_type(tokens, end++) != TTSEMICOLON) {
+        return PARSE_FAILED;
+    }
+
+    if ((*out = ast_push(parser->ast, interface ? SDINTERFACE : SDTYPEALIAS, at, tokens->symbols[at + 1], type)) == NODE_NONE)
+        return PARSE_FAILED;
+
+    return end;
+}
+
+size_t
+parse_statement_or_declaration(struct Parser *parser, size_t at, uint32_t *out)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+
+    if (at >= tokens->count) {
+        return PARSE_FAILED;
+    }
+
+    switch (token_type(tokens, at)) {
+    case TTLET:
+    case TTCONST:
+    case TTVAR:
+        return parse_variable_declaration(parser, at, out);
+    case TTFUNCTION:
+        return parse_function(parser, at, false, out);
+    case TTINTERFACE:
+        return parse_type_declaration(parser, at, out);
+    case TTOPENBRACE: {
+        uint32_t start, count;
+        size_t end = parse_statements(parser, at + 1, &start, &count);
+
+        if (end == PARSE_FAILED || end >= tokens->count)
+            return PARSE_FAILED;
+
+        assert(token_type(tokens, end) == TTCLOSEBRACE);
+        if ((*out = ast_push(parser->ast, SDBLOCK, at, start, count)) == NODE_NONE)
+            return PARSE_FAILED;
+        return end + 1;
+    }
+    case TTRETURN: {
+        uint32_t value = NODE_NONE;
+        size_t end = at + 1;
+
+        if (end < tokens->count && token_type(tokens, end) != TTSEMICOLON)
+            end = parse_expression(parser, end, true, &value);
+
+        if (end == PARSE_FAILED || end >= tokens->count || token_type(tokens, end) != TTSEMICOLON)
+            return PARSE_FAILED;
+
+        if ((*out = ast_push(parser->ast, SDRETURN, at, value, 0)) == NODE_NONE)
+            return PARSE_FAILED;
+        return end + 1;
+    }
+    default:
+        if (is_contextual(tokens, at, "async") && at + 1 < tokens->count && token_type(tokens, at + 1) == TTFUNCTION)
+            return parse_function(parser, at, false, out);
+        if (is_contextual(tokens, at, "type") && at + 2 < tokens->count
+                && token_type(tokens, at + 1) == TTIDENTIFIER && token_type(tokens, at + 2) == TTASSIGN)
+            return parse_type_declaration(parser, at, out);
+        break;
+    }
+
+    // anything else is an expression statement
+    uint32_t expression;
+    size_t end = parse_expression(parser, at, true, &expression);
+
+    if (end == PARSE_FAILED || end >= tokens->count || token_type(tokens, end) != TTSEMICOLON)
+        return PARSE_FAILED;
+
+    if ((*out = ast_push(parser->ast, SDEXPRSTATEMENT, at, expression, 0)) == NODE_NONE)
+        return PARSE_FAILED;
+
+    return end + 1;
+}
+
+/**Parses statements until the end of the tokens or a "}", which is left for
+ * the caller, and returns where they stopped.  The list of statements is
+ * written to *start and *count.
+ */
+size_t parse_statements(struct Parser *parser, size_t at, uint32_t *start, uint32_t *count)
+{
+    const struct TokenBuffer *tokens = parser->tokens;
+    size_t base = parser->operand_count;
+
+    // the statements are collected on the operand stack, so they nest
+    while (at < tokens->count && token_type(tokens, at) != TTCLOSEBRACE) {
+        uint32_t statement;
+        size_t end = parse_statement_or_declaration(parser, at, &statement);
+
+        if (end == PARSE_FAILED || push_operand(parser, statement) != EXIT_SUCCESS) {
+            if (parser->error_token == PARSE_FAILED)
+                parser->error_token = at;
+            parser->operand_count = base;
+            return PARSE_FAILED;
+        }
+
+        at = end;
+    }
+
+    *count = parser->operand_count - base;
+    if (ast_push_list(parser->ast, &parser->operands[base], *count, start) != EXIT_SUCCESS)
+        at = PARSE_FAILED;
+
+    parser->operand_count = base;
+
+    return at;
+}
+
+/* The forms the parser doesn't handle yet, as what parsing failed at. */
+static const char *const unsupported_forms[TTMAX] = {
+    [TTBREAK] = "break statements",
+    [TTCLASS] = "classes",
+    [TTCONTINUE] = "continue statements",
+    [TTDEBUGGER] = "debugger statements",
+    [TTDIVIDE] = "regular expressions",
+    [TTDIVIDEASSIGN] = "regular expressions",
+    [TTDO] = "do statements",
+    [TTENUM] = "enums",
+    [TTEXPORT] = "exports",
+    [TTFOR] = "for statements",
+    [TTIF] = "if statements",
+    [TTSWITCH] = "switch statements",
+    [TTTHROW] = "throw statements",
+    [TTTRY] = "try statements",
+    [TTWHILE] = "while statements",
+    [TTWITH] = "with statements",
+};
+
+const char *parse_unsupported(const struct TokenBuffer *tokens, size_t error_token)
+{
+    if (error_token >= tokens->count)
+        return NULL;
+
+    enum TokenType ttype = token_type(tokens, error_token);
+
+    // "import(...)" and "import.meta" are parsed, declarations aren't
+    if (ttype == TTIMPORT)
+        return error_token + 1 < tokens->count && (token_type(tokens, error_token + 1) == TTOPENPAREN
+                                                    || token_type(tokens, error_token + 1) == TTDOT)
+            ? NULL : "imports";
+
+    return unsupported_forms[ttype];
+}
+
+/* Parallel parsing of one file's top-level statements.
+ *
+ * A scan over the token types finds where top-level statements end: at a
+ * ";" outside any brackets, or at the "}" closing a block or function
+ * declaration.  A "{" where a type is expected, as in "function f(): { a:
+ * number } {}", opens an object type and not the body, so its "}" doesn't
+ * end anything.  This has to be kept in step with the statements the parser
+ * knows.  The tokens are cut into about equal runs at those boundaries, and
+ * each worker parses its run into an Ast in its own arena.
+ *
+ * The parts are then appended to the real tree in order.  Each part's nodes
+ * were built in the same order serial parsing would build them, so after
+ * renumbering the tree is identical.  If any part fails, perhaps because the
+ * scan was misled by broken input, the file is parsed again serially to give
+ * the same error.
+ */
+
+// below this many tokens per thread, threads cost more than they save
+#define PARALLEL_MIN_TOKENS (64 * 1024)
+
+struct Part {
+    struct TokenBuffer tokens;  // the file's, with count cut at the end of the run
+    size_t begin;
+    struct Arena arena;
+    struct Ast ast;
+    uint32_t *statements;       // the top-level statements, in ast
+    uint32_t count;
+    bool failed;
+};
+
+static void *parse_part(void *argument)
+{
+    struct Part *part = argument;
+    struct Parser parser;
+    uint32_t start;
+
+    part->failed = true;
+    arena_init(&part->arena);
+
+    // node 0 is a placeholder, see ast_append
+    if (ast_init(&part->ast, &part->arena, part->tokens.count - part->begin + 1) != EXIT_SUCCESS
+            || ast_push(&part->ast, SDEMPTY, 0, 0, 0) != 0)
+        return NULL;
+
+    if (parser_init(&parser, &part->tokens, &part->ast) == EXIT_SUCCESS
+            && parse_statements(&parser, part->begin, &start, &part->count) == part->tokens.count) {
+        // the list was pushed last; take it back off so it isn't appended
+        part->statements = &part->ast.extra[start];
+        part->ast.extra_count = start;
+        part->failed = false;
+    }
+
+    parser_free(&parser);
+
+    return NULL;
+}
+
+/**Whether a "{" after a token of this type opens an object type: one that
+ * leaves a type to follow, in an annotation, a union or intersection, type
+ * arguments or parameters, or a function type's result.
+ */
+static bool expects_type(enum TokenType ttype)
+{
+    switch (ttype) {
+    case TTCOLON:
+    case TTBITOR:
+    case TTBITAND:
+    case TTLESS:
+    case TTCOMMA:
+    case TTASSIGN:
+    case TTARROW:
+    case TTEXTENDS:
+    case TTCONDITIONAL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**Finds up to parts - 1 top-level statement boundaries near the even split
+ * points, writing where each part starts to begins.  Returns the number of
+ * parts.
+ */
+static size_t split_statements(const struct TokenBuffer *tokens, size_t *begins, size_t parts)
+{
+    size_t found = 1, depth = 0, statement = 0;
+    bool braced = false;    // whether the statement ends at its closing "}"
+    bool typed = false;     // whether the outermost "{" open is an object type
+
+    begins[0] = 0;
+
+    for (size_t i = 0; i < tokens->count && found < parts; i++) {
+        enum TokenType ttype = token_type(tokens, i);
+        bool end = false;
+
+        if (i == statement)
+            braced = ttype == TTOPENBRACE || ttype == TTFUNCTION || ttype == TTINTERFACE
+                  || (ttype == TTIDENTIFIER && i + 1 < tokens->count && token_type(tokens, i + 1) == TTFUNCTION);
+
+        switch (ttype) {
+        case TTOPENBRACE:
+            if (depth == 0)
+                typed = i > statement && expects_type(token_type(tokens, i - 1));
+            // fall through
+        case TTOPENPAREN:
+        case TTOPENBRACKET:
+            ++depth;
+            break;
+        case TTCLOSEPAREN:
+        case TTCLOSEBRACKET:
+            if (depth-- == 0)
+                return found; // unbalanced, so stop guessing
+            break;
+        case TTCLOSEBRACE:
+            if (depth-- == 0)
+                return found;
+            end = depth == 0 && braced && !typed;
+            break;
+        case TTSEMICOLON:
+            end = depth == 0;
+            break;
+        default:
+            break;
+        }
+
+        if (!end)
+            continue;
+
+        statement = i + 1;
+        if (statement >= tokens->count / parts * found && statement < tokens->count)
+            begins[found++] = statement;
+    }
+
+    return found;
+}
+
+int parse_tokens_parallel(const struct TokenBuffer *tokens, struct Ast *ast, size_t *error_token, size_t threads)
+{
+    if (threads > tokens->count / PARALLEL_MIN_TOKENS)
+        threads = tokens->count / PARALLEL_MIN_TOKENS;
+
+    if (threads <= 1)
+        return parse_tokens(tokens, ast, error_token);
+
+    struct Part *parts = calloc(threads, sizeof *parts);
+    size_t *begins = calloc(threads, sizeof *begins);
+    pthread_t *workers = calloc(threads, sizeof *workers);
+    uint32_t *statements = NULL;
+    size_t started = 0, count = 0, num_parts = 0;
+    int result = EXIT_FAILURE;
+
+    *error_token = 0;
+
+    if (parts == NULL || begins == NULL || workers == NULL)
+        goto done;
+
+    num_parts = split_statements(tokens, begins, threads);
+
+    for (size_t k = 0; k < num_parts; k++) {
+        parts[k].tokens = *tokens;
+        parts[k].tokens.count = k + 1 < num_parts ? begins[k + 1] : tokens->count;
+        parts[k].begin = begins[k];
+    }
+
+    // the calling thread takes the first part itself
+    for (started = 1; started < num_parts; started++)
+        if (pthread_create(&workers[started], NULL, parse_part, &parts[started]) != 0)
+            break;
+
+    parse_part(&parts[0]);
+
+    for (size_t k = 1; k < started; k++)
+        pthread_join(workers[k], NULL);
+
+    // any part that couldn't get a thread is parsed here
+    for (size_t k = started; k < num_parts; k++)
+        parse_part(&parts[k]);
+
+    for (size_t k = 0; k < num_parts; k++) {
+        if (parts[k].failed) {
+            result = parse_tokens(tokens, ast, error_token);
+            goto done;
+        }
+        count += parts[k].count;
+    }
+
+    assert(ast->count == 0);
+    if ((statements = malloc((count ? count : 1) * sizeof *statements)) == NULL
+            || ast_push(ast, SDPROGRAM, 0, 0, 0) != 0)
+        goto done;
+
+    count = 0;
+    for (size_t k = 0; k < num_parts; k++) {
+        uint32_t shift = ast->count - 1;
+
+        if (ast_append(ast, &parts[k].ast) != EXIT_SUCCESS)
+            goto done;
+
+        for (uint32_t i = 0; i < parts[k].count; i++)
+            statements[count++] = parts[k].statements[i] + shift;
+    }
+
+    if (ast_push_list(ast, statements, count, &ast->nodes[0].lhs) != EXIT_SUCCESS)
+        goto done;
+    ast->nodes[0].rhs = count;
+
+    result = EXIT_SUCCESS;
+
+done:
+    if (parts != NULL)
+        for (size_t k = 0; k < num_parts; k++)
+            arena_free(&parts[k].arena);
+
+    free(parts);
+    free(begins);
+    free(workers);
+    free(statements);
+
+    return result;
+}
+
+/* Incremental reparsing after edits.
+ *
+ * Once the tokens are patched, the damaged tokens are found inside the
+ * innermost statement list that holds them: the program, a block, or the body
+ * of a function declaration.  Only the statements of that list which overlap
+ * the damage are parsed again, and everything else is kept, the nodes after
+ * the damage having their tokens moved along.  If the new tokens don't parse
+ * as statements ending on a boundary of the old ones, the statement holding
+ * the list is parsed again instead, and so on out to the program.  Damage
+ * inside a body that hasn't been parsed needs no parsing at all, as long as
+ * its braces still match.
+ *
+ * The old nodes are left behind unreferenced, so a tree that has been edited
+ * a great deal is worth parsing again from scratch.
+ *
+ * Moving the token indices of everything after the damage would take time
+ * in proportion to the file, so each edit's shift is only recorded, with how
+ * many nodes and functions there were to apply to, and added in on read.
+ * Settling applies them all in one pass: going from the newest nodes to the
+ * oldest, the shifts that apply are composed one more at a time into a map
+ * from old token to total shift, which each node then looks its token up in.
+ */
+
+struct ReparseLevel {
+    uint32_t owner;         // the node holding the list, the root or an SDBLOCK
+    size_t begin, end;      // the tokens of the list, not counting braces
+    size_t first, last;     // the statements overlapping the damage, last is
+                            // first - 1 if there are none
+    size_t from, to;        // their tokens
+};
+
+static size_t statement_token(const struct Ast *ast, const struct Node *owner, size_t i)
+{
+    return ast_node_token(ast, ast->extra[owner->lhs + i]);
+}
+
+/**Fills in which statements of the level's list overlap the damaged tokens
+ * first to end.
+ */
+static void find_damaged_statements(const struct Ast *ast, struct ReparseLevel *level, size_t first, size_t end)
+{
+    const struct Node *owner = &ast->nodes[level->owner];
+    size_t low = 0, high = owner->rhs;
+
+    // the first statement starting after the first damaged token
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (statement_token(ast, owner, middle) <= first)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    level->first = low > 0 ? low - 1 : 0;
+    level->from = low > 0 ? statement_token(ast, owner, low - 1) : level->begin;
+
+    // and the first one starting after the damage, which is kept
+    size_t limit = end > first ? end : first + 1;
+    while (low < owner->rhs && statement_token(ast, owner, low) < limit)
+        ++low;
+
+    level->last = low - 1; // wraps around if there are none
+    level->to = low < owner->rhs ? statement_token(ast, owner, low) : level->end;
+}
+
+/**Marks the functions in the replaced statements as dropped, so nothing
+ * goes on to parse their bodies.
+ */
+static int drop_functions(struct Parser *parser, const uint32_t *statements, size_t count)
+{
+    struct Ast *ast = parser->ast;
+    size_t base = parser->operand_count;
+
+    for (size_t i = 0; i < count; i++)
+        if (push_operand(parser, statements[i]) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+
+    while (parser->operand_count > base) {
+        uint32_t node = parser->operands[--parser->operand_count];
+        struct Node n = ast->nodes[node];
+        uint32_t children[2] = { NODE_NONE, NODE_NONE };
+        const uint32_t *list = NULL;
+        uint32_t length = 0;
+
+        switch (node_layouts[n.kind]) {
+        case NLLEAF:
+            break;
+        case NLUNARY:
+        case NLMEMBER:
+            children[0] = n.lhs;
+            break;
+        case NLBINARY:
+            children[0] = n.lhs;
+            children[1] = n.rhs;
+            break;
+        case NLTERNARY:
+            children[0] = n.lhs;
+            list = &ast->extra[n.rhs];
+            length = 2;
+            break;
+        case NLCALL:
+            children[0] = n.lhs;
+            list = &ast->extra[n.rhs + 1];
+            length = ast->extra[n.rhs];
+            break;
+        case NLLIST:
+            list = &ast->extra[n.lhs];
+            length = n.rhs;
+            break;
+        case NLFUNCTION: {
+            struct Function *f = &ast->functions[n.lhs];
+            list = &ast->extra[f->parameters + 1];
+            length = ast->extra[f->parameters];
+            children[0] = f->body;
+            *f = (struct Function) { .name = f->name, .parameters = f->parameters };
+            break;
+        }
+        case NLDECLARATION:
+        case NLNAMED:
+            children[0] = n.rhs;
+            break;
+        }
+
+        for (size_t i = 0; i < 2; i++)
+            if (children[i] != NODE_NONE && push_operand(parser, children[i]) != EXIT_SUCCESS)
+                return EXIT_FAILURE;
+
+        // push_operand may move the stack, but not extra
+        for (size_t i = 0; i < length; i++)
+            if (list[i] != NODE_NONE && push_operand(parser, list[i]) != EXIT_SUCCESS)
+                return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**Parses the level's damaged statements again from the new tokens, and
+ * splices them into its list.
+ */
+static int reparse_level(struct Parser *parser, struct ReparseLevel *level)
+{
+    struct Ast *ast = parser->ast;
+    size_t base = parser->operand_count, at = level->from, target = level->to;
+    size_t count = ast->nodes[level->owner].rhs, next = level->last + 1, kept = level->first;
+
+    while (at < target) {
+        uint32_t statement;
+        size_t end = parse_statement_or_declaration(parser, at, &statement);
+
+        if (end == PARSE_FAILED || push_operand(parser, statement) != EXIT_SUCCESS) {
+            if (parser->error_token == PARSE_FAILED)
+                parser->error_token = at;
+            goto failed;
+        }
+
+        at = end;
+
+        // parsed past where the old statements carried on, so take in more
+        while (at > target) {
+            if (next < count) {
+                target = statement_token(ast, &ast->nodes[level->owner], next++);
+            } else if (at > level->end) {
+                goto failed;
+            } else {
+                target = level->end;
+            }
+        }
+    }
+
+    size_t parsed = parser->operand_count - base, total = kept + parsed + (count - next);
+    struct Node *owner = &ast->nodes[level->owner];
+
+    if (drop_functions(parser, &ast->extra[owner->lhs + kept], next - kept) != EXIT_SUCCESS)
+        goto failed;
+
+    if (total == count) {
+        memcpy(&ast->extra[owner->lhs + kept], &parser->operands[base], parsed * sizeof *ast->extra);
+    } else {
+        uint32_t start;
+
+        // the list changes length, so it's copied whole
+        for (size_t i = 0; i < kept; i++)
+            if (push_operand(parser, ast->extra[owner->lhs + i]) != EXIT_SUCCESS)
+                goto failed;
+        for (size_t i = 0; i < parsed; i++)
+            if (push_operand(parser, parser->operands[base + i]) != EXIT_SUCCESS)
+                goto failed;
+        for (size_t i = next; i < count; i++)
+            if (push_operand(parser, ast->extra[owner->lhs + i]) != EXIT_SUCCESS)
+                goto failed;
+
+        if (ast_push_list(ast, &parser->operands[base + parsed], total, &start) != EXIT_SUCCESS)
+            goto failed;
+
+        owner = &ast->nodes[level->owner];
+        owner->lhs = start;
+        owner->rhs = total;
+    }
+
+    parser->operand_count = base;
+    return EXIT_SUCCESS;
+
+failed:
+    parser->operand_count = base;
+    return EXIT_FAILURE;
+}
+
+/**The total shift of tokens from each of from on, up to the next: what a
+ * run of AstShifts comes to.
+ */
+struct ShiftMap {
+    size_t count;
+    uint32_t from[AST_MAX_SHIFTS];
+    int64_t by[AST_MAX_SHIFTS];
+};
+
+static int64_t shift_at(const struct ShiftMap *map, int64_t token)
+{
+    size_t low = 0, high = map->count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (map->from[middle] <= token)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low > 0 ? map->by[low - 1] : 0;
+}
+
+/**Makes map apply shift before what it did already.  The tokens the edit
+ * replaced are in nobody's tree, so the map only has to be right for those
+ * before it, which stay put, and those from its old end on, which move.
+ */
+static void shift_before(struct ShiftMap *map, struct AstShift shift)
+{
+    struct ShiftMap old = *map;
+    int64_t end = shift.from, moved = end + shift.by;
+
+    map->count = 0;
+
+    for (size_t i = 0; i < old.count && old.from[i] < (end < moved ? end : moved); i++) {
+        map->from[map->count] = old.from[i];
+        map->by[map->count++] = old.by[i];
+    }
+
+    map->from[map->count] = shift.from;
+    map->by[map->count++] = shift.by + shift_at(&old, moved);
+
+    for (size_t i = 0; i < old.count; i++) {
+        if (old.from[i] > moved) {
+            map->from[map->count] = old.from[i] - shift.by;
+            map->by[map->count++] = old.by[i] + shift.by;
+        }
+    }
+}
+
+void reparse_settle(struct TokenBuffer *tokens, struct Ast *ast)
+{
+    struct ShiftMap map = {0};
+
+    token_buffer_settle(tokens);
+
+    for (size_t k = ast->shift_count; k-- > 0; ) {
+        struct AstShift shift = ast->shifts[k];
+        // what was made between the shift before and this one has this one
+        // and every one after it to apply
+        // and node 0, the root, starts at token 0 whatever happens
+        size_t nodes = k > 0 ? ast->shifts[k - 1].nodes : 1, functions = k > 0 ? ast->shifts[k - 1].functions : 0;
+
+        shift_before(&map, shift);
+
+        for (size_t i = nodes; i < shift.nodes; i++)
+            ast->nodes[i].token += shift_at(&map, ast->nodes[i].token);
+
+        for (size_t i = functions; i < shift.functions; i++) {
+            struct Function *f = &ast->functions[i];
+            if (f->body_end != 0) {
+                f->body_start += shift_at(&map, f->body_start);
+                f->body_end += shift_at(&map, f->body_end);
+            }
+        }
+    }
+
+    ast->shift_count = 0;
+}
+
+int reparse_edits(const char *contents, size_t length, struct Interner *interner, struct TokenBuffer *tokens,
+                  struct Ast *ast, const struct TextEdit *edits, size_t edit_count, size_t *error_token)
+{
+    struct TokenChange change;
+    struct ReparseLevel *levels = NULL;
+    size_t depth = 0, capacity = 0;
+    uint32_t lazy = UINT32_MAX;     // a function with the damage in its unparsed body
+    struct Parser parser;
+    int result = EXIT_FAILURE;
+
+    *error_token = 0;
+
+    if (ast->shift_count == AST_MAX_SHIFTS)
+        reparse_settle(tokens, ast);
+
+    if (parser_init(&parser, tokens, ast) != EXIT_SUCCESS)
+        goto done;
+
+    if (retokenise_edits(contents, length, interner, tokens, edits, edit_count, &change) != EXIT_SUCCESS) {
+        *error_token = tokens->count;
+        goto done;
+    }
+
+    if (change.old_count == 0 && change.new_count == 0) {
+        result = EXIT_SUCCESS; // only whitespace or comments changed
+        goto done;
+    }
+
+    size_t first = change.first, end = change.first + change.old_count;
+    ptrdiff_t shift = (ptrdiff_t)change.new_count - (ptrdiff_t)change.old_count;
+
+    // find the innermost list holding the damage, in the old token indices
+    for (struct ReparseLevel level = { .owner = 0, .begin = 0, .end = tokens->count - shift }; ; ) {
+        if (depth == capacity) {
+            struct ReparseLevel *bigger = realloc(levels, (capacity = capacity ? capacity * 2 : 16) * sizeof *levels);
+            if (bigger == NULL)
+                goto done;
+            levels = bigger;
+        }
+
+        find_damaged_statements(ast, &level, first, end);
+        levels[depth++] = level;
+
+        if (level.first != level.last || ast->nodes[level.owner].rhs == 0)
+            break;
+
+        uint32_t statement = ast->extra[ast->nodes[level.owner].lhs + level.first];
+        struct Node n = ast->nodes[statement];
+        uint32_t token = ast_node_token(ast, statement);
+
+        if (n.kind == SDBLOCK && token < first && end < level.to) {
+            level = (struct ReparseLevel) { .owner = statement, .begin = token + 1, .end = level.to - 1 };
+        } else if (node_layouts[n.kind] == NLFUNCTION && node_is_statement(n.kind)
+                && ast_function(ast, n.lhs).body_start < first && end <= ast_function(ast, n.lhs).body_end) {
+            struct Function f = ast_function(ast, n.lhs);
+            if (f.body == NODE_NONE) {
+                lazy = n.lhs;
+                break;
+            }
+            level = (struct ReparseLevel) { .owner = f.body, .begin = f.body_start + 1, .end = f.body_end };
+        } else {
+            break;
+        }
+    }
+
+    if (shift != 0)
+        ast->shifts[ast->shift_count++] = (struct AstShift) {
+            .nodes = ast->count, .functions = ast->function_count, .from = end, .by = shift,
+        };
+
+    for (size_t i = 0; i < depth; i++) {
+        levels[i].end += shift;
+        levels[i].to += shift;
+    }
+
+    // damage inside a body nobody has parsed only has to keep its braces
+    if (lazy != UINT32_MAX && match_brace(tokens, ast_function(ast, lazy).body_start) == ast_function(ast, lazy).body_end) {
+        result = EXIT_SUCCESS;
+        goto done;
+    }
+
+    while (depth > 0) {
+        if (reparse_level(&parser, &levels[--depth]) == EXIT_SUCCESS) {
+            result = EXIT_SUCCESS;
+            goto done;
+        }
+    }
+
+    *error_token = parser.error_token != PARSE_FAILED ? parser.error_token : first;
+
+done:
+    parser_free(&parser);
+    free(levels);
 
-    return NULL; // TODO
+    return result;
 }
@@ -0,0 +1,376 @@
+#include "compile.h"
+
+#include <pthread.h>
+#include <stdint.h>
+
+/* Byte-class scanning kernels used by the lexer.
+ *
+ * Each kernel has a scalar version and, on x86, SSE2 and AVX2 versions that
+ * classify 16 or 32 bytes per step with compare/movemask.  The vector kernels
+ * only ever do aligned loads, so they never read across a page boundary past
+ * the end of the text, and the NUL itself is never in any class so every scan
+ * stops there.  The bytes before the start of the first aligned block, and
+ * for scan_line_starts the bytes past the given length, are masked off.
+ *
+ * The public entry points are function pointers that start out pointing at a
+ * resolver; the first call checks CPUID, points every entry point at the best
+ * kernels and then forwards the call.  Writing the pointers while another
+ * thread reads them is a race, so code that starts threads calls
+ * scan_resolve_kernels first and the workers only ever see the final kernels.
+ */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+/* scalar */
+
+static bool is_scan_whitespace(unsigned char c)
+{
+    return c == ' ' || (unsigned char)(c - '\t') <= '\r' - '\t';
+}
+
+static bool is_scan_identifier(unsigned char c)
+{
+    return (unsigned char)((c | 0x20) - 'a') <= 'z' - 'a'
+        || (unsigned char)(c - '0') <= 9
+        || c == '_' || c == '$';
+}
+
+static const char *skip_whitespace_scalar(const char *string)
+{
+    while (is_scan_whitespace(*string))
+        ++string;
+
+    return string;
+}
+
+static const char *skip_identifier_scalar(const char *string)
+{
+    while (is_scan_identifier(*string))
+        ++string;
+
+    return string;
+}
+
+static const char *find_any_scalar(const char *string, char a, char b, char c)
+{
+    while (*string != '\0' && *string != a && *string != b && *string != c)
+        ++string;
+
+    return string;
+}
+
+static size_t line_starts_scalar(const char *string, size_t length, uint32_t base, uint32_t *starts)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        if (string[i] == '\n') {
+            if (starts != NULL)
+                starts[count] = base + i + 1;
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+#ifdef SCAN_X86
+
+/* SSE2 */
+
+#define SSE2_BLOCK 16
+
+__attribute__((target("sse2")))
+static inline __m128i sse2_in_range(__m128i x, char lo, char hi)
+{
+    __m128i t = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(hi - lo)), t);
+}
+
+__attribute__((target("sse2")))
+static inline unsigned sse2_eq(__m128i x, char c)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8(c)));
+}
+
+__attribute__((target("sse2")))
+static inline unsigned sse2_whitespace_mask(__m128i x)
+{
+    return _mm_movemask_epi8(sse2_in_range(x, '\t', '\r')) | sse2_eq(x, ' ');
+}
+
+__attribute__((target("sse2")))
+static inline unsigned sse2_identifier_mask(__m128i x)
+{
+    __m128i alpha = sse2_in_range(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 'z');
+    __m128i digit = sse2_in_range(x, '0', '9');
+    return _mm_movemask_epi8(_mm_or_si128(alpha, digit)) | sse2_eq(x, '_') | sse2_eq(x, '$');
+}
+
+__attribute__((target("sse2")))
+static const char *skip_whitespace_sse2(const char *string)
+{
+    const char *block = (const char *)((uintptr_t)string & ~(uintptr_t)(SSE2_BLOCK - 1));
+    unsigned before = (1u << (string - block)) - 1;
+
+    for (;; block += SSE2_BLOCK, before = 0) {
+        __m128i x = _mm_load_si128((const __m128i *)block);
+        unsigned stop = ~(sse2_whitespace_mask(x) | before) & 0xffffu;
+
+        if (stop != 0)
+            return block + __builtin_ctz(stop);
+    }
+}
+
+__attribute__((target("sse2")))
+static const char *skip_identifier_sse2(const char *string)
+{
+    const char *block = (const char *)((uintptr_t)string & ~(uintptr_t)(SSE2_BLOCK - 1));
+    unsigned before = (1u << (string - block)) - 1;
+
+    for (;; block += SSE2_BLOCK, before = 0) {
+        __m128i x = _mm_load_si128((const __m128i *)block);
+        unsigned stop = ~(sse2_identifier_mask(x) | before) & 0xffffu;
+
+        if (stop != 0)
+            return block + __builtin_ctz(stop);
+    }
+}
+
+__attribute__((target("sse2")))
+static const char *find_any_sse2(const char *string, char a, char b, char c)
+{
+    const char *block = (const char *)((uintptr_t)string & ~(uintptr_t)(SSE2_BLOCK - 1));
+    unsigned before = (1u << (string - block)) - 1;
+
+    for (;; block += SSE2_BLOCK, before = 0) {
+        __m128i x = _mm_load_si128((const __m128i *)block);
+        unsigned stop = (sse2_eq(x, a) | sse2_eq(x, b) | sse2_eq(x, c) | sse2_eq(x, '\0')) & ~before;
+
+        if (stop != 0)
+            return block + __builtin_ctz(stop);
+    }
+}
+
+__attribute__((target("sse2")))
+static size_t line_starts_sse2(const char *string, size_t length, uint32_t base, uint32_t *starts)
+{
+    const char *block = (const char *)((uintptr_t)string & ~(uintptr_t)(SSE2_BLOCK - 1));
+    const char *end = string + length;
+    unsigned before = (1u << (string - block)) - 1;
+    size_t count = 0;
+
+    for (; block < end; block += SSE2_BLOCK, before = 0) {
+        __m128i x = _mm_load_si128((const __m128i *)block);
+        unsigned nl = sse2_eq(x, '\n') & ~before;
+
+        if (end - block < SSE2_BLOCK)
+            nl &= (1u << (end - block)) - 1;
+
+        if (starts == NULL) {
+            count += __builtin_popcount(nl);
+            continue;
+        }
+
+        for (; nl != 0; nl &= nl - 1)
+            starts[count++] = base + (block + __builtin_ctz(nl) + 1 - string);
+    }
+
+    return count;
+}
+
+/* AVX2 */
+
+#define AVX2_BLOCK 32
+
+__attribute__((target("avx2")))
+static inline __m256i avx2_in_range(__m256i x, char lo, char hi)
+{
+    __m256i t = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8(hi - lo)), t);
+}
+
+__attribute__((target("avx2")))
+static inline unsigned avx2_eq(__m256i x, char c)
+{
+    return (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(c)));
+}
+
+__attribute__((target("avx2")))
+static inline unsigned avx2_whitespace_mask(__m256i x)
+{
+    return (unsigned)_mm256_movemask_epi8(avx2_in_range(x, '\t', '\r')) | avx2_eq(x, ' ');
+}
+
+__attribute__((target("avx2")))
+static inline unsigned avx2_identifier_mask(__m256i x)
+{
+    __m256i alpha = avx2_in_range(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 'z');
+    __m256i digit = avx2_in_range(x, '0', '9');
+    return (unsigned)_mm256_movemask_epi8(_mm256_or_si256(alpha, digit)) | avx2_eq(x, '_') | avx2_eq(x, '$');
+}
+
+__attribute__((target("avx2")))
+static const char *skip_whitespace_avx2(const char *string)
+{
+    const char *block = (const char *)((uintptr_t)string & ~(uintptr_t)(AVX2_BLOCK - 1));
+    unsigned before = (1u << (string - block)) - 1;
+
+    for (;; block += AVX2_BLOCK, before = 0) {
+        __m256i x = _mm256_load_si256((const __m256i *)block);
+        unsigned stop = ~(avx2_whitespace_mask(x) | before);
+
+        if (stop != 0)
+            return block + __builtin_ctz(stop);
+    }
+}
+
+__attribute__((target("avx2")))
+static const char *skip_identifier_avx2(const char *string)
+{
+    const char *block = (const char *)((uintptr_t)string & ~(uintptr_t)(AVX2_BLOCK - 1));
+    unsigned before = (1u << (string - block)) - 1;
+
+    for (;; block += AVX2_BLOCK, before = 0) {
+        __m256i x = _mm256_load_si256((const __m256i *)block);
+        unsigned stop = ~(avx2_identifier_mask(x) | before);
+
+        if (stop != 0)
+            return block + __builtin_ctz(stop);
+    }
+}
+
+__attribute__((target("avx2")))
+static const char *find_any_avx2(const char *string, char a, char b, char c)
+{
+    const char *block = (const char *)((uintptr_t)string & ~(uintptr_t)(AVX2_BLOCK - 1));
+    unsigned before = (1u << (string - block)) - 1;
+
+    for (;; block += AVX2_BLOCK, before = 0) {
+        __m256i x = _mm256_load_si256((const __m256i *)block);
+        unsigned stop = (avx2_eq(x, a) | avx2_eq(x, b) | avx2_eq(x, c) | avx2_eq(x, '\0')) & ~before;
+
+        if (stop != 0)
+            return block + __builtin_ctz(stop);
+    }
+}
+
+__attribute__((target("avx2")))
+static size_t line_starts_avx2(const char *string, size_t length, uint32_t base, uint32_t *starts)
+{
+    const char *block = (const char *)((uintptr_t)string & ~(uintptr_t)(AVX2_BLOCK - 1));
+    const char *end = string + length;
+    unsigned before = (1u << (string - block)) - 1;
+    size_t count = 0;
+
+    for (; block < end; block += AVX2_BLOCK, before = 0) {
+        __m256i x = _mm256_load_si256((const __m256i *)block);
+        unsigned nl = avx2_eq(x, '\n') & ~before;
+
+        if (end - block < AVX2_BLOCK)
+            nl &= (1u << (end - block)) - 1;
+
+        if (starts == NULL) {
+            count += __builtin_popcount(nl);
+            continue;
+        }
+
+        for (; nl != 0; nl &= nl - 1)
+            starts[count++] = base + (block + __builtin_ctz(nl) + 1 - string);
+    }
+
+    return count;
+}
+
+#endif // SCAN_X86
+
+/* dispatch */
+
+static const char *resolve_skip_whitespace(const char *string);
+static const char *resolve_skip_identifier(const char *string);
+static const char *resolve_find_any(const char *string, char a, char b, char c);
+static size_t resolve_line_starts(const char *string, size_t length, uint32_t base, uint32_t *starts);
+
+const char *(*scan_skip_whitespace)(const char *string) = resolve_skip_whitespace;
+const char *(*scan_skip_identifier)(const char *string) = resolve_skip_identifier;
+const char *(*scan_find_any)(const char *string, char a, char b, char c) = resolve_find_any;
+size_t (*scan_line_starts)(const char *string, size_t length, uint32_t base, uint32_t *starts) = resolve_line_starts;
+const char *scan_kernel_name = "unresolved";
+
+static pthread_once_t kernels_resolved = PTHREAD_ONCE_INIT;
+
+void scan_select_kernels(enum ScanKernelSet which)
+{
+#ifdef SCAN_X86
+    __builtin_cpu_init();
+
+    if (which == SKBEST)
+        which = __builtin_cpu_supports("avx2") ? SKAVX2
+              : __builtin_cpu_supports("sse2") ? SKSSE2
+              : SKSCALAR;
+
+    if (which == SKAVX2 && __builtin_cpu_supports("avx2")) {
+        scan_skip_whitespace = skip_whitespace_avx2;
+        scan_skip_identifier = skip_identifier_avx2;
+        scan_find_any = find_any_avx2;
+        scan_line_starts = line_starts_avx2;
+        scan_kernel_name = "avx2";
+        return;
+    }
+
+    if (which == SKSSE2 && __builtin_cpu_supports("sse2")) {
+        scan_skip_whitespace = skip_whitespace_sse2;
+        scan_skip_identifier = skip_identifier_sse2;
+        scan_find_any = find_any_sse2;
+        scan_line_starts = line_starts_sse2;
+        scan_kernel_name = "sse2";
+        return;
+    }
+#endif
+
+    scan_skip_whitespace = skip_whitespace_scalar;
+    scan_skip_identifier = skip_identifier_scalar;
+    scan_find_any = find_any_scalar;
+    scan_line_starts = line_starts_scalar;
+    scan_kernel_name = "scalar";
+}
+
+/**Picks the best kernels, unless scan_select_kernels already picked some.
+ */
+static void select_best_kernels(void)
+{
+    if (scan_skip_whitespace == resolve_skip_whitespace)
+        scan_select_kernels(SKBEST);
+}
+
+void scan_resolve_kernels(void)
+{
+    pthread_once(&kernels_resolved, select_best_kernels);
+}
+
+const char *resolve_skip_whitespace(const char *string)
+{
+    scan_resolve_kernels();
+    return scan_skip_whitespace(string);
+}
+
+const char *resolve_skip_identifier(const char *string)
+{
+    scan_resolve_kernels();
+    return scan_skip_identifier(string);
+}
+
+const char *resolve_find_any(const char *string, char a, char b, char c)
+{
+    scan_resolve_kernels();
+    return scan_find_any(string, a, b, c);
+}
+
+size_t resolve_line_starts(const char *string, size_t length, uint32_t base, uint32_t *starts)
+{
+    scan_resolve_kernels();
+    return scan_line_starts(string, length, base, starts);
+}
@@ -0,0 +1,206 @@
+#define _DEFAULT_SOURCE // mmap flags and madvise
+
+#include "compile.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* Regular files are mapped rather than read.  To guarantee the zero tail the
+ * scanners rely on, a read-only anonymous region one page longer than needed
+ * is reserved first and the file is mapped over the start of it: the rest of
+ * the file's last page is zero-filled by the kernel, and the extra page after
+ * it is anonymous zero memory.  That holds even when the file is an exact
+ * multiple of the page size, where mapping the file alone would leave no
+ * room for a terminator.
+ *
+ * Anything that can't be mapped (pipes, stdin, empty files) is read into a
+ * heap buffer with the same padding.
+ */
+
+#define READ_CHUNK_SIZE (64 * 1024)
+
+// bytes scanned into the line table at a time
+#define LINE_CHUNK_SIZE (64 * 1024)
+
+static int map_file(int fd, size_t size, struct SourceFile *out)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t file_pages = (size + page - 1) / page * page;
+    size_t length = file_pages + page; // SOURCE_PADDING <= page
+
+    char *region = mmap(NULL, length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+        return EXIT_FAILURE;
+
+    if (mmap(region, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(region, length);
+        return EXIT_FAILURE;
+    }
+
+    madvise(region, file_pages, MADV_SEQUENTIAL);
+
+    *out = (struct SourceFile) {
+        .data = region,
+        .length = size,
+        .allocation = region,
+        .mapping_length = length,
+    };
+
+    return EXIT_SUCCESS;
+}
+
+static int read_stream(int fd, struct SourceFile *out)
+{
+    size_t length = 0, capacity = READ_CHUNK_SIZE;
+    char *data = malloc(capacity + SOURCE_PADDING);
+
+    if (data == NULL)
+        return EXIT_FAILURE;
+
+    while (true) {
+        if (capacity - length < READ_CHUNK_SIZE) {
+            char *bigger = realloc(data, (capacity *= 2) + SOURCE_PADDING);
+            if (bigger == NULL) {
+                free(data);
+                return EXIT_FAILURE;
+            }
+            data = bigger;
+        }
+
+        ssize_t got = read(fd, &data[length], capacity - length);
+
+        if (got == 0)
+            break;
+
+        if (got < 0) {
+            if (errno == EINTR)
+                continue;
+            free(data);
+            return EXIT_FAILURE;
+        }
+
+        length += got;
+    }
+
+    memset(&data[length], 0, SOURCE_PADDING);
+
+    *out = (struct SourceFile) {
+        .data = data,
+        .length = length,
+        .allocation = data,
+    };
+
+    return EXIT_SUCCESS;
+}
+
+int source_load(const char *name, struct SourceFile *out)
+{
+    bool is_stdin = strcmp(name, "-") == 0;
+    int fd = is_stdin ? STDIN_FILENO : open(name, O_RDONLY);
+    int result = EXIT_FAILURE;
+    struct stat st;
+
+    if (fd < 0)
+        return EXIT_FAILURE;
+
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0
+            && map_file(fd, st.st_size, out) == EXIT_SUCCESS)
+        result = EXIT_SUCCESS;
+    else
+        result = read_stream(fd, out);
+
+    if (!is_stdin)
+        close(fd);
+
+    return result;
+}
+
+void source_free(struct SourceFile *source)
+{
+    line_table_free(&source->lines);
+
+    if (source->mapping_length != 0)
+        munmap(source->allocation, source->mapping_length);
+    else
+        free(source->allocation);
+
+    *source = (struct SourceFile) {0};
+}
+
+/**Builds the table in a single pass over the text, a chunk at a time.
+ * Before each chunk the table is grown, if need be, to hold a line start for
+ * every byte of it; so it starts out sized for lines of about 32 bytes and
+ * is cut down to what it holds at the end.
+ */
+int line_table_build(const char *text, size_t length, struct LineTable *out)
+{
+    size_t count = 1, capacity = 1 + length / 32;
+    uint32_t *starts = malloc(capacity * sizeof *starts);
+
+    if (starts == NULL)
+        return EXIT_FAILURE;
+
+    starts[0] = 0;
+
+    for (size_t at = 0; at < length; at += LINE_CHUNK_SIZE) {
+        size_t chunk = length - at < LINE_CHUNK_SIZE ? length - at : LINE_CHUNK_SIZE;
+
+        if (count + chunk > capacity) {
+            capacity = capacity * 2 > count + chunk ? capacity * 2 : count + chunk;
+            uint32_t *bigger = realloc(starts, capacity * sizeof *starts);
+            if (bigger == NULL) {
+                free(starts);
+                return EXIT_FAILURE;
+            }
+            starts = bigger;
+        }
+
+        count += scan_line_starts(&text[at], chunk, at, &starts[count]);
+    }
+
+    // shrinking can't fail in a way that matters: the bigger block is kept
+    uint32_t *fitted = realloc(starts, count * sizeof *starts);
+
+    *out = (struct LineTable) { .starts = fitted != NULL ? fitted : starts, .count = count };
+
+    return EXIT_SUCCESS;
+}
+
+void line_table_free(struct LineTable *table)
+{
+    free(table->starts);
+    *table = (struct LineTable) {0};
+}
+
+struct SourcePosition line_table_position(const struct LineTable *table, size_t offset)
+{
+    // find the last line starting at or before offset
+    size_t low = 0, high = table->count;
+
+    while (high - low > 1) {
+        size_t middle = low + (high - low) / 2;
+        if (table->starts[middle] <= offset)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    return (struct SourcePosition) {
+        .line = low + 1,
+        .column = offset - table->starts[low] + 1,
+    };
+}
+
+struct SourcePosition source_position(struct SourceFile *source, size_t offset)
+{
+    if (source->lines.starts == NULL
+            && line_table_build(source->data, source->length, &source->lines) != EXIT_SUCCESS)
+        return (struct SourcePosition) {0};
+
+    return line_table_position(&source->lines, offset);
+}
@@ -0,0 +1,235 @@
+#include "compile.h"
+
+#include <string.h>
+
+/* The output is always the source with pieces cut out, so a map is fed the
+ * runs of source text that were copied, in order, and works out where each
+ * lands from the line table: a run's text keeps its line breaks, so a
+ * position in it is on the line it started on plus the lines it has crossed,
+ * and its column only shifts on the run's first line.  Both the tokens and
+ * the line table are walked forward with cursors, never searched.  Text
+ * written in place of source, a folded value, maps to where that started.
+ *
+ * Columns count UTF-16 code units, as browsers do, rather than bytes.  The
+ * offsets asked about only go forward, so the count is carried on from the
+ * last one on the same line instead of starting again from its start.
+ *
+ * Each segment is written as soon as it's found, delta encoded against the
+ * one before, into the text of the mappings field.
+ */
+
+// the worst case for a segment: a comma and four values of seven digits
+#define SEGMENT_MAX_LENGTH 29
+
+// base64 digits; those in the upper half carry the continuation bit
+static const char vlq_digits[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+void source_map_init(struct SourceMap *map, const struct TokenBuffer *tokens, const struct LineTable *lines,
+                     uint8_t detail)
+{
+    *map = (struct SourceMap) { .tokens = tokens, .lines = lines, .detail = detail, .column_line = SIZE_MAX };
+}
+
+void source_map_free(struct SourceMap *map)
+{
+    output_buffer_free(&map->mappings);
+}
+
+static char *encode_vlq(char *to, int64_t value)
+{
+    // the sign goes in the lowest bit
+    uint64_t bits = value < 0 ? (uint64_t)-value << 1 | 1 : (uint64_t)value << 1;
+
+    do {
+        uint64_t digit = bits & 31;
+        bits >>= 5;
+        *to++ = vlq_digits[digit | (bits != 0) << 5];
+    } while (bits != 0);
+
+    return to;
+}
+
+/**The index of the line holding offset, which mustn't come before the last
+ * offset asked about.
+ */
+static size_t line_of(struct SourceMap *map, size_t offset)
+{
+    while (map->line + 1 < map->lines->count && map->lines->starts[map->line + 1] <= offset)
+        ++map->line;
+
+    return map->line;
+}
+
+/**The UTF-16 code units in length bytes of UTF-8: one for each byte that
+ * starts a character, and a second for those past U+FFFF, which take a
+ * surrogate pair.
+ */
+static uint32_t utf16_length(const char *text, size_t length)
+{
+    uint32_t units = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = text[i];
+        units += (c & 0xc0) != 0x80;
+        units += c >= 0xf0;
+    }
+
+    return units;
+}
+
+/**The column of offset, which is on line i and mustn't come before the last
+ * offset asked about.
+ */
+static uint32_t column_of(struct SourceMap *map, size_t i, size_t offset)
+{
+    if (map->column_line != i) {
+        map->column_line = i;
+        map->column_offset = map->lines->starts[i];
+        map->column = 0;
+    }
+
+    map->column += utf16_length(map->tokens->source + map->column_offset, offset - map->column_offset);
+    map->column_offset = offset;
+
+    return map->column;
+}
+
+static void add_segment(struct SourceMap *map, uint32_t generated_line, uint32_t generated_column,
+                        uint32_t source_line, uint32_t source_column)
+{
+    struct OutputBuffer *out = &map->mappings;
+    size_t new_lines = generated_line - map->mapped_line;
+
+    if (output_reserve(out, out->length + new_lines + SEGMENT_MAX_LENGTH) != EXIT_SUCCESS) {
+        map->failed = true;
+        return;
+    }
+
+    char *to = out->data + out->length;
+
+    if (new_lines > 0) {
+        memset(to, ';', new_lines);
+        to += new_lines;
+        map->mapped_line = generated_line;
+        map->previous_column = 0;
+    } else if (map->line_mapped) {
+        *to++ = ',';
+    }
+
+    // there's only ever the one source, so its index is always 0
+    to = encode_vlq(to, (int64_t)generated_column - map->previous_column);
+    *to++ = 'A';
+    to = encode_vlq(to, (int64_t)source_line - map->previous_source_line);
+    to = encode_vlq(to, (int64_t)source_column - map->previous_source_column);
+
+    out->length = to - out->data;
+    map->line_mapped = true;
+    map->previous_column = generated_column;
+    map->previous_source_line = source_line;
+    map->previous_source_column = source_column;
+}
+
+void source_map_add_run(struct SourceMap *map, size_t start, size_t end)
+{
+    const struct TokenBuffer *tokens = map->tokens;
+    const uint32_t *starts = map->lines->starts;
+    size_t first_line;
+    uint32_t line = map->generated_line, column = map->generated_column, start_column;
+
+    if (end <= start || map->failed)
+        return;
+
+    first_line = line_of(map, start);
+    start_column = column_of(map, first_line, start);
+
+    if (map->detail == MDLINES) {
+        // a segment for the first line of the run, unless it's been mapped,
+        // and one for the start of each line after it
+        if (!map->line_mapped || map->mapped_line != line)
+            add_segment(map, line, column, first_line, start_column);
+
+        for (size_t i = first_line + 1; i < map->lines->count && starts[i] < end; i++)
+            add_segment(map, line + (i - first_line), 0, i, 0);
+    } else {
+        while (map->token < tokens->count && tokens->starts[map->token] < start)
+            ++map->token;
+
+        for (; map->token < tokens->count && tokens->starts[map->token] < end; ++map->token) {
+            size_t offset = tokens->starts[map->token], i = line_of(map, offset);
+            uint32_t source_column = column_of(map, i, offset);
+
+            if (i == first_line)
+                add_segment(map, line, column + (source_column - start_column), i, source_column);
+            else
+                add_segment(map, line + (i - first_line), source_column, i, source_column);
+        }
+    }
+
+    size_t last_line = line_of(map, end);
+    uint32_t end_column = column_of(map, last_line, end);
+    map->generated_line = line + (last_line - first_line);
+    map->generated_column = last_line == first_line ? column + (end_column - start_column) : end_column;
+}
+
+void source_map_add_text(struct SourceMap *map, size_t start, const char *text, size_t length)
+{
+    if (length == 0 || map->failed)
+        return;
+
+    // the text is mapped as a whole to where what it replaces started
+    size_t line = line_of(map, start);
+    if (map->detail == MDTOKENS || !map->line_mapped || map->mapped_line != map->generated_line)
+        add_segment(map, map->generated_line, map->generated_column, line, column_of(map, line, start));
+
+    map->generated_column += utf16_length(text, length);
+}
+
+/**Appends a JSON string holding text, with control characters escaped.
+ */
+static int append_json_string(struct OutputBuffer *out, const char *text)
+{
+    static const char hex_digits[16] = "0123456789abcdef";
+    int result = output_append(out, "\"", 1);
+
+    for (; *text != '\0' && result == EXIT_SUCCESS; text++) {
+        unsigned char c = *text;
+
+        if (c < 0x20) {
+            char escape[6] = { '\\', 'u', '0', '0', hex_digits[c >> 4], hex_digits[c & 15] };
+            result = output_append(out, escape, sizeof escape);
+            continue;
+        }
+        if (c == '"' || c == '\\')
+            result = output_append(out, "\\", 1);
+        if (result == EXIT_SUCCESS)
+            result = output_append(out, text, 1);
+    }
+
+    return result == EXIT_SUCCESS ? output_append(out, "\"", 1) : result;
+}
+
+int source_map_write(int fd, const struct SourceMap *map, const char *source_name)
+{
+    static const char head[] = "{\"version\":3,\"sources\":[";
+    static const char middle[] = "],\"names\":[],\"mappings\":\"";
+    static const char tail[] = "\"}\n";
+    struct OutputBuffer parts[3] = {0};
+    int result = EXIT_FAILURE;
+
+    if (map->failed)
+        return EXIT_FAILURE;
+
+    // the mappings are written from where they were built, between the rest
+    if (output_append(&parts[0], head, sizeof head - 1) == EXIT_SUCCESS
+            && append_json_string(&parts[0], source_name) == EXIT_SUCCESS
+            && output_append(&parts[0], middle, sizeof middle - 1) == EXIT_SUCCESS
+            && output_append(&parts[2], tail, sizeof tail - 1) == EXIT_SUCCESS) {
+        parts[1] = map->mappings;
+        result = output_write(fd, parts, 3);
+    }
+
+    output_buffer_free(&parts[0]);
+    output_buffer_free(&parts[2]);
+
+    return result;
+}
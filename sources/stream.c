@@ -0,0 +1,485 @@
+#include "compile.h"
+
+#include <assert.h>
+#include <string.h>
+
+/* The streaming lexer keeps a fixed-size window of the input.  Whenever more
+ * input is reserved, the unconsumed tail (at most one partial token) is moved
+ * to the front of the window, so a token is always contiguous in memory and
+ * the window never grows.  The window is kept NUL terminated so lex_token and
+ * the scanning kernels can run over it unchanged.
+ *
+ * A token that touches the end of the window might continue in the next
+ * chunk (an identifier, "=" before "=", an unterminated string), so until
+ * lexer_finish is called such tokens are not returned.  Comments can be longer
+ * than the window, so they are skipped incrementally instead.
+ */
+
+enum LexerTrivia {
+    LTNONE = 0,
+    LTLINECOMMENT,
+    LTBLOCKCOMMENT,
+};
+
+int lexer_init(struct Lexer *lexer, size_t capacity, struct Interner *interner)
+{
+    *lexer = (struct Lexer) {0};
+
+    if ((lexer->window = malloc(capacity + 1)) == NULL)
+        return EXIT_FAILURE;
+
+    lexer->window[0] = '\0';
+    lexer->capacity = capacity;
+    lexer->interner = interner;
+
+    return EXIT_SUCCESS;
+}
+
+void lexer_free(struct Lexer *lexer)
+{
+    free(lexer->window);
+    *lexer = (struct Lexer) {0};
+}
+
+char *lexer_reserve(struct Lexer *lexer, size_t *space)
+{
+    if (lexer->begin > 0) {
+        memmove(lexer->window, &lexer->window[lexer->begin], lexer->end - lexer->begin);
+        lexer->base += lexer->begin;
+        lexer->end -= lexer->begin;
+        lexer->begin = 0;
+        lexer->window[lexer->end] = '\0';
+    }
+
+    *space = lexer->capacity - lexer->end;
+
+    return &lexer->window[lexer->end];
+}
+
+void lexer_commit(struct Lexer *lexer, size_t length)
+{
+    assert(lexer->end + length <= lexer->capacity);
+
+    lexer->end += length;
+    lexer->window[lexer->end] = '\0';
+}
+
+void lexer_finish(struct Lexer *lexer)
+{
+    lexer->finished = true;
+}
+
+/**Either more input is needed, or if the window is already full of a single
+ * token, nothing more can be done.
+ */
+static enum LexerStatus need_input(const struct Lexer *lexer)
+{
+    return lexer->begin == 0 && lexer->end == lexer->capacity ? LSERROR : LSNEEDINPUT;
+}
+
+/**Skips as much of the current comment as is in the window.
+ *
+ * Returns true if the comment ended.
+ */
+static bool skip_comment(struct Lexer *lexer)
+{
+    char *string = &lexer->window[lexer->begin];
+
+    if (lexer->trivia == LTLINECOMMENT) {
+        string = (char *)scan_find_any(string, '\n', '\n', '\n');
+        lexer->begin = string - lexer->window;
+        return *string == '\n';
+    }
+
+    assert(lexer->trivia == LTBLOCKCOMMENT);
+
+    const char *start = string;
+    bool ended = false;
+
+    while (*(string = (char *)scan_find_any(string, '*', '*', '*')) != '\0') {
+        if (string[1] == '\0')
+            break; // keep the '*', it might be the start of "*/"
+
+        if (string[1] == '/') {
+            string += 2;
+            ended = true;
+            break;
+        }
+
+        ++string;
+    }
+
+    // a block comment with a line break in it counts as one
+    if (memchr(start, '\n', string - start) != NULL)
+        lexer->newline = true;
+
+    lexer->begin = string - lexer->window;
+    return ended;
+}
+
+/**Whether the string starting at contents has a line break before end that
+ * isn't escaped, which ends it however much more input there is.
+ */
+static bool string_breaks_line(const char *contents, const char *end)
+{
+    for (const char *c = contents + 1; c < end; c++) {
+        if (*c == '\\')
+            c += c + 2 < end && c[1] == '\r' && c[2] == '\n' ? 2 : 1;
+        else if (*c == '\n')
+            return true;
+    }
+
+    return false;
+}
+
+enum LexerStatus lexer_next(struct Lexer *lexer, struct LexedToken *out)
+{
+    while (true) {
+        if (lexer->trivia != LTNONE) {
+            if (skip_comment(lexer))
+                lexer->trivia = LTNONE;
+            else if (!lexer->finished)
+                return need_input(lexer);
+            else {
+                // unterminated, which tokenise_file also lets through
+                lexer->trivia = LTNONE;
+                lexer->begin = lexer->end;
+            }
+        }
+
+        if (lexer->begin == lexer->end)
+            return lexer->finished ? LSEND : LSNEEDINPUT;
+
+        const char *contents = &lexer->window[lexer->begin];
+
+        if (strncmp(contents, "//", 2) == 0) {
+            lexer->trivia = LTLINECOMMENT;
+            lexer->begin += 2;
+            continue;
+        } else if (strncmp(contents, "/*", 2) == 0) {
+            lexer->trivia = LTBLOCKCOMMENT;
+            lexer->begin += 2;
+            continue;
+        }
+
+        enum TokenType ttype = TTNONE;
+        uint32_t hash = 0, symbol = SYMBOL_NONE;
+        const char *end = lex_token(contents, &ttype, &hash);
+
+        if (end == NULL) {
+            // an unterminated string is only an error once we know it has hit
+            // a newline or the real end of the input
+            const char *window_end = &lexer->window[lexer->end];
+            bool broken = *contents == '"' || *contents == '\''
+                        ? string_breaks_line(contents, window_end)
+                        : memchr(contents, '\n', window_end - contents) != NULL;
+            if (!lexer->finished && !broken)
+                return need_input(lexer);
+            return LSERROR;
+        }
+
+        if (ttype == TTNONE) {
+            // whitespace can be consumed piecemeal
+            if (memchr(contents, '\n', end - contents) != NULL)
+                lexer->newline = true;
+            lexer->begin = end - lexer->window;
+            continue;
+        }
+
+        // a token touching the end of the window might carry on into the next
+        // chunk, and so might a short punctuator (".." before ".")
+        if (!lexer->finished && (end == &lexer->window[lexer->end]
+                || (size_t)(&lexer->window[lexer->end] - contents) < LEXER_LOOKAHEAD))
+            return need_input(lexer);
+
+        // only intern once the identifier is known to be complete
+        if (ttype == TTIDENTIFIER && (symbol = intern(lexer->interner, contents, end - contents, hash)) == SYMBOL_NONE)
+            return LSERROR;
+
+        *out = (struct LexedToken) {
+            .type = ttype,
+            .symbol = symbol,
+            .offset = lexer->base + lexer->begin,
+            .view = { .data = contents, .length = end - contents },
+            .newline = lexer->newline,
+        };
+        lexer->begin = end - lexer->window;
+        lexer->newline = false;
+
+        return LSREADY;
+    }
+}
+
+void statement_tokens_free(struct StatementTokens *statement)
+{
+    token_buffer_free(&statement->tokens);
+    free(statement->text);
+    *statement = (struct StatementTokens) {0};
+}
+
+static bool is_word(const struct TokenBuffer *tokens, size_t i, const char *word)
+{
+    struct StringView view = token_view(tokens, i);
+
+    return token_type(tokens, i) == TTIDENTIFIER && view.length == strlen(word)
+        && memcmp(view.data, word, view.length) == 0;
+}
+
+/**Whether the statement ends at the '}' that closes its body, which is
+ * decided by its first token once any modifiers and labels are skipped:
+ * "export", "default", "declare", "abstract", "async" before "function", and
+ * "const" before "enum".
+ */
+static bool ends_with_block(const struct TokenBuffer *tokens)
+{
+    size_t i = 0;
+    bool exported = false;
+
+    for (; i < tokens->count; i++) {
+        enum TokenType ttype = token_type(tokens, i);
+        enum TokenType next = i + 1 < tokens->count ? token_type(tokens, i + 1) : TTNONE;
+
+        if (ttype == TTEXPORT || ttype == TTDEFAULT)
+            exported = true;
+        else if (ttype == TTIDENTIFIER && next == TTCOLON)
+            ++i; // a label
+        else if (!(is_word(tokens, i, "declare") || is_word(tokens, i, "abstract")
+                   || (is_word(tokens, i, "async") && next == TTFUNCTION)
+                   || (ttype == TTCONST && next == TTENUM)))
+            break;
+    }
+
+    if (i == tokens->count)
+        return false;
+
+    switch (token_type(tokens, i)) {
+    case TTFUNCTION:
+    case TTINTERFACE:
+    case TTCLASS:
+    case TTENUM:
+    case TTIF:
+    case TTFOR:
+    case TTWHILE:
+    case TTTRY:
+    case TTSWITCH:
+        return true;
+    case TTOPENBRACE:
+        return !exported; // "export { a }" goes on to a ";" or "from"
+    case TTIDENTIFIER:
+        // "namespace N {" and "module 'm' {"
+        return (is_word(tokens, i, "namespace") || is_word(tokens, i, "module")) && i + 1 < tokens->count
+            && (token_type(tokens, i + 1) == TTIDENTIFIER || token_type(tokens, i + 1) == TTSINGLESTRING
+                || token_type(tokens, i + 1) == TTDOUBLESTRING);
+    default:
+        return false;
+    }
+}
+
+/**Whether a token after where the statement could have ended carries it on:
+ * the rest of an if or try, the "while" of a do-while whose body was a
+ * single statement, or a ";" after a closing '}'.
+ */
+static bool continues_statement(const struct StatementTokens *statement, enum TokenType next)
+{
+    switch (next) {
+    case TTELSE:
+    case TTCATCH:
+    case TTFINALLY:
+        return true;
+    case TTWHILE:
+        return statement->dos > statement->whiles;
+    case TTSEMICOLON:
+        return token_type(&statement->tokens, statement->tokens.count - 1) == TTCLOSEBRACE;
+    default:
+        return false;
+    }
+}
+
+/**Whether a statement could end after a token of this type, were a line
+ * break to follow it.  Only tokens that end an expression or a jump can, and
+ * '>' is left out as it could be an operator as well as closing type
+ * arguments.
+ */
+static bool ends_expression(enum TokenType ttype)
+{
+    switch (ttype) {
+    case TTIDENTIFIER:
+    case TTNUMLITERAL:
+    case TTSINGLESTRING:
+    case TTDOUBLESTRING:
+    case TTTEMPLATESTRING:
+    case TTREGEXP:
+    case TTTHIS:
+    case TTSUPER:
+    case TTTRUE:
+    case TTFALSE:
+    case TTNULL:
+    case TTCLOSEPAREN:
+    case TTCLOSEBRACKET:
+    case TTCLOSEBRACE:
+    case TTINCREMENT:
+    case TTDECREMENT:
+    case TTBREAK:
+    case TTCONTINUE:
+    case TTRETURN:
+    case TTDEBUGGER:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**Whether a token of this type, at the start of a line, carries on the
+ * expression before it: a binary or assignment operator, a call, an index, a
+ * member access or a tagged template.  "as" and "extends" can't follow a
+ * line break in an expression or a type, so they don't.
+ */
+static bool continues_expression(enum TokenType ttype)
+{
+    switch (ttype) {
+    case TTBANG:
+    case TTBITNOT:
+    case TTINCREMENT:
+    case TTDECREMENT:
+    case TTSPREAD:
+        return false;
+    case TTIN:
+    case TTINSTANCEOF:
+    case TTTEMPLATESTRING:
+    case TTREGEXP: // a "/" the lexer took for the start of a regular expression
+    case TTSEMICOLON:
+    case TTOPENPAREN:
+    case TTOPENBRACE: // "function ()" and "class C" then their body
+    case TTOPENBRACKET:
+    case TTCOLON:
+    case TTCOMMA:
+        return true;
+    default:
+        return ttype >= TTIDENT && ttype <= TTSPREAD;
+    }
+}
+
+/**Whether automatic semicolon insertion ends the statement before token,
+ * which is on a new line.  A statement that ends with a block goes on until
+ * that block closes, as does a "do" until its "while".
+ */
+static bool inserts_semicolon(const struct StatementTokens *statement, const struct LexedToken *token)
+{
+    if (!token->newline || statement->depth != 0 || statement->tokens.count == 0)
+        return false;
+
+    enum TokenType last = token_type(&statement->tokens, statement->tokens.count - 1);
+
+    if (!ends_expression(last) || statement->dos > statement->whiles || ends_with_block(&statement->tokens))
+        return false;
+
+    // "return", "break" and the like, and a "++" or "--" after them, take
+    // nothing from the next line
+    return last == TTRETURN || last == TTBREAK || last == TTCONTINUE || last == TTDEBUGGER
+        || !continues_expression(token->type);
+}
+
+static int append_token(struct StatementTokens *statement, const struct LexedToken *token)
+{
+    // tokens that were apart in the input stay apart, so "let a" isn't "leta"
+    size_t gap = statement->tokens.count > 0 && token->offset > statement->end;
+
+    if (statement->text_length + gap + token->view.length > statement->text_capacity) {
+        size_t capacity = statement->text_capacity ? statement->text_capacity : 256;
+        while (capacity < statement->text_length + gap + token->view.length)
+            capacity *= 2;
+
+        char *text = realloc(statement->text, capacity);
+        if (text == NULL) return EXIT_FAILURE;
+
+        statement->text = text;
+        statement->text_capacity = capacity;
+        statement->tokens.source = text;
+    }
+
+    if (gap)
+        statement->text[statement->text_length++] = token->newline ? '\n' : ' ';
+
+    memcpy(&statement->text[statement->text_length], token->view.data, token->view.length);
+
+    if (token_buffer_push(&statement->tokens, token->type, statement->text_length, token->view.length, token->symbol) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    statement->text_length += token->view.length;
+    statement->end = token->offset + token->view.length;
+
+    return EXIT_SUCCESS;
+}
+
+enum LexerStatus lexer_next_statement(struct Lexer *lexer, struct StatementTokens *statement)
+{
+    if (statement->complete) {
+        statement->tokens.count = 0;
+        statement->text_length = 0;
+        statement->depth = 0;
+        statement->dos = 0;
+        statement->whiles = 0;
+        statement->ended = false;
+        statement->complete = false;
+    }
+
+    while (true) {
+        struct LexedToken token;
+        enum LexerStatus status = lexer_next(lexer, &token);
+
+        if (status == LSEND && statement->tokens.count > 0) {
+            // trailing statement with no terminator
+            statement->complete = true;
+            return LSREADY;
+        } else if (status != LSREADY) {
+            return status;
+        }
+
+        if (statement->ended && continues_statement(statement, token.type))
+            statement->ended = false;
+
+        if (statement->ended || inserts_semicolon(statement, &token)) {
+            // the token starts the next statement, so it's read again then
+            lexer->begin = token.offset - lexer->base;
+            lexer->newline = token.newline;
+            statement->complete = true;
+            return LSREADY;
+        }
+
+        if (statement->tokens.count == 0)
+            statement->offset = token.offset;
+
+        if (append_token(statement, &token) != EXIT_SUCCESS)
+            return LSERROR;
+
+        // the statement could end at a ";" or '}' at depth 0, but until the
+        // next token is seen it might yet go on
+        switch (token.type) {
+        case TTOPENPAREN:
+        case TTOPENBRACKET:
+        case TTOPENBRACE:
+            ++statement->depth;
+            break;
+        case TTCLOSEPAREN:
+        case TTCLOSEBRACKET:
+            --statement->depth;
+            break;
+        case TTCLOSEBRACE:
+            if (--statement->depth == 0 && ends_with_block(&statement->tokens))
+                statement->ended = true;
+            break;
+        case TTSEMICOLON:
+            if (statement->depth == 0)
+                statement->ended = true;
+            break;
+        case TTDO:
+            statement->dos += statement->depth == 0;
+            break;
+        case TTWHILE:
+            statement->whiles += statement->depth == 0;
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,1063 @@
+#include "compile.h"
+
+#include <string.h>
+
+/* The stripper makes one pass over the tokens with a stack of scopes, one per
+ * open bracket, which know just enough to tell a type from a value: whether
+ * a brace holds statements, class members or properties, whether a
+ * parenthesis holds parameters, and how far through a declaration or member
+ * it has got.  A type, once found, is skipped by its shape (skip_type),
+ * without building anything.
+ *
+ * What's removed is cut from the first byte of its first token to the last
+ * byte of its last, so the whitespace and comments around it stay.  A cast
+ * is also cut from the end of what it casts, so no space is left before the
+ * semicolon.  What's left between the cuts is a span of the source.
+ *
+ * Brackets are matched in a first pass over the token types, so an arrow
+ * function's parameters can be told from a parenthesised expression by
+ * looking past the closing parenthesis.
+ */
+
+#define STRIP_INITIAL_CAPACITY 256
+
+// what skip_type and friends give back for something they can't skip
+#define NOT_A_TYPE UINT32_MAX
+
+enum StripScope {
+    SSBLOCK = 0,        // statements, and the top level
+    SSCLASS,            // class members
+    SSOBJECT,           // properties, or a destructuring pattern
+    SSPARAMETERS,
+    SSPARENTHESES,
+    SSBRACKETS,
+};
+
+enum Declaring {
+    DGNONE = 0,
+    DGTARGET,           // after let, const, var or a comma: the name is next
+    DGNAMED,            // after the name: an annotation may follow
+    DGVALUE,            // in the initialiser
+};
+
+struct Scope {
+    uint8_t kind;
+    uint8_t declaring;  // for let, const and var directly in this scope
+    bool value;         // past a property's colon, in a field's initialiser
+                        // or in a parameter's default
+    bool class_next;    // the next brace at this level is a class body
+    bool body_next;     // the next brace at this level is a function body
+    bool control;       // parentheses after if, for, while, with or switch
+    uint32_t colons;    // ?s and cases kept here that are waiting for a :
+    uint32_t member;    // a class's current member: its first token
+    uint32_t start;     // parameters: the first token of their function
+    size_t span_count;  // parameters: the spans and kept offset at start,
+    uint32_t kept;      // for cutting an overload out after the fact, and
+                        // a class: the same at its current member's start
+};
+
+struct Stripper {
+    const struct TokenBuffer *tokens;
+    struct SpanBuffer *spans;
+    size_t length;
+    uint32_t *partners;         // each bracket's match
+    struct Scope *scopes;
+    size_t scope_count, scope_capacity;
+    uint32_t kept;              // where the text not yet kept or cut starts
+    uint32_t last;              // the last token kept, or UINT32_MAX
+    uint32_t control_close;     // the ) closing the last control parentheses
+    bool parameters_next;       // the next ( opens a function's parameters
+    uint32_t function_start;    // and the first token of that function
+    bool module_clause;         // in import or export braces, where as renames
+    size_t error_token;
+    bool failed;
+};
+
+void span_buffer_free(struct SpanBuffer *spans)
+{
+    free(spans->spans);
+    *spans = (struct SpanBuffer) {0};
+}
+
+static uint8_t type_at(const struct Stripper *s, uint32_t i)
+{
+    return i < s->tokens->count ? s->tokens->types[i] : TTNONE;
+}
+
+static uint32_t token_end(const struct Stripper *s, uint32_t i)
+{
+    return s->tokens->starts[i] + s->tokens->lengths[i];
+}
+
+static bool is_word(const struct Stripper *s, uint32_t i, const char *word)
+{
+    size_t length = strlen(word);
+
+    return type_at(s, i) == TTIDENTIFIER && s->tokens->lengths[i] == length
+        && memcmp(s->tokens->source + s->tokens->starts[i], word, length) == 0;
+}
+
+/**Whether a line break comes between token i and the one before it.
+ */
+static bool newline_before(const struct Stripper *s, uint32_t i)
+{
+    uint32_t from = i > 0 ? token_end(s, i - 1) : 0;
+    uint32_t to = i < s->tokens->count ? s->tokens->starts[i] : s->length;
+
+    return memchr(s->tokens->source + from, '\n', to - from) != NULL;
+}
+
+static bool is_name(uint8_t type)
+{
+    // keywords are names after a dot, in types and as properties
+    return type == TTIDENTIFIER || (type > TTNONE && type <= TTYIELD);
+}
+
+static bool is_literal(uint8_t type)
+{
+    return type == TTSINGLESTRING || type == TTDOUBLESTRING || type == TTTEMPLATESTRING || type == TTNUMLITERAL;
+}
+
+/**Whether a token can end an operand, so that what follows it is an
+ * operator: a postfix ! or a cast, rather than a prefix !.
+ */
+static bool ends_operand(const struct Stripper *s, uint32_t i)
+{
+    uint8_t type = type_at(s, i);
+
+    if (i == UINT32_MAX || i == s->control_close)
+        return false;
+
+    return type == TTIDENTIFIER || is_literal(type) || type == TTCLOSEPAREN || type == TTCLOSEBRACKET
+        || type == TTCLOSEBRACE || type == TTTHIS || type == TTSUPER || type == TTTRUE || type == TTFALSE
+        || type == TTNULL;
+}
+
+/* Spans */
+
+static void fail(struct Stripper *s, uint32_t token)
+{
+    if (!s->failed)
+        s->error_token = token < s->tokens->count ? token : s->tokens->count;
+    s->failed = true;
+}
+
+static void keep_to(struct Stripper *s, uint32_t end)
+{
+    struct SpanBuffer *spans = s->spans;
+
+    if (end <= s->kept)
+        return;
+
+    // a run of bytes kept straight after the last is kept in the same span
+    if (spans->count > 0 && spans->spans[spans->count - 1].start + spans->spans[spans->count - 1].length == s->kept) {
+        spans->spans[spans->count - 1].length += end - s->kept;
+        s->kept = end;
+        return;
+    }
+
+    if (spans->count == spans->capacity) {
+        size_t capacity = spans->capacity ? spans->capacity * 2 : STRIP_INITIAL_CAPACITY;
+        struct SourceSpan *resized = realloc(spans->spans, capacity * sizeof *resized);
+        if (resized == NULL) {
+            s->failed = true;
+            return;
+        }
+        spans->spans = resized;
+        spans->capacity = capacity;
+    }
+
+    spans->spans[spans->count++] = (struct SourceSpan) { .start = s->kept, .length = end - s->kept };
+    s->kept = end;
+}
+
+/**Cuts the bytes from start to end out of the output.
+ */
+static void cut(struct Stripper *s, uint32_t start, uint32_t end)
+{
+    keep_to(s, start);
+    if (end > s->kept)
+        s->kept = end;
+}
+
+/**Cuts tokens first to last, inclusive.
+ */
+static void cut_tokens(struct Stripper *s, uint32_t first, uint32_t last)
+{
+    cut(s, s->tokens->starts[first], token_end(s, last));
+}
+
+/* Skipping types */
+
+/**Matches every bracket with its partner, failing on any that don't match.
+ */
+static int match_brackets(struct Stripper *s)
+{
+    const struct TokenBuffer *tokens = s->tokens;
+    uint32_t *stack = malloc((tokens->count ? tokens->count : 1) * sizeof *stack);
+    size_t depth = 0;
+
+    s->partners = malloc((tokens->count ? tokens->count : 1) * sizeof *s->partners);
+    if (stack == NULL || s->partners == NULL) {
+        free(stack);
+        s->failed = true;
+        return EXIT_FAILURE;
+    }
+
+    for (uint32_t i = 0; i < tokens->count && !s->failed; i++) {
+        uint8_t type = tokens->types[i];
+
+        if (type == TTOPENPAREN || type == TTOPENBRACKET || type == TTOPENBRACE) {
+            stack[depth++] = i;
+        } else if (type == TTCLOSEPAREN || type == TTCLOSEBRACKET || type == TTCLOSEBRACE) {
+            uint8_t opener = type == TTCLOSEPAREN ? TTOPENPAREN : type == TTCLOSEBRACKET ? TTOPENBRACKET : TTOPENBRACE;
+            if (depth == 0 || tokens->types[stack[depth - 1]] != opener) {
+                fail(s, i);
+                break;
+            }
+            s->partners[i] = stack[--depth];
+            s->partners[stack[depth]] = i;
+        }
+    }
+
+    if (depth > 0)
+        fail(s, stack[depth - 1]);
+
+    free(stack);
+
+    return s->failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**Whether a token can be part of a list of type arguments, for telling
+ * f<T>(x) from comparisons.
+ */
+static bool in_type_arguments(uint8_t type)
+{
+    switch (type) {
+    case TTCOMMA:
+    case TTDOT:
+    case TTOPENBRACKET:
+    case TTCLOSEBRACKET:
+    case TTOPENBRACE:
+    case TTCLOSEBRACE:
+    case TTOPENPAREN:
+    case TTCLOSEPAREN:
+    case TTCOLON:
+    case TTSEMICOLON:
+    case TTCONDITIONAL:
+    case TTBITOR:
+    case TTBITAND:
+    case TTARROW:
+    case TTSPREAD:
+    case TTMINUS:
+    case TTLESS:
+    case TTGREATER:
+    case TTBITSHR:
+    case TTBITSHRZERO:
+        return true;
+    default:
+        return is_name(type) || is_literal(type);
+    }
+}
+
+/**Skips <...> from the < at i, counting the >s in >> and >>>.  Strict
+ * skipping gives up on anything that can't be in type arguments.
+ */
+static uint32_t skip_angles(const struct Stripper *s, uint32_t i, bool strict)
+{
+    int depth = 0;
+
+    for (; i < s->tokens->count; i++) {
+        uint8_t type = type_at(s, i);
+
+        if (strict && !in_type_arguments(type))
+            return NOT_A_TYPE;
+
+        switch (type) {
+        case TTLESS:
+            depth++;
+            break;
+        case TTGREATER:
+            depth--;
+            break;
+        case TTBITSHR:
+            depth -= 2;
+            break;
+        case TTBITSHRZERO:
+            depth -= 3;
+            break;
+        case TTOPENPAREN:
+        case TTOPENBRACKET:
+        case TTOPENBRACE:
+            if (!strict)
+                i = s->partners[i];
+            break;
+        case TTCLOSEPAREN:
+        case TTCLOSEBRACKET:
+        case TTCLOSEBRACE:
+        case TTSEMICOLON:
+            // only ever inside brackets that were skipped whole
+            if (!strict)
+                return NOT_A_TYPE;
+            break;
+        default:
+            break;
+        }
+
+        if (depth == 0)
+            return i + 1;
+        if (depth < 0)
+            return NOT_A_TYPE;
+    }
+
+    return NOT_A_TYPE;
+}
+
+static uint32_t skip_type(const struct Stripper *s, uint32_t i);
+
+/**Whether the parenthesis at i opens a function type's parameters rather
+ * than a parenthesised type, which is decided the way tsc does it, by what
+ * starts the first parameter: (), (...a, (a: and the like, or (a) =>.
+ */
+static bool opens_function_type(const struct Stripper *s, uint32_t i)
+{
+    uint8_t next = type_at(s, i + 1);
+    uint32_t j = i + 2;
+
+    if (next == TTCLOSEPAREN || next == TTSPREAD)
+        return true;
+    if (next == TTOPENBRACKET || next == TTOPENBRACE)
+        j = s->partners[i + 1] + 1;
+    else if (!is_name(next))
+        return false;
+
+    switch (type_at(s, j)) {
+    case TTCOLON:
+    case TTCOMMA:
+    case TTCONDITIONAL:
+    case TTASSIGN:
+        return true;
+    case TTCLOSEPAREN:
+        return type_at(s, j + 1) == TTARROW;
+    default:
+        return false;
+    }
+}
+
+static uint32_t skip_operand(const struct Stripper *s, uint32_t i)
+{
+    // prefixes
+    while (is_word(s, i, "keyof") || is_word(s, i, "unique") || is_word(s, i, "readonly") || is_word(s, i, "asserts")) {
+        if (!is_name(type_at(s, i + 1)) && type_at(s, i + 1) != TTOPENPAREN && type_at(s, i + 1) != TTOPENBRACKET
+                && type_at(s, i + 1) != TTOPENBRACE)
+            break;
+        i++;
+    }
+    if (is_word(s, i, "infer") && is_name(type_at(s, i + 1)))
+        i++;
+
+    switch (type_at(s, i)) {
+    case TTOPENPAREN: {
+        // a function type's parameters, or a parenthesised type, which can
+        // be followed by an arrow function's => in a return type
+        uint32_t after = s->partners[i] + 1;
+        if (opens_function_type(s, i))
+            return type_at(s, after) == TTARROW ? skip_type(s, after + 1) : NOT_A_TYPE;
+        if (skip_type(s, i + 1) != after - 1)
+            return NOT_A_TYPE;
+        i = after;
+        break;
+    }
+    case TTLESS: {
+        uint32_t j = skip_angles(s, i, false);
+        if (j == NOT_A_TYPE || type_at(s, j) != TTOPENPAREN || type_at(s, s->partners[j] + 1) != TTARROW)
+            return NOT_A_TYPE;
+        return skip_type(s, s->partners[j] + 2);
+    }
+    case TTNEW: {
+        uint32_t j = i + 1;
+        if (type_at(s, j) == TTLESS && (j = skip_angles(s, j, false)) == NOT_A_TYPE)
+            return NOT_A_TYPE;
+        if (type_at(s, j) != TTOPENPAREN || type_at(s, s->partners[j] + 1) != TTARROW)
+            return NOT_A_TYPE;
+        return skip_type(s, s->partners[j] + 2);
+    }
+    case TTOPENBRACE:
+    case TTOPENBRACKET:
+        i = s->partners[i] + 1;
+        break;
+    case TTMINUS:
+        if (type_at(s, i + 1) != TTNUMLITERAL)
+            return NOT_A_TYPE;
+        i += 2;
+        break;
+    case TTTYPEOF:
+        i++;
+        // fall through
+    default:
+        if (is_literal(type_at(s, i))) {
+            i++;
+            break;
+        }
+        if (!is_name(type_at(s, i)))
+            return NOT_A_TYPE;
+        for (i++; type_at(s, i) == TTDOT && is_name(type_at(s, i + 1)); i += 2)
+            ;
+        if (type_at(s, i) == TTLESS && (i = skip_angles(s, i, false)) == NOT_A_TYPE)
+            return NOT_A_TYPE;
+        // a type predicate
+        if (is_word(s, i, "is") && !newline_before(s, i))
+            return skip_type(s, i + 1);
+        break;
+    }
+
+    // array types and indexed access, which can't start a new line
+    while (type_at(s, i) == TTOPENBRACKET && !newline_before(s, i))
+        i = s->partners[i] + 1;
+
+    return i;
+}
+
+/**The token after the type starting at i, or NOT_A_TYPE.
+ */
+static uint32_t skip_type(const struct Stripper *s, uint32_t i)
+{
+    if (type_at(s, i) == TTBITOR || type_at(s, i) == TTBITAND)
+        i++;
+
+    while ((i = skip_operand(s, i)) != NOT_A_TYPE) {
+        if (type_at(s, i) == TTBITOR || type_at(s, i) == TTBITAND) {
+            i++;
+            continue;
+        }
+
+        // conditional types
+        if (type_at(s, i) == TTEXTENDS) {
+            if ((i = skip_operand(s, i + 1)) == NOT_A_TYPE || type_at(s, i) != TTCONDITIONAL)
+                return NOT_A_TYPE;
+            if ((i = skip_type(s, i + 1)) == NOT_A_TYPE || type_at(s, i) != TTCOLON)
+                return NOT_A_TYPE;
+            return skip_type(s, i + 1);
+        }
+
+        return i;
+    }
+
+    return NOT_A_TYPE;
+}
+
+/**Cuts the annotation whose colon is at i, and returns the token after it.
+ */
+static uint32_t cut_annotation(struct Stripper *s, uint32_t i)
+{
+    uint32_t end = skip_type(s, i + 1);
+
+    if (end == NOT_A_TYPE) {
+        fail(s, i + 1);
+        return s->tokens->count;
+    }
+
+    cut_tokens(s, i, end - 1);
+
+    return end;
+}
+
+/* Statements */
+
+/**The token after a statement that starts at i: the one after its
+ * semicolon, or after the body that ends it.
+ */
+static uint32_t statement_end(const struct Stripper *s, uint32_t i)
+{
+    for (; i < s->tokens->count; i++) {
+        uint8_t type = type_at(s, i);
+
+        if (type == TTSEMICOLON)
+            return i + 1;
+        if (type == TTCLOSEPAREN || type == TTCLOSEBRACKET || type == TTCLOSEBRACE)
+            return i;   // the end of what it's in
+        if (type == TTOPENPAREN || type == TTOPENBRACKET) {
+            i = s->partners[i];
+        } else if (type == TTOPENBRACE) {
+            // an object type goes on; a body is the end
+            uint8_t before = type_at(s, i - 1);
+            if (before != TTCOLON && before != TTASSIGN && before != TTBITOR && before != TTBITAND
+                    && before != TTLESS && before != TTCOMMA && before != TTARROW)
+                return s->partners[i] + 1;
+            i = s->partners[i];
+        }
+    }
+
+    return i;
+}
+
+/**The token after an import or export whose clause starts at i.
+ */
+static uint32_t clause_end(const struct Stripper *s, uint32_t i)
+{
+    if (type_at(s, i) == TTOPENBRACE)
+        i = s->partners[i] + 1;
+    else if (type_at(s, i) == TTMULTIPLY)
+        i = type_at(s, i + 1) == TTAS ? i + 3 : i + 1;
+    else
+        i++;
+
+    // import type X = require("x")
+    if (type_at(s, i) == TTASSIGN)
+        return statement_end(s, i);
+
+    if (is_word(s, i, "from"))
+        i += 2;
+
+    return type_at(s, i) == TTSEMICOLON ? i + 1 : i;
+}
+
+/**If a statement starting at i has only types in it, the token after it,
+ * otherwise i.  Fails on statements that would need code generated for
+ * them.
+ */
+static uint32_t type_statement_end(struct Stripper *s, uint32_t i)
+{
+    uint8_t type = type_at(s, i), next = type_at(s, i + 1);
+
+    if (type == TTINTERFACE && is_name(next)) {
+        uint32_t j = i + 2;
+        while (j < s->tokens->count && type_at(s, j) != TTOPENBRACE)
+            j = type_at(s, j) == TTOPENPAREN || type_at(s, j) == TTOPENBRACKET ? s->partners[j] + 1 : j + 1;
+        return j < s->tokens->count ? s->partners[j] + 1 : j;
+    }
+
+    if (is_word(s, i, "type") && next == TTIDENTIFIER && (type_at(s, i + 2) == TTASSIGN || type_at(s, i + 2) == TTLESS)) {
+        uint32_t j = i + 2;
+        if (type_at(s, j) == TTLESS && (j = skip_angles(s, j, false)) == NOT_A_TYPE)
+            return i;
+        if (type_at(s, j) != TTASSIGN || (j = skip_type(s, j + 1)) == NOT_A_TYPE)
+            return i;
+        return type_at(s, j) == TTSEMICOLON ? j + 1 : j;
+    }
+
+    if (is_word(s, i, "declare") && (is_name(next) || next == TTENUM) && !newline_before(s, i + 1))
+        return statement_end(s, i + 1);
+
+    // import type and export type, but not a default import called type
+    if ((type == TTIMPORT || type == TTEXPORT) && is_word(s, i + 1, "type")
+            && (type_at(s, i + 2) == TTOPENBRACE || type_at(s, i + 2) == TTMULTIPLY
+                || (type == TTIMPORT && is_name(type_at(s, i + 2)) && !is_word(s, i + 2, "from"))))
+        return clause_end(s, i + 2);
+
+    if (type == TTENUM || (type == TTCONST && next == TTENUM)
+            || ((is_word(s, i, "namespace") || is_word(s, i, "module")) && (next == TTIDENTIFIER || next == TTDOUBLESTRING
+                                                                              || next == TTSINGLESTRING)
+                && !newline_before(s, i + 1)))
+        fail(s, i);
+
+    return i;
+}
+
+static struct Scope *top(struct Stripper *s)
+{
+    return &s->scopes[s->scope_count - 1];
+}
+
+static bool at_statement_start(const struct Stripper *s)
+{
+    uint8_t last = s->last == UINT32_MAX ? TTNONE : type_at(s, s->last);
+
+    return s->scopes[s->scope_count - 1].kind == SSBLOCK
+        && (last == TTNONE || last == TTSEMICOLON || last == TTOPENBRACE || last == TTCLOSEBRACE);
+}
+
+/**Whether the colon at i ends a label or a default clause.
+ */
+static bool is_label(const struct Stripper *s, uint32_t i)
+{
+    uint8_t before = s->last != UINT32_MAX && s->last > 0 ? type_at(s, s->last - 1) : TTNONE;
+
+    if (s->last == UINT32_MAX || s->last + 1 != i || s->scopes[s->scope_count - 1].kind != SSBLOCK)
+        return false;
+    if (type_at(s, s->last) == TTDEFAULT)
+        return true;
+
+    return type_at(s, s->last) == TTIDENTIFIER
+        && (s->last == 0 || before == TTSEMICOLON || before == TTOPENBRACE || before == TTCLOSEBRACE || before == TTCOLON);
+}
+
+static bool at_member_start(const struct Stripper *s, uint32_t i)
+{
+    const struct Scope *scope = &s->scopes[s->scope_count - 1];
+    uint8_t last = type_at(s, s->last);
+
+    if (scope->kind != SSCLASS)
+        return false;
+
+    // a field without a semicolon ends at the end of its line
+    return last == TTSEMICOLON || last == TTOPENBRACE || last == TTCLOSEBRACE
+        || (newline_before(s, i) && ends_operand(s, s->last) && (is_name(type_at(s, i)) || type_at(s, i) == TTOPENBRACKET));
+}
+
+static int push_scope(struct Stripper *s, struct Scope scope)
+{
+    if (s->scope_count == s->scope_capacity) {
+        size_t capacity = s->scope_capacity ? s->scope_capacity * 2 : STRIP_INITIAL_CAPACITY;
+        struct Scope *resized = realloc(s->scopes, capacity * sizeof *resized);
+        if (resized == NULL) {
+            s->failed = true;
+            return EXIT_FAILURE;
+        }
+        s->scopes = resized;
+        s->scope_capacity = capacity;
+    }
+
+    s->scopes[s->scope_count++] = scope;
+
+    return EXIT_SUCCESS;
+}
+
+/**Whether the parenthesis at i opens an arrow function's parameters, which
+ * are followed by => or by a return type and =>.
+ */
+static bool opens_arrow(const struct Stripper *s, uint32_t i)
+{
+    uint32_t close = s->partners[i];
+
+    if (type_at(s, close + 1) == TTARROW)
+        return true;
+    if (type_at(s, close + 1) != TTCOLON)
+        return false;
+
+    uint32_t end = skip_type(s, close + 2);
+    return end != NOT_A_TYPE && type_at(s, end) == TTARROW;
+}
+
+/**The kind of scope a brace opens, going by what's before it.
+ */
+static uint8_t brace_scope(struct Stripper *s)
+{
+    struct Scope *scope = top(s);
+    uint8_t last = s->last == UINT32_MAX ? TTNONE : type_at(s, s->last);
+
+    if (scope->class_next) {
+        scope->class_next = false;
+        return SSCLASS;
+    }
+    if (scope->body_next) {
+        scope->body_next = false;
+        return SSBLOCK;
+    }
+
+    switch (last) {
+    case TTNONE:
+    case TTSEMICOLON:
+    case TTOPENBRACE:
+    case TTCLOSEBRACE:
+    case TTCLOSEPAREN:
+    case TTELSE:
+    case TTDO:
+    case TTTRY:
+    case TTFINALLY:
+    case TTARROW:
+        return SSBLOCK;
+    case TTCOLON:
+        // a case or a label, unless it's a property's value
+        return scope->kind == SSBLOCK ? SSBLOCK : SSOBJECT;
+    default:
+        return SSOBJECT;
+    }
+}
+
+/**Handles an opening bracket at i.
+ */
+static void open_scope(struct Stripper *s, uint32_t i)
+{
+    uint8_t type = type_at(s, i);
+    struct Scope scope = {0};
+
+    scope.span_count = s->spans->count;
+    scope.kept = s->kept;
+
+    if (type == TTOPENBRACE) {
+        scope.kind = brace_scope(s);
+    } else if (type == TTOPENBRACKET) {
+        scope.kind = SSBRACKETS;
+    } else if (s->parameters_next) {
+        scope.kind = SSPARAMETERS;
+        scope.start = s->function_start;
+        s->parameters_next = false;
+    } else if (top(s)->kind == SSCLASS && !top(s)->value) {
+        // from where the member started, as an optional mark cut since then
+        // has already kept what came before it
+        scope.kind = SSPARAMETERS;
+        scope.start = top(s)->member;
+        scope.span_count = top(s)->span_count;
+        scope.kept = top(s)->kept;
+    } else if (top(s)->kind == SSOBJECT && !top(s)->value && (is_name(type_at(s, s->last))
+                                                               || is_literal(type_at(s, s->last))
+                                                               || type_at(s, s->last) == TTCLOSEBRACKET)) {
+        // a method, whose key can be a name, a literal or computed
+        scope.kind = SSPARAMETERS;
+        scope.start = UINT32_MAX;
+    } else if (opens_arrow(s, i)) {
+        scope.kind = SSPARAMETERS;
+        scope.start = UINT32_MAX;
+    } else {
+        uint8_t before = type_at(s, s->last);
+        scope.kind = SSPARENTHESES;
+        scope.control = s->last != UINT32_MAX && (before == TTIF || before == TTFOR || before == TTWHILE
+                                                  || before == TTWITH || before == TTSWITCH || before == TTCATCH);
+    }
+
+    push_scope(s, scope);
+}
+
+/**Handles a closing bracket at i, and returns the token after what it
+ * closed off.
+ */
+static uint32_t close_scope(struct Stripper *s, uint32_t i)
+{
+    struct Scope closed = s->scopes[--s->scope_count];
+    struct Scope *scope = top(s);
+
+    if (closed.control)
+        s->control_close = i;
+
+    // a destructuring pattern is a declaration's name
+    if (scope->declaring == DGTARGET)
+        scope->declaring = DGNAMED;
+
+    if (closed.kind != SSPARAMETERS) {
+        s->last = i;
+        return i + 1;
+    }
+
+    uint32_t end = i + 1;
+    if (type_at(s, end) == TTCOLON)
+        end = cut_annotation(s, end);
+
+    if (type_at(s, end) == TTOPENBRACE) {
+        scope->body_next = true;
+    } else if (closed.start != UINT32_MAX && type_at(s, end) != TTARROW) {
+        // an overload, or a method with no body
+        s->spans->count = closed.span_count;
+        s->kept = closed.kept;
+        end = type_at(s, end) == TTSEMICOLON ? end + 1 : end;
+        cut_tokens(s, closed.start, end - 1);
+        s->last = closed.start > 0 ? closed.start - 1 : UINT32_MAX;
+        return end;
+    }
+
+    s->last = i;
+
+    return end;
+}
+
+/**Cuts a class member's modifiers, or the whole member if it's declared or
+ * abstract, or an index signature.  Returns the token to go on from.
+ */
+static uint32_t strip_member(struct Stripper *s, uint32_t i)
+{
+    struct Scope *scope = top(s);
+    uint8_t next = type_at(s, i + 1);
+    bool modifier = (type_at(s, i) == TTPUBLIC || type_at(s, i) == TTPRIVATE || type_at(s, i) == TTPROTECTED
+                     || is_word(s, i, "readonly") || is_word(s, i, "override") || is_word(s, i, "declare")
+                     || is_word(s, i, "abstract"))
+                 && (is_name(next) || is_literal(next) || next == TTOPENBRACKET || next == TTMULTIPLY)
+                 && !newline_before(s, i + 1);
+
+    scope->member = i;
+    scope->span_count = s->spans->count;
+    scope->kept = s->kept;
+    scope->value = false;
+
+    if (modifier && (is_word(s, i, "declare") || is_word(s, i, "abstract"))) {
+        uint32_t end = statement_end(s, i);
+        cut_tokens(s, i, end - 1);
+        return end;
+    }
+
+    if (modifier) {
+        cut(s, s->tokens->starts[i], s->tokens->starts[i + 1]);
+        return i + 1;
+    }
+
+    // an index signature
+    if (type_at(s, i) == TTOPENBRACKET && is_name(next) && type_at(s, i + 2) == TTCOLON) {
+        uint32_t end = statement_end(s, i);
+        cut_tokens(s, i, end - 1);
+        return end;
+    }
+
+    return i;
+}
+
+/**Handles a token that might be type syntax.  Returns the token to go on
+ * from, or i if the token is kept as it is.
+ */
+static uint32_t strip_token(struct Stripper *s, uint32_t i)
+{
+    struct Scope *scope = top(s);
+    uint8_t type = type_at(s, i), next = type_at(s, i + 1);
+
+    if (at_statement_start(s)) {
+        uint32_t from = type == TTEXPORT && type_statement_end(s, i) == i ? i + 1 : i;
+        uint32_t end = type_statement_end(s, from);
+
+        if (s->failed)
+            return s->tokens->count;
+        if (end != from) {
+            cut_tokens(s, i, end - 1);
+            return end;
+        }
+        if (is_word(s, from, "abstract") && type_at(s, from + 1) == TTCLASS) {
+            cut(s, s->tokens->starts[from], s->tokens->starts[from + 1]);
+            return from == i ? i + 1 : i;
+        }
+        if (type == TTIMPORT && next != TTOPENPAREN && next != TTDOT)
+            s->module_clause = true;
+        if (type == TTEXPORT && (next == TTOPENBRACE || next == TTMULTIPLY))
+            s->module_clause = true;
+    }
+
+    if (at_member_start(s, i)) {
+        uint32_t after = strip_member(s, i);
+        if (after != i)
+            return after;
+    }
+
+    switch (type) {
+    case TTCOLON:
+        if ((scope->kind == SSPARAMETERS && !scope->value) || scope->declaring == DGNAMED
+                || (scope->kind == SSCLASS && !scope->value))
+            return cut_annotation(s, i);
+        if (scope->kind == SSOBJECT && !scope->value) {
+            scope->value = true;
+            break;
+        }
+        // anything else is the other half of a ?, a case or default, or a
+        // label, and a colon that's none of those is a type left in place
+        if (scope->colons > 0)
+            scope->colons--;
+        else if (!is_label(s, i))
+            fail(s, i);
+        break;
+    case TTCONDITIONAL:
+        // optional parameters and members
+        if (((scope->kind == SSPARAMETERS && !scope->value) || (scope->kind == SSCLASS && !scope->value))
+                && (next == TTCOLON || next == TTCOMMA || next == TTCLOSEPAREN || next == TTSEMICOLON
+                    || next == TTOPENPAREN || next == TTASSIGN)) {
+            cut_tokens(s, i, i);
+            return i + 1;
+        }
+        break;
+    case TTBANG:
+        // a non-null assertion, or a definite assignment
+        if (ends_operand(s, s->last) && !newline_before(s, i)) {
+            cut_tokens(s, i, i);
+            return i + 1;
+        }
+        break;
+    case TTAS:
+        if (!s->module_clause && ends_operand(s, s->last)) {
+            uint32_t end = type_at(s, i + 1) == TTCONST ? i + 2 : skip_type(s, i + 1);
+            if (end == NOT_A_TYPE) {
+                fail(s, i + 1);
+                return s->tokens->count;
+            }
+            cut(s, token_end(s, s->last), token_end(s, end - 1));
+            return end;
+        }
+        break;
+    case TTIDENTIFIER:
+        if (is_word(s, i, "satisfies") && ends_operand(s, s->last) && !newline_before(s, i)) {
+            uint32_t end = skip_type(s, i + 1);
+            if (end == NOT_A_TYPE) {
+                fail(s, i + 1);
+                return s->tokens->count;
+            }
+            cut(s, token_end(s, s->last), token_end(s, end - 1));
+            return end;
+        }
+        // import { type A, b }
+        if (s->module_clause && scope->kind == SSOBJECT && is_word(s, i, "type") && is_name(next)) {
+            uint32_t end = type_at(s, i + 2) == TTAS ? i + 4 : i + 2;
+            if (type_at(s, end) == TTCOMMA)
+                cut(s, s->tokens->starts[i], s->tokens->starts[end + 1]);
+            else
+                cut_tokens(s, i, end - 1);
+            return type_at(s, end) == TTCOMMA ? end + 1 : end;
+        }
+        if (scope->kind == SSPARAMETERS && !scope->value && is_word(s, i, "readonly") && is_name(next))
+            fail(s, i);
+        break;
+    case TTPUBLIC:
+    case TTPRIVATE:
+    case TTPROTECTED:
+        // parameter properties assign fields, which would need code
+        if (scope->kind == SSPARAMETERS && !scope->value)
+            fail(s, i);
+        break;
+    case TTTHIS:
+        // a function's declared this isn't a parameter
+        if (scope->kind == SSPARAMETERS && type_at(s, s->last) == TTOPENPAREN && next == TTCOLON) {
+            uint32_t end = skip_type(s, i + 2);
+            if (end == NOT_A_TYPE) {
+                fail(s, i + 2);
+                return s->tokens->count;
+            }
+            if (type_at(s, end) == TTCOMMA)
+                cut(s, s->tokens->starts[i], s->tokens->starts[end + 1]);
+            else
+                cut_tokens(s, i, end - 1);
+            return type_at(s, end) == TTCOMMA ? end + 1 : end;
+        }
+        break;
+    case TTIMPLEMENTS:
+        if (scope->class_next) {
+            uint32_t end = i + 1;
+            while (end < s->tokens->count && type_at(s, end) != TTOPENBRACE)
+                end++;
+            cut(s, s->tokens->starts[i], s->tokens->starts[end]);
+            return end;
+        }
+        break;
+    case TTLESS: {
+        // type parameters, and type arguments to calls and superclasses
+        bool declared = s->parameters_next || scope->class_next
+                     || ((scope->kind == SSCLASS || scope->kind == SSOBJECT) && !scope->value);
+        bool operand = ends_operand(s, s->last);
+        uint32_t end = skip_angles(s, i, operand && !declared);
+
+        // a < can't start an expression, so this is a generic arrow
+        // function, <T>(x: T) => x, or an old-style cast, <T>x
+        if (!operand && end != NOT_A_TYPE)
+            declared = true;
+
+        if (end != NOT_A_TYPE && (declared || (operand && type_at(s, end) == TTOPENPAREN && !newline_before(s, i)))) {
+            cut_tokens(s, i, end - 1);
+            return end;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    return i;
+}
+
+/**Updates the scopes for a token that's kept.
+ */
+static void track_token(struct Stripper *s, uint32_t i)
+{
+    struct Scope *scope = top(s);
+    uint8_t type = type_at(s, i);
+
+    switch (type) {
+    case TTLET:
+    case TTCONST:
+    case TTVAR:
+        scope->declaring = DGTARGET;
+        break;
+    case TTASSIGN:
+        if (scope->declaring == DGNAMED)
+            scope->declaring = DGVALUE;
+        if (scope->kind == SSPARAMETERS || scope->kind == SSCLASS)
+            scope->value = true;
+        break;
+    case TTCOMMA:
+        if (scope->declaring == DGNAMED || scope->declaring == DGVALUE)
+            scope->declaring = DGTARGET;
+        if (scope->kind == SSPARAMETERS || scope->kind == SSOBJECT)
+            scope->value = false;
+        break;
+    case TTCONDITIONAL:
+    case TTCASE:
+        scope->colons++;
+        break;
+    case TTSEMICOLON:
+        scope->declaring = DGNONE;
+        scope->value = false;
+        scope->class_next = false;
+        scope->body_next = false;
+        s->module_clause = false;
+        break;
+    case TTCLASS:
+        scope->class_next = true;
+        break;
+    case TTFUNCTION: {
+        uint32_t start = i;
+        // async and export come off with an overload
+        while (start > 0 && (type_at(s, start - 1) == TTEXPORT || type_at(s, start - 1) == TTDEFAULT
+                             || is_word(s, start - 1, "async")))
+            start--;
+        s->parameters_next = true;
+        s->function_start = at_statement_start(s) || start != i ? start : UINT32_MAX;
+        break;
+    }
+    case TTARROW:
+        // an expression body leaves no brace to wait for
+        scope->body_next = type_at(s, i + 1) == TTOPENBRACE;
+        break;
+    case TTIDENTIFIER:
+        if (scope->declaring == DGTARGET)
+            scope->declaring = DGNAMED;
+        else if (scope->declaring == DGNAMED && (is_word(s, i, "of")))
+            scope->declaring = DGVALUE;
+        break;
+    case TTIN:
+        if (scope->declaring == DGNAMED)
+            scope->declaring = DGVALUE;
+        break;
+    default:
+        if (type == TTSINGLESTRING || type == TTDOUBLESTRING)
+            s->module_clause &= !is_word(s, i - 1, "from");
+        break;
+    }
+
+    s->last = i;
+}
+
+int strip_types(const struct TokenBuffer *tokens, size_t length, struct SpanBuffer *spans, size_t *error_token)
+{
+    struct Stripper s = {
+        .tokens = tokens,
+        .spans = spans,
+        .length = length,
+        .last = UINT32_MAX,
+        .control_close = UINT32_MAX,
+        .function_start = UINT32_MAX,
+    };
+
+    spans->count = 0;
+
+    if (match_brackets(&s) == EXIT_SUCCESS)
+        push_scope(&s, (struct Scope) { .kind = SSBLOCK });
+
+    for (uint32_t i = 0; i < tokens->count && !s.failed; ) {
+        uint8_t type = tokens->types[i];
+        uint32_t next = strip_token(&s, i);
+
+        if (next != i) {
+            i = next;
+        } else if (type == TTOPENPAREN || type == TTOPENBRACKET || type == TTOPENBRACE) {
+            open_scope(&s, i);
+            s.last = i++;
+        } else if (type == TTCLOSEPAREN || type == TTCLOSEBRACKET || type == TTCLOSEBRACE) {
+            if (s.scope_count <= 1) {
+                fail(&s, i);
+                break;
+            }
+            i = close_scope(&s, i);
+        } else {
+            track_token(&s, i++);
+        }
+    }
+
+    if (!s.failed)
+        keep_to(&s, length);
+
+    free(s.partners);
+    free(s.scopes);
+    *error_token = s.error_token;
+
+    return s.failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
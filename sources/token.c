@@ -1,390 +1,902 @@
 #include "compile.h"
 
 #include <assert.h>
-#include <ctype.h>
 #include <limits.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-const struct {
-    const char *operator_string;
-    enum TokenType ttype;
-} operators[] = {
-    { "implements", TTIMPLEMENTS },
-    { "instanceof", TTINSTANCEOF },
-    { "protected", TTPROTECTED },
-    { "interface", TTINTERFACE },
-    { "function", TTFUNCTION },
-    { "debugger", TTDEBUGGER },
-    { "continue", TTCONTINUE },
-    { "private", TTPRIVATE },
-    { "package", TTPACKAGE },
-    { "finally", TTFINALLY },
-    { "extends", TTEXTENDS },
-    { "default", TTDEFAULT },
-    { "static", TTSTATIC },
-    { "public", TTPUBLIC },
-    { "typeof", TTTYPEOF },
-    { "switch", TTSWITCH },
-    { "return", TTRETURN },
-    { "import", TTIMPORT },
-    { "export", TTEXPORT },
-    { "delete", TTDELETE },
-    { "while", TTWHILE },
-    { "throw", TTTHROW },
-    { "super", TTSUPER },
-    { "false", TTFALSE },
-    { "const", TTCONST },
-    { "class", TTCLASS },
-    { "catch", TTCATCH },
-    { "break", TTBREAK },
-    { "yield", TTYIELD },
-    { "with", TTWITH },
-    { "void", TTVOID },
-    { "true", TTTRUE },
-    { "this", TTTHIS },
-    { "null", TTNULL },
-    { "enum", TTENUM },
-    { "else", TTELSE },
-    { "case", TTCASE },
-    { "let", TTLET },
-    { "var", TTVAR },
-    { "try", TTTRY },
-    { "new", TTNEW },
-    { "for", TTFOR },
-    { "as", TTAS },
-    { "in", TTIN },
-    { "if", TTIF },
-    { "do", TTDO },
-    { "===", TTIDENT },
-    { "!==", TTNOTIDENT },
-    { ">>>", TTBITSHRZERO },
-    { "==", TTEQ },
-    { "!=", TTNOTEQ },
-    { "+=", TTPLUSASSIGN },
-    { "-=", TTMINUSASSIGN },
-    { "/=", TTDIVIDEASSIGN },
-    { "*=", TTMULTIPLYASSIGN },
-    { "%=", TTMODULOASSIGN },
-    { ">>", TTBITSHR },
-    { "<<", TTBITSHL },
-    { "&&", TTAND },
-    { "||", TTOR },
-    { "<=", TTLESSEQ },
-    { ">=", TTGREATEREQ },
-    { "=", TTASSIGN },
-    { "+", TTPLUS },
-    { "-", TTMINUS },
-    { "/", TTDIVIDE },
-    { "*", TTMULTIPLY },
-    { "%", TTMODULO },
-    { "&", TTBITAND },
-    { "|", TTBITOR },
-    { "^", TTBITXOR },
-    { "~", TTBITNOT },
-    { "!", TTBANG },
-    { "?", TTCONDITIONAL },
-    { "<", TTLESS },
-    { ">", TTGREATER },
-    { ".", TTDOT },
-    { ";", TTSEMICOLON },
-    { "(", TTOPENPAREN },
-    { ")", TTCLOSEPAREN },
-    { "{", TTOPENBRACE },
-    { "}", TTCLOSEBRACE },
-    { "[", TTOPENBRACKET },
-    { "]", TTCLOSEBRACKET },
-    { ":", TTCOLON },
-    { ",", TTCOMMA },
-}; 
-
-/**Gets a keyword or operator out of the current string.
+const char *const token_type_strings[] = {
+    [TTBREAK] = "break",
+    [TTCASE] = "case",
+    [TTCATCH] = "catch",
+    [TTCLASS] = "class",
+    [TTCONST] = "const",
+    [TTCONTINUE] = "continue",
+    [TTDEBUGGER] = "debugger",
+    [TTDEFAULT] = "default",
+    [TTDELETE] = "delete",
+    [TTDO] = "do",
+    [TTELSE] = "else",
+    [TTENUM] = "enum",
+    [TTEXPORT] = "export",
+    [TTEXTENDS] = "extends",
+    [TTFALSE] = "false",
+    [TTFINALLY] = "finally",
+    [TTFOR] = "for",
+    [TTFUNCTION] = "function",
+    [TTIF] = "if",
+    [TTIMPORT] = "import",
+    [TTIN] = "in",
+    [TTINSTANCEOF] = "instanceof",
+    [TTNEW] = "new",
+    [TTNULL] = "null",
+    [TTRETURN] = "return",
+    [TTSUPER] = "super",
+    [TTSWITCH] = "switch",
+    [TTTHIS] = "this",
+    [TTTHROW] = "throw",
+    [TTTRUE] = "true",
+    [TTTRY] = "try",
+    [TTTYPEOF] = "typeof",
+    [TTVAR] = "var",
+    [TTVOID] = "void",
+    [TTWHILE] = "while",
+    [TTWITH] = "with",
+    // strict mode keywords
+    [TTAS] = "as",
+    [TTIMPLEMENTS] = "implements",
+    [TTINTERFACE] = "interface",
+    [TTLET] = "let",
+    [TTPACKAGE] = "package",
+    [TTPRIVATE] = "private",
+    [TTPROTECTED] = "protected",
+    [TTPUBLIC] = "public",
+    [TTSTATIC] = "static",
+    [TTYIELD] = "yield",
+    // operators
+    [TTIDENT] = "===",
+    [TTNOTIDENT] = "!==",
+    [TTEQ] = "==",
+    [TTNOTEQ] = "!=",
+    [TTASSIGN] = "=",
+    [TTPLUS] = "+",
+    [TTMINUS] = "-",
+    [TTDIVIDE] = "/",
+    [TTMULTIPLY] = "*",
+    [TTMODULO] = "%",
+    [TTPLUSASSIGN] = "+=",
+    [TTMINUSASSIGN] = "-=",
+    [TTDIVIDEASSIGN] = "/=",
+    [TTMULTIPLYASSIGN] = "*=",
+    [TTMODULOASSIGN] = "%=",
+    [TTBITAND] = "&",
+    [TTBITOR] = "|",
+    [TTBITXOR] = "^",
+    [TTBITNOT] = "~",
+    [TTBITSHRZERO] = ">>>",
+    [TTBITSHR] = ">>",
+    [TTBITSHL] = "<<",
+    [TTAND] = "&&",
+    [TTOR] = "||",
+    [TTBANG] = "!",
+    [TTCONDITIONAL] = "?",
+    [TTLESS] = "<",
+    [TTGREATER] = ">",
+    [TTLESSEQ] = "<=",
+    [TTGREATEREQ] = ">=",
+    [TTDOT] = ".",
+    [TTINCREMENT] = "++",
+    [TTDECREMENT] = "--",
+    [TTEXPONENT] = "**",
+    [TTEXPONENTASSIGN] = "**=",
+    [TTBITANDASSIGN] = "&=",
+    [TTBITORASSIGN] = "|=",
+    [TTBITXORASSIGN] = "^=",
+    [TTBITSHLASSIGN] = "<<=",
+    [TTBITSHRASSIGN] = ">>=",
+    [TTBITSHRZEROASSIGN] = ">>>=",
+    [TTANDASSIGN] = "&&=",
+    [TTORASSIGN] = "||=",
+    [TTNULLISH] = "??",
+    [TTNULLISHASSIGN] = "?\?=", // not a trigraph
+    [TTOPTIONALCHAIN] = "?.",
+    [TTARROW] = "=>",
+    [TTSPREAD] = "...",
+    // syntax
+    [TTSEMICOLON] = ";",
+    [TTOPENPAREN] = "(",
+    [TTCLOSEPAREN] = ")",
+    [TTOPENBRACE] = "{",
+    [TTCLOSEBRACE] = "}",
+    [TTOPENBRACKET] = "[",
+    [TTCLOSEBRACKET] = "]",
+    [TTCOLON] = ":",
+    [TTCOMMA] = ",",
+};
+
+/* Keywords are looked up with a perfect hash over (length, first char, second
+ * char, last char).  The multipliers were searched for offline so that no two
+ * keywords share a slot; the table is filled in by the compiler from the
+ * designators below, and -Woverride-init turns any future collision into a
+ * build error.  The keyword's spelling lives in token_type_strings.
+ */
+#define KEYWORD_TABLE_SIZE 128
+#define KEYWORD_MIN_LENGTH 2
+#define KEYWORD_MAX_LENGTH 10
+#define KEYWORD_HASH(length, first, second, last) \
+    (((unsigned)(first) * 8u + (unsigned)(second) * 28u + (unsigned)(last) * 15u + (unsigned)(length) * 2u) \
+     & (KEYWORD_TABLE_SIZE - 1))
+
+static const struct {
+    unsigned char length;
+    unsigned char ttype;
+} keyword_table[KEYWORD_TABLE_SIZE] = {
+    // always reserved words
+    [KEYWORD_HASH(5, 'b', 'r', 'k')] = { 5, TTBREAK },
+    [KEYWORD_HASH(4, 'c', 'a', 'e')] = { 4, TTCASE },
+    [KEYWORD_HASH(5, 'c', 'a', 'h')] = { 5, TTCATCH },
+    [KEYWORD_HASH(5, 'c', 'l', 's')] = { 5, TTCLASS },
+    [KEYWORD_HASH(5, 'c', 'o', 't')] = { 5, TTCONST },
+    [KEYWORD_HASH(8, 'c', 'o', 'e')] = { 8, TTCONTINUE },
+    [KEYWORD_HASH(8, 'd', 'e', 'r')] = { 8, TTDEBUGGER },
+    [KEYWORD_HASH(7, 'd', 'e', 't')] = { 7, TTDEFAULT },
+    [KEYWORD_HASH(6, 'd', 'e', 'e')] = { 6, TTDELETE },
+    [KEYWORD_HASH(2, 'd', 'o', 'o')] = { 2, TTDO },
+    [KEYWORD_HASH(4, 'e', 'l', 'e')] = { 4, TTELSE },
+    [KEYWORD_HASH(4, 'e', 'n', 'm')] = { 4, TTENUM },
+    [KEYWORD_HASH(6, 'e', 'x', 't')] = { 6, TTEXPORT },
+    [KEYWORD_HASH(7, 'e', 'x', 's')] = { 7, TTEXTENDS },
+    [KEYWORD_HASH(5, 'f', 'a', 'e')] = { 5, TTFALSE },
+    [KEYWORD_HASH(7, 'f', 'i', 'y')] = { 7, TTFINALLY },
+    [KEYWORD_HASH(3, 'f', 'o', 'r')] = { 3, TTFOR },
+    [KEYWORD_HASH(8, 'f', 'u', 'n')] = { 8, TTFUNCTION },
+    [KEYWORD_HASH(2, 'i', 'f', 'f')] = { 2, TTIF },
+    [KEYWORD_HASH(6, 'i', 'm', 't')] = { 6, TTIMPORT },
+    [KEYWORD_HASH(2, 'i', 'n', 'n')] = { 2, TTIN },
+    [KEYWORD_HASH(10, 'i', 'n', 'f')] = { 10, TTINSTANCEOF },
+    [KEYWORD_HASH(3, 'n', 'e', 'w')] = { 3, TTNEW },
+    [KEYWORD_HASH(4, 'n', 'u', 'l')] = { 4, TTNULL },
+    [KEYWORD_HASH(6, 'r', 'e', 'n')] = { 6, TTRETURN },
+    [KEYWORD_HASH(5, 's', 'u', 'r')] = { 5, TTSUPER },
+    [KEYWORD_HASH(6, 's', 'w', 'h')] = { 6, TTSWITCH },
+    [KEYWORD_HASH(4, 't', 'h', 's')] = { 4, TTTHIS },
+    [KEYWORD_HASH(5, 't', 'h', 'w')] = { 5, TTTHROW },
+    [KEYWORD_HASH(4, 't', 'r', 'e')] = { 4, TTTRUE },
+    [KEYWORD_HASH(3, 't', 'r', 'y')] = { 3, TTTRY },
+    [KEYWORD_HASH(6, 't', 'y', 'f')] = { 6, TTTYPEOF },
+    [KEYWORD_HASH(3, 'v', 'a', 'r')] = { 3, TTVAR },
+    [KEYWORD_HASH(4, 'v', 'o', 'd')] = { 4, TTVOID },
+    [KEYWORD_HASH(5, 'w', 'h', 'e')] = { 5, TTWHILE },
+    [KEYWORD_HASH(4, 'w', 'i', 'h')] = { 4, TTWITH },
+    // TODO: strict mode only; handle this later
+    [KEYWORD_HASH(2, 'a', 's', 's')] = { 2, TTAS },
+    [KEYWORD_HASH(10, 'i', 'm', 's')] = { 10, TTIMPLEMENTS },
+    [KEYWORD_HASH(9, 'i', 'n', 'e')] = { 9, TTINTERFACE },
+    [KEYWORD_HASH(3, 'l', 'e', 't')] = { 3, TTLET },
+    [KEYWORD_HASH(7, 'p', 'a', 'e')] = { 7, TTPACKAGE },
+    [KEYWORD_HASH(7, 'p', 'r', 'e')] = { 7, TTPRIVATE },
+    [KEYWORD_HASH(9, 'p', 'r', 'd')] = { 9, TTPROTECTED },
+    [KEYWORD_HASH(6, 'p', 'u', 'c')] = { 6, TTPUBLIC },
+    [KEYWORD_HASH(6, 's', 't', 'c')] = { 6, TTSTATIC },
+    [KEYWORD_HASH(5, 'y', 'i', 'd')] = { 5, TTYIELD },
+};
+
+/**Gets the token type of word if word is a keyword, else TTNONE.
+ */
+enum TokenType get_keyword_type(struct StringView word)
+{
+    if (word.length < KEYWORD_MIN_LENGTH || word.length > KEYWORD_MAX_LENGTH)
+        return TTNONE;
+
+    const unsigned char *s = (const unsigned char *)word.data;
+    unsigned slot = KEYWORD_HASH(word.length, s[0], s[1], s[word.length - 1]);
+
+    if (keyword_table[slot].length != word.length)
+        return TTNONE;
+
+    enum TokenType ttype = keyword_table[slot].ttype;
+    if (memcmp(word.data, token_type_strings[ttype], word.length) != 0)
+        return TTNONE;
+
+    return ttype;
+}
+
+/**Gets a punctuator out of the current string.
  *
- * Searches longer keywords first as some keywords/operators are substrings of
- * each other.  Writes the enum TokenType of the keyword/operator to the
- * parameter "ttype".
+ * A switch tree on the first character, taking the longest match.  Writes the
+ * enum TokenType of the punctuator to the parameter "ttype".  The caller must
+ * have ruled out comments before calling this, as "/" would otherwise match.
  *
  * Returns NULL if could not find anything.
  */
-const char *get_keyword_or_operator(const char *begin, enum TokenType *ttype)
+const char *get_punctuator(const char *begin, enum TokenType *ttype)
 {
-    if (strncmp(begin, "//", 2) == 0 || strncmp(begin, "/*", 2) == 0) {
+    switch (begin[0]) {
+    case '=':
+        if (begin[1] == '=') {
+            if (begin[2] == '=') { *ttype = TTIDENT; return begin + 3; }
+            *ttype = TTEQ; return begin + 2;
+        }
+        if (begin[1] == '>') { *ttype = TTARROW; return begin + 2; }
+        *ttype = TTASSIGN; return begin + 1;
+    case '!':
+        if (begin[1] == '=') {
+            if (begin[2] == '=') { *ttype = TTNOTIDENT; return begin + 3; }
+            *ttype = TTNOTEQ; return begin + 2;
+        }
+        *ttype = TTBANG; return begin + 1;
+    case '+':
+        if (begin[1] == '+') { *ttype = TTINCREMENT; return begin + 2; }
+        if (begin[1] == '=') { *ttype = TTPLUSASSIGN; return begin + 2; }
+        *ttype = TTPLUS; return begin + 1;
+    case '-':
+        if (begin[1] == '-') { *ttype = TTDECREMENT; return begin + 2; }
+        if (begin[1] == '=') { *ttype = TTMINUSASSIGN; return begin + 2; }
+        *ttype = TTMINUS; return begin + 1;
+    case '/':
+        if (begin[1] == '=') { *ttype = TTDIVIDEASSIGN; return begin + 2; }
+        *ttype = TTDIVIDE; return begin + 1;
+    case '*':
+        if (begin[1] == '*') {
+            if (begin[2] == '=') { *ttype = TTEXPONENTASSIGN; return begin + 3; }
+            *ttype = TTEXPONENT; return begin + 2;
+        }
+        if (begin[1] == '=') { *ttype = TTMULTIPLYASSIGN; return begin + 2; }
+        *ttype = TTMULTIPLY; return begin + 1;
+    case '%':
+        if (begin[1] == '=') { *ttype = TTMODULOASSIGN; return begin + 2; }
+        *ttype = TTMODULO; return begin + 1;
+    case '&':
+        if (begin[1] == '&') {
+            if (begin[2] == '=') { *ttype = TTANDASSIGN; return begin + 3; }
+            *ttype = TTAND; return begin + 2;
+        }
+        if (begin[1] == '=') { *ttype = TTBITANDASSIGN; return begin + 2; }
+        *ttype = TTBITAND; return begin + 1;
+    case '|':
+        if (begin[1] == '|') {
+            if (begin[2] == '=') { *ttype = TTORASSIGN; return begin + 3; }
+            *ttype = TTOR; return begin + 2;
+        }
+        if (begin[1] == '=') { *ttype = TTBITORASSIGN; return begin + 2; }
+        *ttype = TTBITOR; return begin + 1;
+    case '<':
+        if (begin[1] == '<') {
+            if (begin[2] == '=') { *ttype = TTBITSHLASSIGN; return begin + 3; }
+            *ttype = TTBITSHL; return begin + 2;
+        }
+        if (begin[1] == '=') { *ttype = TTLESSEQ; return begin + 2; }
+        *ttype = TTLESS; return begin + 1;
+    case '>':
+        if (begin[1] == '>') {
+            if (begin[2] == '>') {
+                if (begin[3] == '=') { *ttype = TTBITSHRZEROASSIGN; return begin + 4; }
+                *ttype = TTBITSHRZERO; return begin + 3;
+            }
+            if (begin[2] == '=') { *ttype = TTBITSHRASSIGN; return begin + 3; }
+            *ttype = TTBITSHR; return begin + 2;
+        }
+        if (begin[1] == '=') { *ttype = TTGREATEREQ; return begin + 2; }
+        *ttype = TTGREATER; return begin + 1;
+    case '^':
+        if (begin[1] == '=') { *ttype = TTBITXORASSIGN; return begin + 2; }
+        *ttype = TTBITXOR; return begin + 1;
+    case '~': *ttype = TTBITNOT; return begin + 1;
+    case '?':
+        if (begin[1] == '?') {
+            if (begin[2] == '=') { *ttype = TTNULLISHASSIGN; return begin + 3; }
+            *ttype = TTNULLISH; return begin + 2;
+        }
+        // "a?.5:b" is a conditional, not an optional chain
+        if (begin[1] == '.' && !char_is(begin[2], CCDIGIT)) { *ttype = TTOPTIONALCHAIN; return begin + 2; }
+        *ttype = TTCONDITIONAL; return begin + 1;
+    case '.':
+        if (begin[1] == '.' && begin[2] == '.') { *ttype = TTSPREAD; return begin + 3; }
+        *ttype = TTDOT; return begin + 1;
+    case ';': *ttype = TTSEMICOLON; return begin + 1;
+    case '(': *ttype = TTOPENPAREN; return begin + 1;
+    case ')': *ttype = TTCLOSEPAREN; return begin + 1;
+    case '{': *ttype = TTOPENBRACE; return begin + 1;
+    case '}': *ttype = TTCLOSEBRACE; return begin + 1;
+    case '[': *ttype = TTOPENBRACKET; return begin + 1;
+    case ']': *ttype = TTCLOSEBRACKET; return begin + 1;
+    case ':': *ttype = TTCOLON; return begin + 1;
+    case ',': *ttype = TTCOMMA; return begin + 1;
+    default:
         *ttype = TTNONE;
         return NULL;
     }
-
-    const size_t NUM_OPERATORS = sizeof operators / sizeof operators[0];
-    for (int i = 0; i < NUM_OPERATORS; i++) {
-        const char *to_compare = operators[i].operator_string;
-        if (strncmp(to_compare, begin, strlen(to_compare)) == 0) {
-            *ttype = operators[i].ttype;
-            return &begin[strlen(to_compare)];
-        }
-    }
-
-    *ttype = TTNONE;
-    return NULL;
 }
 
-const struct {
-    const char *keyword;
-    enum TokenType ttype;
-} keywords[] = {
-    // always reserved words
-    { "break", TTBREAK },
-    { "case", TTCASE },
-    { "catch", TTCATCH },
-    { "class", TTCLASS },
-    { "const", TTCONST },
-    { "continue", TTCONTINUE },
-    { "debugger", TTDEBUGGER },
-    { "default", TTDEFAULT },
-    { "delete", TTDELETE },
-    { "do", TTDO },
-    { "else", TTELSE },
-    { "enum", TTENUM },
-    { "export", TTEXPORT },
-    { "extends", TTEXTENDS },
-    { "false", TTFALSE },
-    { "finally", TTFINALLY },
-    { "for", TTFOR },
-    { "function", TTFUNCTION },
-    { "if", TTIF },
-    { "import", TTIMPORT },
-    { "in", TTIN },
-    { "instanceof", TTINSTANCEOF },
-    { "new", TTNEW },
-    { "null", TTNULL },
-    { "return", TTRETURN },
-    { "super", TTSUPER },
-    { "switch", TTSWITCH },
-    { "this", TTTHIS },
-    { "throw", TTTHROW },
-    { "true", TTTRUE },
-    { "try", TTTRY },
-    { "typeof", TTTYPEOF },
-    { "var", TTVAR },
-    { "void", TTVOID },
-    { "while", TTWHILE },
-    { "with", TTWITH },
-    // TODO: strict mode only; handle this later
-    { "as", TTAS },
-    { "implements", TTIMPLEMENTS },
-    { "interface", TTINTERFACE },
-    { "let", TTLET },
-    { "package", TTPACKAGE },
-    { "private", TTPRIVATE },
-    { "protected", TTPROTECTED },
-    { "public", TTPUBLIC },
-    { "static", TTSTATIC },
-    { "yield", TTYIELD },
+#define SP CCSPACE
+#define DG (CCDIGIT | CCIDENT)
+#define ID (CCIDENTSTART | CCIDENT)
+#define NO 0
+
+const uint8_t char_classes[256] = {
+    NO, NO, NO, NO, NO, NO, NO, NO, NO, SP, SP, SP, SP, SP, NO, NO, // 0x00
+    NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, // 0x10
+    SP, NO, NO, NO, ID, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, // 0x20
+    DG, DG, DG, DG, DG, DG, DG, DG, DG, DG, NO, NO, NO, NO, NO, NO, // 0x30
+    NO, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, // 0x40
+    ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, NO, NO, NO, NO, ID, // 0x50
+    NO, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, // 0x60
+    ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, NO, NO, NO, NO, NO, // 0x70
+    // the rest are zero
 };
 
-/**Gets the token type of word if word is a keyword, else TTNONE.
+#undef SP
+#undef DG
+#undef ID
+#undef NO
+
+/**Returns the end of a valid identifier, and writes its intern_hash to
+ * "hash" while its bytes are still in cache.
  */
-enum TokenType get_keyword_type(struct StringView word)
+const char *traverse_identifier(const char *string, uint32_t *hash)
 {
-    const size_t NUM_KEYWORDS = sizeof keywords / sizeof keywords[0];
+    assert(char_is(*string, CCIDENTSTART) && "should have checked the first char of an identifier");
 
-    for (int i = 0; i < NUM_KEYWORDS; i++) {
-        // see if the word in question is the keyword in question
-        if (word.length != strlen(keywords[i].keyword))
-            continue;
+    const char *end = scan_skip_identifier(string + 1);
+    *hash = intern_hash(string, end - string);
 
-        if (strncmp(word.data, keywords[i].keyword, word.length) == 0) {
-            return keywords[i].ttype;
-        }
-    }
-
-    return TTNONE;
+    return end;
 }
 
-bool is_identifier_first_char(char c)
+/**Traverses digits of the given radix, allowing single '_' separators
+ * between two digits.
+ *
+ * NULL if a separator is misplaced, writing where it is to "error".
+ */
+static const char *traverse_digits(const char *string, int radix, const char **error)
 {
-    return isalpha(c) || c == '_' || c == '$';
+    const char *start = string;
+
+    while (true) {
+        if (digit_value(*string) < radix) {
+            ++string;
+        } else if (*string == '_') {
+            if (string == start || digit_value(string[1]) >= radix) {
+                *error = string;
+                return NULL;
+            }
+            ++string;
+        } else {
+            return string;
+        }
+    }
 }
 
-bool is_identifier_char(char c)
+/**A numeric literal can't run straight into an identifier, as in "3in".
+ */
+static const char *end_number(const char *end, const char **error)
 {
-    return isdigit(c) || isalpha(c) || c == '_' || c == '$';
+    if (end != NULL && (char_is(*end, CCIDENTSTART) || *end == '\\')) {
+        *error = end;
+        return NULL;
+    }
+
+    return end;
 }
 
-/**Returns the end of a valid identifier
+/**Returns the end of a valid numeric literal: decimal with optional fraction
+ * and exponent, or 0x/0o/0b integers, any of the integers with a BigInt "n"
+ * suffix, and all with '_' separators.  A legacy octal integer like 010 and
+ * a decimal with a leading zero like 08 take neither separators nor the
+ * suffix, and the octal one no fraction or exponent either.
+ *
+ * NULL if malformed, writing the first byte that doesn't fit to "error".
  */
-const char *traverse_identifier(const char *string)
+static const char *traverse_number(const char *string, const char **error)
 {
-    assert(is_identifier_first_char(*string) && "should have checked the first char of an identifier");
+    assert((char_is(*string, CCDIGIT) || (*string == '.' && char_is(string[1], CCDIGIT))) && "should have checked for a digit");
 
-    for (; *string != '\0' && is_identifier_char(*string); ++string)
-        ;
+    if (string[0] == '0' && string[1] != '\0' && strchr("xXoObB", string[1]) != NULL) {
+        int radix = (string[1] | 0x20) == 'x' ? 16 : (string[1] | 0x20) == 'o' ? 8 : 2;
+        const char *end = traverse_digits(string + 2, radix, error);
 
-    return string;
-}
+        if (end == NULL)
+            return NULL;
 
-/**Returns the end of a valid digit literal
- */
-const char *traverse_digit_literal(const char *string)
-{
-    if (!isdigit(*string)) {
-        assert(0 && "shouldn't have made it here bro");
-        return string;
+        if (end == string + 2) {
+            *error = end; // no digits
+            return NULL;
+        }
+
+        return end_number(*end == 'n' ? end + 1 : end, error);
     }
 
-    for (; *string != '\0' && isdigit(*string); ++string)
-        ;
+    bool integer = true;
 
-    return string;
+    if (string[0] == '0' && char_is(string[1], CCDIGIT)) {
+        bool octal = true;
+
+        for (++string; char_is(*string, CCDIGIT); ++string)
+            octal = octal && *string < '8';
+
+        if (*string == '_' || *string == 'n' || (octal && (*string == '.' || (*string | 0x20) == 'e'))) {
+            *error = string;
+            return NULL;
+        }
+
+        if (octal)
+            return end_number(string, error);
+
+        integer = false; // no suffix
+    } else if (*string != '.' && (string = traverse_digits(string, 10, error)) == NULL) {
+        return NULL;
+    }
+
+    if (*string == '.') {
+        integer = false;
+        ++string;
+        if (char_is(*string, CCDIGIT) && (string = traverse_digits(string, 10, error)) == NULL)
+            return NULL;
+    }
+
+    if ((*string | 0x20) == 'e') {
+        integer = false;
+        ++string;
+        if (*string == '+' || *string == '-')
+            ++string;
+        if (!char_is(*string, CCDIGIT)) {
+            *error = string; // no exponent
+            return NULL;
+        }
+        if ((string = traverse_digits(string, 10, error)) == NULL)
+            return NULL;
+    }
+
+    if (integer && *string == 'n')
+        ++string;
+
+    return end_number(string, error);
 }
 
-/**Traverses until the end of a single quoted string
- * 
- * NULL if malformed.
+const char *traverse_numeric_literal(const char *string)
+{
+    const char *error;
+
+    return traverse_number(string, &error);
+}
+
+/**Traverses until the end of a quoted string, one past the closing quote.  A
+ * backslash before a line break continues the string on the next line.
+ *
+ * NULL if malformed, writing the line break or the end of the input that
+ * ended it to "error".
  */
-const char *traverse_single_quoted_string(const char *string)
+static const char *traverse_quoted_string(const char *string, char quote, const char **error)
 {
-    assert(*string == '\'' && "should only be called when starting a single quoted string");
+    string++; // ignore opening quote
+
+    while (true) {
+        string = scan_find_any(string, quote, '\\', '\n');
 
-    string++; // ignore opening '
+        if (*string == quote)
+            return string + 1;
 
-    while (*string != '\'') {
-        if (*string == '\n')
+        if (*string != '\\' || string[1] == '\0') {
+            // a newline, or the end of the file
+            *error = *string == '\\' ? string + 1 : string;
             return NULL;
-        else if (*string == '\\') {
-            if (*(++string) == '\n')
-                return NULL;
         }
 
-        string++;
+        // a CRLF is one line break, and the LF mustn't end the string
+        string += string[1] == '\r' && string[2] == '\n' ? 3 : 2;
     }
-
-    return string;
 }
 
 /**Traverses until the end of a single quoted string
- * 
+ *
+ * NULL if malformed.
+ */
+const char *traverse_single_quoted_string(const char *string)
+{
+    assert(*string == '\'' && "should only be called when starting a single quoted string");
+
+    const char *error;
+    return traverse_quoted_string(string, '\'', &error);
+}
+
+/**Traverses until the end of a double quoted string
+ *
  * NULL if malformed.
  */
 const char *traverse_double_quoted_string(const char *string)
 {
     assert(*string == '"' && "should only be called when starting a double quoted string");
 
-    string++; // ignore opening "
+    const char *error;
+    return traverse_quoted_string(string, '"', &error);
+}
 
-    while (*string != '"') {
-        if (*string == '\n')
-            return NULL;
-        else if (*string == '\\') {
-            if (*(++string) == '\n')
-                return NULL;
-        }
+const char *traverse_line_comment(const char *string) {
+    assert(strncmp(string, "//", 2) == 0 && "should have checked line comment starts with //");
 
-        string++;
+    return scan_find_any(string + strlen("//"), '\n', '\n', '\n');
+}
+
+const char *traverse_block_comment(const char *string) {
+    assert(strncmp(string, "/*", 2) == 0 && "should have checked block comment starts with /*");
+
+    string += strlen("/*");
+
+    while (*(string = scan_find_any(string, '*', '*', '*')) != '\0') {
+        if (*(++string) == '/')
+            return ++string;
     }
 
     return string;
 }
 
-const char *traverse_line_comment(const char *string) {
-    assert(strncmp(string, "//", 2) == 0 && "should have checked line comment starts with //");
+int token_buffer_reserve(struct TokenBuffer *buffer, size_t capacity)
+{
+    if (capacity <= buffer->capacity)
+        return EXIT_SUCCESS;
 
-    string += strlen("//");
+    uint8_t *types = realloc(buffer->types, sizeof *types * capacity);
+    if (types == NULL) return EXIT_FAILURE;
+    buffer->types = types;
 
-    while (*string != '\0' && *string != '\n')
-        ++string;
+    uint32_t *starts = realloc(buffer->starts, sizeof *starts * capacity);
+    if (starts == NULL) return EXIT_FAILURE;
+    buffer->starts = starts;
 
-    return string;
+    uint32_t *lengths = realloc(buffer->lengths, sizeof *lengths * capacity);
+    if (lengths == NULL) return EXIT_FAILURE;
+    buffer->lengths = lengths;
+
+    uint32_t *symbols = realloc(buffer->symbols, sizeof *symbols * capacity);
+    if (symbols == NULL) return EXIT_FAILURE;
+    buffer->symbols = symbols;
+
+    buffer->capacity = capacity;
+
+    return EXIT_SUCCESS;
 }
 
-const char *traverse_block_comment(const char *string, size_t *line) {
-    assert(line != NULL);
-    assert(strncmp(string, "/*", 2) == 0 && "should have checked block comment starts with /*");
+void token_buffer_free(struct TokenBuffer *buffer)
+{
+    free(buffer->types);
+    free(buffer->starts);
+    free(buffer->lengths);
+    free(buffer->symbols);
+    *buffer = (struct TokenBuffer) {0};
+}
 
-    string += strlen("/*");
+void token_buffer_settle(struct TokenBuffer *buffer)
+{
+    for (size_t i = buffer->shift_from; i < buffer->count && buffer->shift != 0; i++)
+        buffer->starts[i] += buffer->shift;
 
-    for (; *string != '\0'; ++string) {
-        if (*string == '*') {
-            if (*(++string) == '/')
-                return ++string;
-        } else if (*string == '\n') {
-            ++*line;
-        }
+    buffer->shift_from = 0;
+    buffer->shift = 0;
+}
+
+/* lex_token dispatches on the first byte through lex_handlers, a table of
+ * which handler each byte starts, rather than testing the byte against each
+ * kind of token in turn.  GCC and Clang jump straight to the handler through
+ * a table of label addresses; other compilers get a switch on the handler,
+ * which they compile to a jump table anyway.
+ */
+
+#if defined(__GNUC__)
+#define LEX_COMPUTED_GOTO 1
+#endif
+
+enum LexHandler {
+    LHINVALID = 0,
+    LHSPACE,
+    LHIDENTIFIER,
+    LHDIGIT,
+    LHDOT,
+    LHSLASH,
+    LHSINGLEQUOTE,
+    LHDOUBLEQUOTE,
+    LHPUNCTUATOR,
+    LHMAX,
+};
+
+#define NO LHINVALID
+#define SP LHSPACE
+#define ID LHIDENTIFIER
+#define DG LHDIGIT
+#define DT LHDOT
+#define SL LHSLASH
+#define SQ LHSINGLEQUOTE
+#define DQ LHDOUBLEQUOTE
+#define PU LHPUNCTUATOR
+
+static const uint8_t lex_handlers[256] = {
+    NO, NO, NO, NO, NO, NO, NO, NO, NO, SP, SP, SP, SP, SP, NO, NO, // 0x00
+    NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, NO, // 0x10
+    SP, PU, DQ, NO, ID, PU, PU, SQ, PU, PU, PU, PU, PU, PU, DT, SL, // 0x20
+    DG, DG, DG, DG, DG, DG, DG, DG, DG, DG, PU, PU, PU, PU, PU, PU, // 0x30
+    NO, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, // 0x40
+    ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, PU, NO, PU, PU, ID, // 0x50
+    NO, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, // 0x60
+    ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, ID, PU, PU, PU, PU, NO, // 0x70
+    // the rest are LHINVALID
+};
+
+#undef NO
+#undef SP
+#undef ID
+#undef DG
+#undef DT
+#undef SL
+#undef SQ
+#undef DQ
+#undef PU
+
+/**Lexes one token, or one run of whitespace or a comment, at contents.
+ *
+ * Writes the token type to "ttype", or TTNONE for whitespace and comments.
+ * For identifiers, writes the identifier's intern_hash to "hash".  Lines are
+ * not tracked here; positions come from the source's line table on demand.
+ *
+ * Returns the end of what was lexed, or NULL if malformed.
+ */
+const char *lex_token(const char *contents, enum TokenType *ttype, uint32_t *hash)
+{
+    const char *end = NULL;
+
+    assert(*contents != '\0');
+
+    *ttype = TTNONE;
+
+#ifdef LEX_COMPUTED_GOTO
+    static const void *const handlers[LHMAX] = {
+        [LHINVALID] = &&invalid,
+        [LHSPACE] = &&space,
+        [LHIDENTIFIER] = &&identifier,
+        [LHDIGIT] = &&digit,
+        [LHDOT] = &&dot,
+        [LHSLASH] = &&slash,
+        [LHSINGLEQUOTE] = &&single_quote,
+        [LHDOUBLEQUOTE] = &&double_quote,
+        [LHPUNCTUATOR] = &&punctuator,
+    };
+
+    goto *handlers[lex_handlers[(unsigned char)*contents]];
+#else
+    switch ((enum LexHandler)lex_handlers[(unsigned char)*contents]) {
+    case LHINVALID: goto invalid;
+    case LHSPACE: goto space;
+    case LHIDENTIFIER: goto identifier;
+    case LHDIGIT: goto digit;
+    case LHDOT: goto dot;
+    case LHSLASH: goto slash;
+    case LHSINGLEQUOTE: goto single_quote;
+    case LHDOUBLEQUOTE: goto double_quote;
+    case LHPUNCTUATOR: goto punctuator;
+    case LHMAX: break;
     }
+    assert(0 && "unreachable");
+#endif
 
-    return string;
+invalid:
+    return NULL;
+
+space:
+    return scan_skip_whitespace(contents);
+
+identifier:
+    // keywords are only keywords at identifier boundaries, so scan the whole
+    // word first and then look it up
+    end = traverse_identifier(contents, hash);
+    struct StringView id = { .data = contents, .length = end - contents };
+
+    if ((*ttype = get_keyword_type(id)) == TTNONE)
+        *ttype = TTIDENTIFIER;
+    return end;
+
+dot:
+    if (!char_is(contents[1], CCDIGIT))
+        goto punctuator;
+    // fall through to a number like ".5"
+digit:
+    *ttype = TTNUMLITERAL;
+    return traverse_numeric_literal(contents);
+
+slash:
+    if (contents[1] == '/')
+        return traverse_line_comment(contents);
+    if (contents[1] == '*')
+        return traverse_block_comment(contents);
+    goto punctuator;
+
+single_quote:
+    *ttype = TTSINGLESTRING;
+    return traverse_single_quoted_string(contents);
+
+double_quote:
+    *ttype = TTDOUBLESTRING;
+    return traverse_double_quoted_string(contents);
+
+punctuator:
+    return get_punctuator(contents, ttype);
 }
 
-int tokenise_file(const char *contents, struct Token **tokens, size_t *tokens_written)
+const char *lex_token_error(const char *contents)
+{
+    const char *error = contents;
+
+    switch ((enum LexHandler)lex_handlers[(unsigned char)*contents]) {
+    case LHDOT:
+        if (!char_is(contents[1], CCDIGIT))
+            break;
+        // fall through
+    case LHDIGIT:
+        traverse_number(contents, &error);
+        break;
+    case LHSINGLEQUOTE:
+    case LHDOUBLEQUOTE:
+        traverse_quoted_string(contents, *contents, &error);
+        break;
+    default:
+        break; // the character itself can't start a token
+    }
+
+    return error;
+}
+
+int tokenise_file(const char *contents, size_t length, struct Interner *interner, struct TokenBuffer *tokens, size_t *error_offset)
 {
-    size_t i = 0;
     enum TokenType ttype = TTNONE;
     const char *end = NULL;
-    size_t line = 1;
+    uint32_t hash = 0, symbol = SYMBOL_NONE;
+
+    *error_offset = length; // unless a token is to blame
+
+    if (length > UINT32_MAX)
+        return EXIT_FAILURE; // offsets are 32 bits
 
-    size_t capacity = 2048;
-    *tokens = calloc(sizeof **tokens, capacity);
+    *tokens = (struct TokenBuffer) { .source = contents };
+    size_t estimate = length / TOKEN_ESTIMATE_BYTES_PER_TOKEN + TOKEN_ESTIMATE_MIN;
+    if (token_buffer_reserve(tokens, estimate) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
 
     while (*contents != '\0') {
-        if (i >= capacity) {
-            *tokens = realloc(*tokens, sizeof **tokens * (capacity *= 2));
-            memset(&(*tokens)[capacity / 2], 0, sizeof **tokens * (capacity / 2));
+        if ((end = lex_token(contents, &ttype, &hash)) == NULL) {
+            *error_offset = lex_token_error(contents) - tokens->source;
+            return EXIT_FAILURE;
         }
 
-        end = NULL;
-        if ((end = get_keyword_or_operator(contents, &ttype)), end != NULL) {
-            (*tokens)[i++].type = ttype;
-            contents = end;
-        } else if (is_identifier_first_char(*contents)) {
-            end = traverse_identifier(contents);
-            struct StringView id = { .data = contents, .length = end - contents };
-            contents = end;
-
-            (*tokens)[i++] = (struct Token) {
-                .type = TTIDENTIFIER,
-                .view = id,
-            };
-        } else if (isspace(*contents)) {
-            // TODO this doesn't always work
-            if (*contents == '\n') ++line;
-            while (isspace(*(++contents)))
-                if (*contents == '\n') ++line;
-        } else if (isdigit(*contents)) {
-            end = traverse_digit_literal(contents);
-            (*tokens)[i++] = (struct Token) {
-                .type = TTNUMLITERAL,
-                .view = { .data = contents, .length = end - contents },
-            };
-            contents = end;
-        } else if (strncmp(contents, "//", 2) == 0) {
-            // a line comment
-            contents = traverse_line_comment(contents);
-        } else if (strncmp(contents, "/*", 2) == 0) {
-            // a block comment
-            contents = traverse_block_comment(contents, &line);
-        } else if (*contents == '\'') {
-            // single-quoted string
-            end = traverse_single_quoted_string(contents);
-            if (end == NULL) return EXIT_FAILURE;
-            (*tokens)[i++] = (struct Token) {
-                .type = TTSINGLESTRING,
-                .view = { .data = contents, .length = end - contents },
-            };
-        } else if (*contents == '"') {
-            // double-quoted string
-            end = traverse_double_quoted_string(contents);
-            if (end == NULL) return EXIT_FAILURE;
-            (*tokens)[i++] = (struct Token) {
-                .type = TTSINGLESTRING,
-                .view = { .data = contents, .length = end - contents },
-            };
-        } else {
-            assert(0 && "unreachable");
+        symbol = SYMBOL_NONE;
+        if (ttype == TTIDENTIFIER && (symbol = intern(interner, contents, end - contents, hash)) == SYMBOL_NONE)
+            return EXIT_FAILURE;
+
+        if (ttype != TTNONE && token_buffer_push(tokens, ttype, contents - tokens->source, end - contents, symbol) != EXIT_SUCCESS)
+            return EXIT_FAILURE;
+
+        contents = end;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/**The index of the first token that ends at or after offset, or tokens->count.
+ */
+static size_t first_token_ending(const struct TokenBuffer *tokens, size_t offset)
+{
+    size_t low = 0, high = tokens->count;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if ((size_t)token_start(tokens, middle) + tokens->lengths[middle] < offset)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+int retokenise_edits(const char *contents, size_t length, struct Interner *interner, struct TokenBuffer *tokens,
+                     const struct TextEdit *edits, size_t edit_count, struct TokenChange *change)
+{
+    enum TokenType ttype;
+    uint32_t hash = 0, symbol;
+    int result = EXIT_FAILURE;
+
+    if (length > UINT32_MAX)
+        return EXIT_FAILURE; // offsets are 32 bits
+
+    if (edit_count == 0) {
+        tokens->source = contents;
+        *change = (struct TokenChange) {0};
+        return EXIT_SUCCESS;
+    }
+
+    // the edits are lexed as one damaged region, from the first to the last
+    size_t damage_start = edits[0].start;
+    size_t damage_end = edits[edit_count - 1].start + edits[edit_count - 1].old_length;
+    ptrdiff_t delta = 0;
+
+    for (size_t i = 0; i < edit_count; i++)
+        delta += (ptrdiff_t)edits[i].new_length - (ptrdiff_t)edits[i].old_length;
+
+    // a token whose lookahead reached into the damage may lex differently, so
+    // start from the end of the one before
+    size_t first = first_token_ending(tokens, damage_start > LEXER_LOOKAHEAD ? damage_start - LEXER_LOOKAHEAD : 0);
+    size_t offset = first > 0 ? token_start(tokens, first - 1) + tokens->lengths[first - 1] : 0;
+    size_t old = first;
+    struct TokenBuffer relexed = { .source = contents };
+
+    while (offset < length && contents[offset] != '\0') {
+        // once past the damage, a token starting where an old one did means
+        // the rest are the old tokens, moved by delta
+        if (offset >= (size_t)(damage_end + delta)) {
+            size_t before = offset - delta;
+
+            while (old < tokens->count && token_start(tokens, old) < before)
+                ++old;
+
+            if (old < tokens->count && token_start(tokens, old) == before)
+                goto synced;
         }
+
+        const char *end = lex_token(&contents[offset], &ttype, &hash);
+        if (end == NULL)
+            goto done;
+
+        symbol = SYMBOL_NONE;
+        if (ttype == TTIDENTIFIER && (symbol = intern(interner, &contents[offset], end - &contents[offset], hash)) == SYMBOL_NONE)
+            goto done;
+
+        if (ttype != TTNONE && token_buffer_push(&relexed, ttype, offset, end - &contents[offset], symbol) != EXIT_SUCCESS)
+            goto done;
+
+        offset = end - contents;
     }
 
-    if (tokens_written != NULL)
-        *tokens_written = i;
+    old = tokens->count;
 
-    return EXIT_SUCCESS;
+synced:;
+    size_t tail = tokens->count - old, count = first + relexed.count + tail;
+    // where the shift already pending starts, if there is one
+    size_t pending = tokens->shift != 0 ? tokens->shift_from : old;
+
+    if (token_buffer_reserve(tokens, count) != EXIT_SUCCESS)
+        goto done;
+
+    size_t to = first + relexed.count;
+
+    // one shift is kept pending, from the end of these edits on, so what's
+    // pending between the last edits and these is written in: the tokens
+    // before these edits that lagged, or those after that didn't
+    for (size_t i = pending; i < first; i++)
+        tokens->starts[i] += tokens->shift;
+    for (size_t i = old; i < pending; i++)
+        tokens->starts[i] += delta;
+
+    memmove(&tokens->types[to], &tokens->types[old], tail * sizeof *tokens->types);
+    memmove(&tokens->starts[to], &tokens->starts[old], tail * sizeof *tokens->starts);
+    memmove(&tokens->lengths[to], &tokens->lengths[old], tail * sizeof *tokens->lengths);
+    memmove(&tokens->symbols[to], &tokens->symbols[old], tail * sizeof *tokens->symbols);
+
+    if (relexed.count > 0) {
+        memcpy(&tokens->types[first], relexed.types, relexed.count * sizeof *tokens->types);
+        memcpy(&tokens->starts[first], relexed.starts, relexed.count * sizeof *tokens->starts);
+        memcpy(&tokens->lengths[first], relexed.lengths, relexed.count * sizeof *tokens->lengths);
+        memcpy(&tokens->symbols[first], relexed.symbols, relexed.count * sizeof *tokens->symbols);
+    }
+
+    tokens->shift_from = (pending > old ? pending : old) - old + to;
+    tokens->shift += delta;
+    tokens->count = count;
+    tokens->source = contents;
+    *change = (struct TokenChange) { .first = first, .old_count = old - first, .new_count = relexed.count };
+    result = EXIT_SUCCESS;
+
+done:
+    token_buffer_free(&relexed);
+
+    return result;
 }
@@ -0,0 +1,351 @@
+#include "compile.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+/* Every type is built through type_intern, which looks its kind, payload and
+ * list up in an open-addressing table of (hash, ID) slots before adding it,
+ * so a structure is only ever stored once.  The constructors put their lists
+ * into a canonical order first (union members and object members sorted,
+ * nested unions flattened) so that types which are the same up to order get
+ * the same ID too.  Candidate lists are built in table->scratch and only
+ * copied into extra if the type turns out to be new.
+ *
+ * The arrays live in the arena the table was given, and grow by doubling
+ * there the way the tree's do, so a table is never freed on its own.
+ */
+
+#define TYPE_INITIAL_SLOTS 1024
+#define TYPE_INITIAL_CAPACITY 256
+
+static uint32_t hash_type(uint8_t kind, uint32_t a, uint32_t b, const uint32_t *list, size_t length)
+{
+    const uint64_t K = 0x9e3779b97f4a7c15ull;
+    uint64_t h = (kind + 1) * K;
+
+    h = (h ^ (((uint64_t)a << 32) | b)) * K;
+    h ^= h >> 29;
+
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ list[i]) * K;
+        h ^= h >> 29;
+    }
+
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+static bool same_type(const struct TypeTable *table, uint32_t type, uint8_t kind, uint32_t a, uint32_t b,
+                      const uint32_t *list, size_t length)
+{
+    struct Type t = table->types[type];
+
+    if (t.kind != kind)
+        return false;
+
+    if (!type_kind_has_list(kind))
+        return t.a == a && t.b == b;
+
+    return t.b == length && memcmp(&table->extra[t.a], list, length * sizeof *list) == 0;
+}
+
+static struct TypeSlot *new_slots(struct Arena *arena, size_t slot_count)
+{
+    struct TypeSlot *slots = ARENA_NEW(arena, struct TypeSlot, slot_count);
+
+    if (slots != NULL)
+        memset(slots, 0, slot_count * sizeof *slots);
+
+    return slots;
+}
+
+static int grow_slots(struct TypeTable *table)
+{
+    size_t slot_count = table->slot_count * 2;
+    struct TypeSlot *slots = new_slots(table->arena, slot_count);
+
+    if (slots == NULL)
+        return EXIT_FAILURE;
+
+    for (size_t i = 0; i < table->slot_count; i++) {
+        struct TypeSlot slot = table->slots[i];
+        if (slot.type == TYPE_NONE)
+            continue;
+
+        size_t j = slot.hash & (slot_count - 1);
+        while (slots[j].type != TYPE_NONE)
+            j = (j + 1) & (slot_count - 1);
+        slots[j] = slot;
+    }
+
+    table->slots = slots;
+    table->slot_count = slot_count;
+
+    return EXIT_SUCCESS;
+}
+
+static int reserve(struct Arena *arena, void **array, size_t *capacity, size_t needed, size_t size)
+{
+    if (needed <= *capacity)
+        return EXIT_SUCCESS;
+
+    size_t wanted = *capacity ? *capacity : TYPE_INITIAL_CAPACITY;
+    while (wanted < needed)
+        wanted *= 2;
+
+    void *resized = arena_resize(arena, *array, *capacity * size, wanted * size);
+    if (resized == NULL)
+        return EXIT_FAILURE;
+
+    *array = resized;
+    *capacity = wanted;
+
+    return EXIT_SUCCESS;
+}
+
+uint32_t type_intern(struct TypeTable *table, uint8_t kind, uint32_t a, uint32_t b, const uint32_t *list, size_t length)
+{
+    assert(type_kind_has_list(kind) || length == 0);
+
+    uint32_t hash = hash_type(kind, a, b, list, length);
+    size_t mask = table->slot_count - 1;
+    size_t i = hash & mask;
+
+    for (; table->slots[i].type != TYPE_NONE; i = (i + 1) & mask) {
+        struct TypeSlot slot = table->slots[i];
+        if (slot.hash == hash && same_type(table, slot.type, kind, a, b, list, length))
+            return slot.type;
+    }
+
+    // a new type
+    if (reserve(table->arena, (void **)&table->types, &table->capacity, table->count + 1, sizeof *table->types)
+            != EXIT_SUCCESS)
+        return TYPE_NONE;
+
+    if (type_kind_has_list(kind)) {
+        if (reserve(table->arena, (void **)&table->extra, &table->extra_capacity, table->extra_count + length,
+                    sizeof *table->extra) != EXIT_SUCCESS)
+            return TYPE_NONE;
+
+        // list may be table->scratch, which extra never overlaps
+        if (length > 0)
+            memcpy(&table->extra[table->extra_count], list, length * sizeof *list);
+        a = table->extra_count;
+        b = length;
+        table->extra_count += length;
+    }
+
+    uint32_t type = table->count++;
+    table->types[type] = (struct Type) { .kind = kind, .a = a, .b = b };
+    table->slots[i] = (struct TypeSlot) { .hash = hash, .type = type };
+
+    // keep the load factor at or below a half
+    if (table->count * 2 > table->slot_count && grow_slots(table) != EXIT_SUCCESS)
+        return TYPE_NONE;
+
+    return type;
+}
+
+int type_table_init(struct TypeTable *table, struct Arena *arena)
+{
+    *table = (struct TypeTable) { .arena = arena };
+
+    table->slots = new_slots(arena, TYPE_INITIAL_SLOTS);
+    if (table->slots == NULL)
+        return EXIT_FAILURE;
+
+    table->slot_count = TYPE_INITIAL_SLOTS;
+
+    if (reserve(arena, (void **)&table->types, &table->capacity, TKPRIMITIVEMAX, sizeof *table->types) != EXIT_SUCCESS)
+        return EXIT_FAILURE;
+
+    // ID 0 is TYPE_NONE, and each primitive's ID is its kind
+    table->types[TYPE_NONE] = (struct Type) { .kind = TKNONE };
+    table->count = 1;
+
+    for (uint8_t kind = TYPE_NONE + 1; kind < TKPRIMITIVEMAX; kind++)
+        if (type_intern(table, kind, 0, 0, NULL, 0) != kind)
+            return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
+
+int type_table_copy(struct TypeTable *copy, const struct TypeTable *table, struct Arena *arena)
+{
+    *copy = (struct TypeTable) {
+        .arena = arena,
+        .count = table->count,
+        .capacity = table->count,
+        .extra_count = table->extra_count,
+        .extra_capacity = table->extra_count,
+        .slot_count = table->slot_count,
+    };
+
+    copy->types = ARENA_NEW(arena, struct Type, table->count);
+    copy->extra = ARENA_NEW(arena, uint32_t, table->extra_count ? table->extra_count : 1);
+    copy->slots = ARENA_NEW(arena, struct TypeSlot, table->slot_count);
+
+    if (copy->types == NULL || copy->extra == NULL || copy->slots == NULL)
+        return EXIT_FAILURE;
+
+    memcpy(copy->types, table->types, table->count * sizeof *copy->types);
+    if (table->extra_count > 0)
+        memcpy(copy->extra, table->extra, table->extra_count * sizeof *copy->extra);
+    memcpy(copy->slots, table->slots, table->slot_count * sizeof *copy->slots);
+
+    return EXIT_SUCCESS;
+}
+
+static uint32_t *scratch(struct TypeTable *table, size_t length)
+{
+    // never NULL, even for an empty list
+    if (reserve(table->arena, (void **)&table->scratch, &table->scratch_capacity, length + 1, sizeof *table->scratch)
+            != EXIT_SUCCESS)
+        return NULL;
+
+    return table->scratch;
+}
+
+uint32_t type_string_literal(struct TypeTable *table, uint32_t symbol)
+{
+    return type_intern(table, TKSTRINGLITERAL, symbol, 0, NULL, 0);
+}
+
+uint32_t type_number_literal(struct TypeTable *table, double value)
+{
+    uint64_t bits;
+
+    // every NaN is the same type, and 0 and -0 are the same literal
+    if (value != value)
+        value = NAN;
+    else if (value == 0)
+        value = 0;
+
+    memcpy(&bits, &value, sizeof bits);
+
+    return type_intern(table, TKNUMBERLITERAL, (uint32_t)bits, (uint32_t)(bits >> 32), NULL, 0);
+}
+
+uint32_t type_array(struct TypeTable *table, uint32_t element)
+{
+    return type_intern(table, TKARRAY, element, 0, NULL, 0);
+}
+
+uint32_t type_parameter(struct TypeTable *table, uint32_t symbol, uint32_t declaration)
+{
+    return type_intern(table, TKPARAMETER, symbol, declaration, NULL, 0);
+}
+
+static int compare_ids(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+uint32_t type_union(struct TypeTable *table, const uint32_t *members, size_t count)
+{
+    size_t length = 0;
+    bool unknown = false;
+
+    // any absorbs everything, and unknown everything but any; a union never
+    // holds either, so only the members themselves need looking at
+    for (size_t i = 0; i < count; i++) {
+        struct Type t = table->types[members[i]];
+
+        if (members[i] == TKANY)
+            return TKANY;
+
+        unknown |= members[i] == TKUNKNOWN;
+        length += t.kind == TKUNION ? t.b : 1;
+    }
+
+    if (unknown)
+        return TKUNKNOWN;
+
+    uint32_t *list = scratch(table, length);
+    if (list == NULL)
+        return TYPE_NONE;
+
+    // members can't point into scratch, so flattening into it is safe
+    length = 0;
+    for (size_t i = 0; i < count; i++) {
+        struct Type t = table->types[members[i]];
+
+        if (t.kind == TKUNION) {
+            memcpy(&list[length], &table->extra[t.a], t.b * sizeof *list);
+            length += t.b;
+        } else if (members[i] != TKNEVER) {
+            list[length++] = members[i];
+        }
+    }
+
+    qsort(list, length, sizeof *list, compare_ids);
+
+    size_t unique = 0;
+    for (size_t i = 0; i < length; i++)
+        if (unique == 0 || list[unique - 1] != list[i])
+            list[unique++] = list[i];
+
+    if (unique == 0)
+        return TKNEVER;
+    if (unique == 1)
+        return list[0];
+
+    return type_intern(table, TKUNION, 0, 0, list, unique);
+}
+
+static int compare_members(const void *a, const void *b)
+{
+    const struct TypeMember *x = a, *y = b;
+    return (x->name > y->name) - (x->name < y->name);
+}
+
+uint32_t type_object(struct TypeTable *table, struct TypeMember *members, size_t count)
+{
+    uint32_t *list = scratch(table, count * 3);
+    if (list == NULL)
+        return TYPE_NONE;
+
+    if (count > 1)
+        qsort(members, count, sizeof *members, compare_members);
+
+    for (size_t i = 0; i < count; i++) {
+        assert(i == 0 || members[i - 1].name != members[i].name);
+        list[i * 3] = members[i].name;
+        list[i * 3 + 1] = members[i].type;
+        list[i * 3 + 2] = members[i].flags;
+    }
+
+    return type_intern(table, TKOBJECT, 0, 0, list, count * 3);
+}
+
+uint32_t type_function(struct TypeTable *table, const uint32_t *parameters, size_t count, size_t required,
+                       bool rest, uint32_t result)
+{
+    assert(required <= count && (!rest || count > 0));
+
+    uint32_t *list = scratch(table, count + 3);
+    if (list == NULL)
+        return TYPE_NONE;
+
+    list[0] = result;
+    list[1] = required;
+    list[2] = rest;
+    if (count > 0)
+        memcpy(&list[3], parameters, count * sizeof *parameters);
+
+    return type_intern(table, TKFUNCTION, 0, 0, list, count + 3);
+}
+
+uint32_t type_instance(struct TypeTable *table, uint32_t declaration, const uint32_t *arguments, size_t count)
+{
+    uint32_t *list = scratch(table, count + 1);
+    if (list == NULL)
+        return TYPE_NONE;
+
+    list[0] = declaration;
+    if (count > 0)
+        memcpy(&list[1], arguments, count * sizeof *arguments);
+
+    return type_intern(table, TKINSTANCE, 0, 0, list, count + 1);
+}
@@ -0,0 +1,390 @@
+#define _POSIX_C_SOURCE 200112L // clock_gettime and posix_memalign
+
+#include "compile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* The harness behind --reparse, --bench-reparse and --recheck.  It edits a
+ * file in place and brings its tokens and tree up to date with reparse_edits,
+ * then lexes and parses the edited text from scratch and compares the two,
+ * token by token and subtree by subtree.  Edits come in pairs spread through
+ * the file: one adds a statement after a ; and renames the next identifier,
+ * and the other takes the statement away again.  With recheck, check_program
+ * is run with a CheckState carried from edit to edit and again with none,
+ * and the two must report the same diagnostics.
+ */
+
+// pairs of edits made by verify_reparse
+#define REPARSE_EDITS 32
+
+static double seconds_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+static bool same_child(const struct Ast *a, uint32_t x, const struct Ast *b, uint32_t y);
+
+static bool same_list(const struct Ast *a, uint32_t x, const struct Ast *b, uint32_t y, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+        if (!same_child(a, a->extra[x + i], b, b->extra[y + i]))
+            return false;
+
+    return true;
+}
+
+/**Whether the subtrees at x in a and y in b are the same, reading tokens
+ * through the shifts reparse_edits may have left pending.  It doesn't care
+ * how the nodes are numbered, as a reparsed tree keeps the nodes it dropped.
+ */
+static bool same_subtree(const struct Ast *a, uint32_t x, const struct Ast *b, uint32_t y)
+{
+    struct Node m = a->nodes[x], n = b->nodes[y];
+
+    if (m.kind != n.kind || ast_node_token(a, x) != ast_node_token(b, y))
+        return false;
+
+    switch (node_layouts[m.kind]) {
+    case NLLEAF:
+        if (m.kind == ETNUMERICLITERAL)
+            return m.rhs == n.rhs && memcmp(&a->numbers[m.lhs], &b->numbers[n.lhs], sizeof *a->numbers) == 0;
+        return m.lhs == n.lhs && m.rhs == n.rhs;
+    case NLUNARY:
+    case NLMEMBER:
+        return m.rhs == n.rhs && same_child(a, m.lhs, b, n.lhs);
+    case NLBINARY:
+        return same_child(a, m.lhs, b, n.lhs) && same_child(a, m.rhs, b, n.rhs);
+    case NLTERNARY:
+        return same_child(a, m.lhs, b, n.lhs) && same_list(a, m.rhs, b, n.rhs, 2);
+    case NLCALL:
+        return same_child(a, m.lhs, b, n.lhs) && a->extra[m.rhs] == b->extra[n.rhs]
+            && same_list(a, m.rhs + 1, b, n.rhs + 1, a->extra[m.rhs]);
+    case NLLIST:
+        return m.rhs == n.rhs && same_list(a, m.lhs, b, n.lhs, m.rhs);
+    case NLFUNCTION: {
+        struct Function f = ast_function(a, m.lhs), g = ast_function(b, n.lhs);
+        return f.name == g.name && f.body_start == g.body_start && f.body_end == g.body_end
+            && a->extra[f.parameters] == b->extra[g.parameters]
+            && same_list(a, f.parameters + 1, b, g.parameters + 1, a->extra[f.parameters])
+            && same_child(a, f.result, b, g.result) && same_child(a, f.body, b, g.body);
+    }
+    case NLDECLARATION:
+    case NLNAMED:
+        return m.lhs == n.lhs && same_child(a, m.rhs, b, n.rhs);
+    }
+
+    return false;
+}
+
+static bool same_child(const struct Ast *a, uint32_t x, const struct Ast *b, uint32_t y)
+{
+    if (x == NODE_NONE || y == NODE_NONE)
+        return x == y;
+
+    return same_subtree(a, x, b, y);
+}
+
+/**Whether tokens and ast, as reparse_edits left them, are what lexing and
+ * parsing from scratch gave.  Both were interned into the same interner.
+ */
+static bool same_reparse(const struct TokenBuffer *tokens, const struct Ast *ast,
+                         const struct TokenBuffer *fresh_tokens, const struct Ast *fresh)
+{
+    if (tokens->count != fresh_tokens->count)
+        return false;
+
+    for (size_t i = 0; i < tokens->count; i++) {
+        if (tokens->types[i] != fresh_tokens->types[i] || token_start(tokens, i) != token_start(fresh_tokens, i)
+                || tokens->lengths[i] != fresh_tokens->lengths[i] || tokens->symbols[i] != fresh_tokens->symbols[i])
+            return false;
+    }
+
+    return same_subtree(ast, 0, fresh, 0);
+}
+
+/**A ; that ends a statement, at or after token from, or tokens->count: one
+ * not inside parentheses or brackets, as in for (;;).
+ */
+static size_t statement_semicolon(const struct TokenBuffer *tokens, size_t from)
+{
+    uint8_t *open = malloc(tokens->count + 1);
+    size_t depth = 0, i = 0;
+
+    for (; open != NULL && i < tokens->count; i++) {
+        enum TokenType ttype = token_type(tokens, i);
+
+        if (ttype == TTOPENPAREN || ttype == TTOPENBRACKET || ttype == TTOPENBRACE)
+            open[depth++] = ttype;
+        else if ((ttype == TTCLOSEPAREN || ttype == TTCLOSEBRACKET || ttype == TTCLOSEBRACE) && depth > 0)
+            depth--;
+        else if (ttype == TTSEMICOLON && i >= from && (depth == 0 || open[depth - 1] == TTOPENBRACE))
+            break;
+    }
+
+    free(open);
+
+    return open != NULL ? i : tokens->count;
+}
+
+/**Applies edits, in order and in the offsets of the text before them, to
+ * the text in place, writing new_text for each.
+ */
+static void apply_edits(char *text, size_t *length, const struct TextEdit *edits, const char *const *new_text,
+                        size_t count)
+{
+    for (size_t k = count; k-- > 0; ) {
+        struct TextEdit edit = edits[k];
+        size_t after = edit.start + edit.old_length;
+
+        memmove(&text[edit.start + edit.new_length], &text[after], *length - after + 1);
+        memcpy(&text[edit.start], new_text[k], edit.new_length);
+        *length = *length - edit.old_length + edit.new_length;
+    }
+}
+
+/**Lexes and parses text from scratch into tokens and ast.
+ */
+static bool parse_fresh(const char *text, size_t length, struct Interner *interner, struct TokenBuffer *tokens,
+                        struct Ast *ast, struct Arena *arena)
+{
+    size_t error_offset, error_token;
+
+    arena_init(arena);
+
+    return tokenise_file(text, length, interner, tokens, &error_offset) == EXIT_SUCCESS
+        && ast_init(ast, arena, tokens->count) == EXIT_SUCCESS
+        && parse_tokens(tokens, ast, &error_token) == EXIT_SUCCESS;
+}
+
+/**What --recheck keeps from one check to the next.  A CheckState only
+ * makes sense with the type table it was made with, so the table lives as
+ * long as the state.
+ */
+struct Recheck {
+    struct Arena arena;         // what types is allocated from
+    struct TypeTable types;
+    struct CheckState state;
+    size_t checked, kept;
+};
+
+/**Whether the diagnostics are the same, in the same order, at the same
+ * tokens.
+ */
+static bool same_diagnostics(const struct Diagnostics *a, const struct Diagnostics *b)
+{
+    if (a->count != b->count)
+        return false;
+
+    for (size_t i = 0; i < a->count; i++) {
+        if (a->items[i].token != b->items[i].token || strcmp(a->items[i].message, b->items[i].message) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+/**Checks tokens and ast, as reparse_edits left them, with what the last
+ * check remembered, and fresh from scratch with nothing remembered, and
+ * returns whether both came out the same.  Every function body in both
+ * trees is parsed by the end.
+ */
+static bool same_recheck(struct Recheck *recheck, struct TokenBuffer *tokens, struct Ast *ast,
+                         const struct TokenBuffer *fresh_tokens, struct Ast *fresh, struct Interner *interner)
+{
+    struct Diagnostics diagnostics = {0}, full = {0};
+    struct Arena arena;
+    struct TypeTable types;
+    size_t error_token, full_error_token;
+    int result, full_result = EXIT_FAILURE;
+
+    arena_init(&diagnostics.text);
+    arena_init(&full.text);
+    arena_init(&arena);
+
+    reparse_settle(tokens, ast);
+    result = check_program(tokens, ast, interner, &recheck->types, &diagnostics, &error_token, 1, &recheck->state);
+    recheck->checked += recheck->state.checked;
+    recheck->kept += recheck->state.kept;
+
+    if (type_table_init(&types, &arena) == EXIT_SUCCESS)
+        full_result = check_program(fresh_tokens, fresh, interner, &types, &full, &full_error_token, 1, NULL);
+
+    bool same = result == full_result && (result == EXIT_SUCCESS ? same_diagnostics(&diagnostics, &full)
+                                                                 : error_token == full_error_token);
+
+    // the bodies of what was kept weren't parsed, so parse every body for
+    // the trees to be compared
+    if (same && result == EXIT_SUCCESS) {
+        same = parse_function_bodies(tokens, ast, &error_token)
+            == parse_function_bodies(fresh_tokens, fresh, &full_error_token);
+    }
+
+    diagnostics_free(&diagnostics);
+    diagnostics_free(&full);
+    arena_free(&arena);
+
+    return same;
+}
+
+int verify_reparse(const char *name, bool bench, bool recheck)
+{
+    static const char *const added[] = { " x;", "_" };
+    struct SourceFile source;
+    struct Interner interner;
+    struct TokenBuffer tokens = {0};
+    struct Arena arena;
+    struct Ast ast;
+    struct Recheck checks = {0};
+    size_t error_token, edits = 0, failures = 0, mismatches = 0, recheck_mismatches = 0;
+    double reparse_time = 0, fresh_time = 0;
+
+    if (source_load(name, &source) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not load file\n");
+        return EXIT_FAILURE;
+    }
+
+    // every pair of edits leaves the text a byte longer
+    size_t length = source.length, capacity = source.length + REPARSE_EDITS + sizeof " x;";
+    // the scanners read whole aligned blocks, as they do from a mapped file
+    void *allocation = NULL;
+    char *saved = malloc(capacity);
+
+    if (posix_memalign(&allocation, SOURCE_PADDING, capacity + SOURCE_PADDING) != 0 || saved == NULL
+            || interner_init(&interner) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not allocate text\n");
+        free(allocation);
+        free(saved);
+        source_free(&source);
+        return EXIT_FAILURE;
+    }
+
+    char *text = allocation;
+    memset(text, 0, capacity + SOURCE_PADDING);
+    memcpy(text, source.data, length);
+
+    arena_init(&checks.arena);
+    if (recheck && type_table_init(&checks.types, &checks.arena) != EXIT_SUCCESS) {
+        fprintf(stderr, "could not allocate type table\n");
+        mismatches++;
+        goto done;
+    }
+
+    if (!parse_fresh(text, length, &interner, &tokens, &ast, &arena)) {
+        fprintf(stderr, "%s: failure to parse\n", name);
+        mismatches++;
+        goto done;
+    }
+
+    for (size_t pair = 0; pair < REPARSE_EDITS; pair++) {
+        size_t semicolon = statement_semicolon(&tokens, pair * tokens.count / REPARSE_EDITS), identifier;
+
+        for (identifier = semicolon + 1; identifier < tokens.count; identifier++)
+            if (token_type(&tokens, identifier) == TTIDENTIFIER)
+                break;
+        if (identifier >= tokens.count)
+            continue;
+
+        size_t end = token_start(&tokens, semicolon) + 1;
+        struct TextEdit edit[2] = {
+            { .start = end, .new_length = strlen(added[0]) },
+            { .start = token_start(&tokens, identifier) + tokens.lengths[identifier], .new_length = strlen(added[1]) },
+        };
+        struct TextEdit undo = { .start = end, .old_length = strlen(added[0]) };
+
+        for (size_t step = 0; step < 2; step++) {
+            const struct TextEdit *these = step == 0 ? edit : &undo;
+            size_t count = step == 0 ? 2 : 1, error_token;
+            struct TokenBuffer fresh_tokens = {0};
+            struct Arena fresh_arena;
+            struct Ast fresh;
+
+            memcpy(saved, text, length + 1);
+            size_t saved_length = length;
+            apply_edits(text, &length, these, added, count);
+            edits++;
+
+            double start = seconds_now();
+            bool reparsed = reparse_edits(text, length, &interner, &tokens, &ast, these, count, &error_token)
+                         == EXIT_SUCCESS;
+            double middle = seconds_now();
+            bool parsed = parse_fresh(text, length, &interner, &fresh_tokens, &fresh, &fresh_arena);
+            reparse_time += middle - start;
+            fresh_time += seconds_now() - middle;
+
+            // checking parses function bodies, so it goes first for the
+            // trees to be compared
+            bool rechecked = !(recheck && reparsed && parsed)
+                          || same_recheck(&checks, &tokens, &ast, &fresh_tokens, &fresh, &interner);
+
+            if (reparsed != parsed || (parsed && !same_reparse(&tokens, &ast, &fresh_tokens, &fresh))) {
+                printf("edit %zu: reparsing %s\n", edits, reparsed == parsed ? "differs from parsing from scratch"
+                                                       : reparsed ? "succeeded where parsing failed"
+                                                       : "failed where parsing succeeded");
+                mismatches++;
+            } else if (!rechecked) {
+                printf("edit %zu: checking again differs from checking from scratch\n", edits);
+                recheck_mismatches++;
+            }
+
+            token_buffer_free(&fresh_tokens);
+            arena_free(&fresh_arena);
+
+            if (reparsed == parsed && parsed)
+                continue;
+
+            // start again from the text before, which parses
+            failures += !parsed;
+            memcpy(text, saved, saved_length + 1);
+            length = saved_length;
+            token_buffer_free(&tokens);
+            arena_free(&arena);
+            parse_fresh(text, length, &interner, &tokens, &ast, &arena);
+            break;
+        }
+    }
+
+    // and once the shifts still pending are written in
+    struct TokenBuffer fresh_tokens = {0};
+    struct Arena fresh_arena;
+    struct Ast fresh;
+
+    reparse_settle(&tokens, &ast);
+    bool parsed = parse_fresh(text, length, &interner, &fresh_tokens, &fresh, &fresh_arena);
+    if (parsed && recheck) {
+        parsed = parse_function_bodies(&tokens, &ast, &error_token)
+              == parse_function_bodies(&fresh_tokens, &fresh, &error_token);
+    }
+    if (!parsed || !same_reparse(&tokens, &ast, &fresh_tokens, &fresh)) {
+        printf("settled: reparsing differs from parsing from scratch\n");
+        mismatches++;
+    }
+
+    printf("%zu edits, %zu that don't parse, %zu where reparsing differs\n", edits, failures, mismatches);
+    if (recheck) {
+        printf("%zu parts checked again, %zu kept, %zu edits where checking differs\n", checks.checked, checks.kept,
+               recheck_mismatches);
+    }
+    if (bench && edits > 0) {
+        printf("reparse    %8.1f us per edit\n", reparse_time / edits * 1e6);
+        printf("from scratch %6.1f us per edit\n", fresh_time / edits * 1e6);
+    }
+
+    token_buffer_free(&fresh_tokens);
+    arena_free(&fresh_arena);
+done:
+    check_state_free(&checks.state);
+    arena_free(&checks.arena);
+    token_buffer_free(&tokens);
+    arena_free(&arena);
+    interner_free(&interner);
+    free(text);
+    free(saved);
+    source_free(&source);
+
+    return mismatches > 0 || recheck_mismatches > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
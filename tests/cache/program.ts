@@ -0,0 +1,17 @@
+interface Point {
+    x: number;
+    y: number;
+}
+
+const origin: Point = { x: 0, y: 0 };
+let total = 0x10 + 1.5e3 + 7n;
+
+function distance(a: Point, b: Point): number {
+    const dx = a.x - b.x;
+    const dy = a.y - b.y;
+    return Math.sqrt(dx * dx + dy * dy);
+}
+
+type Shape = { kind: "circle", radius: number } | { kind: "square", side: number };
+
+const names = ["a", "b", "c"].map((s) => s + origin.x);
@@ -0,0 +1,16 @@
+interface Options {
+    default: number;
+    new?: string;
+    readonly delete: boolean;
+}
+
+let options: Options = { default: 1, delete: false };
+let a: number = options.default;
+let b: string = options.default;
+let c = options.class;
+let d: string | undefined = options.new;
+
+let o = { x: 1, default: "d", in: 2 };
+let e: string = o.default;
+let f: string = o.in;
+let g = o.for;
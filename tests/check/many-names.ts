@@ -0,0 +1,2503 @@
+// enough names to grow the interner's slots and strings more than once
+let name0: number = 0;
+let name1: number = name0 + 1;
+let name2: number = name1 + 2;
+let name3: number = name2 + 3;
+let name4: number = name3 + 4;
+let name5: number = name4 + 5;
+let name6: number = name5 + 6;
+let name7: number = name6 + 7;
+let name8: number = name7 + 8;
+let name9: number = name8 + 9;
+let name10: number = name9 + 10;
+let name11: number = name10 + 11;
+let name12: number = name11 + 12;
+let name13: number = name12 + 13;
+let name14: number = name13 + 14;
+let name15: number = name14 + 15;
+let name16: number = name15 + 16;
+let name17: number = name16 + 17;
+let name18: number = name17 + 18;
+let name19: number = name18 + 19;
+let name20: number = name19 + 20;
+let name21: number = name20 + 21;
+let name22: number = name21 + 22;
+let name23: number = name22 + 23;
+let name24: number = name23 + 24;
+let name25: number = name24 + 25;
+let name26: number = name25 + 26;
+let name27: number = name26 + 27;
+let name28: number = name27 + 28;
+let name29: number = name28 + 29;
+let name30: number = name29 + 30;
+let name31: number = name30 + 31;
+let name32: number = name31 + 32;
+let name33: number = name32 + 33;
+let name34: number = name33 + 34;
+let name35: number = name34 + 35;
+let name36: number = name35 + 36;
+let name37: number = name36 + 37;
+let name38: number = name37 + 38;
+let name39: number = name38 + 39;
+let name40: number = name39 + 40;
+let name41: number = name40 + 41;
+let name42: number = name41 + 42;
+let name43: number = name42 + 43;
+let name44: number = name43 + 44;
+let name45: number = name44 + 45;
+let name46: number = name45 + 46;
+let name47: number = name46 + 47;
+let name48: number = name47 + 48;
+let name49: number = name48 + 49;
+let name50: number = name49 + 50;
+let name51: number = name50 + 51;
+let name52: number = name51 + 52;
+let name53: number = name52 + 53;
+let name54: number = name53 + 54;
+let name55: number = name54 + 55;
+let name56: number = name55 + 56;
+let name57: number = name56 + 57;
+let name58: number = name57 + 58;
+let name59: number = name58 + 59;
+let name60: number = name59 + 60;
+let name61: number = name60 + 61;
+let name62: number = name61 + 62;
+let name63: number = name62 + 63;
+let name64: number = name63 + 64;
+let name65: number = name64 + 65;
+let name66: number = name65 + 66;
+let name67: number = name66 + 67;
+let name68: number = name67 + 68;
+let name69: number = name68 + 69;
+let name70: number = name69 + 70;
+let name71: number = name70 + 71;
+let name72: number = name71 + 72;
+let name73: number = name72 + 73;
+let name74: number = name73 + 74;
+let name75: number = name74 + 75;
+let name76: number = name75 + 76;
+let name77: number = name76 + 77;
+let name78: number = name77 + 78;
+let name79: number = name78 + 79;
+let name80: number = name79 + 80;
+let name81: number = name80 + 81;
+let name82: number = name81 + 82;
+let name83: number = name82 + 83;
+let name84: number = name83 + 84;
+let name85: number = name84 + 85;
+let name86: number = name85 + 86;
+let name87: number = name86 + 87;
+let name88: number = name87 + 88;
+let name89: number = name88 + 89;
+let name90: number = name89 + 90;
+let name91: number = name90 + 91;
+let name92: number = name91 + 92;
+let name93: number = name92 + 93;
+let name94: number = name93 + 94;
+let name95: number = name94 + 95;
+let name96: number = name95 + 96;
+let name97: number = name96 + 97;
+let name98: number = name97 + 98;
+let name99: number = name98 + 99;
+let name100: number = name99 + 100;
+let name101: number = name100 + 101;
+let name102: number = name101 + 102;
+let name103: number = name102 + 103;
+let name104: number = name103 + 104;
+let name105: number = name104 + 105;
+let name106: number = name105 + 106;
+let name107: number = name106 + 107;
+let name108: number = name107 + 108;
+let name109: number = name108 + 109;
+let name110: number = name109 + 110;
+let name111: number = name110 + 111;
+let name112: number = name111 + 112;
+let name113: number = name112 + 113;
+let name114: number = name113 + 114;
+let name115: number = name114 + 115;
+let name116: number = name115 + 116;
+let name117: number = name116 + 117;
+let name118: number = name117 + 118;
+let name119: number = name118 + 119;
+let name120: number = name119 + 120;
+let name121: number = name120 + 121;
+let name122: number = name121 + 122;
+let name123: number = name122 + 123;
+let name124: number = name123 + 124;
+let name125: number = name124 + 125;
+let name126: number = name125 + 126;
+let name127: number = name126 + 127;
+let name128: number = name127 + 128;
+let name129: number = name128 + 129;
+let name130: number = name129 + 130;
+let name131: number = name130 + 131;
+let name132: number = name131 + 132;
+let name133: number = name132 + 133;
+let name134: number = name133 + 134;
+let name135: number = name134 + 135;
+let name136: number = name135 + 136;
+let name137: number = name136 + 137;
+let name138: number = name137 + 138;
+let name139: number = name138 + 139;
+let name140: number = name139 + 140;
+let name141: number = name140 + 141;
+let name142: number = name141 + 142;
+let name143: number = name142 + 143;
+let name144: number = name143 + 144;
+let name145: number = name144 + 145;
+let name146: number = name145 + 146;
+let name147: number = name146 + 147;
+let name148: number = name147 + 148;
+let name149: number = name148 + 149;
+let name150: number = name149 + 150;
+let name151: number = name150 + 151;
+let name152: number = name151 + 152;
+let name153: number = name152 + 153;
+let name154: number = name153 + 154;
+let name155: number = name154 + 155;
+let name156: number = name155 + 156;
+let name157: number = name156 + 157;
+let name158: number = name157 + 158;
+let name159: number = name158 + 159;
+let name160: number = name159 + 160;
+let name161: number = name160 + 161;
+let name162: number = name161 + 162;
+let name163: number = name162 + 163;
+let name164: number = name163 + 164;
+let name165: number = name164 + 165;
+let name166: number = name165 + 166;
+let name167: number = name166 + 167;
+let name168: number = name167 + 168;
+let name169: number = name168 + 169;
+let name170: number = name169 + 170;
+let name171: number = name170 + 171;
+let name172: number = name171 + 172;
+let name173: number = name172 + 173;
+let name174: number = name173 + 174;
+let name175: number = name174 + 175;
+let name176: number = name175 + 176;
+let name177: number = name176 + 177;
+let name178: number = name177 + 178;
+let name179: number = name178 + 179;
+let name180: number = name179 + 180;
+let name181: number = name180 + 181;
+let name182: number = name181 + 182;
+let name183: number = name182 + 183;
+let name184: number = name183 + 184;
+let name185: number = name184 + 185;
+let name186: number = name185 + 186;
+let name187: number = name186 + 187;
+let name188: number = name187 + 188;
+let name189: number = name188 + 189;
+let name190: number = name189 + 190;
+let name191: number = name190 + 191;
+let name192: number = name191 + 192;
+let name193: number = name192 + 193;
+let name194: number = name193 + 194;
+let name195: number = name194 + 195;
+let name196: number = name195 + 196;
+let name197: number = name196 + 197;
+let name198: number = name197 + 198;
+let name199: number = name198 + 199;
+let name200: number = name199 + 200;
+let name201: number = name200 + 201;
+let name202: number = name201 + 202;
+let name203: number = name202 + 203;
+let name204: number = name203 + 204;
+let name205: number = name204 + 205;
+let name206: number = name205 + 206;
+let name207: number = name206 + 207;
+let name208: number = name207 + 208;
+let name209: number = name208 + 209;
+let name210: number = name209 + 210;
+let name211: number = name210 + 211;
+let name212: number = name211 + 212;
+let name213: number = name212 + 213;
+let name214: number = name213 + 214;
+let name215: number = name214 + 215;
+let name216: number = name215 + 216;
+let name217: number = name216 + 217;
+let name218: number = name217 + 218;
+let name219: number = name218 + 219;
+let name220: number = name219 + 220;
+let name221: number = name220 + 221;
+let name222: number = name221 + 222;
+let name223: number = name222 + 223;
+let name224: number = name223 + 224;
+let name225: number = name224 + 225;
+let name226: number = name225 + 226;
+let name227: number = name226 + 227;
+let name228: number = name227 + 228;
+let name229: number = name228 + 229;
+let name230: number = name229 + 230;
+let name231: number = name230 + 231;
+let name232: number = name231 + 232;
+let name233: number = name232 + 233;
+let name234: number = name233 + 234;
+let name235: number = name234 + 235;
+let name236: number = name235 + 236;
+let name237: number = name236 + 237;
+let name238: number = name237 + 238;
+let name239: number = name238 + 239;
+let name240: number = name239 + 240;
+let name241: number = name240 + 241;
+let name242: number = name241 + 242;
+let name243: number = name242 + 243;
+let name244: number = name243 + 244;
+let name245: number = name244 + 245;
+let name246: number = name245 + 246;
+let name247: number = name246 + 247;
+let name248: number = name247 + 248;
+let name249: number = name248 + 249;
+let name250: number = name249 + 250;
+let name251: number = name250 + 251;
+let name252: number = name251 + 252;
+let name253: number = name252 + 253;
+let name254: number = name253 + 254;
+let name255: number = name254 + 255;
+let name256: number = name255 + 256;
+let name257: number = name256 + 257;
+let name258: number = name257 + 258;
+let name259: number = name258 + 259;
+let name260: number = name259 + 260;
+let name261: number = name260 + 261;
+let name262: number = name261 + 262;
+let name263: number = name262 + 263;
+let name264: number = name263 + 264;
+let name265: number = name264 + 265;
+let name266: number = name265 + 266;
+let name267: number = name266 + 267;
+let name268: number = name267 + 268;
+let name269: number = name268 + 269;
+let name270: number = name269 + 270;
+let name271: number = name270 + 271;
+let name272: number = name271 + 272;
+let name273: number = name272 + 273;
+let name274: number = name273 + 274;
+let name275: number = name274 + 275;
+let name276: number = name275 + 276;
+let name277: number = name276 + 277;
+let name278: number = name277 + 278;
+let name279: number = name278 + 279;
+let name280: number = name279 + 280;
+let name281: number = name280 + 281;
+let name282: number = name281 + 282;
+let name283: number = name282 + 283;
+let name284: number = name283 + 284;
+let name285: number = name284 + 285;
+let name286: number = name285 + 286;
+let name287: number = name286 + 287;
+let name288: number = name287 + 288;
+let name289: number = name288 + 289;
+let name290: number = name289 + 290;
+let name291: number = name290 + 291;
+let name292: number = name291 + 292;
+let name293: number = name292 + 293;
+let name294: number = name293 + 294;
+let name295: number = name294 + 295;
+let name296: number = name295 + 296;
+let name297: number = name296 + 297;
+let name298: number = name297 + 298;
+let name299: number = name298 + 299;
+let name300: number = name299 + 300;
+let name301: number = name300 + 301;
+let name302: number = name301 + 302;
+let name303: number = name302 + 303;
+let name304: number = name303 + 304;
+let name305: number = name304 + 305;
+let name306: number = name305 + 306;
+let name307: number = name306 + 307;
+let name308: number = name307 + 308;
+let name309: number = name308 + 309;
+let name310: number = name309 + 310;
+let name311: number = name310 + 311;
+let name312: number = name311 + 312;
+let name313: number = name312 + 313;
+let name314: number = name313 + 314;
+let name315: number = name314 + 315;
+let name316: number = name315 + 316;
+let name317: number = name316 + 317;
+let name318: number = name317 + 318;
+let name319: number = name318 + 319;
+let name320: number = name319 + 320;
+let name321: number = name320 + 321;
+let name322: number = name321 + 322;
+let name323: number = name322 + 323;
+let name324: number = name323 + 324;
+let name325: number = name324 + 325;
+let name326: number = name325 + 326;
+let name327: number = name326 + 327;
+let name328: number = name327 + 328;
+let name329: number = name328 + 329;
+let name330: number = name329 + 330;
+let name331: number = name330 + 331;
+let name332: number = name331 + 332;
+let name333: number = name332 + 333;
+let name334: number = name333 + 334;
+let name335: number = name334 + 335;
+let name336: number = name335 + 336;
+let name337: number = name336 + 337;
+let name338: number = name337 + 338;
+let name339: number = name338 + 339;
+let name340: number = name339 + 340;
+let name341: number = name340 + 341;
+let name342: number = name341 + 342;
+let name343: number = name342 + 343;
+let name344: number = name343 + 344;
+let name345: number = name344 + 345;
+let name346: number = name345 + 346;
+let name347: number = name346 + 347;
+let name348: number = name347 + 348;
+let name349: number = name348 + 349;
+let name350: number = name349 + 350;
+let name351: number = name350 + 351;
+let name352: number = name351 + 352;
+let name353: number = name352 + 353;
+let name354: number = name353 + 354;
+let name355: number = name354 + 355;
+let name356: number = name355 + 356;
+let name357: number = name356 + 357;
+let name358: number = name357 + 358;
+let name359: number = name358 + 359;
+let name360: number = name359 + 360;
+let name361: number = name360 + 361;
+let name362: number = name361 + 362;
+let name363: number = name362 + 363;
+let name364: number = name363 + 364;
+let name365: number = name364 + 365;
+let name366: number = name365 + 366;
+let name367: number = name366 + 367;
+let name368: number = name367 + 368;
+let name369: number = name368 + 369;
+let name370: number = name369 + 370;
+let name371: number = name370 + 371;
+let name372: number = name371 + 372;
+let name373: number = name372 + 373;
+let name374: number = name373 + 374;
+let name375: number = name374 + 375;
+let name376: number = name375 + 376;
+let name377: number = name376 + 377;
+let name378: number = name377 + 378;
+let name379: number = name378 + 379;
+let name380: number = name379 + 380;
+let name381: number = name380 + 381;
+let name382: number = name381 + 382;
+let name383: number = name382 + 383;
+let name384: number = name383 + 384;
+let name385: number = name384 + 385;
+let name386: number = name385 + 386;
+let name387: number = name386 + 387;
+let name388: number = name387 + 388;
+let name389: number = name388 + 389;
+let name390: number = name389 + 390;
+let name391: number = name390 + 391;
+let name392: number = name391 + 392;
+let name393: number = name392 + 393;
+let name394: number = name393 + 394;
+let name395: number = name394 + 395;
+let name396: number = name395 + 396;
+let name397: number = name396 + 397;
+let name398: number = name397 + 398;
+let name399: number = name398 + 399;
+let name400: number = name399 + 400;
+let name401: number = name400 + 401;
+let name402: number = name401 + 402;
+let name403: number = name402 + 403;
+let name404: number = name403 + 404;
+let name405: number = name404 + 405;
+let name406: number = name405 + 406;
+let name407: number = name406 + 407;
+let name408: number = name407 + 408;
+let name409: number = name408 + 409;
+let name410: number = name409 + 410;
+let name411: number = name410 + 411;
+let name412: number = name411 + 412;
+let name413: number = name412 + 413;
+let name414: number = name413 + 414;
+let name415: number = name414 + 415;
+let name416: number = name415 + 416;
+let name417: number = name416 + 417;
+let name418: number = name417 + 418;
+let name419: number = name418 + 419;
+let name420: number = name419 + 420;
+let name421: number = name420 + 421;
+let name422: number = name421 + 422;
+let name423: number = name422 + 423;
+let name424: number = name423 + 424;
+let name425: number = name424 + 425;
+let name426: number = name425 + 426;
+let name427: number = name426 + 427;
+let name428: number = name427 + 428;
+let name429: number = name428 + 429;
+let name430: number = name429 + 430;
+let name431: number = name430 + 431;
+let name432: number = name431 + 432;
+let name433: number = name432 + 433;
+let name434: number = name433 + 434;
+let name435: number = name434 + 435;
+let name436: number = name435 + 436;
+let name437: number = name436 + 437;
+let name438: number = name437 + 438;
+let name439: number = name438 + 439;
+let name440: number = name439 + 440;
+let name441: number = name440 + 441;
+let name442: number = name441 + 442;
+let name443: number = name442 + 443;
+let name444: number = name443 + 444;
+let name445: number = name444 + 445;
+let name446: number = name445 + 446;
+let name447: number = name446 + 447;
+let name448: number = name447 + 448;
+let name449: number = name448 + 449;
+let name450: number = name449 + 450;
+let name451: number = name450 + 451;
+let name452: number = name451 + 452;
+let name453: number = name452 + 453;
+let name454: number = name453 + 454;
+let name455: number = name454 + 455;
+let name456: number = name455 + 456;
+let name457: number = name456 + 457;
+let name458: number = name457 + 458;
+let name459: number = name458 + 459;
+let name460: number = name459 + 460;
+let name461: number = name460 + 461;
+let name462: number = name461 + 462;
+let name463: number = name462 + 463;
+let name464: number = name463 + 464;
+let name465: number = name464 + 465;
+let name466: number = name465 + 466;
+let name467: number = name466 + 467;
+let name468: number = name467 + 468;
+let name469: number = name468 + 469;
+let name470: number = name469 + 470;
+let name471: number = name470 + 471;
+let name472: number = name471 + 472;
+let name473: number = name472 + 473;
+let name474: number = name473 + 474;
+let name475: number = name474 + 475;
+let name476: number = name475 + 476;
+let name477: number = name476 + 477;
+let name478: number = name477 + 478;
+let name479: number = name478 + 479;
+let name480: number = name479 + 480;
+let name481: number = name480 + 481;
+let name482: number = name481 + 482;
+let name483: number = name482 + 483;
+let name484: number = name483 + 484;
+let name485: number = name484 + 485;
+let name486: number = name485 + 486;
+let name487: number = name486 + 487;
+let name488: number = name487 + 488;
+let name489: number = name488 + 489;
+let name490: number = name489 + 490;
+let name491: number = name490 + 491;
+let name492: number = name491 + 492;
+let name493: number = name492 + 493;
+let name494: number = name493 + 494;
+let name495: number = name494 + 495;
+let name496: number = name495 + 496;
+let name497: number = name496 + 497;
+let name498: number = name497 + 498;
+let name499: number = name498 + 499;
+let name500: number = name499 + 500;
+let name501: number = name500 + 501;
+let name502: number = name501 + 502;
+let name503: number = name502 + 503;
+let name504: number = name503 + 504;
+let name505: number = name504 + 505;
+let name506: number = name505 + 506;
+let name507: number = name506 + 507;
+let name508: number = name507 + 508;
+let name509: number = name508 + 509;
+let name510: number = name509 + 510;
+let name511: number = name510 + 511;
+let name512: number = name511 + 512;
+let name513: number = name512 + 513;
+let name514: number = name513 + 514;
+let name515: number = name514 + 515;
+let name516: number = name515 + 516;
+let name517: number = name516 + 517;
+let name518: number = name517 + 518;
+let name519: number = name518 + 519;
+let name520: number = name519 + 520;
+let name521: number = name520 + 521;
+let name522: number = name521 + 522;
+let name523: number = name522 + 523;
+let name524: number = name523 + 524;
+let name525: number = name524 + 525;
+let name526: number = name525 + 526;
+let name527: number = name526 + 527;
+let name528: number = name527 + 528;
+let name529: number = name528 + 529;
+let name530: number = name529 + 530;
+let name531: number = name530 + 531;
+let name532: number = name531 + 532;
+let name533: number = name532 + 533;
+let name534: number = name533 + 534;
+let name535: number = name534 + 535;
+let name536: number = name535 + 536;
+let name537: number = name536 + 537;
+let name538: number = name537 + 538;
+let name539: number = name538 + 539;
+let name540: number = name539 + 540;
+let name541: number = name540 + 541;
+let name542: number = name541 + 542;
+let name543: number = name542 + 543;
+let name544: number = name543 + 544;
+let name545: number = name544 + 545;
+let name546: number = name545 + 546;
+let name547: number = name546 + 547;
+let name548: number = name547 + 548;
+let name549: number = name548 + 549;
+let name550: number = name549 + 550;
+let name551: number = name550 + 551;
+let name552: number = name551 + 552;
+let name553: number = name552 + 553;
+let name554: number = name553 + 554;
+let name555: number = name554 + 555;
+let name556: number = name555 + 556;
+let name557: number = name556 + 557;
+let name558: number = name557 + 558;
+let name559: number = name558 + 559;
+let name560: number = name559 + 560;
+let name561: number = name560 + 561;
+let name562: number = name561 + 562;
+let name563: number = name562 + 563;
+let name564: number = name563 + 564;
+let name565: number = name564 + 565;
+let name566: number = name565 + 566;
+let name567: number = name566 + 567;
+let name568: number = name567 + 568;
+let name569: number = name568 + 569;
+let name570: number = name569 + 570;
+let name571: number = name570 + 571;
+let name572: number = name571 + 572;
+let name573: number = name572 + 573;
+let name574: number = name573 + 574;
+let name575: number = name574 + 575;
+let name576: number = name575 + 576;
+let name577: number = name576 + 577;
+let name578: number = name577 + 578;
+let name579: number = name578 + 579;
+let name580: number = name579 + 580;
+let name581: number = name580 + 581;
+let name582: number = name581 + 582;
+let name583: number = name582 + 583;
+let name584: number = name583 + 584;
+let name585: number = name584 + 585;
+let name586: number = name585 + 586;
+let name587: number = name586 + 587;
+let name588: number = name587 + 588;
+let name589: number = name588 + 589;
+let name590: number = name589 + 590;
+let name591: number = name590 + 591;
+let name592: number = name591 + 592;
+let name593: number = name592 + 593;
+let name594: number = name593 + 594;
+let name595: number = name594 + 595;
+let name596: number = name595 + 596;
+let name597: number = name596 + 597;
+let name598: number = name597 + 598;
+let name599: number = name598 + 599;
+let name600: number = name599 + 600;
+let name601: number = name600 + 601;
+let name602: number = name601 + 602;
+let name603: number = name602 + 603;
+let name604: number = name603 + 604;
+let name605: number = name604 + 605;
+let name606: number = name605 + 606;
+let name607: number = name606 + 607;
+let name608: number = name607 + 608;
+let name609: number = name608 + 609;
+let name610: number = name609 + 610;
+let name611: number = name610 + 611;
+let name612: number = name611 + 612;
+let name613: number = name612 + 613;
+let name614: number = name613 + 614;
+let name615: number = name614 + 615;
+let name616: number = name615 + 616;
+let name617: number = name616 + 617;
+let name618: number = name617 + 618;
+let name619: number = name618 + 619;
+let name620: number = name619 + 620;
+let name621: number = name620 + 621;
+let name622: number = name621 + 622;
+let name623: number = name622 + 623;
+let name624: number = name623 + 624;
+let name625: number = name624 + 625;
+let name626: number = name625 + 626;
+let name627: number = name626 + 627;
+let name628: number = name627 + 628;
+let name629: number = name628 + 629;
+let name630: number = name629 + 630;
+let name631: number = name630 + 631;
+let name632: number = name631 + 632;
+let name633: number = name632 + 633;
+let name634: number = name633 + 634;
+let name635: number = name634 + 635;
+let name636: number = name635 + 636;
+let name637: number = name636 + 637;
+let name638: number = name637 + 638;
+let name639: number = name638 + 639;
+let name640: number = name639 + 640;
+let name641: number = name640 + 641;
+let name642: number = name641 + 642;
+let name643: number = name642 + 643;
+let name644: number = name643 + 644;
+let name645: number = name644 + 645;
+let name646: number = name645 + 646;
+let name647: number = name646 + 647;
+let name648: number = name647 + 648;
+let name649: number = name648 + 649;
+let name650: number = name649 + 650;
+let name651: number = name650 + 651;
+let name652: number = name651 + 652;
+let name653: number = name652 + 653;
+let name654: number = name653 + 654;
+let name655: number = name654 + 655;
+let name656: number = name655 + 656;
+let name657: number = name656 + 657;
+let name658: number = name657 + 658;
+let name659: number = name658 + 659;
+let name660: number = name659 + 660;
+let name661: number = name660 + 661;
+let name662: number = name661 + 662;
+let name663: number = name662 + 663;
+let name664: number = name663 + 664;
+let name665: number = name664 + 665;
+let name666: number = name665 + 666;
+let name667: number = name666 + 667;
+let name668: number = name667 + 668;
+let name669: number = name668 + 669;
+let name670: number = name669 + 670;
+let name671: number = name670 + 671;
+let name672: number = name671 + 672;
+let name673: number = name672 + 673;
+let name674: number = name673 + 674;
+let name675: number = name674 + 675;
+let name676: number = name675 + 676;
+let name677: number = name676 + 677;
+let name678: number = name677 + 678;
+let name679: number = name678 + 679;
+let name680: number = name679 + 680;
+let name681: number = name680 + 681;
+let name682: number = name681 + 682;
+let name683: number = name682 + 683;
+let name684: number = name683 + 684;
+let name685: number = name684 + 685;
+let name686: number = name685 + 686;
+let name687: number = name686 + 687;
+let name688: number = name687 + 688;
+let name689: number = name688 + 689;
+let name690: number = name689 + 690;
+let name691: number = name690 + 691;
+let name692: number = name691 + 692;
+let name693: number = name692 + 693;
+let name694: number = name693 + 694;
+let name695: number = name694 + 695;
+let name696: number = name695 + 696;
+let name697: number = name696 + 697;
+let name698: number = name697 + 698;
+let name699: number = name698 + 699;
+let name700: number = name699 + 700;
+let name701: number = name700 + 701;
+let name702: number = name701 + 702;
+let name703: number = name702 + 703;
+let name704: number = name703 + 704;
+let name705: number = name704 + 705;
+let name706: number = name705 + 706;
+let name707: number = name706 + 707;
+let name708: number = name707 + 708;
+let name709: number = name708 + 709;
+let name710: number = name709 + 710;
+let name711: number = name710 + 711;
+let name712: number = name711 + 712;
+let name713: number = name712 + 713;
+let name714: number = name713 + 714;
+let name715: number = name714 + 715;
+let name716: number = name715 + 716;
+let name717: number = name716 + 717;
+let name718: number = name717 + 718;
+let name719: number = name718 + 719;
+let name720: number = name719 + 720;
+let name721: number = name720 + 721;
+let name722: number = name721 + 722;
+let name723: number = name722 + 723;
+let name724: number = name723 + 724;
+let name725: number = name724 + 725;
+let name726: number = name725 + 726;
+let name727: number = name726 + 727;
+let name728: number = name727 + 728;
+let name729: number = name728 + 729;
+let name730: number = name729 + 730;
+let name731: number = name730 + 731;
+let name732: number = name731 + 732;
+let name733: number = name732 + 733;
+let name734: number = name733 + 734;
+let name735: number = name734 + 735;
+let name736: number = name735 + 736;
+let name737: number = name736 + 737;
+let name738: number = name737 + 738;
+let name739: number = name738 + 739;
+let name740: number = name739 + 740;
+let name741: number = name740 + 741;
+let name742: number = name741 + 742;
+let name743: number = name742 + 743;
+let name744: number = name743 + 744;
+let name745: number = name744 + 745;
+let name746: number = name745 + 746;
+let name747: number = name746 + 747;
+let name748: number = name747 + 748;
+let name749: number = name748 + 749;
+let name750: number = name749 + 750;
+let name751: number = name750 + 751;
+let name752: number = name751 + 752;
+let name753: number = name752 + 753;
+let name754: number = name753 + 754;
+let name755: number = name754 + 755;
+let name756: number = name755 + 756;
+let name757: number = name756 + 757;
+let name758: number = name757 + 758;
+let name759: number = name758 + 759;
+let name760: number = name759 + 760;
+let name761: number = name760 + 761;
+let name762: number = name761 + 762;
+let name763: number = name762 + 763;
+let name764: number = name763 + 764;
+let name765: number = name764 + 765;
+let name766: number = name765 + 766;
+let name767: number = name766 + 767;
+let name768: number = name767 + 768;
+let name769: number = name768 + 769;
+let name770: number = name769 + 770;
+let name771: number = name770 + 771;
+let name772: number = name771 + 772;
+let name773: number = name772 + 773;
+let name774: number = name773 + 774;
+let name775: number = name774 + 775;
+let name776: number = name775 + 776;
+let name777: number = name776 + 777;
+let name778: number = name777 + 778;
+let name779: number = name778 + 779;
+let name780: number = name779 + 780;
+let name781: number = name780 + 781;
+let name782: number = name781 + 782;
+let name783: number = name782 + 783;
+let name784: number = name783 + 784;
+let name785: number = name784 + 785;
+let name786: number = name785 + 786;
+let name787: number = name786 + 787;
+let name788: number = name787 + 788;
+let name789: number = name788 + 789;
+let name790: number = name789 + 790;
+let name791: number = name790 + 791;
+let name792: number = name791 + 792;
+let name793: number = name792 + 793;
+let name794: number = name793 + 794;
+let name795: number = name794 + 795;
+let name796: number = name795 + 796;
+let name797: number = name796 + 797;
+let name798: number = name797 + 798;
+let name799: number = name798 + 799;
+let name800: number = name799 + 800;
+let name801: number = name800 + 801;
+let name802: number = name801 + 802;
+let name803: number = name802 + 803;
+let name804: number = name803 + 804;
+let name805: number = name804 + 805;
+let name806: number = name805 + 806;
+let name807: number = name806 + 807;
+let name808: number = name807 + 808;
+let name809: number = name808 + 809;
+let name810: number = name809 + 810;
+let name811: number = name810 + 811;
+let name812: number = name811 + 812;
+let name813: number = name812 + 813;
+let name814: number = name813 + 814;
+let name815: number = name814 + 815;
+let name816: number = name815 + 816;
+let name817: number = name816 + 817;
+let name818: number = name817 + 818;
+let name819: number = name818 + 819;
+let name820: number = name819 + 820;
+let name821: number = name820 + 821;
+let name822: number = name821 + 822;
+let name823: number = name822 + 823;
+let name824: number = name823 + 824;
+let name825: number = name824 + 825;
+let name826: number = name825 + 826;
+let name827: number = name826 + 827;
+let name828: number = name827 + 828;
+let name829: number = name828 + 829;
+let name830: number = name829 + 830;
+let name831: number = name830 + 831;
+let name832: number = name831 + 832;
+let name833: number = name832 + 833;
+let name834: number = name833 + 834;
+let name835: number = name834 + 835;
+let name836: number = name835 + 836;
+let name837: number = name836 + 837;
+let name838: number = name837 + 838;
+let name839: number = name838 + 839;
+let name840: number = name839 + 840;
+let name841: number = name840 + 841;
+let name842: number = name841 + 842;
+let name843: number = name842 + 843;
+let name844: number = name843 + 844;
+let name845: number = name844 + 845;
+let name846: number = name845 + 846;
+let name847: number = name846 + 847;
+let name848: number = name847 + 848;
+let name849: number = name848 + 849;
+let name850: number = name849 + 850;
+let name851: number = name850 + 851;
+let name852: number = name851 + 852;
+let name853: number = name852 + 853;
+let name854: number = name853 + 854;
+let name855: number = name854 + 855;
+let name856: number = name855 + 856;
+let name857: number = name856 + 857;
+let name858: number = name857 + 858;
+let name859: number = name858 + 859;
+let name860: number = name859 + 860;
+let name861: number = name860 + 861;
+let name862: number = name861 + 862;
+let name863: number = name862 + 863;
+let name864: number = name863 + 864;
+let name865: number = name864 + 865;
+let name866: number = name865 + 866;
+let name867: number = name866 + 867;
+let name868: number = name867 + 868;
+let name869: number = name868 + 869;
+let name870: number = name869 + 870;
+let name871: number = name870 + 871;
+let name872: number = name871 + 872;
+let name873: number = name872 + 873;
+let name874: number = name873 + 874;
+let name875: number = name874 + 875;
+let name876: number = name875 + 876;
+let name877: number = name876 + 877;
+let name878: number = name877 + 878;
+let name879: number = name878 + 879;
+let name880: number = name879 + 880;
+let name881: number = name880 + 881;
+let name882: number = name881 + 882;
+let name883: number = name882 + 883;
+let name884: number = name883 + 884;
+let name885: number = name884 + 885;
+let name886: number = name885 + 886;
+let name887: number = name886 + 887;
+let name888: number = name887 + 888;
+let name889: number = name888 + 889;
+let name890: number = name889 + 890;
+let name891: number = name890 + 891;
+let name892: number = name891 + 892;
+let name893: number = name892 + 893;
+let name894: number = name893 + 894;
+let name895: number = name894 + 895;
+let name896: number = name895 + 896;
+let name897: number = name896 + 897;
+let name898: number = name897 + 898;
+let name899: number = name898 + 899;
+let name900: number = name899 + 900;
+let name901: number = name900 + 901;
+let name902: number = name901 + 902;
+let name903: number = name902 + 903;
+let name904: number = name903 + 904;
+let name905: number = name904 + 905;
+let name906: number = name905 + 906;
+let name907: number = name906 + 907;
+let name908: number = name907 + 908;
+let name909: number = name908 + 909;
+let name910: number = name909 + 910;
+let name911: number = name910 + 911;
+let name912: number = name911 + 912;
+let name913: number = name912 + 913;
+let name914: number = name913 + 914;
+let name915: number = name914 + 915;
+let name916: number = name915 + 916;
+let name917: number = name916 + 917;
+let name918: number = name917 + 918;
+let name919: number = name918 + 919;
+let name920: number = name919 + 920;
+let name921: number = name920 + 921;
+let name922: number = name921 + 922;
+let name923: number = name922 + 923;
+let name924: number = name923 + 924;
+let name925: number = name924 + 925;
+let name926: number = name925 + 926;
+let name927: number = name926 + 927;
+let name928: number = name927 + 928;
+let name929: number = name928 + 929;
+let name930: number = name929 + 930;
+let name931: number = name930 + 931;
+let name932: number = name931 + 932;
+let name933: number = name932 + 933;
+let name934: number = name933 + 934;
+let name935: number = name934 + 935;
+let name936: number = name935 + 936;
+let name937: number = name936 + 937;
+let name938: number = name937 + 938;
+let name939: number = name938 + 939;
+let name940: number = name939 + 940;
+let name941: number = name940 + 941;
+let name942: number = name941 + 942;
+let name943: number = name942 + 943;
+let name944: number = name943 + 944;
+let name945: number = name944 + 945;
+let name946: number = name945 + 946;
+let name947: number = name946 + 947;
+let name948: number = name947 + 948;
+let name949: number = name948 + 949;
+let name950: number = name949 + 950;
+let name951: number = name950 + 951;
+let name952: number = name951 + 952;
+let name953: number = name952 + 953;
+let name954: number = name953 + 954;
+let name955: number = name954 + 955;
+let name956: number = name955 + 956;
+let name957: number = name956 + 957;
+let name958: number = name957 + 958;
+let name959: number = name958 + 959;
+let name960: number = name959 + 960;
+let name961: number = name960 + 961;
+let name962: number = name961 + 962;
+let name963: number = name962 + 963;
+let name964: number = name963 + 964;
+let name965: number = name964 + 965;
+let name966: number = name965 + 966;
+let name967: number = name966 + 967;
+let name968: number = name967 + 968;
+let name969: number = name968 + 969;
+let name970: number = name969 + 970;
+let name971: number = name970 + 971;
+let name972: number = name971 + 972;
+let name973: number = name972 + 973;
+let name974: number = name973 + 974;
+let name975: number = name974 + 975;
+let name976: number = name975 + 976;
+let name977: number = name976 + 977;
+let name978: number = name977 + 978;
+let name979: number = name978 + 979;
+let name980: number = name979 + 980;
+let name981: number = name980 + 981;
+let name982: number = name981 + 982;
+let name983: number = name982 + 983;
+let name984: number = name983 + 984;
+let name985: number = name984 + 985;
+let name986: number = name985 + 986;
+let name987: number = name986 + 987;
+let name988: number = name987 + 988;
+let name989: number = name988 + 989;
+let name990: number = name989 + 990;
+let name991: number = name990 + 991;
+let name992: number = name991 + 992;
+let name993: number = name992 + 993;
+let name994: number = name993 + 994;
+let name995: number = name994 + 995;
+let name996: number = name995 + 996;
+let name997: number = name996 + 997;
+let name998: number = name997 + 998;
+let name999: number = name998 + 999;
+let name1000: number = name999 + 1000;
+let name1001: number = name1000 + 1001;
+let name1002: number = name1001 + 1002;
+let name1003: number = name1002 + 1003;
+let name1004: number = name1003 + 1004;
+let name1005: number = name1004 + 1005;
+let name1006: number = name1005 + 1006;
+let name1007: number = name1006 + 1007;
+let name1008: number = name1007 + 1008;
+let name1009: number = name1008 + 1009;
+let name1010: number = name1009 + 1010;
+let name1011: number = name1010 + 1011;
+let name1012: number = name1011 + 1012;
+let name1013: number = name1012 + 1013;
+let name1014: number = name1013 + 1014;
+let name1015: number = name1014 + 1015;
+let name1016: number = name1015 + 1016;
+let name1017: number = name1016 + 1017;
+let name1018: number = name1017 + 1018;
+let name1019: number = name1018 + 1019;
+let name1020: number = name1019 + 1020;
+let name1021: number = name1020 + 1021;
+let name1022: number = name1021 + 1022;
+let name1023: number = name1022 + 1023;
+let name1024: number = name1023 + 1024;
+let name1025: number = name1024 + 1025;
+let name1026: number = name1025 + 1026;
+let name1027: number = name1026 + 1027;
+let name1028: number = name1027 + 1028;
+let name1029: number = name1028 + 1029;
+let name1030: number = name1029 + 1030;
+let name1031: number = name1030 + 1031;
+let name1032: number = name1031 + 1032;
+let name1033: number = name1032 + 1033;
+let name1034: number = name1033 + 1034;
+let name1035: number = name1034 + 1035;
+let name1036: number = name1035 + 1036;
+let name1037: number = name1036 + 1037;
+let name1038: number = name1037 + 1038;
+let name1039: number = name1038 + 1039;
+let name1040: number = name1039 + 1040;
+let name1041: number = name1040 + 1041;
+let name1042: number = name1041 + 1042;
+let name1043: number = name1042 + 1043;
+let name1044: number = name1043 + 1044;
+let name1045: number = name1044 + 1045;
+let name1046: number = name1045 + 1046;
+let name1047: number = name1046 + 1047;
+let name1048: number = name1047 + 1048;
+let name1049: number = name1048 + 1049;
+let name1050: number = name1049 + 1050;
+let name1051: number = name1050 + 1051;
+let name1052: number = name1051 + 1052;
+let name1053: number = name1052 + 1053;
+let name1054: number = name1053 + 1054;
+let name1055: number = name1054 + 1055;
+let name1056: number = name1055 + 1056;
+let name1057: number = name1056 + 1057;
+let name1058: number = name1057 + 1058;
+let name1059: number = name1058 + 1059;
+let name1060: number = name1059 + 1060;
+let name1061: number = name1060 + 1061;
+let name1062: number = name1061 + 1062;
+let name1063: number = name1062 + 1063;
+let name1064: number = name1063 + 1064;
+let name1065: number = name1064 + 1065;
+let name1066: number = name1065 + 1066;
+let name1067: number = name1066 + 1067;
+let name1068: number = name1067 + 1068;
+let name1069: number = name1068 + 1069;
+let name1070: number = name1069 + 1070;
+let name1071: number = name1070 + 1071;
+let name1072: number = name1071 + 1072;
+let name1073: number = name1072 + 1073;
+let name1074: number = name1073 + 1074;
+let name1075: number = name1074 + 1075;
+let name1076: number = name1075 + 1076;
+let name1077: number = name1076 + 1077;
+let name1078: number = name1077 + 1078;
+let name1079: number = name1078 + 1079;
+let name1080: number = name1079 + 1080;
+let name1081: number = name1080 + 1081;
+let name1082: number = name1081 + 1082;
+let name1083: number = name1082 + 1083;
+let name1084: number = name1083 + 1084;
+let name1085: number = name1084 + 1085;
+let name1086: number = name1085 + 1086;
+let name1087: number = name1086 + 1087;
+let name1088: number = name1087 + 1088;
+let name1089: number = name1088 + 1089;
+let name1090: number = name1089 + 1090;
+let name1091: number = name1090 + 1091;
+let name1092: number = name1091 + 1092;
+let name1093: number = name1092 + 1093;
+let name1094: number = name1093 + 1094;
+let name1095: number = name1094 + 1095;
+let name1096: number = name1095 + 1096;
+let name1097: number = name1096 + 1097;
+let name1098: number = name1097 + 1098;
+let name1099: number = name1098 + 1099;
+let name1100: number = name1099 + 1100;
+let name1101: number = name1100 + 1101;
+let name1102: number = name1101 + 1102;
+let name1103: number = name1102 + 1103;
+let name1104: number = name1103 + 1104;
+let name1105: number = name1104 + 1105;
+let name1106: number = name1105 + 1106;
+let name1107: number = name1106 + 1107;
+let name1108: number = name1107 + 1108;
+let name1109: number = name1108 + 1109;
+let name1110: number = name1109 + 1110;
+let name1111: number = name1110 + 1111;
+let name1112: number = name1111 + 1112;
+let name1113: number = name1112 + 1113;
+let name1114: number = name1113 + 1114;
+let name1115: number = name1114 + 1115;
+let name1116: number = name1115 + 1116;
+let name1117: number = name1116 + 1117;
+let name1118: number = name1117 + 1118;
+let name1119: number = name1118 + 1119;
+let name1120: number = name1119 + 1120;
+let name1121: number = name1120 + 1121;
+let name1122: number = name1121 + 1122;
+let name1123: number = name1122 + 1123;
+let name1124: number = name1123 + 1124;
+let name1125: number = name1124 + 1125;
+let name1126: number = name1125 + 1126;
+let name1127: number = name1126 + 1127;
+let name1128: number = name1127 + 1128;
+let name1129: number = name1128 + 1129;
+let name1130: number = name1129 + 1130;
+let name1131: number = name1130 + 1131;
+let name1132: number = name1131 + 1132;
+let name1133: number = name1132 + 1133;
+let name1134: number = name1133 + 1134;
+let name1135: number = name1134 + 1135;
+let name1136: number = name1135 + 1136;
+let name1137: number = name1136 + 1137;
+let name1138: number = name1137 + 1138;
+let name1139: number = name1138 + 1139;
+let name1140: number = name1139 + 1140;
+let name1141: number = name1140 + 1141;
+let name1142: number = name1141 + 1142;
+let name1143: number = name1142 + 1143;
+let name1144: number = name1143 + 1144;
+let name1145: number = name1144 + 1145;
+let name1146: number = name1145 + 1146;
+let name1147: number = name1146 + 1147;
+let name1148: number = name1147 + 1148;
+let name1149: number = name1148 + 1149;
+let name1150: number = name1149 + 1150;
+let name1151: number = name1150 + 1151;
+let name1152: number = name1151 + 1152;
+let name1153: number = name1152 + 1153;
+let name1154: number = name1153 + 1154;
+let name1155: number = name1154 + 1155;
+let name1156: number = name1155 + 1156;
+let name1157: number = name1156 + 1157;
+let name1158: number = name1157 + 1158;
+let name1159: number = name1158 + 1159;
+let name1160: number = name1159 + 1160;
+let name1161: number = name1160 + 1161;
+let name1162: number = name1161 + 1162;
+let name1163: number = name1162 + 1163;
+let name1164: number = name1163 + 1164;
+let name1165: number = name1164 + 1165;
+let name1166: number = name1165 + 1166;
+let name1167: number = name1166 + 1167;
+let name1168: number = name1167 + 1168;
+let name1169: number = name1168 + 1169;
+let name1170: number = name1169 + 1170;
+let name1171: number = name1170 + 1171;
+let name1172: number = name1171 + 1172;
+let name1173: number = name1172 + 1173;
+let name1174: number = name1173 + 1174;
+let name1175: number = name1174 + 1175;
+let name1176: number = name1175 + 1176;
+let name1177: number = name1176 + 1177;
+let name1178: number = name1177 + 1178;
+let name1179: number = name1178 + 1179;
+let name1180: number = name1179 + 1180;
+let name1181: number = name1180 + 1181;
+let name1182: number = name1181 + 1182;
+let name1183: number = name1182 + 1183;
+let name1184: number = name1183 + 1184;
+let name1185: number = name1184 + 1185;
+let name1186: number = name1185 + 1186;
+let name1187: number = name1186 + 1187;
+let name1188: number = name1187 + 1188;
+let name1189: number = name1188 + 1189;
+let name1190: number = name1189 + 1190;
+let name1191: number = name1190 + 1191;
+let name1192: number = name1191 + 1192;
+let name1193: number = name1192 + 1193;
+let name1194: number = name1193 + 1194;
+let name1195: number = name1194 + 1195;
+let name1196: number = name1195 + 1196;
+let name1197: number = name1196 + 1197;
+let name1198: number = name1197 + 1198;
+let name1199: number = name1198 + 1199;
+let name1200: number = name1199 + 1200;
+let name1201: number = name1200 + 1201;
+let name1202: number = name1201 + 1202;
+let name1203: number = name1202 + 1203;
+let name1204: number = name1203 + 1204;
+let name1205: number = name1204 + 1205;
+let name1206: number = name1205 + 1206;
+let name1207: number = name1206 + 1207;
+let name1208: number = name1207 + 1208;
+let name1209: number = name1208 + 1209;
+let name1210: number = name1209 + 1210;
+let name1211: number = name1210 + 1211;
+let name1212: number = name1211 + 1212;
+let name1213: number = name1212 + 1213;
+let name1214: number = name1213 + 1214;
+let name1215: number = name1214 + 1215;
+let name1216: number = name1215 + 1216;
+let name1217: number = name1216 + 1217;
+let name1218: number = name1217 + 1218;
+let name1219: number = name1218 + 1219;
+let name1220: number = name1219 + 1220;
+let name1221: number = name1220 + 1221;
+let name1222: number = name1221 + 1222;
+let name1223: number = name1222 + 1223;
+let name1224: number = name1223 + 1224;
+let name1225: number = name1224 + 1225;
+let name1226: number = name1225 + 1226;
+let name1227: number = name1226 + 1227;
+let name1228: number = name1227 + 1228;
+let name1229: number = name1228 + 1229;
+let name1230: number = name1229 + 1230;
+let name1231: number = name1230 + 1231;
+let name1232: number = name1231 + 1232;
+let name1233: number = name1232 + 1233;
+let name1234: number = name1233 + 1234;
+let name1235: number = name1234 + 1235;
+let name1236: number = name1235 + 1236;
+let name1237: number = name1236 + 1237;
+let name1238: number = name1237 + 1238;
+let name1239: number = name1238 + 1239;
+let name1240: number = name1239 + 1240;
+let name1241: number = name1240 + 1241;
+let name1242: number = name1241 + 1242;
+let name1243: number = name1242 + 1243;
+let name1244: number = name1243 + 1244;
+let name1245: number = name1244 + 1245;
+let name1246: number = name1245 + 1246;
+let name1247: number = name1246 + 1247;
+let name1248: number = name1247 + 1248;
+let name1249: number = name1248 + 1249;
+let name1250: number = name1249 + 1250;
+let name1251: number = name1250 + 1251;
+let name1252: number = name1251 + 1252;
+let name1253: number = name1252 + 1253;
+let name1254: number = name1253 + 1254;
+let name1255: number = name1254 + 1255;
+let name1256: number = name1255 + 1256;
+let name1257: number = name1256 + 1257;
+let name1258: number = name1257 + 1258;
+let name1259: number = name1258 + 1259;
+let name1260: number = name1259 + 1260;
+let name1261: number = name1260 + 1261;
+let name1262: number = name1261 + 1262;
+let name1263: number = name1262 + 1263;
+let name1264: number = name1263 + 1264;
+let name1265: number = name1264 + 1265;
+let name1266: number = name1265 + 1266;
+let name1267: number = name1266 + 1267;
+let name1268: number = name1267 + 1268;
+let name1269: number = name1268 + 1269;
+let name1270: number = name1269 + 1270;
+let name1271: number = name1270 + 1271;
+let name1272: number = name1271 + 1272;
+let name1273: number = name1272 + 1273;
+let name1274: number = name1273 + 1274;
+let name1275: number = name1274 + 1275;
+let name1276: number = name1275 + 1276;
+let name1277: number = name1276 + 1277;
+let name1278: number = name1277 + 1278;
+let name1279: number = name1278 + 1279;
+let name1280: number = name1279 + 1280;
+let name1281: number = name1280 + 1281;
+let name1282: number = name1281 + 1282;
+let name1283: number = name1282 + 1283;
+let name1284: number = name1283 + 1284;
+let name1285: number = name1284 + 1285;
+let name1286: number = name1285 + 1286;
+let name1287: number = name1286 + 1287;
+let name1288: number = name1287 + 1288;
+let name1289: number = name1288 + 1289;
+let name1290: number = name1289 + 1290;
+let name1291: number = name1290 + 1291;
+let name1292: number = name1291 + 1292;
+let name1293: number = name1292 + 1293;
+let name1294: number = name1293 + 1294;
+let name1295: number = name1294 + 1295;
+let name1296: number = name1295 + 1296;
+let name1297: number = name1296 + 1297;
+let name1298: number = name1297 + 1298;
+let name1299: number = name1298 + 1299;
+let name1300: number = name1299 + 1300;
+let name1301: number = name1300 + 1301;
+let name1302: number = name1301 + 1302;
+let name1303: number = name1302 + 1303;
+let name1304: number = name1303 + 1304;
+let name1305: number = name1304 + 1305;
+let name1306: number = name1305 + 1306;
+let name1307: number = name1306 + 1307;
+let name1308: number = name1307 + 1308;
+let name1309: number = name1308 + 1309;
+let name1310: number = name1309 + 1310;
+let name1311: number = name1310 + 1311;
+let name1312: number = name1311 + 1312;
+let name1313: number = name1312 + 1313;
+let name1314: number = name1313 + 1314;
+let name1315: number = name1314 + 1315;
+let name1316: number = name1315 + 1316;
+let name1317: number = name1316 + 1317;
+let name1318: number = name1317 + 1318;
+let name1319: number = name1318 + 1319;
+let name1320: number = name1319 + 1320;
+let name1321: number = name1320 + 1321;
+let name1322: number = name1321 + 1322;
+let name1323: number = name1322 + 1323;
+let name1324: number = name1323 + 1324;
+let name1325: number = name1324 + 1325;
+let name1326: number = name1325 + 1326;
+let name1327: number = name1326 + 1327;
+let name1328: number = name1327 + 1328;
+let name1329: number = name1328 + 1329;
+let name1330: number = name1329 + 1330;
+let name1331: number = name1330 + 1331;
+let name1332: number = name1331 + 1332;
+let name1333: number = name1332 + 1333;
+let name1334: number = name1333 + 1334;
+let name1335: number = name1334 + 1335;
+let name1336: number = name1335 + 1336;
+let name1337: number = name1336 + 1337;
+let name1338: number = name1337 + 1338;
+let name1339: number = name1338 + 1339;
+let name1340: number = name1339 + 1340;
+let name1341: number = name1340 + 1341;
+let name1342: number = name1341 + 1342;
+let name1343: number = name1342 + 1343;
+let name1344: number = name1343 + 1344;
+let name1345: number = name1344 + 1345;
+let name1346: number = name1345 + 1346;
+let name1347: number = name1346 + 1347;
+let name1348: number = name1347 + 1348;
+let name1349: number = name1348 + 1349;
+let name1350: number = name1349 + 1350;
+let name1351: number = name1350 + 1351;
+let name1352: number = name1351 + 1352;
+let name1353: number = name1352 + 1353;
+let name1354: number = name1353 + 1354;
+let name1355: number = name1354 + 1355;
+let name1356: number = name1355 + 1356;
+let name1357: number = name1356 + 1357;
+let name1358: number = name1357 + 1358;
+let name1359: number = name1358 + 1359;
+let name1360: number = name1359 + 1360;
+let name1361: number = name1360 + 1361;
+let name1362: number = name1361 + 1362;
+let name1363: number = name1362 + 1363;
+let name1364: number = name1363 + 1364;
+let name1365: number = name1364 + 1365;
+let name1366: number = name1365 + 1366;
+let name1367: number = name1366 + 1367;
+let name1368: number = name1367 + 1368;
+let name1369: number = name1368 + 1369;
+let name1370: number = name1369 + 1370;
+let name1371: number = name1370 + 1371;
+let name1372: number = name1371 + 1372;
+let name1373: number = name1372 + 1373;
+let name1374: number = name1373 + 1374;
+let name1375: number = name1374 + 1375;
+let name1376: number = name1375 + 1376;
+let name1377: number = name1376 + 1377;
+let name1378: number = name1377 + 1378;
+let name1379: number = name1378 + 1379;
+let name1380: number = name1379 + 1380;
+let name1381: number = name1380 + 1381;
+let name1382: number = name1381 + 1382;
+let name1383: number = name1382 + 1383;
+let name1384: number = name1383 + 1384;
+let name1385: number = name1384 + 1385;
+let name1386: number = name1385 + 1386;
+let name1387: number = name1386 + 1387;
+let name1388: number = name1387 + 1388;
+let name1389: number = name1388 + 1389;
+let name1390: number = name1389 + 1390;
+let name1391: number = name1390 + 1391;
+let name1392: number = name1391 + 1392;
+let name1393: number = name1392 + 1393;
+let name1394: number = name1393 + 1394;
+let name1395: number = name1394 + 1395;
+let name1396: number = name1395 + 1396;
+let name1397: number = name1396 + 1397;
+let name1398: number = name1397 + 1398;
+let name1399: number = name1398 + 1399;
+let name1400: number = name1399 + 1400;
+let name1401: number = name1400 + 1401;
+let name1402: number = name1401 + 1402;
+let name1403: number = name1402 + 1403;
+let name1404: number = name1403 + 1404;
+let name1405: number = name1404 + 1405;
+let name1406: number = name1405 + 1406;
+let name1407: number = name1406 + 1407;
+let name1408: number = name1407 + 1408;
+let name1409: number = name1408 + 1409;
+let name1410: number = name1409 + 1410;
+let name1411: number = name1410 + 1411;
+let name1412: number = name1411 + 1412;
+let name1413: number = name1412 + 1413;
+let name1414: number = name1413 + 1414;
+let name1415: number = name1414 + 1415;
+let name1416: number = name1415 + 1416;
+let name1417: number = name1416 + 1417;
+let name1418: number = name1417 + 1418;
+let name1419: number = name1418 + 1419;
+let name1420: number = name1419 + 1420;
+let name1421: number = name1420 + 1421;
+let name1422: number = name1421 + 1422;
+let name1423: number = name1422 + 1423;
+let name1424: number = name1423 + 1424;
+let name1425: number = name1424 + 1425;
+let name1426: number = name1425 + 1426;
+let name1427: number = name1426 + 1427;
+let name1428: number = name1427 + 1428;
+let name1429: number = name1428 + 1429;
+let name1430: number = name1429 + 1430;
+let name1431: number = name1430 + 1431;
+let name1432: number = name1431 + 1432;
+let name1433: number = name1432 + 1433;
+let name1434: number = name1433 + 1434;
+let name1435: number = name1434 + 1435;
+let name1436: number = name1435 + 1436;
+let name1437: number = name1436 + 1437;
+let name1438: number = name1437 + 1438;
+let name1439: number = name1438 + 1439;
+let name1440: number = name1439 + 1440;
+let name1441: number = name1440 + 1441;
+let name1442: number = name1441 + 1442;
+let name1443: number = name1442 + 1443;
+let name1444: number = name1443 + 1444;
+let name1445: number = name1444 + 1445;
+let name1446: number = name1445 + 1446;
+let name1447: number = name1446 + 1447;
+let name1448: number = name1447 + 1448;
+let name1449: number = name1448 + 1449;
+let name1450: number = name1449 + 1450;
+let name1451: number = name1450 + 1451;
+let name1452: number = name1451 + 1452;
+let name1453: number = name1452 + 1453;
+let name1454: number = name1453 + 1454;
+let name1455: number = name1454 + 1455;
+let name1456: number = name1455 + 1456;
+let name1457: number = name1456 + 1457;
+let name1458: number = name1457 + 1458;
+let name1459: number = name1458 + 1459;
+let name1460: number = name1459 + 1460;
+let name1461: number = name1460 + 1461;
+let name1462: number = name1461 + 1462;
+let name1463: number = name1462 + 1463;
+let name1464: number = name1463 + 1464;
+let name1465: number = name1464 + 1465;
+let name1466: number = name1465 + 1466;
+let name1467: number = name1466 + 1467;
+let name1468: number = name1467 + 1468;
+let name1469: number = name1468 + 1469;
+let name1470: number = name1469 + 1470;
+let name1471: number = name1470 + 1471;
+let name1472: number = name1471 + 1472;
+let name1473: number = name1472 + 1473;
+let name1474: number = name1473 + 1474;
+let name1475: number = name1474 + 1475;
+let name1476: number = name1475 + 1476;
+let name1477: number = name1476 + 1477;
+let name1478: number = name1477 + 1478;
+let name1479: number = name1478 + 1479;
+let name1480: number = name1479 + 1480;
+let name1481: number = name1480 + 1481;
+let name1482: number = name1481 + 1482;
+let name1483: number = name1482 + 1483;
+let name1484: number = name1483 + 1484;
+let name1485: number = name1484 + 1485;
+let name1486: number = name1485 + 1486;
+let name1487: number = name1486 + 1487;
+let name1488: number = name1487 + 1488;
+let name1489: number = name1488 + 1489;
+let name1490: number = name1489 + 1490;
+let name1491: number = name1490 + 1491;
+let name1492: number = name1491 + 1492;
+let name1493: number = name1492 + 1493;
+let name1494: number = name1493 + 1494;
+let name1495: number = name1494 + 1495;
+let name1496: number = name1495 + 1496;
+let name1497: number = name1496 + 1497;
+let name1498: number = name1497 + 1498;
+let name1499: number = name1498 + 1499;
+let name1500: number = name1499 + 1500;
+let name1501: number = name1500 + 1501;
+let name1502: number = name1501 + 1502;
+let name1503: number = name1502 + 1503;
+let name1504: number = name1503 + 1504;
+let name1505: number = name1504 + 1505;
+let name1506: number = name1505 + 1506;
+let name1507: number = name1506 + 1507;
+let name1508: number = name1507 + 1508;
+let name1509: number = name1508 + 1509;
+let name1510: number = name1509 + 1510;
+let name1511: number = name1510 + 1511;
+let name1512: number = name1511 + 1512;
+let name1513: number = name1512 + 1513;
+let name1514: number = name1513 + 1514;
+let name1515: number = name1514 + 1515;
+let name1516: number = name1515 + 1516;
+let name1517: number = name1516 + 1517;
+let name1518: number = name1517 + 1518;
+let name1519: number = name1518 + 1519;
+let name1520: number = name1519 + 1520;
+let name1521: number = name1520 + 1521;
+let name1522: number = name1521 + 1522;
+let name1523: number = name1522 + 1523;
+let name1524: number = name1523 + 1524;
+let name1525: number = name1524 + 1525;
+let name1526: number = name1525 + 1526;
+let name1527: number = name1526 + 1527;
+let name1528: number = name1527 + 1528;
+let name1529: number = name1528 + 1529;
+let name1530: number = name1529 + 1530;
+let name1531: number = name1530 + 1531;
+let name1532: number = name1531 + 1532;
+let name1533: number = name1532 + 1533;
+let name1534: number = name1533 + 1534;
+let name1535: number = name1534 + 1535;
+let name1536: number = name1535 + 1536;
+let name1537: number = name1536 + 1537;
+let name1538: number = name1537 + 1538;
+let name1539: number = name1538 + 1539;
+let name1540: number = name1539 + 1540;
+let name1541: number = name1540 + 1541;
+let name1542: number = name1541 + 1542;
+let name1543: number = name1542 + 1543;
+let name1544: number = name1543 + 1544;
+let name1545: number = name1544 + 1545;
+let name1546: number = name1545 + 1546;
+let name1547: number = name1546 + 1547;
+let name1548: number = name1547 + 1548;
+let name1549: number = name1548 + 1549;
+let name1550: number = name1549 + 1550;
+let name1551: number = name1550 + 1551;
+let name1552: number = name1551 + 1552;
+let name1553: number = name1552 + 1553;
+let name1554: number = name1553 + 1554;
+let name1555: number = name1554 + 1555;
+let name1556: number = name1555 + 1556;
+let name1557: number = name1556 + 1557;
+let name1558: number = name1557 + 1558;
+let name1559: number = name1558 + 1559;
+let name1560: number = name1559 + 1560;
+let name1561: number = name1560 + 1561;
+let name1562: number = name1561 + 1562;
+let name1563: number = name1562 + 1563;
+let name1564: number = name1563 + 1564;
+let name1565: number = name1564 + 1565;
+let name1566: number = name1565 + 1566;
+let name1567: number = name1566 + 1567;
+let name1568: number = name1567 + 1568;
+let name1569: number = name1568 + 1569;
+let name1570: number = name1569 + 1570;
+let name1571: number = name1570 + 1571;
+let name1572: number = name1571 + 1572;
+let name1573: number = name1572 + 1573;
+let name1574: number = name1573 + 1574;
+let name1575: number = name1574 + 1575;
+let name1576: number = name1575 + 1576;
+let name1577: number = name1576 + 1577;
+let name1578: number = name1577 + 1578;
+let name1579: number = name1578 + 1579;
+let name1580: number = name1579 + 1580;
+let name1581: number = name1580 + 1581;
+let name1582: number = name1581 + 1582;
+let name1583: number = name1582 + 1583;
+let name1584: number = name1583 + 1584;
+let name1585: number = name1584 + 1585;
+let name1586: number = name1585 + 1586;
+let name1587: number = name1586 + 1587;
+let name1588: number = name1587 + 1588;
+let name1589: number = name1588 + 1589;
+let name1590: number = name1589 + 1590;
+let name1591: number = name1590 + 1591;
+let name1592: number = name1591 + 1592;
+let name1593: number = name1592 + 1593;
+let name1594: number = name1593 + 1594;
+let name1595: number = name1594 + 1595;
+let name1596: number = name1595 + 1596;
+let name1597: number = name1596 + 1597;
+let name1598: number = name1597 + 1598;
+let name1599: number = name1598 + 1599;
+let name1600: number = name1599 + 1600;
+let name1601: number = name1600 + 1601;
+let name1602: number = name1601 + 1602;
+let name1603: number = name1602 + 1603;
+let name1604: number = name1603 + 1604;
+let name1605: number = name1604 + 1605;
+let name1606: number = name1605 + 1606;
+let name1607: number = name1606 + 1607;
+let name1608: number = name1607 + 1608;
+let name1609: number = name1608 + 1609;
+let name1610: number = name1609 + 1610;
+let name1611: number = name1610 + 1611;
+let name1612: number = name1611 + 1612;
+let name1613: number = name1612 + 1613;
+let name1614: number = name1613 + 1614;
+let name1615: number = name1614 + 1615;
+let name1616: number = name1615 + 1616;
+let name1617: number = name1616 + 1617;
+let name1618: number = name1617 + 1618;
+let name1619: number = name1618 + 1619;
+let name1620: number = name1619 + 1620;
+let name1621: number = name1620 + 1621;
+let name1622: number = name1621 + 1622;
+let name1623: number = name1622 + 1623;
+let name1624: number = name1623 + 1624;
+let name1625: number = name1624 + 1625;
+let name1626: number = name1625 + 1626;
+let name1627: number = name1626 + 1627;
+let name1628: number = name1627 + 1628;
+let name1629: number = name1628 + 1629;
+let name1630: number = name1629 + 1630;
+let name1631: number = name1630 + 1631;
+let name1632: number = name1631 + 1632;
+let name1633: number = name1632 + 1633;
+let name1634: number = name1633 + 1634;
+let name1635: number = name1634 + 1635;
+let name1636: number = name1635 + 1636;
+let name1637: number = name1636 + 1637;
+let name1638: number = name1637 + 1638;
+let name1639: number = name1638 + 1639;
+let name1640: number = name1639 + 1640;
+let name1641: number = name1640 + 1641;
+let name1642: number = name1641 + 1642;
+let name1643: number = name1642 + 1643;
+let name1644: number = name1643 + 1644;
+let name1645: number = name1644 + 1645;
+let name1646: number = name1645 + 1646;
+let name1647: number = name1646 + 1647;
+let name1648: number = name1647 + 1648;
+let name1649: number = name1648 + 1649;
+let name1650: number = name1649 + 1650;
+let name1651: number = name1650 + 1651;
+let name1652: number = name1651 + 1652;
+let name1653: number = name1652 + 1653;
+let name1654: number = name1653 + 1654;
+let name1655: number = name1654 + 1655;
+let name1656: number = name1655 + 1656;
+let name1657: number = name1656 + 1657;
+let name1658: number = name1657 + 1658;
+let name1659: number = name1658 + 1659;
+let name1660: number = name1659 + 1660;
+let name1661: number = name1660 + 1661;
+let name1662: number = name1661 + 1662;
+let name1663: number = name1662 + 1663;
+let name1664: number = name1663 + 1664;
+let name1665: number = name1664 + 1665;
+let name1666: number = name1665 + 1666;
+let name1667: number = name1666 + 1667;
+let name1668: number = name1667 + 1668;
+let name1669: number = name1668 + 1669;
+let name1670: number = name1669 + 1670;
+let name1671: number = name1670 + 1671;
+let name1672: number = name1671 + 1672;
+let name1673: number = name1672 + 1673;
+let name1674: number = name1673 + 1674;
+let name1675: number = name1674 + 1675;
+let name1676: number = name1675 + 1676;
+let name1677: number = name1676 + 1677;
+let name1678: number = name1677 + 1678;
+let name1679: number = name1678 + 1679;
+let name1680: number = name1679 + 1680;
+let name1681: number = name1680 + 1681;
+let name1682: number = name1681 + 1682;
+let name1683: number = name1682 + 1683;
+let name1684: number = name1683 + 1684;
+let name1685: number = name1684 + 1685;
+let name1686: number = name1685 + 1686;
+let name1687: number = name1686 + 1687;
+let name1688: number = name1687 + 1688;
+let name1689: number = name1688 + 1689;
+let name1690: number = name1689 + 1690;
+let name1691: number = name1690 + 1691;
+let name1692: number = name1691 + 1692;
+let name1693: number = name1692 + 1693;
+let name1694: number = name1693 + 1694;
+let name1695: number = name1694 + 1695;
+let name1696: number = name1695 + 1696;
+let name1697: number = name1696 + 1697;
+let name1698: number = name1697 + 1698;
+let name1699: number = name1698 + 1699;
+let name1700: number = name1699 + 1700;
+let name1701: number = name1700 + 1701;
+let name1702: number = name1701 + 1702;
+let name1703: number = name1702 + 1703;
+let name1704: number = name1703 + 1704;
+let name1705: number = name1704 + 1705;
+let name1706: number = name1705 + 1706;
+let name1707: number = name1706 + 1707;
+let name1708: number = name1707 + 1708;
+let name1709: number = name1708 + 1709;
+let name1710: number = name1709 + 1710;
+let name1711: number = name1710 + 1711;
+let name1712: number = name1711 + 1712;
+let name1713: number = name1712 + 1713;
+let name1714: number = name1713 + 1714;
+let name1715: number = name1714 + 1715;
+let name1716: number = name1715 + 1716;
+let name1717: number = name1716 + 1717;
+let name1718: number = name1717 + 1718;
+let name1719: number = name1718 + 1719;
+let name1720: number = name1719 + 1720;
+let name1721: number = name1720 + 1721;
+let name1722: number = name1721 + 1722;
+let name1723: number = name1722 + 1723;
+let name1724: number = name1723 + 1724;
+let name1725: number = name1724 + 1725;
+let name1726: number = name1725 + 1726;
+let name1727: number = name1726 + 1727;
+let name1728: number = name1727 + 1728;
+let name1729: number = name1728 + 1729;
+let name1730: number = name1729 + 1730;
+let name1731: number = name1730 + 1731;
+let name1732: number = name1731 + 1732;
+let name1733: number = name1732 + 1733;
+let name1734: number = name1733 + 1734;
+let name1735: number = name1734 + 1735;
+let name1736: number = name1735 + 1736;
+let name1737: number = name1736 + 1737;
+let name1738: number = name1737 + 1738;
+let name1739: number = name1738 + 1739;
+let name1740: number = name1739 + 1740;
+let name1741: number = name1740 + 1741;
+let name1742: number = name1741 + 1742;
+let name1743: number = name1742 + 1743;
+let name1744: number = name1743 + 1744;
+let name1745: number = name1744 + 1745;
+let name1746: number = name1745 + 1746;
+let name1747: number = name1746 + 1747;
+let name1748: number = name1747 + 1748;
+let name1749: number = name1748 + 1749;
+let name1750: number = name1749 + 1750;
+let name1751: number = name1750 + 1751;
+let name1752: number = name1751 + 1752;
+let name1753: number = name1752 + 1753;
+let name1754: number = name1753 + 1754;
+let name1755: number = name1754 + 1755;
+let name1756: number = name1755 + 1756;
+let name1757: number = name1756 + 1757;
+let name1758: number = name1757 + 1758;
+let name1759: number = name1758 + 1759;
+let name1760: number = name1759 + 1760;
+let name1761: number = name1760 + 1761;
+let name1762: number = name1761 + 1762;
+let name1763: number = name1762 + 1763;
+let name1764: number = name1763 + 1764;
+let name1765: number = name1764 + 1765;
+let name1766: number = name1765 + 1766;
+let name1767: number = name1766 + 1767;
+let name1768: number = name1767 + 1768;
+let name1769: number = name1768 + 1769;
+let name1770: number = name1769 + 1770;
+let name1771: number = name1770 + 1771;
+let name1772: number = name1771 + 1772;
+let name1773: number = name1772 + 1773;
+let name1774: number = name1773 + 1774;
+let name1775: number = name1774 + 1775;
+let name1776: number = name1775 + 1776;
+let name1777: number = name1776 + 1777;
+let name1778: number = name1777 + 1778;
+let name1779: number = name1778 + 1779;
+let name1780: number = name1779 + 1780;
+let name1781: number = name1780 + 1781;
+let name1782: number = name1781 + 1782;
+let name1783: number = name1782 + 1783;
+let name1784: number = name1783 + 1784;
+let name1785: number = name1784 + 1785;
+let name1786: number = name1785 + 1786;
+let name1787: number = name1786 + 1787;
+let name1788: number = name1787 + 1788;
+let name1789: number = name1788 + 1789;
+let name1790: number = name1789 + 1790;
+let name1791: number = name1790 + 1791;
+let name1792: number = name1791 + 1792;
+let name1793: number = name1792 + 1793;
+let name1794: number = name1793 + 1794;
+let name1795: number = name1794 + 1795;
+let name1796: number = name1795 + 1796;
+let name1797: number = name1796 + 1797;
+let name1798: number = name1797 + 1798;
+let name1799: number = name1798 + 1799;
+let name1800: number = name1799 + 1800;
+let name1801: number = name1800 + 1801;
+let name1802: number = name1801 + 1802;
+let name1803: number = name1802 + 1803;
+let name1804: number = name1803 + 1804;
+let name1805: number = name1804 + 1805;
+let name1806: number = name1805 + 1806;
+let name1807: number = name1806 + 1807;
+let name1808: number = name1807 + 1808;
+let name1809: number = name1808 + 1809;
+let name1810: number = name1809 + 1810;
+let name1811: number = name1810 + 1811;
+let name1812: number = name1811 + 1812;
+let name1813: number = name1812 + 1813;
+let name1814: number = name1813 + 1814;
+let name1815: number = name1814 + 1815;
+let name1816: number = name1815 + 1816;
+let name1817: number = name1816 + 1817;
+let name1818: number = name1817 + 1818;
+let name1819: number = name1818 + 1819;
+let name1820: number = name1819 + 1820;
+let name1821: number = name1820 + 1821;
+let name1822: number = name1821 + 1822;
+let name1823: number = name1822 + 1823;
+let name1824: number = name1823 + 1824;
+let name1825: number = name1824 + 1825;
+let name1826: number = name1825 + 1826;
+let name1827: number = name1826 + 1827;
+let name1828: number = name1827 + 1828;
+let name1829: number = name1828 + 1829;
+let name1830: number = name1829 + 1830;
+let name1831: number = name1830 + 1831;
+let name1832: number = name1831 + 1832;
+let name1833: number = name1832 + 1833;
+let name1834: number = name1833 + 1834;
+let name1835: number = name1834 + 1835;
+let name1836: number = name1835 + 1836;
+let name1837: number = name1836 + 1837;
+let name1838: number = name1837 + 1838;
+let name1839: number = name1838 + 1839;
+let name1840: number = name1839 + 1840;
+let name1841: number = name1840 + 1841;
+let name1842: number = name1841 + 1842;
+let name1843: number = name1842 + 1843;
+let name1844: number = name1843 + 1844;
+let name1845: number = name1844 + 1845;
+let name1846: number = name1845 + 1846;
+let name1847: number = name1846 + 1847;
+let name1848: number = name1847 + 1848;
+let name1849: number = name1848 + 1849;
+let name1850: number = name1849 + 1850;
+let name1851: number = name1850 + 1851;
+let name1852: number = name1851 + 1852;
+let name1853: number = name1852 + 1853;
+let name1854: number = name1853 + 1854;
+let name1855: number = name1854 + 1855;
+let name1856: number = name1855 + 1856;
+let name1857: number = name1856 + 1857;
+let name1858: number = name1857 + 1858;
+let name1859: number = name1858 + 1859;
+let name1860: number = name1859 + 1860;
+let name1861: number = name1860 + 1861;
+let name1862: number = name1861 + 1862;
+let name1863: number = name1862 + 1863;
+let name1864: number = name1863 + 1864;
+let name1865: number = name1864 + 1865;
+let name1866: number = name1865 + 1866;
+let name1867: number = name1866 + 1867;
+let name1868: number = name1867 + 1868;
+let name1869: number = name1868 + 1869;
+let name1870: number = name1869 + 1870;
+let name1871: number = name1870 + 1871;
+let name1872: number = name1871 + 1872;
+let name1873: number = name1872 + 1873;
+let name1874: number = name1873 + 1874;
+let name1875: number = name1874 + 1875;
+let name1876: number = name1875 + 1876;
+let name1877: number = name1876 + 1877;
+let name1878: number = name1877 + 1878;
+let name1879: number = name1878 + 1879;
+let name1880: number = name1879 + 1880;
+let name1881: number = name1880 + 1881;
+let name1882: number = name1881 + 1882;
+let name1883: number = name1882 + 1883;
+let name1884: number = name1883 + 1884;
+let name1885: number = name1884 + 1885;
+let name1886: number = name1885 + 1886;
+let name1887: number = name1886 + 1887;
+let name1888: number = name1887 + 1888;
+let name1889: number = name1888 + 1889;
+let name1890: number = name1889 + 1890;
+let name1891: number = name1890 + 1891;
+let name1892: number = name1891 + 1892;
+let name1893: number = name1892 + 1893;
+let name1894: number = name1893 + 1894;
+let name1895: number = name1894 + 1895;
+let name1896: number = name1895 + 1896;
+let name1897: number = name1896 + 1897;
+let name1898: number = name1897 + 1898;
+let name1899: number = name1898 + 1899;
+let name1900: number = name1899 + 1900;
+let name1901: number = name1900 + 1901;
+let name1902: number = name1901 + 1902;
+let name1903: number = name1902 + 1903;
+let name1904: number = name1903 + 1904;
+let name1905: number = name1904 + 1905;
+let name1906: number = name1905 + 1906;
+let name1907: number = name1906 + 1907;
+let name1908: number = name1907 + 1908;
+let name1909: number = name1908 + 1909;
+let name1910: number = name1909 + 1910;
+let name1911: number = name1910 + 1911;
+let name1912: number = name1911 + 1912;
+let name1913: number = name1912 + 1913;
+let name1914: number = name1913 + 1914;
+let name1915: number = name1914 + 1915;
+let name1916: number = name1915 + 1916;
+let name1917: number = name1916 + 1917;
+let name1918: number = name1917 + 1918;
+let name1919: number = name1918 + 1919;
+let name1920: number = name1919 + 1920;
+let name1921: number = name1920 + 1921;
+let name1922: number = name1921 + 1922;
+let name1923: number = name1922 + 1923;
+let name1924: number = name1923 + 1924;
+let name1925: number = name1924 + 1925;
+let name1926: number = name1925 + 1926;
+let name1927: number = name1926 + 1927;
+let name1928: number = name1927 + 1928;
+let name1929: number = name1928 + 1929;
+let name1930: number = name1929 + 1930;
+let name1931: number = name1930 + 1931;
+let name1932: number = name1931 + 1932;
+let name1933: number = name1932 + 1933;
+let name1934: number = name1933 + 1934;
+let name1935: number = name1934 + 1935;
+let name1936: number = name1935 + 1936;
+let name1937: number = name1936 + 1937;
+let name1938: number = name1937 + 1938;
+let name1939: number = name1938 + 1939;
+let name1940: number = name1939 + 1940;
+let name1941: number = name1940 + 1941;
+let name1942: number = name1941 + 1942;
+let name1943: number = name1942 + 1943;
+let name1944: number = name1943 + 1944;
+let name1945: number = name1944 + 1945;
+let name1946: number = name1945 + 1946;
+let name1947: number = name1946 + 1947;
+let name1948: number = name1947 + 1948;
+let name1949: number = name1948 + 1949;
+let name1950: number = name1949 + 1950;
+let name1951: number = name1950 + 1951;
+let name1952: number = name1951 + 1952;
+let name1953: number = name1952 + 1953;
+let name1954: number = name1953 + 1954;
+let name1955: number = name1954 + 1955;
+let name1956: number = name1955 + 1956;
+let name1957: number = name1956 + 1957;
+let name1958: number = name1957 + 1958;
+let name1959: number = name1958 + 1959;
+let name1960: number = name1959 + 1960;
+let name1961: number = name1960 + 1961;
+let name1962: number = name1961 + 1962;
+let name1963: number = name1962 + 1963;
+let name1964: number = name1963 + 1964;
+let name1965: number = name1964 + 1965;
+let name1966: number = name1965 + 1966;
+let name1967: number = name1966 + 1967;
+let name1968: number = name1967 + 1968;
+let name1969: number = name1968 + 1969;
+let name1970: number = name1969 + 1970;
+let name1971: number = name1970 + 1971;
+let name1972: number = name1971 + 1972;
+let name1973: number = name1972 + 1973;
+let name1974: number = name1973 + 1974;
+let name1975: number = name1974 + 1975;
+let name1976: number = name1975 + 1976;
+let name1977: number = name1976 + 1977;
+let name1978: number = name1977 + 1978;
+let name1979: number = name1978 + 1979;
+let name1980: number = name1979 + 1980;
+let name1981: number = name1980 + 1981;
+let name1982: number = name1981 + 1982;
+let name1983: number = name1982 + 1983;
+let name1984: number = name1983 + 1984;
+let name1985: number = name1984 + 1985;
+let name1986: number = name1985 + 1986;
+let name1987: number = name1986 + 1987;
+let name1988: number = name1987 + 1988;
+let name1989: number = name1988 + 1989;
+let name1990: number = name1989 + 1990;
+let name1991: number = name1990 + 1991;
+let name1992: number = name1991 + 1992;
+let name1993: number = name1992 + 1993;
+let name1994: number = name1993 + 1994;
+let name1995: number = name1994 + 1995;
+let name1996: number = name1995 + 1996;
+let name1997: number = name1996 + 1997;
+let name1998: number = name1997 + 1998;
+let name1999: number = name1998 + 1999;
+let name2000: number = name1999 + 2000;
+let name2001: number = name2000 + 2001;
+let name2002: number = name2001 + 2002;
+let name2003: number = name2002 + 2003;
+let name2004: number = name2003 + 2004;
+let name2005: number = name2004 + 2005;
+let name2006: number = name2005 + 2006;
+let name2007: number = name2006 + 2007;
+let name2008: number = name2007 + 2008;
+let name2009: number = name2008 + 2009;
+let name2010: number = name2009 + 2010;
+let name2011: number = name2010 + 2011;
+let name2012: number = name2011 + 2012;
+let name2013: number = name2012 + 2013;
+let name2014: number = name2013 + 2014;
+let name2015: number = name2014 + 2015;
+let name2016: number = name2015 + 2016;
+let name2017: number = name2016 + 2017;
+let name2018: number = name2017 + 2018;
+let name2019: number = name2018 + 2019;
+let name2020: number = name2019 + 2020;
+let name2021: number = name2020 + 2021;
+let name2022: number = name2021 + 2022;
+let name2023: number = name2022 + 2023;
+let name2024: number = name2023 + 2024;
+let name2025: number = name2024 + 2025;
+let name2026: number = name2025 + 2026;
+let name2027: number = name2026 + 2027;
+let name2028: number = name2027 + 2028;
+let name2029: number = name2028 + 2029;
+let name2030: number = name2029 + 2030;
+let name2031: number = name2030 + 2031;
+let name2032: number = name2031 + 2032;
+let name2033: number = name2032 + 2033;
+let name2034: number = name2033 + 2034;
+let name2035: number = name2034 + 2035;
+let name2036: number = name2035 + 2036;
+let name2037: number = name2036 + 2037;
+let name2038: number = name2037 + 2038;
+let name2039: number = name2038 + 2039;
+let name2040: number = name2039 + 2040;
+let name2041: number = name2040 + 2041;
+let name2042: number = name2041 + 2042;
+let name2043: number = name2042 + 2043;
+let name2044: number = name2043 + 2044;
+let name2045: number = name2044 + 2045;
+let name2046: number = name2045 + 2046;
+let name2047: number = name2046 + 2047;
+let name2048: number = name2047 + 2048;
+let name2049: number = name2048 + 2049;
+let name2050: number = name2049 + 2050;
+let name2051: number = name2050 + 2051;
+let name2052: number = name2051 + 2052;
+let name2053: number = name2052 + 2053;
+let name2054: number = name2053 + 2054;
+let name2055: number = name2054 + 2055;
+let name2056: number = name2055 + 2056;
+let name2057: number = name2056 + 2057;
+let name2058: number = name2057 + 2058;
+let name2059: number = name2058 + 2059;
+let name2060: number = name2059 + 2060;
+let name2061: number = name2060 + 2061;
+let name2062: number = name2061 + 2062;
+let name2063: number = name2062 + 2063;
+let name2064: number = name2063 + 2064;
+let name2065: number = name2064 + 2065;
+let name2066: number = name2065 + 2066;
+let name2067: number = name2066 + 2067;
+let name2068: number = name2067 + 2068;
+let name2069: number = name2068 + 2069;
+let name2070: number = name2069 + 2070;
+let name2071: number = name2070 + 2071;
+let name2072: number = name2071 + 2072;
+let name2073: number = name2072 + 2073;
+let name2074: number = name2073 + 2074;
+let name2075: number = name2074 + 2075;
+let name2076: number = name2075 + 2076;
+let name2077: number = name2076 + 2077;
+let name2078: number = name2077 + 2078;
+let name2079: number = name2078 + 2079;
+let name2080: number = name2079 + 2080;
+let name2081: number = name2080 + 2081;
+let name2082: number = name2081 + 2082;
+let name2083: number = name2082 + 2083;
+let name2084: number = name2083 + 2084;
+let name2085: number = name2084 + 2085;
+let name2086: number = name2085 + 2086;
+let name2087: number = name2086 + 2087;
+let name2088: number = name2087 + 2088;
+let name2089: number = name2088 + 2089;
+let name2090: number = name2089 + 2090;
+let name2091: number = name2090 + 2091;
+let name2092: number = name2091 + 2092;
+let name2093: number = name2092 + 2093;
+let name2094: number = name2093 + 2094;
+let name2095: number = name2094 + 2095;
+let name2096: number = name2095 + 2096;
+let name2097: number = name2096 + 2097;
+let name2098: number = name2097 + 2098;
+let name2099: number = name2098 + 2099;
+let name2100: number = name2099 + 2100;
+let name2101: number = name2100 + 2101;
+let name2102: number = name2101 + 2102;
+let name2103: number = name2102 + 2103;
+let name2104: number = name2103 + 2104;
+let name2105: number = name2104 + 2105;
+let name2106: number = name2105 + 2106;
+let name2107: number = name2106 + 2107;
+let name2108: number = name2107 + 2108;
+let name2109: number = name2108 + 2109;
+let name2110: number = name2109 + 2110;
+let name2111: number = name2110 + 2111;
+let name2112: number = name2111 + 2112;
+let name2113: number = name2112 + 2113;
+let name2114: number = name2113 + 2114;
+let name2115: number = name2114 + 2115;
+let name2116: number = name2115 + 2116;
+let name2117: number = name2116 + 2117;
+let name2118: number = name2117 + 2118;
+let name2119: number = name2118 + 2119;
+let name2120: number = name2119 + 2120;
+let name2121: number = name2120 + 2121;
+let name2122: number = name2121 + 2122;
+let name2123: number = name2122 + 2123;
+let name2124: number = name2123 + 2124;
+let name2125: number = name2124 + 2125;
+let name2126: number = name2125 + 2126;
+let name2127: number = name2126 + 2127;
+let name2128: number = name2127 + 2128;
+let name2129: number = name2128 + 2129;
+let name2130: number = name2129 + 2130;
+let name2131: number = name2130 + 2131;
+let name2132: number = name2131 + 2132;
+let name2133: number = name2132 + 2133;
+let name2134: number = name2133 + 2134;
+let name2135: number = name2134 + 2135;
+let name2136: number = name2135 + 2136;
+let name2137: number = name2136 + 2137;
+let name2138: number = name2137 + 2138;
+let name2139: number = name2138 + 2139;
+let name2140: number = name2139 + 2140;
+let name2141: number = name2140 + 2141;
+let name2142: number = name2141 + 2142;
+let name2143: number = name2142 + 2143;
+let name2144: number = name2143 + 2144;
+let name2145: number = name2144 + 2145;
+let name2146: number = name2145 + 2146;
+let name2147: number = name2146 + 2147;
+let name2148: number = name2147 + 2148;
+let name2149: number = name2148 + 2149;
+let name2150: number = name2149 + 2150;
+let name2151: number = name2150 + 2151;
+let name2152: number = name2151 + 2152;
+let name2153: number = name2152 + 2153;
+let name2154: number = name2153 + 2154;
+let name2155: number = name2154 + 2155;
+let name2156: number = name2155 + 2156;
+let name2157: number = name2156 + 2157;
+let name2158: number = name2157 + 2158;
+let name2159: number = name2158 + 2159;
+let name2160: number = name2159 + 2160;
+let name2161: number = name2160 + 2161;
+let name2162: number = name2161 + 2162;
+let name2163: number = name2162 + 2163;
+let name2164: number = name2163 + 2164;
+let name2165: number = name2164 + 2165;
+let name2166: number = name2165 + 2166;
+let name2167: number = name2166 + 2167;
+let name2168: number = name2167 + 2168;
+let name2169: number = name2168 + 2169;
+let name2170: number = name2169 + 2170;
+let name2171: number = name2170 + 2171;
+let name2172: number = name2171 + 2172;
+let name2173: number = name2172 + 2173;
+let name2174: number = name2173 + 2174;
+let name2175: number = name2174 + 2175;
+let name2176: number = name2175 + 2176;
+let name2177: number = name2176 + 2177;
+let name2178: number = name2177 + 2178;
+let name2179: number = name2178 + 2179;
+let name2180: number = name2179 + 2180;
+let name2181: number = name2180 + 2181;
+let name2182: number = name2181 + 2182;
+let name2183: number = name2182 + 2183;
+let name2184: number = name2183 + 2184;
+let name2185: number = name2184 + 2185;
+let name2186: number = name2185 + 2186;
+let name2187: number = name2186 + 2187;
+let name2188: number = name2187 + 2188;
+let name2189: number = name2188 + 2189;
+let name2190: number = name2189 + 2190;
+let name2191: number = name2190 + 2191;
+let name2192: number = name2191 + 2192;
+let name2193: number = name2192 + 2193;
+let name2194: number = name2193 + 2194;
+let name2195: number = name2194 + 2195;
+let name2196: number = name2195 + 2196;
+let name2197: number = name2196 + 2197;
+let name2198: number = name2197 + 2198;
+let name2199: number = name2198 + 2199;
+let name2200: number = name2199 + 2200;
+let name2201: number = name2200 + 2201;
+let name2202: number = name2201 + 2202;
+let name2203: number = name2202 + 2203;
+let name2204: number = name2203 + 2204;
+let name2205: number = name2204 + 2205;
+let name2206: number = name2205 + 2206;
+let name2207: number = name2206 + 2207;
+let name2208: number = name2207 + 2208;
+let name2209: number = name2208 + 2209;
+let name2210: number = name2209 + 2210;
+let name2211: number = name2210 + 2211;
+let name2212: number = name2211 + 2212;
+let name2213: number = name2212 + 2213;
+let name2214: number = name2213 + 2214;
+let name2215: number = name2214 + 2215;
+let name2216: number = name2215 + 2216;
+let name2217: number = name2216 + 2217;
+let name2218: number = name2217 + 2218;
+let name2219: number = name2218 + 2219;
+let name2220: number = name2219 + 2220;
+let name2221: number = name2220 + 2221;
+let name2222: number = name2221 + 2222;
+let name2223: number = name2222 + 2223;
+let name2224: number = name2223 + 2224;
+let name2225: number = name2224 + 2225;
+let name2226: number = name2225 + 2226;
+let name2227: number = name2226 + 2227;
+let name2228: number = name2227 + 2228;
+let name2229: number = name2228 + 2229;
+let name2230: number = name2229 + 2230;
+let name2231: number = name2230 + 2231;
+let name2232: number = name2231 + 2232;
+let name2233: number = name2232 + 2233;
+let name2234: number = name2233 + 2234;
+let name2235: number = name2234 + 2235;
+let name2236: number = name2235 + 2236;
+let name2237: number = name2236 + 2237;
+let name2238: number = name2237 + 2238;
+let name2239: number = name2238 + 2239;
+let name2240: number = name2239 + 2240;
+let name2241: number = name2240 + 2241;
+let name2242: number = name2241 + 2242;
+let name2243: number = name2242 + 2243;
+let name2244: number = name2243 + 2244;
+let name2245: number = name2244 + 2245;
+let name2246: number = name2245 + 2246;
+let name2247: number = name2246 + 2247;
+let name2248: number = name2247 + 2248;
+let name2249: number = name2248 + 2249;
+let name2250: number = name2249 + 2250;
+let name2251: number = name2250 + 2251;
+let name2252: number = name2251 + 2252;
+let name2253: number = name2252 + 2253;
+let name2254: number = name2253 + 2254;
+let name2255: number = name2254 + 2255;
+let name2256: number = name2255 + 2256;
+let name2257: number = name2256 + 2257;
+let name2258: number = name2257 + 2258;
+let name2259: number = name2258 + 2259;
+let name2260: number = name2259 + 2260;
+let name2261: number = name2260 + 2261;
+let name2262: number = name2261 + 2262;
+let name2263: number = name2262 + 2263;
+let name2264: number = name2263 + 2264;
+let name2265: number = name2264 + 2265;
+let name2266: number = name2265 + 2266;
+let name2267: number = name2266 + 2267;
+let name2268: number = name2267 + 2268;
+let name2269: number = name2268 + 2269;
+let name2270: number = name2269 + 2270;
+let name2271: number = name2270 + 2271;
+let name2272: number = name2271 + 2272;
+let name2273: number = name2272 + 2273;
+let name2274: number = name2273 + 2274;
+let name2275: number = name2274 + 2275;
+let name2276: number = name2275 + 2276;
+let name2277: number = name2276 + 2277;
+let name2278: number = name2277 + 2278;
+let name2279: number = name2278 + 2279;
+let name2280: number = name2279 + 2280;
+let name2281: number = name2280 + 2281;
+let name2282: number = name2281 + 2282;
+let name2283: number = name2282 + 2283;
+let name2284: number = name2283 + 2284;
+let name2285: number = name2284 + 2285;
+let name2286: number = name2285 + 2286;
+let name2287: number = name2286 + 2287;
+let name2288: number = name2287 + 2288;
+let name2289: number = name2288 + 2289;
+let name2290: number = name2289 + 2290;
+let name2291: number = name2290 + 2291;
+let name2292: number = name2291 + 2292;
+let name2293: number = name2292 + 2293;
+let name2294: number = name2293 + 2294;
+let name2295: number = name2294 + 2295;
+let name2296: number = name2295 + 2296;
+let name2297: number = name2296 + 2297;
+let name2298: number = name2297 + 2298;
+let name2299: number = name2298 + 2299;
+let name2300: number = name2299 + 2300;
+let name2301: number = name2300 + 2301;
+let name2302: number = name2301 + 2302;
+let name2303: number = name2302 + 2303;
+let name2304: number = name2303 + 2304;
+let name2305: number = name2304 + 2305;
+let name2306: number = name2305 + 2306;
+let name2307: number = name2306 + 2307;
+let name2308: number = name2307 + 2308;
+let name2309: number = name2308 + 2309;
+let name2310: number = name2309 + 2310;
+let name2311: number = name2310 + 2311;
+let name2312: number = name2311 + 2312;
+let name2313: number = name2312 + 2313;
+let name2314: number = name2313 + 2314;
+let name2315: number = name2314 + 2315;
+let name2316: number = name2315 + 2316;
+let name2317: number = name2316 + 2317;
+let name2318: number = name2317 + 2318;
+let name2319: number = name2318 + 2319;
+let name2320: number = name2319 + 2320;
+let name2321: number = name2320 + 2321;
+let name2322: number = name2321 + 2322;
+let name2323: number = name2322 + 2323;
+let name2324: number = name2323 + 2324;
+let name2325: number = name2324 + 2325;
+let name2326: number = name2325 + 2326;
+let name2327: number = name2326 + 2327;
+let name2328: number = name2327 + 2328;
+let name2329: number = name2328 + 2329;
+let name2330: number = name2329 + 2330;
+let name2331: number = name2330 + 2331;
+let name2332: number = name2331 + 2332;
+let name2333: number = name2332 + 2333;
+let name2334: number = name2333 + 2334;
+let name2335: number = name2334 + 2335;
+let name2336: number = name2335 + 2336;
+let name2337: number = name2336 + 2337;
+let name2338: number = name2337 + 2338;
+let name2339: number = name2338 + 2339;
+let name2340: number = name2339 + 2340;
+let name2341: number = name2340 + 2341;
+let name2342: number = name2341 + 2342;
+let name2343: number = name2342 + 2343;
+let name2344: number = name2343 + 2344;
+let name2345: number = name2344 + 2345;
+let name2346: number = name2345 + 2346;
+let name2347: number = name2346 + 2347;
+let name2348: number = name2347 + 2348;
+let name2349: number = name2348 + 2349;
+let name2350: number = name2349 + 2350;
+let name2351: number = name2350 + 2351;
+let name2352: number = name2351 + 2352;
+let name2353: number = name2352 + 2353;
+let name2354: number = name2353 + 2354;
+let name2355: number = name2354 + 2355;
+let name2356: number = name2355 + 2356;
+let name2357: number = name2356 + 2357;
+let name2358: number = name2357 + 2358;
+let name2359: number = name2358 + 2359;
+let name2360: number = name2359 + 2360;
+let name2361: number = name2360 + 2361;
+let name2362: number = name2361 + 2362;
+let name2363: number = name2362 + 2363;
+let name2364: number = name2363 + 2364;
+let name2365: number = name2364 + 2365;
+let name2366: number = name2365 + 2366;
+let name2367: number = name2366 + 2367;
+let name2368: number = name2367 + 2368;
+let name2369: number = name2368 + 2369;
+let name2370: number = name2369 + 2370;
+let name2371: number = name2370 + 2371;
+let name2372: number = name2371 + 2372;
+let name2373: number = name2372 + 2373;
+let name2374: number = name2373 + 2374;
+let name2375: number = name2374 + 2375;
+let name2376: number = name2375 + 2376;
+let name2377: number = name2376 + 2377;
+let name2378: number = name2377 + 2378;
+let name2379: number = name2378 + 2379;
+let name2380: number = name2379 + 2380;
+let name2381: number = name2380 + 2381;
+let name2382: number = name2381 + 2382;
+let name2383: number = name2382 + 2383;
+let name2384: number = name2383 + 2384;
+let name2385: number = name2384 + 2385;
+let name2386: number = name2385 + 2386;
+let name2387: number = name2386 + 2387;
+let name2388: number = name2387 + 2388;
+let name2389: number = name2388 + 2389;
+let name2390: number = name2389 + 2390;
+let name2391: number = name2390 + 2391;
+let name2392: number = name2391 + 2392;
+let name2393: number = name2392 + 2393;
+let name2394: number = name2393 + 2394;
+let name2395: number = name2394 + 2395;
+let name2396: number = name2395 + 2396;
+let name2397: number = name2396 + 2397;
+let name2398: number = name2397 + 2398;
+let name2399: number = name2398 + 2399;
+let name2400: number = name2399 + 2400;
+let name2401: number = name2400 + 2401;
+let name2402: number = name2401 + 2402;
+let name2403: number = name2402 + 2403;
+let name2404: number = name2403 + 2404;
+let name2405: number = name2404 + 2405;
+let name2406: number = name2405 + 2406;
+let name2407: number = name2406 + 2407;
+let name2408: number = name2407 + 2408;
+let name2409: number = name2408 + 2409;
+let name2410: number = name2409 + 2410;
+let name2411: number = name2410 + 2411;
+let name2412: number = name2411 + 2412;
+let name2413: number = name2412 + 2413;
+let name2414: number = name2413 + 2414;
+let name2415: number = name2414 + 2415;
+let name2416: number = name2415 + 2416;
+let name2417: number = name2416 + 2417;
+let name2418: number = name2417 + 2418;
+let name2419: number = name2418 + 2419;
+let name2420: number = name2419 + 2420;
+let name2421: number = name2420 + 2421;
+let name2422: number = name2421 + 2422;
+let name2423: number = name2422 + 2423;
+let name2424: number = name2423 + 2424;
+let name2425: number = name2424 + 2425;
+let name2426: number = name2425 + 2426;
+let name2427: number = name2426 + 2427;
+let name2428: number = name2427 + 2428;
+let name2429: number = name2428 + 2429;
+let name2430: number = name2429 + 2430;
+let name2431: number = name2430 + 2431;
+let name2432: number = name2431 + 2432;
+let name2433: number = name2432 + 2433;
+let name2434: number = name2433 + 2434;
+let name2435: number = name2434 + 2435;
+let name2436: number = name2435 + 2436;
+let name2437: number = name2436 + 2437;
+let name2438: number = name2437 + 2438;
+let name2439: number = name2438 + 2439;
+let name2440: number = name2439 + 2440;
+let name2441: number = name2440 + 2441;
+let name2442: number = name2441 + 2442;
+let name2443: number = name2442 + 2443;
+let name2444: number = name2443 + 2444;
+let name2445: number = name2444 + 2445;
+let name2446: number = name2445 + 2446;
+let name2447: number = name2446 + 2447;
+let name2448: number = name2447 + 2448;
+let name2449: number = name2448 + 2449;
+let name2450: number = name2449 + 2450;
+let name2451: number = name2450 + 2451;
+let name2452: number = name2451 + 2452;
+let name2453: number = name2452 + 2453;
+let name2454: number = name2453 + 2454;
+let name2455: number = name2454 + 2455;
+let name2456: number = name2455 + 2456;
+let name2457: number = name2456 + 2457;
+let name2458: number = name2457 + 2458;
+let name2459: number = name2458 + 2459;
+let name2460: number = name2459 + 2460;
+let name2461: number = name2460 + 2461;
+let name2462: number = name2461 + 2462;
+let name2463: number = name2462 + 2463;
+let name2464: number = name2463 + 2464;
+let name2465: number = name2464 + 2465;
+let name2466: number = name2465 + 2466;
+let name2467: number = name2466 + 2467;
+let name2468: number = name2467 + 2468;
+let name2469: number = name2468 + 2469;
+let name2470: number = name2469 + 2470;
+let name2471: number = name2470 + 2471;
+let name2472: number = name2471 + 2472;
+let name2473: number = name2472 + 2473;
+let name2474: number = name2473 + 2474;
+let name2475: number = name2474 + 2475;
+let name2476: number = name2475 + 2476;
+let name2477: number = name2476 + 2477;
+let name2478: number = name2477 + 2478;
+let name2479: number = name2478 + 2479;
+let name2480: number = name2479 + 2480;
+let name2481: number = name2480 + 2481;
+let name2482: number = name2481 + 2482;
+let name2483: number = name2482 + 2483;
+let name2484: number = name2483 + 2484;
+let name2485: number = name2484 + 2485;
+let name2486: number = name2485 + 2486;
+let name2487: number = name2486 + 2487;
+let name2488: number = name2487 + 2488;
+let name2489: number = name2488 + 2489;
+let name2490: number = name2489 + 2490;
+let name2491: number = name2490 + 2491;
+let name2492: number = name2491 + 2492;
+let name2493: number = name2492 + 2493;
+let name2494: number = name2493 + 2494;
+let name2495: number = name2494 + 2495;
+let name2496: number = name2495 + 2496;
+let name2497: number = name2496 + 2497;
+let name2498: number = name2497 + 2498;
+let name2499: number = name2498 + 2499;
+let first: string = name0;
+let last: string = name2499;
@@ -0,0 +1,8 @@
+let o = {
+    m(x: number): number { return x + 1; },
+    get v(): number { return 1; },
+    set w(value: string) {},
+};
+let s: string = o.v;
+let t: number = o.w;
+let u: string = o.m(2);
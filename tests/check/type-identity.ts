@@ -0,0 +1,21 @@
+type A = string | number;
+type B = number | string;
+type C = string | number | string;
+let a: A = 1;
+let b: B = a;
+let c: C = b;
+let d: boolean = c;
+
+type P = { x: number, y: { z: string } };
+type Q = { y: { z: string }, x: number };
+let p: P = { x: 1, y: { z: "" } };
+let q: Q = p;
+let r: { x: number, y: { z: number } } = q;
+
+let f: (n: number) => string = (n: number): string => "";
+let g: (m: number) => string = f;
+let h: (m: string) => string = g;
+
+let xs: number[] = [1, 2];
+let ys: Array<number> = xs;
+let zs: string[] = ys;
@@ -0,0 +1,13 @@
+const twice = (x: number): number => x * 2;
+const wrong = (x: number): string => x;
+const name = (first: string, last?: string) => first;
+const empty = (): boolean => true;
+const block = (x: number): number => {
+    return x;
+};
+
+let a: number = twice(2);
+let b: string = twice(2);
+let c: number = empty();
+let d: string = name("a");
+twice("no");
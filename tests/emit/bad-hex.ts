@@ -0,0 +1 @@
+let a = 0x;
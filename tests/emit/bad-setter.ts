@@ -0,0 +1,3 @@
+let o = {
+    set v(...values: number[]) {},
+};
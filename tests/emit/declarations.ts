@@ -0,0 +1,21 @@
+interface Point {
+    x: number;
+    y: number;
+}
+
+type Pair = Point | null;
+
+const origin: Point = { x: 0, y: 0 };
+let name: string = "origin";
+
+function distance(a: Point, b: Point): number {
+    let dx = a.x - b.x;
+    let dy = a.y - b.y;
+    return Math.sqrt(dx * dx + dy * dy);
+}
+
+async function later(value: number): Promise<number> {
+    return value;
+}
+
+let far = distance(origin, { x: 3, y: 4 }) > 2;
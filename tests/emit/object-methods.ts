@@ -0,0 +1,18 @@
+const k = "m";
+let o = {
+    a: 1,
+    m(x: number): number { return x + 1; },
+    async n(y: string) { return y; },
+    *g() { yield 1; },
+    async *h() {},
+    get v(): number { return 1; },
+    set v(value: number) {},
+    [k](z: number) { return z; },
+    async [k + "2"](z: number) {},
+    get: 1,
+    set() {},
+    async: 2,
+    get [k]() { return 1; },
+};
+let n: number = o.v;
+let w = o.m(2);
@@ -0,0 +1,11 @@
+const a = (x: number) => x;
+const b = (x?) => x;
+const c = (): number => 1;
+const d = (x: number, y?: string, ...rest: number[]): string => y + x;
+const e = (x: number = 1, { y }: { y: number }) => x + y;
+const f = (x: number): number => { return x; };
+const g = true ? (x) : (y);
+const h = true ? (x): number => x : null;
+const i = (x, y) => x + y;
+const j = (a ? b : c);
+const k = ([p, q]: number[]) => p;
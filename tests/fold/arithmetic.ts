@@ -0,0 +1,16 @@
+const a = 1 + 2 * 3;
+const b = 7 % -3;
+const c = -(0);
+const d = 1 / 0;
+const e = 0 / 0;
+const f = 2 ** 10;
+const g = (-2) ** 2;
+const h = 1 << 31;
+const i = -1 >>> 0;
+const j = 5 & 3 | 8 ^ 1;
+const k = ~~3.7;
+const l = 0.1 + 0.2;
+const m = (1).toString();
+const n = 1e21 + 1;
+const o = 2 ** 0.5;
+console.log(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o);
@@ -0,0 +1,20 @@
+const width = 4;
+const height = width * 2;
+const area = width * height;
+let changing = 1;
+const notConstant = changing + 1;
+function shadow(width: number) {
+    return width * height;
+}
+function inner() {
+    const width = 10;
+    return width + area;
+}
+const early = later + 1;
+const later = 2;
+function hoisted() {
+    return late;
+}
+console.log(hoisted());
+const late = 3;
+console.log(area, notConstant, shadow(1), inner(), early);
@@ -0,0 +1,4 @@
+const x = 1;
+const y = x + 1;
+eval("var x = 5");
+console.log(y, 2 + 3);
@@ -0,0 +1,6 @@
+let a = 010 + 0;
+let b = 08 + 0;
+let c = 09.5 * 2;
+let d = 0777 - 1;
+let e = 00 + 1;
+let f = 0o10 + 010;
@@ -0,0 +1,15 @@
+const yes = !0;
+const no = !"x";
+const loose = 1 == "1";
+const strict = 1 === "1";
+const nan = NaN === NaN;
+const nothing = null == undefined;
+const picked = 0 || "fallback";
+const kept = 1 && "second";
+const defaulted = null ?? 5;
+const chosen = 2 > 1 ? "big" : "small";
+const dead = false ? f() : 0;
+const live = true && g();
+const skipped = false && g();
+const voided = void 0;
+console.log(yes, no, loose, strict, nan, nothing, picked, kept, defaulted, chosen, dead, live, skipped, voided);
@@ -0,0 +1,7 @@
+let n = 0;
+const a = (n++, 1) + 2;
+const b = [1][0] + 1;
+const c = { v: 1 }.v + 1;
+const d = -"3" + +"4";
+const e = (1, 2) + 3;
+console.log(a, b, c, d, e, n);
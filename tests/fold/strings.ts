@@ -0,0 +1,10 @@
+const greeting = "hello" + ", " + "world";
+const count = "n=" + 3 + 4;
+const sum = 3 + 4 + "=n";
+const quoted = 'say "hi"';
+const joined = quoted + "!";
+const escaped = "a\n" + "b";
+const compared = "abc" < "abd";
+const typed = typeof 1 + typeof "" + typeof true + typeof undefined + typeof null;
+const length = "four".length;
+console.log(greeting, count, sum, joined, escaped, compared, typed, length);
@@ -0,0 +1 @@
+let a = "ends at the file\
\ No newline at end of file
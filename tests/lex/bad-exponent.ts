@@ -0,0 +1 @@
+let e = 1e;
@@ -0,0 +1 @@
+let n = 1__000;
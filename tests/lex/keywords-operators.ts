@@ -0,0 +1,8 @@
+break case catch class const continue debugger default delete do else enum
+export extends false finally for function if import in instanceof new null
+return super switch this throw true try typeof var void while with
+as implements interface let package private protected public static yield
+breaks i ins instanceo lets yields As True _new $this constructor
+=== !== == != = + - / * % += -= /= *= %= & | ^ ~ >>> >> << && || ! ? < > <= >=
+. ++ -- ** **= &= |= ^= <<= >>= >>>= &&= ||= ?? ??= ?. => ... ; ( ) { } [ ] : ,
+a?.5:b a?.b x>>>=1 y=>y ...z a===b!==c a**=2 !!d ~-e
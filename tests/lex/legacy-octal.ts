@@ -0,0 +1,6 @@
+let a = 010;
+let b = 08;
+let c = 09.5;
+let d = 0777;
+let e = 0;
+let f = 0.5;
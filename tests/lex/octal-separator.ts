@@ -0,0 +1 @@
+let a = 01_0;
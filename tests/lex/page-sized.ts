@@ -0,0 +1,267 @@
+// a file of exactly one page, which ends in the middle of an identifier
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let value = 1;
+let last = xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
\ No newline at end of file
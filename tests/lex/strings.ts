@@ -0,0 +1,9 @@
+let a = 'it\'s';
+let b = "say \"hi\"";
+let c = 'back\\slash';
+let d = 'one \
+two';
+let e = "a string long enough to go through more than one block of the vector kernels";
+let f = "carriage \
+return";
+let g = 1;
@@ -0,0 +1,3 @@
+let s: string = "héllo 😀"; let n: number = 1;
+let t = "€"; let u: number = 2;
+let v = "é" + "😀" + 1; let w: number = 3;
@@ -0,0 +1,8 @@
+(function () {
+    const origin = { x: 0, y: 0 };
+    const scale = (p: { x: number, y: number }, k: number) => ({ x: p.x * k, y: p.y * k });
+    let label: string = scale(origin, 2).x;
+    let names: string[] = ["a", "b"].map((s) => s + origin.y);
+    let count: number = names.length + "1";
+    return label;
+})();
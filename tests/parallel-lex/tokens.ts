@@ -0,0 +1,10 @@
+/* A block comment that runs over
+   several lines, with "quotes", 'quotes' and // inside it,
+   so a chunk boundary may well fall in the middle of it. */
+let text = "a string with /* no comment */ in it";
+let other = 'and one with \' an escape // too';
+const values = [0x1f, 0b101, 0o17, 1_000_000, 3.25e-2, 12n, .5];
+// a line comment with 'an unclosed quote
+value >>>= 2; value **= 3; value ??= nothing?.at(1);
+const arrow = (a, ...rest) => a === rest[0] !== false;
+label: while (x <= y && y >= z || !done) { x++; --y; }
@@ -0,0 +1,17 @@
+interface Point {
+    x: number;
+    readonly y?: number;
+}
+type Pair = Point | null;
+const origin: Point = { x: 0, y: 0 };
+function distance(a: Point, b: Point): number {
+    const dx = a.x - b.x;
+    return Math.sqrt(dx * dx);
+}
+let pick = (p: Point, keys: string[]): number => keys.length ? p.x : p.y ?? 0;
+let nested = { a: [1, 2, { b: -3 }], "c": (x) => x * 2, [key]: typeof origin };
+let chained = origin?.x ?? new Date(2020, 1).getTime() + +"4";
+function box(n: number): { value: number } {
+    return { value: n };
+}
+function both(): { a: number } | { b: string } { return { a: 1 }; }
@@ -0,0 +1,25 @@
+interface Point {
+    x: number;
+    y: number;
+}
+type Name = string;
+
+let origin: Point = { x: 0, y: 0 };
+let across: number = origin.x;
+let title: Name = "origin";
+let height: number = origin.y;
+
+function length(p: Point): number {
+    let total = p.x + p.y;
+    return total;
+}
+
+function describe(name: Name, p: Point): string {
+    let size: number = length(p);
+    return name + size;
+}
+
+let size: number = length(origin);
+let label: string = describe(title, origin);
+let wrong: string = size;
+let copy: Point = origin;
@@ -0,0 +1,26 @@
+const limit = 10;
+let count: number = limit;
+
+function clamp(value: number): number {
+    let bounded = value;
+    bounded = bounded - limit;
+    return bounded;
+}
+
+function twice(value: number): number {
+    let doubled = clamp(value) + clamp(value);
+    return doubled;
+}
+
+const half = function (value: number): number {
+    let result = value / 2;
+    return result;
+};
+
+const square = (value) => value * value;
+
+let total: number = twice(count);
+total = half(total);
+let text: string = clamp(total);
+count = square(total);
+limit = 5;
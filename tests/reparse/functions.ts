@@ -0,0 +1,34 @@
+function add(left: number, right: number): number {
+    let sum = left + right;
+    return sum;
+}
+
+function scale(value: number, by: number): number {
+    let scaled = value * by;
+    let rounded = Math.round(scaled);
+    return rounded;
+}
+
+const twice = function (value: number): number {
+    let doubled = add(value, value);
+    return doubled;
+};
+
+const square = (value) => value * value;
+
+function outer(limit: number): number {
+    function inner(step: number): number {
+        let next = step + 1;
+        return next;
+    }
+
+    let step = 0;
+    while (step < limit) {
+        step = inner(step);
+    }
+    return step;
+}
+
+let result = outer(scale(twice(2), 3));
+result = square(result);
+result = add(result, 1);
@@ -0,0 +1,28 @@
+let state = { depth: 0, seen: [1, 2, 3] };
+
+function walk(node: any, depth: number): number {
+    if (node === null) {
+        return depth;
+    }
+
+    let deepest = depth;
+    for (const child of node.children) {
+        const reached = walk(child, depth + 1);
+        if (reached > deepest) {
+            deepest = reached;
+        }
+    }
+
+    try {
+        state.depth = deepest;
+    } catch (error) {
+        state.depth = 0;
+    }
+
+    return deepest;
+}
+
+let tree = { children: [{ children: [] }, { children: [{ children: [] }] }] };
+let depth = walk(tree, 0);
+let flag = depth > 1 ? "deep" : "shallow";
+state.seen = [depth, depth + 1];
@@ -0,0 +1,28 @@
+let total = 0;
+const names = ["a", "b", "c"];
+let count = names.length;
+
+function sum(limit: number): number {
+    let i = 0;
+    while (i < limit) {
+        total = total + i;
+        i = i + 1;
+    }
+    return total;
+}
+
+function reset(): void {
+    if (count > 2) {
+        total = sum(count);
+        count = count - 1;
+    } else {
+        total = 0;
+    }
+}
+
+reset();
+
+let last = names[count - 1];
+let label = last + ":" + total;
+total = total * 2;
+label = label + total;
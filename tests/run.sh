@@ -0,0 +1,152 @@
+#!/bin/sh
+# Runs each tests/<mode>/<name>.ts through the compiler with the options for
+# its mode, and compares what it prints and its exit status with
+# <name>.expected.  "tests/run.sh update" rewrites the expected files instead.
+#
+# Output that should be JavaScript is also given to node --check, when there
+# is a node to give it to.  A source map is written to file descriptor 3 and
+# follows the output.
+#
+# A mode may also name baseline options, which the input is run with first:
+# the two runs must print the same.  The cache mode's first run writes an
+# entry and its second must read that entry back rather than writing another.
+#
+# The parallel modes repeat their input until it's big enough for lexing,
+# parsing and checking each to split it four ways, and compare four threads
+# with one.  Only the start of what they print, its length and its checksum
+# are kept in the expected file.
+
+compile=./compile
+update=false
+failed=0
+
+if [ "$1" = update ]; then
+    update=true
+fi
+
+scratch=$(mktemp -d) || exit 1
+trap 'rm -rf "$scratch"' EXIT
+
+# Runs the compiler over $file with the options given after the file to
+# write what it printed to, leaving its output and status in $scratch.  A
+# file made in $scratch is named as the input it was made from.
+run() {
+    printed=$1
+    shift
+    $compile "$@" "$file" >"$scratch/out" 2>"$scratch/err" 3>"$scratch/map"
+    status=$?
+
+    {
+        cat "$scratch/out"
+        cat "$scratch/map"
+        sed 's/^/stderr: /' "$scratch/err"
+        echo "exit $status"
+    } | sed "s|$scratch/big/||g" >"$printed"
+}
+
+# Writes $input over and over to $file until it's at least a MiB, which is
+# four of parlex.c's chunks.  One more copy at the end stops the chunks
+# from all starting where a copy does.
+repeat() {
+    file="$scratch/big/$input"
+    mkdir -p "$(dirname "$file")"
+    cp "$input" "$file"
+
+    while [ "$(wc -c <"$file")" -lt 1048576 ]; do
+        cat "$file" "$file" >"$scratch/twice"
+        mv "$scratch/twice" "$file"
+    done
+
+    cat "$input" >>"$file"
+}
+
+for input in tests/*/*.ts; do
+    mode=$(basename "$(dirname "$input")")
+    expected="${input%.ts}.expected"
+    javascript=false
+    baseline=
+    file=$input
+
+    case $mode in
+    lex) options= ;;
+    stream) options=--stream ;;
+    stream-ast) options='--stream --ast' ;;
+    check) options=--check ;;
+    emit) options=--emit javascript=true ;;
+    strip) options=--transpile-only javascript=true ;;
+    fold) options='--emit --fold' javascript=true ;;
+    map) options='--emit --fold --source-map /dev/fd/3' javascript=true ;;
+    reparse) options=--reparse ;;
+    recheck) options=--recheck ;;
+    cache)
+        rm -rf "$scratch/cache"
+        options="--ast --cache $scratch/cache"
+        baseline=$options
+        ;;
+    parallel-lex) options='--threads 4' baseline='--threads 1' ;;
+    parallel-parse) options='--ast --threads 4' baseline='--ast --threads 1' ;;
+    parallel-check) options='--check --threads 4' baseline='--check --threads 1' ;;
+    *)
+        echo "$input: no options for mode $mode"
+        failed=1
+        continue
+        ;;
+    esac
+
+    case $mode in
+    parallel-*) repeat ;;
+    esac
+
+    if [ -n "$baseline" ]; then
+        run "$scratch/baseline" $baseline
+        entry=$(ls -i "$scratch"/cache/*.ast 2>/dev/null)
+    fi
+
+    run "$scratch/actual" $options
+
+    if [ -n "$baseline" ] && ! diff -u "$scratch/baseline" "$scratch/actual" >"$scratch/diff" 2>&1; then
+        echo "FAIL $input: differs from a run with $baseline"
+        cat "$scratch/diff"
+        failed=1
+        continue
+    fi
+
+    if [ $mode = cache ] && { [ -z "$entry" ] || [ "$entry" != "$(ls -i "$scratch"/cache/*.ast)" ]; }; then
+        echo "FAIL $input: the cache entry wasn't written once and read back"
+        failed=1
+        continue
+    fi
+
+    if [ "$file" != "$input" ]; then
+        {
+            head -n 10 "$scratch/actual"
+            echo "... $(wc -l <"$scratch/actual") lines, checksum $(cksum <"$scratch/actual")"
+        } >"$scratch/summary"
+        mv "$scratch/summary" "$scratch/actual"
+    fi
+
+    if $update; then
+        cp "$scratch/actual" "$expected"
+    elif ! diff -u "$expected" "$scratch/actual" >"$scratch/diff" 2>&1; then
+        echo "FAIL $input"
+        cat "$scratch/diff"
+        failed=1
+        continue
+    fi
+
+    if $javascript && [ $status -eq 0 ] && command -v node >/dev/null 2>&1; then
+        cp "$scratch/out" "$scratch/out.js"
+        if ! node --check "$scratch/out.js" >"$scratch/node" 2>&1; then
+            echo "FAIL $input: output isn't JavaScript"
+            cat "$scratch/node"
+            failed=1
+            continue
+        fi
+    fi
+done
+
+if [ $failed -eq 0 ]; then
+    echo "all tests passed"
+fi
+
+exit $failed
@@ -0,0 +1,7 @@
+let o = { m(x) { return x; }, async n() {}, *g() {}, get v() { return 1; }, set v(x) {} };
+let p = { [k](x) {}, get [k]() { return 1; }, get: 1, set() {}, async };
+let q = { get x(a) { return a; } };
+let r = { set x() {} };
+let s = { async x: 1 };
+let t = { get *x() {} };
+let u = { async [k]: 1 };
@@ -0,0 +1,7 @@
+let a = b?.c.d;
+(b?.c).d = 1;
+b?.c = 1;
+b?.c.d = 1;
+b?.[0] = 1;
+b?.c().d = 1;
+b?.c++;
@@ -0,0 +1,13 @@
+f(...a, ...b);
+new F(...a);
+let v = [a, , ...b];
+let o = { ...a, b };
+let f = (a, ...b) => a;
+function g(a: number, ...rest: number[]) { return rest; }
+a + ...b;
+x = ...a;
+let c = a ? ...b : c;
+...a;
+let w = (a, ...b);
+f(a[...b]);
+let h = () => ...a;
@@ -0,0 +1,9 @@
+let a: number = 1;
+async function g(x: string) { return x; }
+interface Point { x: number; y: number; }
+type Pair = { first: number; second: number };
+{ let b = a + 1; }
+const f = (p) => p.x * 2;
+g("a").then(h => h);
+if (a) { a = 2; } else { a = 3; }
+let last = f({ x: 1, y: 2 });
@@ -0,0 +1,7 @@
+let C = class {};
+let r = /ab+c/;
+if (a) { b(); }
+for (;;) {}
+import x from "y";
+let m = import("y");
+throw a;
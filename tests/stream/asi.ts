@@ -0,0 +1,21 @@
+let a = 1
+let b = a
+  + 2
+const c = f
+(b)
+x
+++y
+label: {
+}
+let o = { m: 1 }
+/* a
+   comment */ o.m = 2
+let s = "one" // trailing
+  , t = 2
+do x++
+while (x < 3)
+function g()
+{
+}
+let d = a
+let e = b;
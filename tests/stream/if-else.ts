@@ -0,0 +1,4 @@
+if (a) { b(); } else { c(); }
+try { d(); } catch { e(); }
+async function g() {}
+let x = 1;
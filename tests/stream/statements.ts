@@ -0,0 +1,15 @@
+if (a) { b(); } else { c(); }
+try { d(); } catch (e) { f(); } finally { g(); }
+async function g() {}
+let x = 1;
+if (a) b(); else c();
+do x++; while (x < 3);
+do { x++; } while (x < 5);
+while (x) { x--; }
+function h() {};
+export { x };
+export default function k() {}
+namespace N { let y = 1; }
+label: for (;;) { break label; }
+const enum E { A }
+let o = { m: 1 };
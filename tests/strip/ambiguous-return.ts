@@ -0,0 +1 @@
+let g = (x: number): (number) => x;
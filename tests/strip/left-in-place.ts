@@ -0,0 +1,2 @@
+let ok = 1;
+let w = (x): number | => x;
@@ -0,0 +1,9 @@
+let k = "m";
+let o = {
+    m(a: number): number { return a; },
+    [k](a: number) {},
+    "quoted"(b?: string) {},
+    1<T>(c: T): T { return c; },
+    async *[k + "s"](d: number) {},
+    get [k + "g"](): number { return 1; },
+};
@@ -0,0 +1,21 @@
+class K {
+    m?(): void;
+    n() {}
+}
+
+class L { m?(): void; n() {} }
+
+class M {
+    public p?(x: number): void;
+    static q?<T>(x: T): T;
+    r(): void;
+    r() {}
+    s?: number;
+    t = 1;
+}
+
+abstract class N {
+    u?(): void;
+    v?(a: string, b?: number): string;
+    w() { return 1; }
+}
@@ -0,0 +1,6 @@
+let a = (x): ((y: number) => string) => null;
+let b = (x): (A | B) => x;
+let c = (x): ((y: number) => string)[] => [];
+let d = (x): (() => void) => () => {};
+let e = (x: (A & B)[], f: ((g: string) => void) | null): void => {};
+let after = { m(a: number) {} };
@@ -0,0 +1,11 @@
+let c = a ? (b) : d;
+switch (c) {
+case (1): break;
+default: c = 2;
+}
+outer: for (;;) { inner: while (c) break outer; }
+let n = { a: b ? 1 : 2, [k]: 3, "s"(x: number) { return x; }, 4(y?: string) {} };
+let h = (x): ((y: number) => string)[] => [];
+let t = (x): (() => void) => () => {};
+let e = (x) => ({ y: 1 });
+let after = { m(a: number) {} };